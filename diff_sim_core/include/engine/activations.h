@@ -6,5 +6,20 @@
 // Activation Functions
 Tensor relu(const Tensor& input);
 Tensor tanh(const Tensor& input);
+Tensor sigmoid(const Tensor& input);
+Tensor softplus(const Tensor& input);
+Tensor elu(const Tensor& input, float alpha = 1.0f);
+Tensor gelu(const Tensor& input); // Exact (erf) form
+
+// Normalized along 'axis': 0 = within each column, 1 = within each row
+Tensor softmax(const Tensor& input, int axis = 0);
+Tensor log_softmax(const Tensor& input, int axis = 0);
+
+// Layer normalization along 'axis'. gamma and beta hold one value per
+// normalized element ((rows, 1) for axis 0, (1, cols) for axis 1); pass
+// nullptr to skip the affine part.
+Tensor layer_norm(const Tensor& input, int axis = 0, float eps = 1e-5f);
+Tensor layer_norm(const Tensor& input, const Tensor& gamma, const Tensor& beta, int axis = 0, float eps = 1e-5f);
+Tensor layer_norm(const Tensor& input, const Tensor* pGamma, const Tensor* pBeta, int axis, float eps);
 
 #endif // ACTIVATIONS_H
@@ -0,0 +1,112 @@
+#ifndef ARTICULATED_H
+#define ARTICULATED_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+class Body;
+
+/**
+ * ArticulatedChain - Tree of bodies linked by revolute joints, in reduced coordinates
+ *
+ * The state is the root pose plus one angle per joint, and forward dynamics
+ * is Featherstone's articulated-body algorithm in O(links), so every joint
+ * holds exactly with no solver iterations (tethers, manipulators, long
+ * pendulums). The links are ordinary Bodies: their shapes collide with the
+ * engine's bodies and colliders, motors and gravity act on them through the
+ * force accumulators, and the engine writes every link's pose and velocity
+ * back after each substep.
+ *
+ * Spatial vectors are planar (angular, x, y), world-aligned and referenced at
+ * each link's center, so frame changes are pure translations and a link's
+ * equations of motion carry no velocity-product terms. Each substep is one
+ * RK4 step (four ABA passes) with the accumulated forces held constant.
+ *
+ * Contacts see each link as a free body; the velocity and position changes
+ * they make are then projected onto the chain through its mass matrix (one
+ * more O(links) pass). Link 0 is the root: floating (3 DOF) or fixed in place.
+ * Links must not also be added with Engine::AddBody or used in a Joint.
+ */
+class ArticulatedChain {
+public:
+    // A static root is always fixed
+    ArticulatedChain(Body* pRoot, bool floatingBase = true);
+
+    // Revolute joint at world point (anchorX, anchorY) between pLink and an
+    // earlier link; returns the new link's index (also its joint index)
+    int AddLink(Body* pLink, int parent, float anchorX, float anchorY, float damping = 0.0f);
+
+    int NumLinks() const { return (int)m_Links.size(); }
+    const std::vector<Body*>& Links() const { return m_LinkBodies; }
+    bool IsFloating() const { return m_bFloating; }
+
+    // Joint torque on link i (about its joint, reaction on its parent), held until changed
+    void SetJointTorque(int link, float torque);
+    void SetJointTorques(const Eigen::VectorXf& torques);  // (NumLinks() - 1), links 1..n-1
+
+    float GetJointAngle(int link) const;     // Zero at AddLink
+    float GetJointVelocity(int link) const;
+    Eigen::VectorXf GetJointAngles() const;
+    Eigen::VectorXf GetJointVelocities() const;
+
+    // Set a joint's state and move every link to match
+    void SetJointState(int link, float angle, float velocity);
+    // Rebuild link poses/velocities from the root body and the joint state
+    // (e.g. after moving the root by hand)
+    void UpdateLinks();
+
+    // Advance by dt with the forces in the links' accumulators (cleared)
+    void Step(float dt);
+
+    // Contact coupling: remember link states, then project whatever changed them
+    void CaptureLinkStates();
+    void ProjectLinkChanges();
+
+private:
+    struct Link {
+        Body* pBody;
+        int parent;
+        float parentAnchor[2];  // Joint point in the parent's local frame
+        float childAnchor[2];   // Joint point in this link's local frame
+        float referenceAngle;
+        float q = 0.0f;
+        float qd = 0.0f;
+        float torque = 0.0f;
+        float damping = 0.0f;
+
+        // World state (angle, center, angular/linear velocity) and joint geometry
+        float theta = 0.0f;
+        float omega = 0.0f;
+        Eigen::Vector2f c, v;
+        Eigen::Vector2f jointPoint;   // a_i
+        Eigen::Vector3f S;            // Motion subspace at the center
+        Eigen::Vector3f kappa;        // Velocity-product acceleration
+
+        // ABA scratch
+        Eigen::Matrix3f IA;
+        Eigen::Vector3f pA, U, A;
+        float D = 0.0f, u = 0.0f, qdd = 0.0f;
+
+        // Snapshot for contact projection
+        Eigen::Vector3f capturedVel, capturedPos;
+    };
+
+    void CheckJoint(int link, const char* pWhere) const;
+    void ReadRoot();
+    void Kinematics(bool bVelocity);
+    // Articulated-body pass. forces: external spatial force per link.
+    // Dynamics fills qdd and the root acceleration; impulse mode drops
+    // torques, damping and velocity terms, giving M^-1 J^T f.
+    void Propagate(const std::vector<Eigen::Vector3f>& forces, bool bImpulse);
+    Eigen::VectorXf GetState() const;
+    void SetState(const Eigen::VectorXf& x);  // Also updates kinematics
+    Eigen::VectorXf Derivative(const Eigen::VectorXf& x);
+    void WriteLinks();
+
+    std::vector<Link> m_Links;
+    std::vector<Body*> m_LinkBodies;
+    bool m_bFloating;
+    std::vector<Eigen::Vector3f> m_Forces;  // Reused per step
+};
+
+#endif // ARTICULATED_H
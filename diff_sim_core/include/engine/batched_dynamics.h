@@ -0,0 +1,36 @@
+#ifndef BATCHED_DYNAMICS_H
+#define BATCHED_DYNAMICS_H
+
+#include "engine/body.h"
+#include "engine/engine.h"
+#include "engine/motor.h"
+#include "engine/tensor.h"
+#include <vector>
+
+// Motor layout and integration settings shared by every world of a batch.
+// Only local_x, local_y and angle of each motor are read; thrust comes in
+// as a Tensor.
+struct BatchedBodyModel {
+    std::vector<Motor> motors;
+    float gravityX = 0.0f;
+    float gravityY = -9.81f;
+    float deltaTime = 0.016f;
+    int substeps = 20;
+
+    // Motors of 'body' plus the engine's gravity, dt and substeps
+    static BatchedBodyModel FromBody(const Engine& engine, const Body& body);
+};
+
+// One control step (one Engine::Update()) of N motorized bodies in free flight,
+// as a single autograd node. Batches are column-per-world:
+//   state  (6, N)  [x, y, theta, vx, vy, omega]
+//   thrust (M, N)  motor thrusts in Newtons (not clamped; squash them upstream)
+//   mass, inertia  (1, 1) shared by all worlds, or (1, N) per world
+// Returns the (6, N) next state. Backward runs the adjoint of the substep
+// loop for every world at once on the thread pool; gradients of shared
+// mass/inertia are reduced across worlds. Forward-mode tangents are carried.
+// Contacts are not modeled.
+Tensor BatchedBodyStep(const Tensor& state, const Tensor& thrust, const Tensor& mass, const Tensor& inertia,
+                       const BatchedBodyModel& model);
+
+#endif // BATCHED_DYNAMICS_H
@@ -167,12 +167,20 @@ public:
     void ApplyTorque(const Tensor& t);
     void ResetForces();
     
+    // State setters for solvers: write into the existing buffer while the
+    // state is a leaf, otherwise start a fresh leaf (cutting the graph there)
+    void SetPosition(float x, float y);
+    void SetVelocity(float vx, float vy);
+    void SetRotation(float theta);
+    void SetAngularVelocity(float omega);
+
     // Getters for rendering
     float GetX() const;
     float GetY() const;
     float GetRotation() const;
 
-    std::vector<Tensor> GetCorners();
+    // World-space box corners as columns (2, 4): TR, TL, BL, BR
+    Tensor GetCorners();
 
     // Shape management
     void AddBoxShape(float w, float h, float offX = 0, float offY = 0) {
@@ -0,0 +1,115 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "engine/tensor.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// Binary checkpoints
+//
+// Layout (little-endian, version 1):
+//   header   "RLCK", version, byte-order mark, entry count, table offset/size
+//   blocks   raw payloads, each starting on a 64-byte boundary
+//   table    per entry: name, dtype, rows, cols, offset, size
+// float32 blocks are column-major, exactly as Eigen stores them, so a
+// memory-mapped file can be read in place without any parsing.
+// ============================================================================
+
+enum class CheckpointDType : uint32_t {
+    FLOAT32 = 0,  // (rows, cols) matrix
+    INT64 = 1,    // Scalar
+    BYTES = 2     // Opaque blob (e.g. serialized RNG state)
+};
+
+/**
+ * CheckpointWriter - Collects named entries and writes them in one go
+ *
+ * Entries are copied when added, so the sources may change afterwards.
+ * Save() writes to a temporary file and renames it over the target, so
+ * readers never map a half-written checkpoint.
+ */
+class CheckpointWriter {
+public:
+    void AddMatrix(const std::string& name, const Eigen::MatrixXf& data);
+    void AddTensor(const std::string& name, const Tensor& tensor) { AddMatrix(name, tensor.Data()); }
+    // Stored as "<prefix>/0", "<prefix>/1", ...
+    void AddParameters(const std::string& prefix, const std::vector<Tensor*>& params);
+    void AddInt(const std::string& name, int64_t value);
+    void AddBytes(const std::string& name, const std::string& bytes);
+    void AddRng(const std::string& name, const std::mt19937& rng);
+
+    int NumEntries() const { return (int)m_Records.size(); }
+    void Save(const std::string& path) const;
+
+private:
+    struct Record {
+        std::string name;
+        CheckpointDType dtype;
+        int32_t rows;
+        int32_t cols;
+        std::string payload;
+    };
+    void Add(Record&& record);
+
+    std::vector<Record> m_Records;
+};
+
+/**
+ * Checkpoint - Read-only, memory-mapped view of a checkpoint file
+ *
+ * Opening maps the file and parses only the entry table; Matrix() returns
+ * an Eigen::Map straight into the mapping, valid for the Checkpoint's
+ * lifetime. Loading into a Tensor is a single copy out of the page cache.
+ */
+class Checkpoint {
+public:
+    explicit Checkpoint(const std::string& path);
+    ~Checkpoint();
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    const std::string& Path() const { return m_Path; }
+    const std::vector<std::string>& Names() const { return m_Names; }  // In file order
+    bool Has(const std::string& name) const { return m_Entries.count(name) > 0; }
+    int Rows(const std::string& name) const;
+    int Cols(const std::string& name) const;
+
+    // Zero-copy view of a float32 entry
+    Eigen::Map<const Eigen::MatrixXf> Matrix(const std::string& name) const;
+    int64_t Int(const std::string& name) const;
+    std::string Bytes(const std::string& name) const;
+
+    // Copy into existing Tensors; shapes must match
+    void LoadTensor(const std::string& name, Tensor& target) const;
+    void LoadParameters(const std::string& prefix, const std::vector<Tensor*>& params) const;
+    void LoadRng(const std::string& name, std::mt19937& rng) const;
+
+private:
+    struct Entry {
+        CheckpointDType dtype;
+        int32_t rows;
+        int32_t cols;
+        uint64_t offset;
+        uint64_t size;
+    };
+    const Entry& Find(const std::string& name, CheckpointDType dtype) const;
+    void Unmap();
+
+    std::string m_Path;
+    const char* m_pData = nullptr;
+    size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_hFile = nullptr;
+    void* m_hMapping = nullptr;
+#endif
+    std::unordered_map<std::string, Entry> m_Entries;
+    std::vector<std::string> m_Names;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,31 @@
+#ifndef COMPUTE_H
+#define COMPUTE_H
+
+#include <Eigen/Dense>
+#include <cstdint>
+
+// ============================================================================
+// Compute backend for dense kernels
+//
+// Large GEMMs are split into independent output (or reduction) blocks and run
+// on the global ThreadPool, each block through Eigen's cache-blocked kernel
+// with Eigen's own threading disabled. Because the pool is shared, a GEMM
+// issued from a pool worker (e.g. inside a parallel environment step) runs
+// serially instead of oversubscribing the cores.
+// ============================================================================
+
+// Threads one GEMM may use (<= 0: every thread of the global pool)
+void SetIntraOpThreads(int numThreads);
+int GetIntraOpThreads();
+
+// Products below this many multiply-adds (m * n * k) stay single-threaded
+void SetGemmParallelThreshold(int64_t minMacs);
+int64_t GetGemmParallelThreshold();
+
+// C = op(A) * op(B), or C += op(A) * op(B) when bAccumulate.
+// op(X) is X or X^T; transposed operands are read in place, never copied.
+void Gemm(const Eigen::MatrixXf& A, bool bTransA,
+          const Eigen::MatrixXf& B, bool bTransB,
+          Eigen::MatrixXf& C, bool bAccumulate);
+
+#endif // COMPUTE_H
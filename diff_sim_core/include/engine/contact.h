@@ -139,6 +139,11 @@ public:
     // Clear all contacts
     void Clear();
     
+    int NumCached() const { return (int)m_ManifoldCache.size(); }
+    int NumActive() const { return (int)m_ActiveManifolds.size(); }
+    // Approximate heap footprint of the cache and the active list
+    int64_t MemoryBytes() const;
+    
 private:
     std::unordered_map<ContactKey, ContactManifold, ContactKeyHash> m_ManifoldCache;
     std::vector<ContactManifold*> m_ActiveManifolds;
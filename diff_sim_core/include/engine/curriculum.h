@@ -0,0 +1,78 @@
+#ifndef CURRICULUM_H
+#define CURRICULUM_H
+
+#include <Eigen/Dense>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+enum class CurriculumMode {
+    UNIFORM,            // Every spawn point equally often (the Python DroneEnv behavior)
+    LEARNING_PROGRESS,  // Spawns whose return is changing fastest: |fast EMA - slow EMA|
+    DIFFICULTY          // Spawns the policy fails on: 1 - success rate
+};
+
+struct CurriculumConfig {
+    CurriculumMode mode = CurriculumMode::UNIFORM;
+    float fastRate = 0.1f;      // EMA rate of the fast return/success averages
+    float slowRate = 0.01f;     // EMA rate of the slow ones
+    float uniformMix = 0.1f;    // Probability mass always spread evenly, so no spawn is starved
+    int minEpisodes = 3;        // Spawns with fewer finished episodes get the highest weight
+    float successRadius = 0.5f; // Success: not crashed and ending within this distance of the target
+};
+
+/**
+ * CurriculumSampler - Picks spawn points from per-spawn episode statistics
+ *
+ * Record() and Sample() are lock-free and may be called from any number of
+ * worker threads at once: every statistic is an atomic, EMAs are updated
+ * with compare-and-swap, and each spawn's counters sit on their own cache
+ * line. Sample() derives the distribution from the current statistics on
+ * every call (O(numSpawns)), so there is no shared table to rebuild.
+ * EMAs start at zero and are bias-corrected when read.
+ */
+class CurriculumSampler {
+public:
+    struct SpawnStats {
+        int64_t episodes = 0;
+        float successRate = 0.0f;   // Over all recorded episodes
+        float fastReturn = 0.0f;
+        float slowReturn = 0.0f;
+        float fastSuccess = 0.0f;
+        float slowSuccess = 0.0f;
+    };
+
+    CurriculumSampler(int numSpawns, const CurriculumConfig& config = CurriculumConfig());
+
+    int NumSpawns() const { return m_NumSpawns; }
+    const CurriculumConfig& Config() const { return m_Config; }
+
+    // u uniform in [0, 1)
+    int Sample(float u) const;
+    int Sample(std::mt19937& rng) const;
+
+    void Record(int spawn, float episodeReturn, bool success);
+
+    SpawnStats Stats(int spawn) const;
+    Eigen::VectorXf Probabilities() const;
+    void Reset();
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<int64_t> episodes{0};
+        std::atomic<int64_t> successes{0};
+        std::atomic<float> fastReturn{0.0f};
+        std::atomic<float> slowReturn{0.0f};
+        std::atomic<float> fastSuccess{0.0f};
+        std::atomic<float> slowSuccess{0.0f};
+    };
+
+    float Weight(const SpawnStats& stats) const;
+
+    int m_NumSpawns;
+    CurriculumConfig m_Config;
+    std::unique_ptr<Slot[]> m_pSlots;
+};
+
+#endif // CURRICULUM_H
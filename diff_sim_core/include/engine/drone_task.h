@@ -0,0 +1,144 @@
+#ifndef DRONE_TASK_H
+#define DRONE_TASK_H
+
+#include "engine/curriculum.h"
+#include "engine/engine.h"
+#include "engine/motor.h"
+#include "engine/observation_history.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// C++ mirror of rigidrl_py's EnvConfig for the drone hover task
+struct DroneTaskConfig {
+    float mass = 1.0f;
+    float width = 1.0f;
+    float height = 0.2f;
+    std::vector<Motor> motors = {Motor(-0.4f, 0.0f, 0.1f, 0.1f, 0.05f, 10.0f),
+                                 Motor(0.4f, 0.0f, 0.1f, 0.1f, 0.05f, 10.0f)};
+    float targetX = 0.0f;
+    float targetY = 4.0f;
+    std::vector<std::pair<float, float>> spawnPoints = {{0.0f, 1.5f}};
+    int maxSteps = 500;
+    float deltaTime = 0.016f;
+    int substeps = 20;
+    CurriculumConfig curriculum;  // How resets choose among spawnPoints
+    bool enableSensors = false;   // IMU + position fixes on the drone (see sensors.h)
+    SensorConfig sensors;
+    int historyLength = 0;        // Observations kept per world in History(); 0 = off
+    // Actuator latency in substeps, drawn uniformly per world on every reset
+    int minActionDelay = 0;
+    int maxActionDelay = 0;
+    int rewindSteps = 0;          // Steps each world can rewind within its episode; 0 = off
+    int rewindKeyframeInterval = 16;
+};
+
+/**
+ * DroneVecEnv - N independent headless drone worlds stepped in lockstep
+ *
+ * Same observation, reward and termination rules as the Python DroneEnv:
+ *   obs = [dx, dy, vx, vy, rotation, angular_velocity], d = target - position
+ * Actions are normalized to [-1, 1] per motor and mapped onto [0, max_thrust],
+ * so a zero-mean policy starts near hover. Worlds step in parallel on the
+ * global ThreadPool and reset themselves when an episode ends; the spawn
+ * point of each reset comes from a CurriculumSampler that every world
+ * reports its finished episodes to.
+ *
+ * With enableSensors, each world's engine also samples the drone's IMU and
+ * position fixes with its own seeded RNG, gathered into SensorReadings().
+ *
+ * With historyLength = k, every step also writes each world's observation
+ * into an ObservationHistory, so the last k frames are a (N, k, 6) view with
+ * no stacking copies; a world's history is cleared when it resets.
+ *
+ * Actions can reach the motors with a latency of minActionDelay to
+ * maxActionDelay substeps (Motor::SetDelay), redrawn for a world whenever it
+ * resets, so each world emulates its own command link.
+ *
+ * With rewindSteps = T, every world's engine records its last T states
+ * (Engine::EnableRewind), restarted on reset, and RewindWorld() steps one
+ * world back within its episode.
+ *
+ * All batches are column-per-world: observations (6, N), actions (A, N),
+ * sensor readings (SensorSuite::ROWS, N).
+ */
+class DroneVecEnv {
+public:
+    static const int OBS_SIZE = 6;
+
+    DroneVecEnv(const DroneTaskConfig& config, int numEnvs, unsigned int seed = 0);
+    ~DroneVecEnv();
+
+    DroneVecEnv(const DroneVecEnv&) = delete;
+    DroneVecEnv& operator=(const DroneVecEnv&) = delete;
+
+    int NumEnvs() const { return (int)m_Worlds.size(); }
+    int ObservationSize() const { return OBS_SIZE; }
+    int ActionSize() const { return (int)m_Config.motors.size(); }
+    const DroneTaskConfig& Config() const { return m_Config; }
+
+    // Reset every world to a random spawn point; returns the observations
+    const Eigen::MatrixXf& Reset();
+    // Start a new episode in one world at (x, y), at rest; updates its observation column.
+    // rng draws the episode's action delay, so callers can make it depend on the
+    // episode rather than on the world it runs in.
+    void ResetWorldAt(int index, float x, float y, std::mt19937& rng);
+
+    // Advance every world by one control step (deltaTime). Worlds whose
+    // episode ended are reset before returning; their last observation is
+    // kept in TerminalObservations().
+    void Step(const Eigen::MatrixXf& actions);
+
+    const Eigen::MatrixXf& Observations() const { return m_Observations; }
+    const Eigen::MatrixXf& TerminalObservations() const { return m_TerminalObservations; }
+    const Eigen::VectorXf& Rewards() const { return m_Rewards; }
+    const std::vector<uint8_t>& Terminated() const { return m_Terminated; } // Crashed or flipped
+    const std::vector<uint8_t>& Truncated() const { return m_Truncated; }   // Hit maxSteps
+    // Latest step's readings; a world that was just reset shows its fresh (empty) sensors
+    const Eigen::MatrixXf& SensorReadings() const { return m_SensorReadings; }
+    // Frame stack of the current observations (historyLength > 0), newest frame last
+    const ObservationHistory& History() const;
+
+    // Move one world back `steps` control steps (rewindSteps > 0): physics,
+    // step count, episode return and its observation column. Its sensor
+    // readings and frame stack keep the latest step.
+    void RewindWorld(int index, int steps);
+    int RewindAvailable(int index) const;
+
+    // Undiscounted returns and lengths of episodes finished since the last call
+    void TakeFinishedEpisodes(std::vector<float>& returns, std::vector<int>& lengths);
+
+    CurriculumSampler& Curriculum() { return *m_pCurriculum; }
+    const CurriculumSampler& Curriculum() const { return *m_pCurriculum; }
+
+private:
+    struct World;
+
+    void ResetWorld(int index);
+    void PlaceWorld(int index, float x, float y, std::mt19937& rng);
+    void WriteObservation(int index, Eigen::MatrixXf& target) const;
+    void WriteSensors(int index);
+    void WriteHistory(int index, bool bClear);
+    float ComputeReward(int index) const;
+    bool IsTerminated(int index) const;
+
+    DroneTaskConfig m_Config;
+    std::unique_ptr<CurriculumSampler> m_pCurriculum;
+    std::vector<std::unique_ptr<World>> m_Worlds;
+
+    Eigen::MatrixXf m_Observations;
+    Eigen::MatrixXf m_TerminalObservations;
+    Eigen::VectorXf m_Rewards;
+    std::vector<uint8_t> m_Terminated;
+    std::vector<uint8_t> m_Truncated;
+    Eigen::MatrixXf m_SensorReadings;
+    std::unique_ptr<ObservationHistory> m_pHistory;
+
+    std::vector<float> m_FinishedReturns;
+    std::vector<int> m_FinishedLengths;
+};
+
+#endif // DRONE_TASK_H
@@ -0,0 +1,108 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <cmath>
+
+// Maximum number of simultaneous tangent directions carried by a Dual.
+// Sized for system identification (a handful of physical parameters) and
+// for single-step linearization (6 body states + a few motor commands).
+constexpr int DUAL_MAX_TANGENTS = 16;
+
+/**
+ * Dual - Forward-mode dual number with a fixed block of tangents
+ *
+ * val holds the primal value and tan[i] its derivative along direction i.
+ * Tangents travel alongside values, so memory is O(1) in the number of
+ * steps simulated. Unused directions stay zero and cost only SIMD lanes.
+ */
+struct Dual {
+    float val = 0.0f;
+    float tan[DUAL_MAX_TANGENTS] = {0};
+
+    Dual() = default;
+    Dual(float v) : val(v) {}
+
+    // Independent variable: value v, unit tangent along direction idx
+    static Dual Variable(float v, int idx) {
+        Dual d(v);
+        d.tan[idx] = 1.0f;
+        return d;
+    }
+
+    Dual& operator+=(const Dual& o) {
+        val += o.val;
+        for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) tan[i] += o.tan[i];
+        return *this;
+    }
+    Dual& operator-=(const Dual& o) {
+        val -= o.val;
+        for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) tan[i] -= o.tan[i];
+        return *this;
+    }
+    Dual& operator*=(const Dual& o) {
+        for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) tan[i] = tan[i] * o.val + val * o.tan[i];
+        val *= o.val;
+        return *this;
+    }
+    Dual& operator/=(const Dual& o) {
+        float inv = 1.0f / o.val;
+        float q = val * inv;
+        for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) tan[i] = (tan[i] - q * o.tan[i]) * inv;
+        val = q;
+        return *this;
+    }
+};
+
+inline Dual operator+(Dual a, const Dual& b) { return a += b; }
+inline Dual operator-(Dual a, const Dual& b) { return a -= b; }
+inline Dual operator*(Dual a, const Dual& b) { return a *= b; }
+inline Dual operator/(Dual a, const Dual& b) { return a /= b; }
+
+inline Dual operator+(Dual a, float s) { a.val += s; return a; }
+inline Dual operator+(float s, Dual a) { a.val += s; return a; }
+inline Dual operator-(Dual a, float s) { a.val -= s; return a; }
+inline Dual operator-(float s, const Dual& a) {
+    Dual r(s - a.val);
+    for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) r.tan[i] = -a.tan[i];
+    return r;
+}
+inline Dual operator*(Dual a, float s) {
+    a.val *= s;
+    for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) a.tan[i] *= s;
+    return a;
+}
+inline Dual operator*(float s, Dual a) { return a * s; }
+inline Dual operator/(Dual a, float s) { return a * (1.0f / s); }
+inline Dual operator/(float s, const Dual& a) {
+    float inv = 1.0f / a.val;
+    Dual r(s * inv);
+    float k = -s * inv * inv;
+    for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) r.tan[i] = k * a.tan[i];
+    return r;
+}
+inline Dual operator-(const Dual& a) { return a * -1.0f; }
+
+// Apply chain rule for a scalar function with value f and derivative df
+inline Dual DualChain(const Dual& a, float f, float df) {
+    Dual r(f);
+    for (int i = 0; i < DUAL_MAX_TANGENTS; ++i) r.tan[i] = df * a.tan[i];
+    return r;
+}
+
+inline Dual sin(const Dual& a) { return DualChain(a, std::sin(a.val), std::cos(a.val)); }
+inline Dual cos(const Dual& a) { return DualChain(a, std::cos(a.val), -std::sin(a.val)); }
+inline Dual exp(const Dual& a) { float e = std::exp(a.val); return DualChain(a, e, e); }
+inline Dual log(const Dual& a) { return DualChain(a, std::log(a.val), 1.0f / a.val); }
+inline Dual sqrt(const Dual& a) { float s = std::sqrt(a.val); return DualChain(a, s, 0.5f / s); }
+inline Dual abs(const Dual& a) { return a.val < 0.0f ? -a : a; }
+
+// Piecewise ops pick the active branch; its tangent passes through
+inline const Dual& DualMax(const Dual& a, const Dual& b) { return (a.val < b.val) ? b : a; }
+inline const Dual& DualMin(const Dual& a, const Dual& b) { return (b.val < a.val) ? b : a; }
+inline Dual DualClamp(const Dual& a, float lo, float hi) {
+    if (a.val < lo) return Dual(lo);
+    if (a.val > hi) return Dual(hi);
+    return a;
+}
+
+#endif // DUAL_H
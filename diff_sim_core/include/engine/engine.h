@@ -6,6 +6,45 @@
 #include "engine/body.h"
 #include "engine/tensor.h"
 #include "engine/contact.h"
+#include "engine/dual.h"
+#include "engine/memory_stats.h"
+#include "engine/joint.h"
+#include "engine/articulated.h"
+#include "engine/sensors.h"
+#include "engine/rewind.h"
+#include <memory>
+#include <unordered_map>
+
+// Physical parameters that forward-mode sensitivities can be taken against
+enum class SensitivityParam {
+    MASS,
+    INERTIA,
+    FRICTION,
+    RESTITUTION,
+    MOTOR_MAX_THRUST,   // Commands are held as a fixed fraction of max_thrust
+    MOTOR_ANGLE
+};
+
+struct SensitivityParamRef {
+    Body* pBody;
+    SensitivityParam kind;
+    int motorIndex;
+};
+
+// Body state carried as dual numbers: [x, y, theta, vx, vy, omega]
+struct DualBodyState {
+    Dual x, y, theta;
+    Dual vx, vy, omega;
+};
+
+struct DualBody;
+struct XPBDContact;
+
+// Constraint solver used by Engine::Update
+enum class SolverMode {
+    IMPULSE,    // Sequential impulses with velocity/position iterations (default)
+    XPBD        // Extended position-based dynamics: one compliant position iteration per substep
+};
 
 class Engine {
 private:
@@ -14,6 +53,13 @@ private:
     std::vector<Body*> m_Bodies;          // Dynamic bodies
     std::vector<Body*> m_Colliders;       // Static colliders (ground, walls, etc.)
     ContactManager m_ContactManager;       // Sequential impulse solver
+    std::vector<Joint*> m_Joints;          // Not owned
+    std::vector<Body*> m_JointBodies;      // Dynamic bodies of m_Joints, rebuilt every substep
+    std::vector<float> m_JointVelocities;  // Their (vx, vy, w) as integrated, before the joint solve
+    std::vector<ArticulatedChain*> m_Articulations;  // Not owned
+    SensorSuite m_Sensors;                 // IMUs and position fixes, sampled every Update()
+    std::unique_ptr<RewindBuffer> m_pRewind;  // Recent states, recorded every Update() when enabled
+    std::vector<float> m_RewindState;         // Scratch for recording and restoring
     
     // Simulation parameters
     float m_DeltaTime;
@@ -24,9 +70,16 @@ private:
     // Solver settings
     int m_VelocityIterations = 8;
     int m_PositionIterations = 3;
+    SolverMode m_SolverMode = SolverMode::IMPULSE;
+    float m_ContactCompliance = 0.0f;   // XPBD only (m/N), 0 = rigid
+    float m_JointCompliance = 0.0f;
     
     // Rendering mode
     bool m_bHeadless;
+    
+    // Forward-mode sensitivities (disabled while no parameters are registered)
+    std::vector<SensitivityParamRef> m_SensitivityParams;
+    std::unordered_map<Body*, DualBodyState> m_DualStates;
 
 public:
     // Constructor / Destructor
@@ -43,23 +96,97 @@ public:
                       float rotation = 0.0f, float friction = 0.5f);
     void ClearColliders();
     
+    // Joints (not owned; solved every substep before collisions, see joint.h)
+    void AddJoint(Joint* pJoint);
+    void RemoveJoint(Joint* pJoint);
+    void ClearJoints();
+    const std::vector<Joint*>& GetJoints() const { return m_Joints; }
+    
+    // Reduced-coordinate chains (not owned; their links collide like bodies, see articulated.h)
+    void AddArticulation(ArticulatedChain* pChain);
+    void RemoveArticulation(ArticulatedChain* pChain);
+    void ClearArticulations();
+    
+    // Sensors on bodies (see sensors.h); ClearBodies() removes them too
+    SensorSuite& GetSensors() { return m_Sensors; }
+    
+    // Rewind: the last `steps` states, keyframed every keyframeInterval steps
+    // and delta-encoded in between (see rewind.h). Rewind() restores bodies,
+    // motor commands in flight and articulation joints, drops the later
+    // frames and clears the contact and joint warm starts and sensitivity
+    // tangents.
+    // Sensor noise and clocks are not rewound. Adding bodies or changing a
+    // motor delay changes the state layout: call RestartRewind() after it.
+    void EnableRewind(int steps, int keyframeInterval = 16);
+    void DisableRewind();
+    void RestartRewind();   // Drop the history; the current state becomes frame 0
+    void Rewind(int steps);
+    int GetRewindAvailable() const;
+    const RewindBuffer* GetRewindBuffer() const { return m_pRewind.get(); }
+    
     // Environment
     void SetGravity(float x, float y);
     
+    // Solver. XPBD wants more substeps (20-50) but does a single constraint
+    // iteration in each; compliance is inverse stiffness, 0 = rigid.
+    void SetSolverMode(SolverMode mode);
+    SolverMode GetSolverMode() const { return m_SolverMode; }
+    void SetContactCompliance(float compliance);
+    void SetJointCompliance(float compliance);
+    float GetContactCompliance() const { return m_ContactCompliance; }
+    float GetJointCompliance() const { return m_JointCompliance; }
+    
     // Simulation
     void Update();          // Physics step only
     void RenderBodies();    // Render all bodies + colliders
     bool Step();            // Full frame: events + physics + render
     
+    // Forward-mode sensitivities: d[x, y, theta, vx, vy, omega] / d(params).
+    // Once a parameter is registered, Update() carries tangents through motors,
+    // gravity, integration and contact impulses in O(1) memory per body.
+    int AddSensitivityParameter(Body* pBody, SensitivityParam kind, int motorIndex = -1);
+    void ClearSensitivityParameters();
+    void ResetSensitivities();     // Zero all tangents (e.g. at the start of a segment)
+    int NumSensitivityParameters() const { return (int)m_SensitivityParams.size(); }
+    Eigen::MatrixXf GetSensitivity(Body* pBody) const;  // (6 x P)
+    
     // Accessors
     Renderer* GetRenderer() { return m_pRenderer; }
     bool IsHeadless() const { return m_bHeadless; }
+    float GetDeltaTime() const { return m_DeltaTime; }
+    int GetSubsteps() const { return m_Substeps; }
+    float GetGravityX() const { return m_GravityX; }
+    float GetGravityY() const { return m_GravityY; }
+    
+    // Counts and approximate bytes of bodies, colliders and contact state (see MemoryTracker)
+    EngineMemoryStats GetMemoryStats() const;
 
 private:
     // Physics helpers
     void ApplyGravity(Body* pBody, float subDt);
     void Integrate(Body* pBody, float subDt);
     
+    // Joint pass after integration (see joint.cpp)
+    void SolveJoints(float subDt);
+    bool JointPreventsCollision(Body* pBodyA, Body* pBodyB) const;
+    void ResolveArticulationContacts();
+    
+    // Rewind state (see rewind.cpp)
+    void RecordRewindState();
+    void SaveRewindState(std::vector<float>& state) const;
+    void LoadRewindState(const std::vector<float>& state);
+    
+    // Sequential-impulse substep loop
+    void UpdateImpulse();
+    
+    // Position-based substep loop (see xpbd.cpp)
+    void UpdateXPBD();
+    void DetectXPBDContacts(Body* pBodyA, Body* pBodyB, std::vector<XPBDContact>& contacts);
+    
+    // Dual-number physics step (see sensitivity.cpp)
+    void UpdateWithSensitivities();
+    void ResolveCollisionDual(DualBody& bodyA, DualBody& bodyB);
+    
     // Collision detection
     bool DetectCollision(Body* pBodyA, Body* pBodyB, ContactManifold& manifold);
     void FindIncidentFace(float* pVertices, Body* pBody, float nx, float ny);
@@ -74,6 +201,13 @@ private:
     
     // Legacy collision (kept for compatibility)
     void ResolveCollision(Body* pBodyA, Body* pBodyB);
+    
+    // Shape-pair dispatch: fills up to 4 contacts with the normal pointing from B to A.
+    // Returns the number of contacts (0 = no collision). pContactsPen, if given,
+    // receives each contact's own depth (box pairs), otherwise pen.
+    int CollideShapes(Body* pBodyA, const Shape& shapeA, Body* pBodyB, const Shape& shapeB,
+                      float& pen, float& nx, float& ny, float* pContactsX, float* pContactsY,
+                      float* pContactsPen = nullptr);
     bool DetectBoxBox(Body* pBodyA, const Shape& shapeA, Body* pBodyB, const Shape& shapeB,
                       float& penDepth, float& nx, float& ny, float& cx, float& cy);
     int DetectBoxBoxMulti(Body* pBodyA, const Shape& shapeA, Body* pBodyB, const Shape& shapeB,
@@ -0,0 +1,80 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "engine/drone_task.h"
+#include "engine/policy.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// One evaluation condition: a spawn point and the seed its episodes derive from
+struct EvalCondition {
+    float spawnX = 0.0f;
+    float spawnY = 1.5f;
+    unsigned int seed = 0;
+};
+
+struct EvalConfig {
+    int episodesPerCondition = 10;
+    int numWorlds = 256;           // Worlds stepped in lockstep; episodes are streamed through them
+    float spawnJitter = 0.0f;      // Uniform +/- offset on the spawn point, drawn per episode
+    bool deterministic = true;     // GaussianPolicy only: act with the mean instead of sampling
+    float successRadius = 0.5f;    // Success: not crashed and ending within this distance of the target
+    bool recordTrajectories = false;
+};
+
+struct EvalConditionResult {
+    EvalCondition condition;
+    std::vector<float> returns;       // Per episode, undiscounted
+    std::vector<int> lengths;
+    std::vector<uint8_t> successes;
+    float meanReturn = 0.0f;
+    float stdReturn = 0.0f;
+    float minReturn = 0.0f;
+    float maxReturn = 0.0f;
+    float meanLength = 0.0f;
+    float successRate = 0.0f;
+    // Per episode (6, length + 1) states [x, y, theta, vx, vy, omega], if recorded
+    std::vector<Eigen::MatrixXf> trajectories;
+};
+
+// Batched policy: (6, B) observations -> (num_motors, B) actions in [-1, 1]
+using EvalPolicyFn = std::function<Eigen::MatrixXf(const Eigen::MatrixXf&)>;
+
+/**
+ * PolicyEvaluator - Runs many evaluation episodes in parallel
+ *
+ * Every (condition, episode) pair becomes one episode. Episodes are streamed
+ * through a fixed pool of DroneVecEnv worlds: a world that finishes starts
+ * the next pending episode, so the batch stays full until the tail. The
+ * policy is called once per control step on the observations of all running
+ * episodes. Each episode's jitter, action delay and action noise come from
+ * its own RNG, seeded from the condition seed and episode index, so results
+ * do not depend on numWorlds or the thread count.
+ */
+class PolicyEvaluator {
+public:
+    PolicyEvaluator(const DroneTaskConfig& task, const EvalConfig& config = EvalConfig());
+
+    std::vector<EvalConditionResult> Evaluate(const std::vector<EvalCondition>& conditions,
+                                              const EvalPolicyFn& policy);
+    std::vector<EvalConditionResult> Evaluate(const std::vector<EvalCondition>& conditions,
+                                              const GaussianPolicy& policy);
+
+    const DroneTaskConfig& Task() const { return m_Task; }
+    const EvalConfig& Config() const { return m_Config; }
+
+private:
+    // actionStd: per-motor Gaussian noise added to the policy output (empty for none)
+    std::vector<EvalConditionResult> Run(const std::vector<EvalCondition>& conditions,
+                                         const EvalPolicyFn& policy,
+                                         const Eigen::VectorXf& actionStd);
+
+    DroneTaskConfig m_Task;
+    EvalConfig m_Config;
+    std::unique_ptr<DroneVecEnv> m_pEnv; // Rebuilt only when the world count changes
+};
+
+#endif // EVALUATION_H
@@ -0,0 +1,104 @@
+#ifndef ILQR_H
+#define ILQR_H
+
+#include "engine/body.h"
+#include "engine/engine.h"
+#include <Eigen/Dense>
+#include <vector>
+
+// Quadratic tracking cost with diagonal weights, over a horizon of T steps:
+//   sum_t |x_t - target|^2_Q + |u_t - uRef|^2_R  +  |x_T - target|^2_Qf
+// States are [x, y, theta, vx, vy, omega]; controls are motor thrusts.
+struct ILQRCost {
+    Eigen::VectorXf stateTarget = Eigen::VectorXf::Zero(6);
+    Eigen::VectorXf stateWeights = Eigen::VectorXf::Ones(6);                // diag(Q)
+    Eigen::VectorXf finalStateWeights = Eigen::VectorXf::Constant(6, 10.0f); // diag(Qf)
+    Eigen::VectorXf controlReference;  // Empty: zero thrust
+    Eigen::VectorXf controlWeights;    // diag(R); empty: 1e-3 per motor
+};
+
+struct ILQRConfig {
+    int maxIterations = 50;
+    float tolerance = 1e-6f;        // Stop once the relative cost decrease drops below this
+    int maxLineSearchSteps = 10;    // Step sizes 1, 1/2, 1/4, ...
+    float regularization = 1e-6f;   // Initial Levenberg-Marquardt damping on Q_uu
+    float maxRegularization = 1e10f;
+};
+
+struct ILQRResult {
+    Eigen::MatrixXf states;                      // (6, T + 1)
+    Eigen::MatrixXf controls;                    // (M, T) motor thrusts
+    std::vector<Eigen::MatrixXf> feedbackGains;  // T x (M, 6): u = u_t + K_t (x - x_t), clamped
+    std::vector<float> costHistory;              // Initial cost, then one entry per accepted step
+    float cost = 0.0f;
+    int iterations = 0;
+    bool bConverged = false;
+};
+
+/**
+ * ILQRSolver - Iterative LQR over the free-flight dynamics of a motorized body
+ *
+ * x_{t+1} = f(x_t, u_t) is one Engine::Update() of the body: 'substeps'
+ * rounds of motor forces, gravity and semi-implicit Euler. The Jacobians
+ * A = df/dx and B = df/du are propagated analytically through the substeps
+ * alongside the state, so every iteration costs O(T * substeps) small dense
+ * products instead of a rollout through the autograd graph. The backward
+ * Riccati pass runs in double precision and respects the motor limits
+ * [0, max_thrust] by clamping the feedforward step and dropping feedback on
+ * saturated motors; the forward pass is line-searched on the true cost.
+ *
+ * Contacts are not modeled: keep the nominal trajectory clear of colliders.
+ */
+class ILQRSolver {
+public:
+    // Snapshots the body's mass, inertia and motors and the engine's gravity, dt and substeps
+    ILQRSolver(const Engine& engine, const Body& body, const ILQRConfig& config = ILQRConfig());
+
+    int StateSize() const { return 6; }
+    int ControlSize() const { return (int)m_MaxThrust.size(); }
+    const Eigen::VectorXf& ControlLimits() const { return m_MaxThrust; }
+    ILQRConfig& Config() { return m_Config; }
+
+    // One control step from 'state' under thrusts 'controls'
+    Eigen::VectorXf Dynamics(const Eigen::VectorXf& state, const Eigen::VectorXf& controls) const;
+    // Jacobians of Dynamics(): A = df/dx (6, 6), B = df/du (6, M)
+    void Linearize(const Eigen::VectorXf& state, const Eigen::VectorXf& controls,
+                   Eigen::MatrixXf& A, Eigen::MatrixXf& B) const;
+
+    // Optimize the thrusts from 'initialState'; initialControls (M, T) sets the
+    // horizon and the starting guess (clamped to the motor limits)
+    ILQRResult Solve(const Eigen::VectorXf& initialState, const Eigen::MatrixXf& initialControls,
+                     const ILQRCost& cost) const;
+
+private:
+    typedef Eigen::Matrix<double, 6, 1> StateVector;
+    typedef Eigen::Matrix<double, 6, 6> StateMatrix;
+    typedef Eigen::Matrix<double, 6, Eigen::Dynamic> Jacobian;
+
+    struct Trajectory;
+    struct CostTerms;
+
+    void Propagate(const StateVector& x, const Eigen::VectorXd& u, StateVector& xNext, Jacobian* pJacobian) const;
+    double Rollout(const Trajectory& nominal, const std::vector<Eigen::VectorXd>& k,
+                   const std::vector<Eigen::MatrixXd>& K, double alpha, const CostTerms& cost,
+                   Trajectory& out) const;
+    bool BackwardPass(const Trajectory& nominal, const std::vector<Jacobian>& jacobians, const CostTerms& cost,
+                      double mu, std::vector<Eigen::VectorXd>& k, std::vector<Eigen::MatrixXd>& K,
+                      double& expectedLinear, double& expectedQuadratic) const;
+
+    ILQRConfig m_Config;
+
+    // Model snapshot
+    double m_Mass;
+    double m_Inertia;
+    double m_GravityX;
+    double m_GravityY;
+    double m_DeltaTime;
+    int m_Substeps;
+    Eigen::VectorXd m_ForceX;     // Body-frame force per unit thrust, per motor
+    Eigen::VectorXd m_ForceY;
+    Eigen::VectorXd m_Torque;     // Torque per unit thrust (independent of rotation)
+    Eigen::VectorXf m_MaxThrust;
+};
+
+#endif // ILQR_H
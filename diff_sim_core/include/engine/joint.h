@@ -0,0 +1,182 @@
+#ifndef JOINT_H
+#define JOINT_H
+
+class Body;
+
+enum class JointType { REVOLUTE, PRISMATIC, WELD, DISTANCE };
+
+/**
+ * Joint - Constraint between two bodies, solved before the contacts
+ *
+ * Joints are solved by sequential impulses in their own pass every substep,
+ * after integration and before collisions are resolved: velocity iterations
+ * first (the position change the impulses imply is applied too, as if they
+ * had acted before the position update), then a few position iterations
+ * that remove the remaining drift directly. Contacts see the joint-corrected
+ * state; the two are not iterated together.
+ * Accumulated impulses persist in the joint between substeps and frames and
+ * warm-start the next solve, the way ContactManager keeps contact impulses,
+ * so stiff chains converge at normal substep counts. In SolverMode::XPBD
+ * only the position solve runs, once per substep, with the engine's joint
+ * compliance.
+ *
+ * Anchors are given in world coordinates at creation and stored in each
+ * body's local frame. Either body may be static (e.g. a collider returned
+ * by Engine::AddCollider). The engine does not own joints.
+ */
+class Joint {
+public:
+    virtual ~Joint() = default;
+
+    JointType GetType() const { return m_Type; }
+    Body* GetBodyA() const { return m_pBodyA; }
+    Body* GetBodyB() const { return m_pBodyB; }
+
+    // Constraint force/torque applied to body B during the last substep (impulse solver)
+    float GetReactionForceX() const { return m_ReactionX; }
+    float GetReactionForceY() const { return m_ReactionY; }
+    float GetReactionTorque() const { return m_ReactionTorque; }
+
+    // Let the two bodies keep colliding with each other
+    bool collide_connected = false;
+
+protected:
+    friend class Engine;
+
+    Joint(JointType type, Body* pBodyA, Body* pBodyB);
+
+    // Cache anchors and effective masses for this substep, apply the warm start
+    virtual void Prepare(float dt) = 0;
+    virtual void SolveVelocity(float dt) = 0;
+    // Returns the remaining position error. compliance is XPBD's alpha / dt^2
+    // (0 = rigid), added to the diagonal of the effective mass.
+    virtual float SolvePosition(float compliance) = 0;
+    // Velocity-level drive for the position-based solver (motors)
+    virtual void ApplyMotor(float /*dt*/) {}
+    // Total impulse of the substep, as force/torque on body B
+    virtual void StoreReaction(float invDt) = 0;
+    // Drop the accumulated impulses, i.e. the warm start of the next solve
+    virtual void ResetImpulses() = 0;
+
+    // Local anchor of a world point on a body
+    static void ToLocal(const Body* pBody, float wx, float wy, float& lx, float& ly);
+
+    JointType m_Type;
+    Body* m_pBodyA;
+    Body* m_pBodyB;
+    float m_ReactionX = 0.0f;
+    float m_ReactionY = 0.0f;
+    float m_ReactionTorque = 0.0f;
+};
+
+// Pin at a shared anchor; optional angle limits and an angular velocity motor
+class RevoluteJoint : public Joint {
+public:
+    RevoluteJoint(Body* pBodyA, Body* pBodyB, float anchorX, float anchorY);
+
+    float GetAngle() const;  // Relative angle, zero at creation
+
+    bool enable_limit = false;
+    float lower_angle = 0.0f;
+    float upper_angle = 0.0f;
+    bool enable_motor = false;
+    float motor_speed = 0.0f;       // Target relative angular velocity (rad/s)
+    float max_motor_torque = 0.0f;
+
+private:
+    void Prepare(float dt) override;
+    void SolveVelocity(float dt) override;
+    float SolvePosition(float compliance) override;
+    void ApplyMotor(float dt) override;
+    void StoreReaction(float invDt) override;
+    void ResetImpulses() override;
+
+    float m_LocalA[2], m_LocalB[2];
+    float m_ReferenceAngle;
+    float m_Impulse[2] = {0.0f, 0.0f};
+    float m_MotorImpulse = 0.0f;
+    float m_LowerImpulse = 0.0f;
+    float m_UpperImpulse = 0.0f;
+    // Per-substep cache
+    float m_Ra[2], m_Rb[2];
+    float m_AxialMass = 0.0f;
+};
+
+// Slides along an axis fixed in body A, no relative rotation; optional translation limits
+class PrismaticJoint : public Joint {
+public:
+    PrismaticJoint(Body* pBodyA, Body* pBodyB, float anchorX, float anchorY, float axisX, float axisY);
+
+    float GetTranslation() const;  // Along the axis, zero at creation
+
+    bool enable_limit = false;
+    float lower_translation = 0.0f;
+    float upper_translation = 0.0f;
+
+private:
+    void Prepare(float dt) override;
+    void SolveVelocity(float dt) override;
+    float SolvePosition(float compliance) override;
+    void StoreReaction(float invDt) override;
+    void ResetImpulses() override;
+
+    float m_LocalA[2], m_LocalB[2];
+    float m_LocalAxis[2];
+    float m_ReferenceAngle;
+    float m_Impulse[2] = {0.0f, 0.0f};  // Perpendicular, angular
+    float m_LowerImpulse = 0.0f;
+    float m_UpperImpulse = 0.0f;
+    // Per-substep cache
+    float m_Ra[2], m_Rb[2];
+    float m_Axis[2], m_Perp[2];
+    float m_A1, m_A2, m_S1, m_S2;
+    float m_AxialMass = 0.0f;
+    float m_Translation = 0.0f;
+};
+
+// Rigid attachment: no relative translation or rotation
+class WeldJoint : public Joint {
+public:
+    WeldJoint(Body* pBodyA, Body* pBodyB, float anchorX, float anchorY);
+
+private:
+    void Prepare(float dt) override;
+    void SolveVelocity(float dt) override;
+    float SolvePosition(float compliance) override;
+    void StoreReaction(float invDt) override;
+    void ResetImpulses() override;
+
+    float m_LocalA[2], m_LocalB[2];
+    float m_ReferenceAngle;
+    float m_Impulse[3] = {0.0f, 0.0f, 0.0f};
+    float m_Ra[2], m_Rb[2];
+};
+
+// Fixed distance between two anchors. As a rope it only resists stretching
+// (slack is free), which is what a slung load hangs from.
+class DistanceJoint : public Joint {
+public:
+    DistanceJoint(Body* pBodyA, Body* pBodyB, float anchorAX, float anchorAY, float anchorBX, float anchorBY,
+                  bool rope = false);
+
+    float GetCurrentLength() const;
+
+    float length;  // Defaults to the anchor distance at creation
+    bool rope;
+
+private:
+    void Prepare(float dt) override;
+    void SolveVelocity(float dt) override;
+    float SolvePosition(float compliance) override;
+    void StoreReaction(float invDt) override;
+    void ResetImpulses() override;
+
+    float m_LocalA[2], m_LocalB[2];
+    float m_Impulse = 0.0f;
+    float m_Ra[2], m_Rb[2];
+    float m_U[2];
+    float m_CurrentLength = 0.0f;
+    float m_Mass = 0.0f;
+};
+
+#endif // JOINT_H
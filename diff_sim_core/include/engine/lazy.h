@@ -0,0 +1,80 @@
+#ifndef LAZY_H
+#define LAZY_H
+
+#include "engine/tensor.h"
+#include <memory>
+#include <vector>
+
+// Elementwise op codes recorded by LazyExpr
+enum class LazyOp {
+    LEAF,
+    ADD, SUB, MUL, DIV,
+    ADD_SCALAR, MUL_SCALAR, POW,
+    EXP, LOG, SQRT, ABS, SIN, COS, TANH, CLAMP
+};
+
+struct LazyNode;
+struct LazyKernel;
+
+/**
+ * LazyExpr - Deferred elementwise expression over Tensors
+ *
+ * Elementwise ops on a LazyExpr only record a node in an expression DAG.
+ * Materialize() compiles the DAG into a flat register program (once, cached
+ * on the root) and evaluates it in a single tiled loop, producing one output
+ * Tensor with one fused backward closure. Intermediate values never hit
+ * memory as full-size Tensors, in either direction.
+ *
+ * Usage: ((a.Lazy() - mu).Pow(2) * s + b.Lazy().Exp()).Materialize()
+ *
+ * Leaves must have the output shape or be (1, 1) scalars, which broadcast.
+ * Like every other op, leaves are held by raw pointer and must outlive
+ * the materialized result's backward pass.
+ */
+class LazyExpr {
+public:
+    LazyExpr(const Tensor& leaf); // Implicit: lets Tensors mix into expressions
+
+    int Rows() const;
+    int Cols() const;
+
+    // Binary ops (same shape, or either side (1, 1))
+    LazyExpr operator+(const LazyExpr& other) const;
+    LazyExpr operator-(const LazyExpr& other) const;
+    LazyExpr operator*(const LazyExpr& other) const;
+    LazyExpr operator/(const LazyExpr& other) const;
+
+    // Scalar ops
+    LazyExpr operator+(float scalar) const;
+    LazyExpr operator-(float scalar) const;
+    LazyExpr operator*(float scalar) const;
+    LazyExpr operator-() const;
+
+    // Unary math
+    LazyExpr Pow(float exponent) const;
+    LazyExpr Exp() const;
+    LazyExpr Log() const;
+    LazyExpr Sqrt() const;
+    LazyExpr Abs() const;
+    LazyExpr Sin() const;
+    LazyExpr Cos() const;
+    LazyExpr Tanh() const;
+    LazyExpr Clamp(float minVal, float maxVal) const;
+
+    // Compile (first call only) and evaluate into a single Tensor
+    Tensor Materialize() const;
+
+    // Number of nodes in the compiled program (for inspection)
+    int NumInstructions() const;
+
+private:
+    explicit LazyExpr(std::shared_ptr<LazyNode> pNode);
+    static LazyExpr Unary(const LazyExpr& a, LazyOp op, float s0 = 0.0f, float s1 = 0.0f);
+    static LazyExpr Binary(const LazyExpr& a, const LazyExpr& b, LazyOp op);
+
+    std::shared_ptr<LazyKernel> Compile() const;
+
+    std::shared_ptr<LazyNode> m_pNode;
+};
+
+#endif // LAZY_H
@@ -0,0 +1,38 @@
+#ifndef LOSSES_H
+#define LOSSES_H
+
+#include "engine/tensor.h"
+
+// PPO hyperparameters
+struct PPOLossConfig {
+    float clipRatio = 0.2f;   // Policy ratio is clipped to [1 - clipRatio, 1 + clipRatio]
+    float valueClip = 0.2f;   // Values move at most this far from valuesOld (<= 0: no value clipping)
+    float valueCoef = 0.5f;
+    float entropyCoef = 0.0f;
+};
+
+// Diagnostics from the last PPOLoss call (batch means)
+struct PPOLossStats {
+    float policyLoss = 0.0f;
+    float valueLoss = 0.0f;
+    float entropy = 0.0f;
+    float approxKl = 0.0f;     // E[(r - 1) - log r], r = exp(logpNew - logpOld)
+    float clipFraction = 0.0f; // Share of samples whose ratio left the clip range
+};
+
+// Fused PPO objective for a batch of B samples, returned as a (1, 1) Tensor:
+//   loss = -mean(min(r A, clip(r) A))
+//        + valueCoef * 0.5 * mean(max((v - R)^2, (clip(v, vOld) - R)^2))
+//        - entropyCoef * H(logStd)
+// logpNew/logpOld/advantages/values/valuesOld/returns each hold B elements
+// (any shape). logStd is the (D, 1) state-independent or (D, B) per-sample log
+// std of the diagonal Gaussian policy; H is its mean entropy.
+// Gradients flow to logpNew, values and logStd only; the rest are targets.
+// The gradient is computed in the forward pass, so backward is one scaled add
+// per input.
+Tensor PPOLoss(const Tensor& logpNew, const Tensor& logpOld, const Tensor& advantages,
+               const Tensor& values, const Tensor& valuesOld, const Tensor& returns,
+               const Tensor& logStd, const PPOLossConfig& config = PPOLossConfig(),
+               PPOLossStats* pStats = nullptr);
+
+#endif // LOSSES_H
@@ -0,0 +1,156 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class Engine;
+class Tensor;
+
+// One Engine's share of the simulation state
+struct EngineMemoryStats {
+    int bodies = 0;
+    int colliders = 0;
+    int shapes = 0;
+    int joints = 0;
+    int manifolds = 0;          // Cached contact manifolds (warm-start history)
+    int activeManifolds = 0;    // Touched in the latest step
+    int garbageTensors = 0;     // Body::garbage_collector entries across all bodies
+    int64_t garbageBytes = 0;   // Their data + grad buffers (also counted in tensorDataBytes/tensorGradBytes)
+    int64_t rewindBytes = 0;    // Rewind history (also counted in bytes)
+    int64_t bytes = 0;          // Bodies, shapes, contact cache and sensitivity state (Tensors excluded)
+};
+
+struct MemoryStats {
+    int64_t liveTensors = 0;
+    int64_t peakTensors = 0;
+    int64_t tensorDataBytes = 0;
+    int64_t tensorGradBytes = 0;
+    int64_t peakTensorBytes = 0;        // High-water mark of data + grad
+    int64_t graphNodes = 0;             // Tensors holding a backward closure
+    int64_t peakGraphNodes = 0;
+    int64_t backwardScratchBytes = 0;   // Per-worker gradient buffers of a running parallel backward
+    int64_t peakBackwardScratchBytes = 0;
+    std::vector<EngineMemoryStats> engines;
+    int64_t residentBytes = 0;          // Process RSS / working set (0 where unsupported)
+    int64_t peakResidentBytes = 0;
+};
+
+/**
+ * MemoryTracker - Process-wide live memory counters
+ *
+ * Tensor counts, buffer bytes and graph nodes are kept in relaxed atomics
+ * updated where Tensors allocate (the same places the profiler counts
+ * allocations), so Snapshot() only reads them. Engines register themselves
+ * and are walked on Snapshot(); call it between steps, not while another
+ * thread is stepping an engine.
+ */
+class MemoryTracker {
+public:
+    static MemoryStats Snapshot();
+    // Restart every high-water mark from the current values
+    static void ResetPeaks();
+
+    static void AddTensors(int64_t count);
+    static void AddTensorBytes(int64_t dataBytes, int64_t gradBytes);
+    static void AddGraphNodes(int64_t count);
+    static void AddBackwardScratchBytes(int64_t bytes);
+
+    static void RegisterEngine(const Engine* pEngine);
+    static void UnregisterEngine(const Engine* pEngine);
+};
+
+// Tensor member: counts its owner as live and remembers the buffer bytes
+// last reported for it, so copies, moves and destruction stay balanced.
+class TensorMemoryStamp {
+public:
+    TensorMemoryStamp() { MemoryTracker::AddTensors(1); }
+    TensorMemoryStamp(const TensorMemoryStamp& other)
+        : m_DataBytes(other.m_DataBytes), m_GradBytes(other.m_GradBytes) {
+        MemoryTracker::AddTensors(1);
+        MemoryTracker::AddTensorBytes(m_DataBytes, m_GradBytes);
+    }
+    TensorMemoryStamp(TensorMemoryStamp&& other) noexcept
+        : m_DataBytes(other.m_DataBytes), m_GradBytes(other.m_GradBytes) {
+        // Eigen leaves moved-from matrices empty
+        MemoryTracker::AddTensors(1);
+        other.m_DataBytes = 0;
+        other.m_GradBytes = 0;
+    }
+    TensorMemoryStamp& operator=(const TensorMemoryStamp& other) {
+        Update(other.m_DataBytes, other.m_GradBytes);
+        return *this;
+    }
+    TensorMemoryStamp& operator=(TensorMemoryStamp&& other) noexcept {
+        // Eigen move-assignment swaps the buffers
+        std::swap(m_DataBytes, other.m_DataBytes);
+        std::swap(m_GradBytes, other.m_GradBytes);
+        return *this;
+    }
+    ~TensorMemoryStamp() {
+        MemoryTracker::AddTensors(-1);
+        MemoryTracker::AddTensorBytes(-m_DataBytes, -m_GradBytes);
+    }
+
+    void Update(int64_t dataBytes, int64_t gradBytes) {
+        if (dataBytes == m_DataBytes && gradBytes == m_GradBytes) return;
+        MemoryTracker::AddTensorBytes(dataBytes - m_DataBytes, gradBytes - m_GradBytes);
+        m_DataBytes = dataBytes;
+        m_GradBytes = gradBytes;
+    }
+
+private:
+    int64_t m_DataBytes = 0;
+    int64_t m_GradBytes = 0;
+};
+
+// std::function for a node's backward pass that counts itself as a live graph node while set
+class BackwardClosure {
+public:
+    BackwardClosure() = default;
+    BackwardClosure(const BackwardClosure& other) : m_Fn(other.m_Fn) { Count(); }
+    BackwardClosure(BackwardClosure&& other) noexcept
+        : m_Fn(std::move(other.m_Fn)), m_bCounted(other.m_bCounted) {
+        other.m_Fn = nullptr;
+        other.m_bCounted = false;
+    }
+    BackwardClosure& operator=(const BackwardClosure& other) {
+        m_Fn = other.m_Fn;
+        Count();
+        return *this;
+    }
+    BackwardClosure& operator=(BackwardClosure&& other) noexcept {
+        std::swap(m_Fn, other.m_Fn);
+        std::swap(m_bCounted, other.m_bCounted);
+        return *this;
+    }
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, BackwardClosure>::value>::type>
+    BackwardClosure& operator=(F&& fn) {
+        m_Fn = std::forward<F>(fn);
+        Count();
+        return *this;
+    }
+    ~BackwardClosure() {
+        if (m_bCounted) MemoryTracker::AddGraphNodes(-1);
+    }
+
+    explicit operator bool() const { return (bool)m_Fn; }
+    void operator()(Tensor& node) const { m_Fn(node); }
+
+private:
+    void Count() {
+        bool bSet = (bool)m_Fn;
+        if (bSet != m_bCounted) MemoryTracker::AddGraphNodes(bSet ? 1 : -1);
+        m_bCounted = bSet;
+    }
+
+    std::function<void(Tensor&)> m_Fn;
+    bool m_bCounted = false;
+};
+
+#endif // MEMORY_STATS_H
@@ -1,7 +1,9 @@
 #ifndef MOTOR_H
 #define MOTOR_H
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -22,6 +24,7 @@ public:
     
     // Thrust properties
     float thrust = 0;        // Current thrust (0 to max_thrust)
+    float command = 0;       // Latest SetThrust() value; equals thrust without a delay
     float max_thrust = 10.0f;
     float angle = M_PI / 2;  // Thrust direction (default: up)
     
@@ -37,9 +40,44 @@ public:
     Motor(float lx, float ly, float w, float h, float m, float maxT)
         : local_x(lx), local_y(ly), width(w), height(h), mass(m), max_thrust(maxT) {}
     
-    // Set thrust (clamped to 0..max_thrust)
+    // Set thrust (clamped to 0..max_thrust); with a delay this is only the command
     void SetThrust(float t) {
-        thrust = std::max(0.0f, std::min(t, max_thrust));
+        command = std::max(0.0f, std::min(t, max_thrust));
+        if (m_Pending.empty()) thrust = command;
+    }
+    
+    // Actuator latency: commands reach `thrust` this many substeps after
+    // SetThrust(). Pending commands are replaced by the current thrust.
+    void SetDelay(int substeps) {
+        m_Pending.assign(std::max(substeps, 0), thrust);
+        m_Head = 0;
+        command = thrust;
+    }
+    int GetDelay() const { return (int)m_Pending.size(); }
+    
+    // Drop pending commands and hold t (e.g. on reset); keeps the delay
+    void ResetThrust(float t = 0.0f) {
+        thrust = command = t;
+        std::fill(m_Pending.begin(), m_Pending.end(), t);
+    }
+    
+    // One substep of the delay line (Body::ApplyMotorForces calls this)
+    void AdvanceDelay() {
+        if (m_Pending.empty()) return;
+        thrust = m_Pending[m_Head];
+        m_Pending[m_Head] = command;
+        m_Head = m_Head + 1 == (int)m_Pending.size() ? 0 : m_Head + 1;
+    }
+    
+    // Commands in flight, oldest first (GetDelay() values; e.g. for a rewind snapshot)
+    void SavePending(float* pOut) const {
+        for (int i = 0; i < (int)m_Pending.size(); ++i) {
+            pOut[i] = m_Pending[(m_Head + i) % m_Pending.size()];
+        }
+    }
+    void LoadPending(const float* pIn) {
+        std::copy(pIn, pIn + m_Pending.size(), m_Pending.begin());
+        m_Head = 0;
     }
     
     // Check if this motor overlaps with another (in local body space)
@@ -52,6 +90,10 @@ public:
         
         return !(right1 < left2 || right2 < left1 || top1 < bottom2 || top2 < bottom1);
     }
+
+private:
+    std::vector<float> m_Pending;  // Commands in flight, oldest at m_Head
+    int m_Head = 0;
 };
 
 #endif // MOTOR_H
@@ -0,0 +1,48 @@
+#ifndef OBSERVATION_HISTORY_H
+#define OBSERVATION_HISTORY_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * ObservationHistory - Last k observations of N worlds stepped in lockstep (frame stacking)
+ *
+ * Each world owns a ring of 2k slots and every frame is written twice, at
+ * slot i and i + k, so its last k frames are always one contiguous run of
+ * k * obsSize floats starting at the same slot for every world. A stacked
+ * batch is therefore a strided (N, k, obsSize) view of the storage, oldest
+ * frame first, and stacking costs one small write per world per step.
+ *
+ * Advance() moves every ring on by one slot (once per step, before the
+ * worlds write); Clear() zeroes one world's history without touching the
+ * others. Data() moves with Advance(), so take a fresh view after each step.
+ */
+class ObservationHistory {
+public:
+    ObservationHistory(int numWorlds, int length, int obsSize);
+
+    int NumWorlds() const { return m_NumWorlds; }
+    int Length() const { return m_Length; }
+    int ObservationSize() const { return m_ObsSize; }
+
+    void Advance();
+    // Newest frame of one world (obsSize floats); safe to call for different worlds in parallel
+    void Write(int world, const float* pObs);
+    void Clear(int world);
+    void ClearAll();
+
+    // Oldest frame of world 0's window; world w starts WorldStride() floats further
+    const float* Data() const { return m_Storage.data() + (int64_t)m_Start * m_ObsSize; }
+    int64_t WorldStride() const { return (int64_t)2 * m_Length * m_ObsSize; }
+    // Frame j (0 = oldest) of a world
+    const float* Frame(int world, int j) const { return Data() + world * WorldStride() + (int64_t)j * m_ObsSize; }
+
+private:
+    int m_NumWorlds;
+    int m_Length;
+    int m_ObsSize;
+    int m_Start = 1;  // Window is slots [m_Start, m_Start + k); the newest frame is slot m_Start + k - 1
+    std::vector<float> m_Storage;
+};
+
+#endif // OBSERVATION_HISTORY_H
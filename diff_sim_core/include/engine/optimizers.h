@@ -1,9 +1,14 @@
 #ifndef OPTIMIZERS_H
 #define OPTIMIZERS_H
 
+#include <functional>
+#include <string>
 #include <vector>
 #include "engine/tensor.h"
 
+class Checkpoint;
+class CheckpointWriter;
+
 class Optimizer {
 public:
     Optimizer(std::vector<Tensor*> params, float lr);
@@ -11,6 +16,13 @@ public:
     virtual void Step() = 0;
     virtual void ZeroGrad();
 
+    float GetLearningRate() const { return m_LearningRate; }
+    void SetLearningRate(float lr) { m_LearningRate = lr; }
+
+    // Internal state as "<prefix>/..." entries (the parameters themselves are saved separately)
+    virtual void SaveState(CheckpointWriter& writer, const std::string& prefix) const;
+    virtual void LoadState(const Checkpoint& checkpoint, const std::string& prefix);
+
 protected:
     std::vector<Tensor*> m_Parameters;
     float m_LearningRate;
@@ -28,6 +40,8 @@ class Adam : public Optimizer {
 public:
     Adam(std::vector<Tensor*> params, float lr = 0.001, float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1e-8);
     virtual void Step() override;
+    virtual void SaveState(CheckpointWriter& writer, const std::string& prefix) const override;
+    virtual void LoadState(const Checkpoint& checkpoint, const std::string& prefix) override;
 
 private:
     float m_Beta1;
@@ -43,6 +57,8 @@ class AdamW : public Optimizer {
 public:
     AdamW(std::vector<Tensor*> params, float lr = 0.001, float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1e-8, float weightDecay = 0.0);
     virtual void Step() override;
+    virtual void SaveState(CheckpointWriter& writer, const std::string& prefix) const override;
+    virtual void LoadState(const Checkpoint& checkpoint, const std::string& prefix) override;
 
 private:
     float m_Beta1;
@@ -55,4 +71,122 @@ private:
 };
 
 
+/**
+ * LBFGS - Limited-memory BFGS over all parameters flattened into one vector
+ *
+ * Meant for smooth, deterministic objectives such as trajectory optimization
+ * or system identification through the engine, where it typically converges
+ * in tens of iterations. Each Step() runs up to maxIter quasi-Newton
+ * iterations; the curvature history carries over between calls.
+ *
+ * The closure must rebuild the graph from the current parameter values,
+ * call Backward() on the loss and return the loss value. Gradients are
+ * zeroed before each call. With the strong-Wolfe line search a single
+ * iteration may evaluate the closure several times.
+ */
+class LBFGS : public Optimizer {
+public:
+    LBFGS(std::vector<Tensor*> params, float lr = 1.0f, int maxIter = 20, int maxEval = -1,
+          float toleranceGrad = 1e-7f, float toleranceChange = 1e-9f, int historySize = 10,
+          bool bStrongWolfe = true);
+
+    // Returns the loss at the start of the step
+    float Step(const std::function<float()>& closure);
+    virtual void Step() override; // Throws: LBFGS needs a closure
+
+    int NumEvaluations() const { return m_NumEvals; } // Closure calls so far
+    void ResetHistory();
+
+private:
+    int NumElements() const;
+    Eigen::VectorXd GatherParams() const;
+    Eigen::VectorXd GatherGrad() const;
+    void ScatterParams(const Eigen::VectorXd& x);
+    double Evaluate(const std::function<float()>& closure, Eigen::VectorXd& grad);
+    double StrongWolfe(const std::function<float()>& closure, const Eigen::VectorXd& x, double& t,
+                       const Eigen::VectorXd& d, double f, const Eigen::VectorXd& g, double gtd,
+                       Eigen::VectorXd& gNew);
+
+    int m_MaxIter;
+    int m_MaxEval;
+    double m_ToleranceGrad;
+    double m_ToleranceChange;
+    int m_HistorySize;
+    bool m_bStrongWolfe;
+
+    std::vector<Eigen::VectorXd> m_S;   // Parameter steps, oldest first
+    std::vector<Eigen::VectorXd> m_Y;   // Gradient changes
+    std::vector<double> m_Rho;          // 1 / (y . s)
+    int m_NumEvals = 0;
+    int m_NumIters = 0;
+};
+
+
+// ---------------- Learning-rate schedules ----------------
+
+/**
+ * LRScheduler - Drives an optimizer's learning rate from a step counter
+ *
+ * The schedule is a function of the step count and the learning rate the
+ * optimizer had when the scheduler was attached. Call Step() once per
+ * optimizer step (or per epoch, as the schedule is defined).
+ */
+class LRScheduler {
+public:
+    explicit LRScheduler(Optimizer& optimizer);
+    virtual ~LRScheduler();
+
+    void Step();
+    int GetStep() const { return m_Step; }
+    float GetBaseLearningRate() const { return m_BaseLearningRate; }
+    float GetLearningRate() const { return m_Optimizer.GetLearningRate(); }
+
+    // Learning rate for a given step count
+    virtual float LearningRateAt(int step) const = 0;
+
+protected:
+    Optimizer& m_Optimizer;
+    float m_BaseLearningRate;
+    int m_Step = 0;
+};
+
+// Cosine decay from the base rate to minLr over totalSteps, then held at minLr
+class CosineAnnealingLR : public LRScheduler {
+public:
+    CosineAnnealingLR(Optimizer& optimizer, int totalSteps, float minLr = 0.0f);
+    virtual float LearningRateAt(int step) const override;
+
+private:
+    int m_TotalSteps;
+    float m_MinLearningRate;
+};
+
+// Linear ramp from startFactor * base to base over warmupSteps. After the
+// warmup, hands over to 'pAfter' (offset so its step 0 is the end of the
+// warmup) or holds the base rate. Create pAfter first, on the same optimizer,
+// and only Step() the warmup scheduler.
+class LinearWarmupLR : public LRScheduler {
+public:
+    LinearWarmupLR(Optimizer& optimizer, int warmupSteps, float startFactor = 0.0f,
+                   LRScheduler* pAfter = nullptr);
+    virtual float LearningRateAt(int step) const override;
+
+private:
+    int m_WarmupSteps;
+    float m_StartFactor;
+    LRScheduler* m_pAfter;
+};
+
+// Multiply the base rate by gamma every stepSize steps
+class StepLR : public LRScheduler {
+public:
+    StepLR(Optimizer& optimizer, int stepSize, float gamma = 0.1f);
+    virtual float LearningRateAt(int step) const override;
+
+private:
+    int m_StepSize;
+    float m_Gamma;
+};
+
+
 #endif // OPTIMIZERS_H
\ No newline at end of file
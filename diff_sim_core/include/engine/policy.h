@@ -0,0 +1,92 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "engine/tensor.h"
+#include <Eigen/Dense>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * MLP - Fully connected network with tanh hidden layers and a linear output
+ *
+ * Batches are column-per-sample: (in, B) -> (out, B). Forward() builds an
+ * autograd graph whose intermediates live in the caller's tape (they must
+ * outlive Backward()); Evaluate() is a plain Eigen pass for rollouts and
+ * deployment that allocates no Tensors.
+ */
+class MLP {
+public:
+    // layerSizes = {in, hidden..., out}. Weights ~ N(0, 1/fan_in), the last
+    // layer scaled by outputScale; biases start at zero.
+    MLP(const std::vector<int>& layerSizes, std::mt19937& rng, float outputScale = 1.0f);
+
+    Tensor& Forward(const Tensor& input, std::list<Tensor>& tape);
+    Eigen::MatrixXf Evaluate(const Eigen::MatrixXf& input) const;
+
+    std::vector<Tensor*> Parameters();
+    const std::vector<int>& LayerSizes() const { return m_LayerSizes; }
+    int NumLayers() const { return (int)m_Weights.size(); }
+    Tensor& Weight(int layer) { return m_Weights[layer]; } // (out, in)
+    Tensor& Bias(int layer) { return m_Biases[layer]; }    // (out, 1)
+    const Tensor& Weight(int layer) const { return m_Weights[layer]; }
+    const Tensor& Bias(int layer) const { return m_Biases[layer]; }
+
+private:
+    std::vector<int> m_LayerSizes;
+    std::vector<Tensor> m_Weights;
+    std::vector<Tensor> m_Biases;
+};
+
+/**
+ * GaussianPolicy - Actor-critic for continuous control
+ *
+ * The actor MLP gives the action mean, a state-independent log std gives the
+ * spread, and a separate critic MLP gives the state value. Actions live in
+ * the normalized [-1, 1] range the environments expect (sampling itself is
+ * unbounded; environments clip).
+ *
+ * Save()/Load() use a small little-endian binary format:
+ *   "RLPL" | u32 version | i32 obsSize, actionSize, numHidden | i32 hidden[numHidden]
+ *   | actor (W, b per layer, column-major f32) | critic (same) | logStd f32[actionSize]
+ */
+class GaussianPolicy {
+public:
+    GaussianPolicy(int obsSize, int actionSize, const std::vector<int>& hiddenSizes,
+                   unsigned int seed = 0, float initLogStd = 0.0f);
+
+    int ObservationSize() const { return m_ObsSize; }
+    int ActionSize() const { return m_ActionSize; }
+    const std::vector<int>& HiddenSizes() const { return m_HiddenSizes; }
+
+    MLP& Actor() { return m_Actor; }
+    MLP& Critic() { return m_Critic; }
+    const MLP& Actor() const { return m_Actor; }
+    const MLP& Critic() const { return m_Critic; }
+    Tensor& LogStd() { return m_LogStd; } // (actionSize, 1)
+    const Tensor& LogStd() const { return m_LogStd; }
+    std::vector<Tensor*> Parameters();
+
+    // Inference on (obsSize, B) observations, no graph built
+    Eigen::MatrixXf Mean(const Eigen::MatrixXf& obs) const;   // (actionSize, B)
+    Eigen::VectorXf Value(const Eigen::MatrixXf& obs) const;  // (B)
+
+    // Sample actions and report their log probabilities and the state values
+    void Sample(const Eigen::MatrixXf& obs, std::mt19937& rng, Eigen::MatrixXf& actions,
+                Eigen::VectorXf& logProbs, Eigen::VectorXf& values) const;
+
+    void Save(const std::string& path) const;
+    static GaussianPolicy Load(const std::string& path);
+
+private:
+    int m_ObsSize;
+    int m_ActionSize;
+    std::vector<int> m_HiddenSizes;
+    std::mt19937 m_InitRng; // Declared before the networks: it seeds them
+    MLP m_Actor;
+    MLP m_Critic;
+    Tensor m_LogStd;
+};
+
+#endif // POLICY_H
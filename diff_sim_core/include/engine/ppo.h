@@ -0,0 +1,100 @@
+#ifndef PPO_H
+#define PPO_H
+
+#include "engine/drone_task.h"
+#include "engine/losses.h"
+#include "engine/optimizers.h"
+#include "engine/policy.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct PPOConfig {
+    int numEnvs = 8;
+    int stepsPerEnv = 256;       // Rollout length; batch = numEnvs * stepsPerEnv
+    int epochs = 10;
+    int minibatchSize = 256;
+    float learningRate = 3e-4f;
+    float gamma = 0.99f;
+    float gaeLambda = 0.95f;
+    float maxGradNorm = 0.5f;    // <= 0: no clipping
+    bool normalizeAdvantages = true;
+    PPOLossConfig loss;
+    std::vector<int> hiddenSizes = {64, 64};
+    float initLogStd = -0.5f;
+    unsigned int seed = 0;
+};
+
+// Summary of one Iterate() call
+struct PPOIterationStats {
+    int iteration = 0;
+    int64_t totalSteps = 0;
+    int episodesFinished = 0;
+    float meanEpisodeReturn = 0.0f;  // 0 when no episode finished
+    float meanEpisodeLength = 0.0f;
+    float policyLoss = 0.0f;         // Means over every minibatch update
+    float valueLoss = 0.0f;
+    float entropy = 0.0f;
+    float approxKl = 0.0f;
+    float clipFraction = 0.0f;
+    double rolloutMs = 0.0;
+    double updateMs = 0.0;
+};
+
+/**
+ * PPOTrainer - Proximal Policy Optimization entirely in C++
+ *
+ * Each Iterate() collects stepsPerEnv steps from a DroneVecEnv (worlds
+ * stepped in parallel, policy evaluated in batch with plain Eigen), computes
+ * GAE(lambda) advantages, then runs 'epochs' passes of shuffled minibatch
+ * updates through the autograd graph with the fused PPOLoss and Adam.
+ * Time-limit truncations bootstrap from the critic's value of the final
+ * observation instead of being treated as terminal.
+ */
+class PPOTrainer {
+public:
+    PPOTrainer(const DroneTaskConfig& task, const PPOConfig& config);
+
+    PPOIterationStats Iterate();
+    // Iterate until at least totalSteps environment steps have been taken
+    std::vector<PPOIterationStats> Train(int64_t totalSteps);
+
+    GaussianPolicy& Policy() { return m_Policy; }
+    DroneVecEnv& Env() { return m_Env; }
+    const PPOConfig& Config() const { return m_Config; }
+    int64_t TotalSteps() const { return m_TotalSteps; }
+
+    // Policy weights, Adam moments, sampling RNG and step counters (see checkpoint.h).
+    // Environments are not saved; a loaded trainer resumes from fresh resets.
+    void SaveCheckpoint(const std::string& path);
+    void LoadCheckpoint(const std::string& path);
+
+private:
+    void CollectRollout(PPOIterationStats& stats);
+    void ComputeAdvantages();
+    void Update(PPOIterationStats& stats);
+    void ClipGradNorm();
+
+    PPOConfig m_Config;
+    DroneVecEnv m_Env;
+    GaussianPolicy m_Policy;
+    std::unique_ptr<Adam> m_pOptimizer;
+    std::mt19937 m_Rng;
+
+    int m_Iteration = 0;
+    int64_t m_TotalSteps = 0;
+
+    // Rollout buffers, column k = t * numEnvs + env
+    Eigen::MatrixXf m_Obs;         // (obsSize, T*N)
+    Eigen::MatrixXf m_Actions;     // (actionSize, T*N)
+    Eigen::VectorXf m_LogProbs;
+    Eigen::VectorXf m_Values;
+    Eigen::VectorXf m_Rewards;
+    Eigen::VectorXf m_Dones;       // 1 where the episode ended after this step
+    Eigen::VectorXf m_Advantages;
+    Eigen::VectorXf m_Returns;
+    Eigen::VectorXf m_LastValues;  // (N) bootstrap values after the final step
+};
+
+#endif // PPO_H
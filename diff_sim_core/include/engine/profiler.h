@@ -0,0 +1,91 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Aggregated numbers for one op type
+struct OpStats {
+    std::string name;
+    int64_t forwardCount = 0;
+    int64_t backwardCount = 0;
+    double forwardMs = 0.0;
+    double backwardMs = 0.0;
+    int64_t bytesAllocated = 0;                      // Tensor data + grad buffers created by the op
+    std::map<std::pair<int, int>, int64_t> shapes;   // Output shape -> count
+
+    double TotalMs() const { return forwardMs + backwardMs; }
+};
+
+/**
+ * Profiler - Opt-in per-op timing for the autograd engine
+ *
+ * While enabled, every Tensor op records its forward wall time, the bytes
+ * of Tensor storage it allocated and its output shape; Backward() records
+ * the time of each node's closure under the op that created it. When
+ * disabled, an op pays one relaxed atomic load.
+ *
+ * Forward times are for the outermost op only: Transpose reports as
+ * Transpose, not as the View it is built on.
+ */
+class Profiler {
+public:
+    static bool IsEnabled() { return s_bEnabled.load(std::memory_order_relaxed); }
+    static void Enable();
+    static void Disable();
+    static void Reset();
+
+    // Keep individual events for DumpTrace (off by default: aggregates only)
+    static void SetTraceEnabled(bool bEnabled);
+
+    static void RecordForward(const char* opName, int64_t startNs, int64_t durationNs,
+                              int rows, int cols, int64_t bytes);
+    static void RecordBackward(const char* opName, int64_t startNs, int64_t durationNs);
+
+    // Stats sorted by descending total (forward + backward) time
+    static std::vector<OpStats> GetStats();
+    static std::string Table(int maxRows = 0);
+
+    // Chrome trace format (chrome://tracing, Perfetto)
+    static void DumpTrace(const std::string& path);
+
+    static int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static std::atomic<bool> s_bEnabled;
+};
+
+/**
+ * ProfileScope - RAII forward timer placed at the top of each op
+ *
+ * Tensors allocated while the scope is active add to its byte count; the
+ * first one is taken to be the op's output.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* opName);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    // Called by Tensor when it allocates storage
+    static void CountAllocation(int rows, int cols, int64_t bytes);
+
+private:
+    const char* m_pOpName = nullptr; // nullptr: inactive (profiler off, or nested)
+    int64_t m_StartNs = 0;
+    int64_t m_Bytes = 0;
+    int m_Rows = -1;
+    int m_Cols = -1;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,75 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * RewindBuffer - Last T states of one world, delta-compressed in memory
+ *
+ * States are flat float vectors of a fixed size. Every keyframeInterval-th
+ * frame (clamped to T) is stored raw. In between, each 32-bit word is XORed
+ * with a prediction and its zero high bytes are dropped (a 2-bit byte count
+ * per word: 0, 2, 3 or 4). The prediction is per word, whichever leaves
+ * fewer bytes: linear extrapolation 2 * x[t-1] - x[t-2] on the bit patterns,
+ * exact for constant words and close for moving floats, or the previous word
+ * of the same frame, which catches runs such as a motor's commands in
+ * flight. A delta that would not be smaller than the frame is stored raw,
+ * so no frame costs more than a snapshot plus its one-byte header.
+ *
+ * Measured with T = 256, k = 16 against Steps() + 1 snapshots (RawBytes()),
+ * a drone takes about 75% resting and 80% flying, and about 25-30% with a
+ * 36-substep motor delay. Short windows of small states are the exception:
+ * the two reference frames and the keyframes alone can outweigh them.
+ *
+ * Frames are grouped in segments of one keyframe plus its deltas, kept in a
+ * ring of reused buffers just large enough to span T + 1 frames. A segment
+ * reserves what the previous one encoded and grows only when a frame does
+ * not fit, so Bytes() follows the encoded data, stays under MaxBytes() and
+ * once the ring has filled rarely allocates. Rewind() decodes at most one
+ * keyframe and k - 1 deltas, and drops the frames after its target so
+ * recording continues from there.
+ */
+class RewindBuffer {
+public:
+    RewindBuffer(int steps, int keyframeInterval);
+
+    int Steps() const { return m_Steps; }
+    int KeyframeInterval() const { return m_Interval; }
+    int StateSize() const { return m_StateSize; }
+
+    // Append the newest state; a state of another size restarts the history
+    void Record(const std::vector<float>& state);
+    void Clear();
+
+    // Frames that can be rewound over (at most Steps())
+    int Available() const { return m_Newest < 0 ? 0 : m_Newest - m_Oldest; }
+    // Decode the state `steps` frames back into state; later frames are dropped
+    void Rewind(int steps, std::vector<float>& state);
+
+    int64_t Bytes() const;      // Allocated now
+    int64_t MaxBytes() const;   // Bound for the current state size
+    int64_t RawBytes() const;   // A ring of Steps() + 1 full snapshots
+
+private:
+    struct Segment {
+        std::vector<uint8_t> data;  // Keyframe, then its deltas in order
+    };
+
+    // Decode a frame into m_Last (and the one before into m_Before); returns
+    // where its encoding ends in the segment
+    size_t Decode(int64_t frame);
+    int64_t SegmentBytes() const;   // Worst case of a full segment
+
+    int m_Steps;
+    int m_Interval;
+    int m_StateSize = 0;
+    int64_t m_Newest = -1;   // Frame ids count up from the last Clear()
+    int64_t m_Oldest = 0;
+    std::vector<Segment> m_Segments;
+    std::vector<uint32_t> m_Last;     // Newest frame and the one before it,
+    std::vector<uint32_t> m_Before;   // the references of the next delta
+};
+
+#endif // REWIND_H
@@ -0,0 +1,95 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <Eigen/Dense>
+#include <deque>
+#include <random>
+#include <vector>
+
+class Body;
+
+// Noise model of one body's IMU and position fixes. Std devs are per sample;
+// random walks are per sqrt(second); a resolution of 0 disables quantization.
+struct SensorConfig {
+    // Accelerometer: specific force in the body frame (m/s^2)
+    float accelNoise = 0.0f;
+    float accelBias = 0.0f;         // Std dev of the bias drawn on every reset
+    float accelBiasWalk = 0.0f;
+    float accelResolution = 0.0f;
+    // Gyro: angular rate (rad/s)
+    float gyroNoise = 0.0f;
+    float gyroBias = 0.0f;
+    float gyroBiasWalk = 0.0f;
+    float gyroResolution = 0.0f;
+    // Position fixes in the world frame (m)
+    float positionNoise = 0.0f;
+    float positionRate = 0.0f;      // Fixes per second; 0 = one per step
+    float positionDelay = 0.0f;     // Latency before a fix is reported (s)
+};
+
+/**
+ * SensorSuite - Simulated IMUs and delayed position fixes, sampled by Engine::Update
+ *
+ * Each sensor rides on a body. The accelerometer reads the specific force
+ * (a - g) rotated into the body frame, where a is the body's mean
+ * acceleration over the step: the velocity change the integrator produced,
+ * contacts and joints included. The gyro reads the mean angular rate.
+ * Position fixes are measured at positionRate and reported positionDelay
+ * seconds later; FIX_AGE is the time since the reported fix was measured
+ * (-1 until the first one arrives).
+ *
+ * Readings are column-per-sensor (ROWS, N) in one buffer that is
+ * overwritten every step. All noise comes from the suite's own RNG, so each
+ * engine (world) is reproducible from its seed alone.
+ */
+class SensorSuite {
+public:
+    enum Row { ACCEL_X, ACCEL_Y, GYRO, FIX_X, FIX_Y, FIX_AGE, ROWS };
+
+    explicit SensorSuite(unsigned int seed = 0);
+
+    // Returns the sensor's column in Readings()
+    int Add(Body* pBody, const SensorConfig& config);
+    void Clear();
+    int Count() const { return (int)m_Sensors.size(); }
+
+    // New biases, pending fixes dropped and the clock restarted (call on episode reset)
+    void Reset();
+    void Seed(unsigned int seed);
+
+    const Eigen::MatrixXf& Readings() const { return m_Readings; }
+
+    // Engine hooks around one Update()
+    void BeginStep();
+    void EndStep(float dt, float gravityX, float gravityY);
+
+private:
+    struct Fix {
+        double time;
+        float x, y;
+    };
+
+    struct Sensor {
+        Body* pBody;
+        SensorConfig config;
+        float accelBias[2] = {0.0f, 0.0f};
+        float gyroBias = 0.0f;
+        float startVel[2] = {0.0f, 0.0f};
+        float startAngle = 0.0f;
+        double nextFixTime = 0.0;
+        std::deque<Fix> pending;
+        Fix reported = {0.0, 0.0f, 0.0f};
+        bool bHasFix = false;
+    };
+
+    float Gaussian(float stdDev);
+    void ResetSensor(int index);
+
+    std::vector<Sensor> m_Sensors;
+    std::mt19937 m_Rng;
+    std::normal_distribution<float> m_Normal{0.0f, 1.0f};
+    double m_Time = 0.0;  // Since the last Reset()
+    Eigen::MatrixXf m_Readings;
+};
+
+#endif // SENSORS_H
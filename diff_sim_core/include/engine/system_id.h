@@ -0,0 +1,105 @@
+#ifndef SYSTEM_ID_H
+#define SYSTEM_ID_H
+
+#include "engine/drone_task.h"
+#include "engine/engine.h"
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+
+// One physical parameter to fit (motorIndex only for the MOTOR_* kinds)
+struct SysIdParameter {
+    SensitivityParam kind = SensitivityParam::MASS;
+    int motorIndex = -1;
+};
+
+// Robust penalties on each weighted state residual r (scale c = lossScale):
+//   SQUARED: r^2    HUBER: r^2 inside c, 2c|r| - c^2 outside    CAUCHY: c^2 log(1 + r^2 / c^2)
+enum class RobustLoss {
+    SQUARED,
+    HUBER,
+    CAUCHY
+};
+
+struct SysIdConfig {
+    int maxIterations = 30;
+    float tolerance = 1e-6f;        // Stop once the relative cost decrease drops below this
+    float initialDamping = 1e-3f;   // Levenberg-Marquardt lambda (scales diag of J^T W J)
+    RobustLoss loss = RobustLoss::SQUARED;
+    float lossScale = 1.0f;
+    Eigen::VectorXf stateWeights = Eigen::VectorXf::Ones(6);  // Residual = weight * (sim - logged)
+};
+
+// A logged flight: commands are throttles in [0, 1] (thrust = throttle * max_thrust)
+struct SysIdSegment {
+    Eigen::VectorXf initialState;  // [x, y, theta, vx, vy, omega]
+    Eigen::MatrixXf commands;      // (M, T), applied for one control step each
+    Eigen::MatrixXf states;        // (6, T) logged state after each step
+};
+
+struct SysIdResult {
+    Eigen::VectorXf parameters;
+    std::vector<float> costHistory;  // Initial cost, then one entry per accepted step
+    float cost = 0.0f;
+    int iterations = 0;
+    bool bConverged = false;
+};
+
+/**
+ * SystemIdentifier - Fits body and motor parameters to logged flight segments
+ *
+ * Every segment is replayed from its logged initial state through the same
+ * world as DroneVecEnv (ground collider included) with the parameters under
+ * fit registered as forward-mode sensitivity parameters, so one replay yields
+ * both the residuals and their Jacobian. Segments are spread over one world
+ * per pool thread and the normal equations reduced per thread; the step is
+ * Levenberg-Marquardt with IRLS weights for the robust losses.
+ *
+ * The fitted values are left in place, so Evaluate()/Replay() use them.
+ */
+class SystemIdentifier {
+public:
+    SystemIdentifier(const DroneTaskConfig& model, const std::vector<SysIdParameter>& parameters,
+                     const SysIdConfig& config = SysIdConfig());
+    ~SystemIdentifier();
+
+    SystemIdentifier(const SystemIdentifier&) = delete;
+    SystemIdentifier& operator=(const SystemIdentifier&) = delete;
+
+    void AddSegment(const SysIdSegment& segment);
+    void ClearSegments() { m_Segments.clear(); }
+    int NumSegments() const { return (int)m_Segments.size(); }
+    int NumParameters() const { return (int)m_Parameters.size(); }
+    SysIdConfig& Config() { return m_Config; }
+
+    // Current values, in the order the parameters were given (mass is the total incl. motors)
+    Eigen::VectorXf GetParameters() const;
+    void SetParameters(const Eigen::VectorXf& values);
+
+    // Robust cost 0.5 * sum(rho(r)) over every segment at the current parameters
+    float Evaluate();
+    // Simulated (6, T) states of one segment at the current parameters
+    Eigen::MatrixXf Replay(int segmentIndex);
+
+    // Levenberg-Marquardt from the current parameters
+    SysIdResult Fit();
+
+private:
+    struct World;
+    struct Accumulator;
+
+    void ApplyParameters(World& world, const Eigen::VectorXd& values) const;
+    void ReplaySegment(World& world, const SysIdSegment& segment, bool bJacobian,
+                       Accumulator& acc, Eigen::MatrixXf* pStates) const;
+    double Accumulate(const Eigen::VectorXd& values, bool bJacobian,
+                      Eigen::MatrixXd* pHessian, Eigen::VectorXd* pGradient);
+
+    DroneTaskConfig m_Model;
+    std::vector<SysIdParameter> m_Parameters;
+    SysIdConfig m_Config;
+    Eigen::VectorXd m_Values;
+    std::vector<SysIdSegment> m_Segments;
+    std::vector<std::unique_ptr<World>> m_Worlds;  // One per pool thread
+};
+
+#endif // SYSTEM_ID_H
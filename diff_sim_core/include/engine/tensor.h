@@ -5,13 +5,35 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <initializer_list>
+#include <utility>
+#include "engine/memory_stats.h"
+
+class LazyExpr;
+struct PPOLossConfig;
+struct PPOLossStats;
+struct BatchedBodyModel;
 
 class Tensor {
     friend class SGD;
     friend class Adam;
     friend class AdamW;
+    friend class LBFGS;
+    friend class LazyExpr;
     friend Tensor relu(const Tensor& input);
     friend Tensor tanh(const Tensor& input);
+    friend Tensor sigmoid(const Tensor& input);
+    friend Tensor softplus(const Tensor& input);
+    friend Tensor elu(const Tensor& input, float alpha);
+    friend Tensor gelu(const Tensor& input);
+    friend Tensor softmax(const Tensor& input, int axis);
+    friend Tensor log_softmax(const Tensor& input, int axis);
+    friend Tensor layer_norm(const Tensor& input, const Tensor* pGamma, const Tensor* pBeta, int axis, float eps);
+    friend Tensor PPOLoss(const Tensor& logpNew, const Tensor& logpOld, const Tensor& advantages,
+                          const Tensor& values, const Tensor& valuesOld, const Tensor& returns,
+                          const Tensor& logStd, const PPOLossConfig& config, PPOLossStats* pStats);
+    friend Tensor BatchedBodyStep(const Tensor& state, const Tensor& thrust, const Tensor& mass,
+                                  const Tensor& inertia, const BatchedBodyModel& model);
     
 public:
     // Constructor for arbitrary 2D shape (rows, cols)
@@ -24,7 +46,7 @@ public:
     // Constructor from 1D list (creates size x 1 column vector)
     Tensor(std::vector<float> dataList, bool requiresGrad = false);
     
-    // Set value at specific row/col
+    // Set value at specific row/col (counts as an in-place write)
     void Set(int r, int c, float value);
 
     // Get value
@@ -33,6 +55,11 @@ public:
     // Backward function
     void Backward();
 
+    // Graphs with at least this many nodes run backward on the global thread
+    // pool (see engine/thread_pool.h); smaller graphs stay serial
+    static void SetParallelBackwardThreshold(int minNodes);
+    static int GetParallelBackwardThreshold();
+
     // Set requires_grad
     void SetRequiresGrad(bool requiresGrad);
 
@@ -42,19 +69,48 @@ public:
     // Dimensions
     int Rows() const;
     int Cols() const;
+    // Bytes held by the data and grad buffers
+    int64_t StorageBytes() const { return (int64_t)(m_Data.size() + m_Grad.size()) * (int64_t)sizeof(float); }
 
     // Accessors for Python bindings (Copy-based for now)
     Eigen::MatrixXf GetData() const;
     void SetData(const Eigen::MatrixXf& d);
+    // Read-only view of the data without the copy GetData() makes
+    const Eigen::MatrixXf& Data() const { return m_Data; }
     
     Eigen::MatrixXf GetGrad() const;
     void SetGrad(const Eigen::MatrixXf& g);
 
     bool GetRequiresGrad() const;
 
+    // Forward-mode AD: tangent is (size x P), one column per direction.
+    // Column p holds the column-major flattened derivative of the data along
+    // direction p. Ops propagate tangents alongside values when any input has one.
+    void SetTangent(const Eigen::MatrixXf& t);
+    Eigen::MatrixXf GetTangent() const;
+    int NumTangents() const;
+    void ClearTangent();
+
     // Pointer to underlying data (useful for binding to NumPy later)
     float* DataPtr();
 
+    // In-place ops. They write into this Tensor's buffer and bump its version;
+    // a later Backward() through a node that saved the old data throws instead
+    // of using the new values. Only valid on leaves, with operands that don't
+    // require grad (nothing records the mutation in the graph).
+    Tensor& AddInPlace(const Tensor& other, float alpha = 1.0f); // this += alpha * other
+    Tensor& MulInPlace(const Tensor& other);                     // this *= other (elementwise)
+    Tensor& MulInPlace(float scalar);
+    Tensor& CopyFrom(const Tensor& other);
+    Tensor& ClampInPlace(float minVal, float maxVal);
+
+    // Number of in-place writes to this Tensor's data
+    unsigned int Version() const { return m_Version; }
+    // True if no op produced this Tensor (no backward closure)
+    bool IsLeaf() const { return !m_BackwardFn; }
+    // Name of the op that produced this Tensor (nullptr for leaves)
+    const char* OpName() const { return m_OpName; }
+
     Tensor Sum();
     Tensor Sum(int axis); // Axis reduction
     Tensor Mean();
@@ -76,10 +132,25 @@ public:
 
     // Core Ops
     Tensor Select(int idx) const; // Differentiable indexing
-    static Tensor Stack(const std::vector<Tensor*>& tensors); // Differentiable stacking
+    static Tensor Stack(const std::vector<Tensor*>& tensors); // Scalars -> (n, 1); (r, 1) vectors -> (r, n)
     static Tensor Cat(const std::vector<Tensor*>& tensors, int dim); // Differentiable concatenation
     Tensor Reshape(int r, int c);
 
+    // Strided copy: element (i, j) reads the column-major storage at
+    // offset + i * rowStride + j * colStride. Tensors own their storage, so
+    // the result is a new buffer, not an alias; backward is one strided
+    // scatter into this Tensor's gradient. Select, Slice, Reshape and
+    // Transpose are built on it.
+    Tensor View(int offset, int rows, int cols, int rowStride, int colStride) const;
+    Tensor Slice(int rowStart, int numRows, int colStart = 0, int numCols = -1) const;
+
+    // Bulk indexing on flat (column-major) indices
+    Tensor Gather(const std::vector<int>& indices) const; // (n, 1) = this[indices]
+    Tensor ScatterAdd(const std::vector<int>& indices, int rows, int cols) const; // out[indices] += this
+
+    // Start a fused elementwise expression (see engine/lazy.h)
+    LazyExpr Lazy() const;
+
     // Operations
     Tensor operator+(const Tensor& other) const;
     Tensor operator-(const Tensor& other) const;
@@ -91,7 +162,8 @@ public:
     Tensor Transpose();
     Tensor Matmul(const Tensor& other);
     
-    // Gaussian log probability for policy gradients
+    // Gaussian log probability for policy gradients: (D, B) actions and means,
+    // (D, B) or shared (D, 1) log std -> (1, B) log probs
     static Tensor GaussianLogProb(const Tensor& action, const Tensor& mean, const Tensor& logStd);
 
 private:
@@ -100,7 +172,41 @@ private:
     Eigen::MatrixXf m_Grad;
     bool m_bRequiresGrad = false;
     std::vector<Tensor*> m_Children;
-    std::function<void(Tensor&)> m_BackwardFn;
+    BackwardClosure m_BackwardFn;
+    const char* m_OpName = nullptr; // Static string set by the creating op
+
+    // In-place write counter, and the versions of the Tensors whose data this
+    // node's backward reads (nullptr = this node's own output)
+    unsigned int m_Version = 0;
+    std::vector<std::pair<const Tensor*, unsigned int>> m_SavedVersions;
+
+    // Record inputs (and optionally the output) whose data backward will read
+    void SaveForBackward(std::initializer_list<const Tensor*> inputs, bool bOutput = false);
+    // Throws if a saved Tensor was modified in place since it was recorded
+    void CheckSavedVersions() const;
+    void CheckInPlace(const Tensor* pOther, const char* opName) const;
+
+    // Forward-mode tangent (empty when not tracking)
+    Eigen::MatrixXf m_Tangent;
+
+    // Live-Tensor accounting; TrackMemory() reports buffer size changes
+    TensorMemoryStamp m_MemoryStamp;
+    void TrackMemory() {
+        m_MemoryStamp.Update((int64_t)m_Data.size() * sizeof(float), (int64_t)m_Grad.size() * sizeof(float));
+    }
+
+    // Tangent, or zeros of (size x numDirs) when this Tensor carries none;
+    // throws if it carries a different number of directions
+    Eigen::MatrixXf TangentOrZero(int numDirs) const;
+
+    // Gradient sink for backward closures. Normally pTarget->m_Grad; during a
+    // parallel backward, nodes fed by several parents get a per-worker buffer
+    // that is reduced into m_Grad once all of their parents have run.
+    static Eigen::MatrixXf& GradAccumulator(const Tensor* pTarget);
+
+    static void BackwardParallel(const std::vector<Tensor*>& topo);
+    // Version check, then the node's closure (timed when profiling)
+    static void RunBackwardFn(Tensor* pNode);
 };
 
 #endif // CORE_H
\ No newline at end of file
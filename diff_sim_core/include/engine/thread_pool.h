@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool - Fixed set of worker threads fed from one task queue
+ *
+ * Shared by everything in the engine that fans work out (parallel backward,
+ * batched environments, ...). Work submitted from inside a worker runs
+ * inline on that worker instead of being queued, so nested parallel
+ * regions never deadlock or oversubscribe the machine.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Worker threads (the calling thread also participates in ParallelFor)
+    int NumThreads() const { return (int)m_Workers.size(); }
+
+    // Run fn(i) for every i in [0, count) and block until all are done.
+    // Index 0 runs on the calling thread. Serial when called from a worker.
+    void ParallelFor(int count, const std::function<void(int)>& fn);
+
+    // True on a pool worker thread, or on the caller while it runs its ParallelFor share
+    static bool InWorker();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_Workers;
+    std::deque<std::function<void()>> m_Tasks;
+    std::mutex m_Mutex;
+    std::condition_variable m_TaskCv;
+    bool m_bStop = false;
+};
+
+// Process-wide pool, created on first use with hardware_concurrency() - 1 workers
+ThreadPool& GetGlobalThreadPool();
+
+// Resize the global pool (total threads including the caller; <= 0 = hardware default).
+// Must not be called while parallel work is in flight.
+void SetNumThreads(int numThreads);
+int GetNumThreads();
+
+#endif // THREAD_POOL_H
@@ -1,13 +1,30 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <iostream>
 #include "engine/tensor.h"
 #include "engine/activations.h"
+#include "engine/losses.h"
+#include "engine/lazy.h"
+#include "engine/thread_pool.h"
+#include "engine/compute.h"
+#include "engine/profiler.h"
 #include "engine/optimizers.h"
+#include "engine/checkpoint.h"
 #include "engine/body.h"
 #include "renderer/sdl_renderer.h"
 #include "engine/engine.h"
+#include "engine/joint.h"
+#include "engine/articulated.h"
+#include "engine/ilqr.h"
+#include "engine/batched_dynamics.h"
+#include "engine/system_id.h"
+#include "engine/drone_task.h"
+#include "engine/policy.h"
+#include "engine/ppo.h"
+#include "engine/evaluation.h"
 
 namespace py = pybind11;
 
@@ -22,6 +39,104 @@ PYBIND11_MODULE(rigidRL, m) {
 
     m.def("add", &add_cpp, "A test function that adds two numbers");
 
+    m.def("set_num_threads", &SetNumThreads, py::arg("num_threads"),
+          "Size of the shared worker pool, including the calling thread (<= 0: all cores).");
+    m.def("get_num_threads", &GetNumThreads);
+    m.def("set_intra_op_threads", &SetIntraOpThreads, py::arg("num_threads"),
+          "Threads a single large GEMM may use from the shared pool (<= 0: all of them).");
+    m.def("get_intra_op_threads", &GetIntraOpThreads);
+    m.def("set_gemm_parallel_threshold", &SetGemmParallelThreshold, py::arg("min_macs"),
+          "Matmuls below this many multiply-adds stay single-threaded.");
+    m.def("get_gemm_parallel_threshold", &GetGemmParallelThreshold);
+
+    // Op profiler. Usage:
+    //   with rigidRL.profiler(trace=True) as prof: ...
+    //   print(prof.table()); prof.dump_trace("trace.json")
+    py::class_<Profiler>(m, "profiler")
+        .def(py::init([](bool trace) {
+            Profiler::SetTraceEnabled(trace);
+            return Profiler();
+        }), py::arg("trace")=false, "Per-op forward/backward profiler; trace=True keeps events for dump_trace().")
+        .def("__enter__", [](Profiler& self) -> Profiler& {
+            Profiler::Reset();
+            Profiler::Enable();
+            return self;
+        }, py::return_value_policy::reference)
+        .def("__exit__", [](Profiler&, py::object, py::object, py::object) {
+            Profiler::Disable();
+        })
+        .def("table", [](Profiler&, int maxRows) { return Profiler::Table(maxRows); }, py::arg("max_rows")=0,
+             "Ops sorted by total (forward + backward) time.")
+        .def("__str__", [](Profiler&) { return Profiler::Table(); })
+        .def("stats", [](Profiler&) {
+            py::list rows;
+            for (const OpStats& op : Profiler::GetStats()) {
+                py::dict row;
+                row["op"] = op.name;
+                row["forward_calls"] = op.forwardCount;
+                row["forward_ms"] = op.forwardMs;
+                row["backward_calls"] = op.backwardCount;
+                row["backward_ms"] = op.backwardMs;
+                row["total_ms"] = op.TotalMs();
+                row["bytes"] = op.bytesAllocated;
+                py::dict shapes;
+                for (const auto& shape : op.shapes) {
+                    shapes[py::make_tuple(shape.first.first, shape.first.second)] = shape.second;
+                }
+                row["shapes"] = shapes;
+                rows.append(row);
+            }
+            return rows;
+        })
+        .def("dump_trace", [](Profiler&, const std::string& path) { Profiler::DumpTrace(path); }, py::arg("path"),
+             "Write a Chrome trace (chrome://tracing / Perfetto). Needs trace=True.")
+        .def_static("enable", &Profiler::Enable)
+        .def_static("disable", &Profiler::Disable)
+        .def_static("reset", &Profiler::Reset);
+
+    // Live memory accounting; cheap enough to call every iteration
+    m.def("memory_stats", []() {
+        MemoryStats stats = MemoryTracker::Snapshot();
+        py::dict tensors;
+        tensors["live"] = stats.liveTensors;
+        tensors["peak"] = stats.peakTensors;
+        tensors["data_bytes"] = stats.tensorDataBytes;
+        tensors["grad_bytes"] = stats.tensorGradBytes;
+        tensors["peak_bytes"] = stats.peakTensorBytes;
+        py::dict graph;
+        graph["nodes"] = stats.graphNodes;
+        graph["peak_nodes"] = stats.peakGraphNodes;
+        graph["backward_scratch_bytes"] = stats.backwardScratchBytes;
+        graph["peak_backward_scratch_bytes"] = stats.peakBackwardScratchBytes;
+        py::list engines;
+        for (const EngineMemoryStats& e : stats.engines) {
+            py::dict engine;
+            engine["bodies"] = e.bodies;
+            engine["colliders"] = e.colliders;
+            engine["shapes"] = e.shapes;
+            engine["joints"] = e.joints;
+            engine["manifolds"] = e.manifolds;
+            engine["active_manifolds"] = e.activeManifolds;
+            engine["garbage_tensors"] = e.garbageTensors;
+            engine["garbage_bytes"] = e.garbageBytes;
+            engine["rewind_bytes"] = e.rewindBytes;
+            engine["bytes"] = e.bytes;
+            engines.append(engine);
+        }
+        py::dict process;
+        process["resident_bytes"] = stats.residentBytes;
+        process["peak_resident_bytes"] = stats.peakResidentBytes;
+        py::dict result;
+        result["tensors"] = tensors;
+        result["graph"] = graph;
+        result["engines"] = engines;
+        result["process"] = process;
+        return result;
+    }, "Live Tensors (count, data/grad bytes), autograd nodes, per-Engine body/collider/manifold "
+       "counts and bytes, and process RSS, each with a high-water mark.");
+    m.def("reset_memory_peaks", &MemoryTracker::ResetPeaks,
+          "Restart the high-water marks of memory_stats() (the process RSS peak is the OS's).");
+
     py::class_<Tensor>(m, "Tensor")
         // 1. Constructors
         .def(py::init<int, int, bool>(), py::arg("rows"), py::arg("cols"), py::arg("requires_grad")=false)
@@ -35,6 +150,9 @@ PYBIND11_MODULE(rigidRL, m) {
         .def("cols", &Tensor::Cols)
         .def("backward", &Tensor::Backward)
         .def("zero_grad", &Tensor::ZeroGrad)
+        .def_static("set_parallel_backward_threshold", &Tensor::SetParallelBackwardThreshold, py::arg("min_nodes"),
+             "Graphs with at least this many nodes run backward on the thread pool.")
+        .def_static("get_parallel_backward_threshold", &Tensor::GetParallelBackwardThreshold)
         
         // 3. Properties
         .def_property_readonly("shape", [](const Tensor& t) {
@@ -43,6 +161,11 @@ PYBIND11_MODULE(rigidRL, m) {
         .def_property("requires_grad", &Tensor::GetRequiresGrad, &Tensor::SetRequiresGrad)
         .def_property("data", &Tensor::GetData, &Tensor::SetData)
         .def_property("grad", &Tensor::GetGrad, &Tensor::SetGrad)
+        .def_property("tangent", &Tensor::GetTangent, &Tensor::SetTangent,
+             "Forward-mode tangents, shape (size, P): one column per direction.")
+        .def("set_tangent", &Tensor::SetTangent)
+        .def("clear_tangent", &Tensor::ClearTangent)
+        .def("num_tangents", &Tensor::NumTangents)
 
 
 
@@ -52,6 +175,28 @@ PYBIND11_MODULE(rigidRL, m) {
         .def("log", &Tensor::Log, py::keep_alive<0, 1>())
         .def("select", &Tensor::Select, py::keep_alive<0, 1>())
         .def("__getitem__", &Tensor::Select, py::keep_alive<0, 1>()) // Enable t[i] syntax
+        .def("__getitem__", [](const Tensor& t, py::slice rowSlice) { // t[a:b:step] -> strided row copy
+            py::ssize_t start, stop, step, length;
+            if (!rowSlice.compute(t.Rows(), &start, &stop, &step, &length)) throw py::error_already_set();
+            if (step <= 0 || length == 0) throw py::value_error("Tensor slicing needs a positive step and a non-empty range");
+            return t.View((int)start, (int)length, t.Cols(), (int)step, t.Rows());
+        }, py::keep_alive<0, 1>())
+        // In-place ops (leaves only; return self)
+        .def("add_", &Tensor::AddInPlace, py::arg("other"), py::arg("alpha")=1.0f, py::return_value_policy::reference)
+        .def("mul_", py::overload_cast<const Tensor&>(&Tensor::MulInPlace), py::arg("other"), py::return_value_policy::reference)
+        .def("mul_", py::overload_cast<float>(&Tensor::MulInPlace), py::arg("scalar"), py::return_value_policy::reference)
+        .def("copy_", &Tensor::CopyFrom, py::arg("other"), py::return_value_policy::reference)
+        .def("clamp_", &Tensor::ClampInPlace, py::arg("min"), py::arg("max"), py::return_value_policy::reference)
+        .def_property_readonly("version", &Tensor::Version)
+        .def_property_readonly("is_leaf", &Tensor::IsLeaf)
+        .def("view", &Tensor::View, py::arg("offset"), py::arg("rows"), py::arg("cols"),
+             py::arg("row_stride"), py::arg("col_stride"), py::keep_alive<0, 1>(),
+             "Strided copy out of column-major storage (not an alias); backward scatters into this Tensor's grad.")
+        .def("slice", &Tensor::Slice, py::arg("row_start"), py::arg("num_rows"),
+             py::arg("col_start")=0, py::arg("num_cols")=-1, py::keep_alive<0, 1>())
+        .def("gather", &Tensor::Gather, py::arg("indices"), py::keep_alive<0, 1>())
+        .def("scatter_add", &Tensor::ScatterAdd, py::arg("indices"), py::arg("rows"), py::arg("cols"),
+             py::keep_alive<0, 1>())
         .def_static("stack", &Tensor::Stack, py::keep_alive<0, 1>()) // Static method
 
         // 4. Operators (with keep_alive to manage graph lifetime)
@@ -88,10 +233,45 @@ PYBIND11_MODULE(rigidRL, m) {
         .def("__pow__", &Tensor::Pow, py::keep_alive<0, 1>())
         .def("reshape", &Tensor::Reshape, py::keep_alive<0, 1>())
         .def_static("cat", &Tensor::Cat, py::keep_alive<0, 1>())
+        .def("lazy", &Tensor::Lazy, py::keep_alive<0, 1>(),
+             "Start a fused elementwise expression. Call materialize() on the result.")
         .def_static("gaussian_log_prob", &Tensor::GaussianLogProb, 
             py::arg("action"), py::arg("mean"), py::arg("log_std"),
             py::keep_alive<0, 1>(), py::keep_alive<0, 2>(), py::keep_alive<0, 3>());
     
+    // Lazy elementwise expressions: every op keeps its operands alive, and the
+    // materialized Tensor keeps the whole expression (and so its leaves) alive
+    py::class_<LazyExpr>(m, "LazyExpr")
+        .def(py::init<const Tensor&>(), py::arg("tensor"), py::keep_alive<1, 2>())
+        .def_property_readonly("shape", [](const LazyExpr& e) {
+            return std::make_pair(e.Rows(), e.Cols());
+        })
+        .def("__add__", (LazyExpr (LazyExpr::*)(const LazyExpr&) const) &LazyExpr::operator+, py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+        .def("__sub__", (LazyExpr (LazyExpr::*)(const LazyExpr&) const) &LazyExpr::operator-, py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+        .def("__mul__", (LazyExpr (LazyExpr::*)(const LazyExpr&) const) &LazyExpr::operator*, py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+        .def("__truediv__", (LazyExpr (LazyExpr::*)(const LazyExpr&) const) &LazyExpr::operator/, py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+        .def("__add__", (LazyExpr (LazyExpr::*)(float) const) &LazyExpr::operator+, py::keep_alive<0, 1>())
+        .def("__radd__", (LazyExpr (LazyExpr::*)(float) const) &LazyExpr::operator+, py::keep_alive<0, 1>())
+        .def("__sub__", (LazyExpr (LazyExpr::*)(float) const) &LazyExpr::operator-, py::keep_alive<0, 1>())
+        .def("__rsub__", [](const LazyExpr& e, float s) { return -e + s; }, py::keep_alive<0, 1>())
+        .def("__mul__", (LazyExpr (LazyExpr::*)(float) const) &LazyExpr::operator*, py::keep_alive<0, 1>())
+        .def("__rmul__", (LazyExpr (LazyExpr::*)(float) const) &LazyExpr::operator*, py::keep_alive<0, 1>())
+        .def("__neg__", (LazyExpr (LazyExpr::*)() const) &LazyExpr::operator-, py::keep_alive<0, 1>())
+        .def("pow", &LazyExpr::Pow, py::keep_alive<0, 1>())
+        .def("__pow__", &LazyExpr::Pow, py::keep_alive<0, 1>())
+        .def("exp", &LazyExpr::Exp, py::keep_alive<0, 1>())
+        .def("log", &LazyExpr::Log, py::keep_alive<0, 1>())
+        .def("sqrt", &LazyExpr::Sqrt, py::keep_alive<0, 1>())
+        .def("abs", &LazyExpr::Abs, py::keep_alive<0, 1>())
+        .def("sin", &LazyExpr::Sin, py::keep_alive<0, 1>())
+        .def("cos", &LazyExpr::Cos, py::keep_alive<0, 1>())
+        .def("tanh", &LazyExpr::Tanh, py::keep_alive<0, 1>())
+        .def("clamp", &LazyExpr::Clamp, py::arg("min"), py::arg("max"), py::keep_alive<0, 1>())
+        .def("materialize", &LazyExpr::Materialize, py::keep_alive<0, 1>(),
+             "Compile (first call only) and evaluate into a single Tensor with a fused backward.")
+        .def("num_instructions", &LazyExpr::NumInstructions);
+    py::implicitly_convertible<Tensor, LazyExpr>();
+
     // Module-level function for convenience
     m.def("gaussian_log_prob", &Tensor::GaussianLogProb, 
         py::arg("action"), py::arg("mean"), py::arg("log_std"),
@@ -100,24 +280,133 @@ PYBIND11_MODULE(rigidRL, m) {
     // Module-level Activations
     m.def("relu", &relu, py::keep_alive<0, 1>());
     m.def("tanh", (Tensor (*)(const Tensor&)) &tanh, py::keep_alive<0, 1>());
+    m.def("sigmoid", &sigmoid, py::keep_alive<0, 1>());
+    m.def("softplus", &softplus, py::keep_alive<0, 1>());
+    m.def("elu", &elu, py::arg("input"), py::arg("alpha")=1.0f, py::keep_alive<0, 1>());
+    m.def("gelu", &gelu, py::keep_alive<0, 1>());
+    m.def("softmax", &softmax, py::arg("input"), py::arg("axis")=0, py::keep_alive<0, 1>());
+    m.def("log_softmax", &log_softmax, py::arg("input"), py::arg("axis")=0, py::keep_alive<0, 1>());
+    m.def("layer_norm", (Tensor (*)(const Tensor&, const Tensor*, const Tensor*, int, float)) &layer_norm,
+          py::arg("input"), py::arg("gamma")=nullptr, py::arg("beta")=nullptr, py::arg("axis")=0, py::arg("eps")=1e-5f,
+          py::keep_alive<0, 1>(), py::keep_alive<0, 2>(), py::keep_alive<0, 3>(),
+          "Normalize along axis (0: each column, 1: each row), then scale by gamma and shift by beta if given.");
+
+    // Fused PPO loss
+    py::class_<PPOLossConfig>(m, "PPOLossConfig")
+        .def(py::init<>())
+        .def_readwrite("clip_ratio", &PPOLossConfig::clipRatio)
+        .def_readwrite("value_clip", &PPOLossConfig::valueClip)
+        .def_readwrite("value_coef", &PPOLossConfig::valueCoef)
+        .def_readwrite("entropy_coef", &PPOLossConfig::entropyCoef);
+
+    py::class_<PPOLossStats>(m, "PPOLossStats")
+        .def(py::init<>())
+        .def_readonly("policy_loss", &PPOLossStats::policyLoss)
+        .def_readonly("value_loss", &PPOLossStats::valueLoss)
+        .def_readonly("entropy", &PPOLossStats::entropy)
+        .def_readonly("approx_kl", &PPOLossStats::approxKl)
+        .def_readonly("clip_fraction", &PPOLossStats::clipFraction);
+
+    m.def("ppo_loss", &PPOLoss,
+          py::arg("logp_new"), py::arg("logp_old"), py::arg("advantages"),
+          py::arg("values"), py::arg("values_old"), py::arg("returns"), py::arg("log_std"),
+          py::arg("config")=PPOLossConfig(), py::arg("stats")=nullptr,
+          py::keep_alive<0, 1>(), py::keep_alive<0, 4>(), py::keep_alive<0, 7>(),
+          "Clipped surrogate + clipped value loss - entropy bonus as one (1, 1) Tensor. "
+          "Pass a PPOLossStats to receive the individual terms, approx KL and clip fraction.");
+
+    py::class_<Optimizer>(m, "Optimizer")
+        .def("step", (void (Optimizer::*)()) &Optimizer::Step)
+        .def("zero_grad", &Optimizer::ZeroGrad)
+        .def_property("lr", &Optimizer::GetLearningRate, &Optimizer::SetLearningRate)
+        .def("save_state", &Optimizer::SaveState, py::arg("writer"), py::arg("prefix"))
+        .def("load_state", &Optimizer::LoadState, py::arg("checkpoint"), py::arg("prefix"));
 
-    py::class_<SGD>(m, "SGD")
+    py::class_<SGD, Optimizer>(m, "SGD")
         .def(py::init<std::vector<Tensor*>, float>(), py::arg("params"), py::arg("lr"))
         .def("step", &SGD::Step)
         .def("zero_grad", &SGD::ZeroGrad);
 
-    py::class_<Adam>(m, "Adam")
+    py::class_<Adam, Optimizer>(m, "Adam")
         .def(py::init<std::vector<Tensor*>, float, float, float, float>(), 
              py::arg("params"), py::arg("lr")=0.001, py::arg("beta1")=0.9, py::arg("beta2")=0.999, py::arg("epsilon")=1e-8)
         .def("step", &Adam::Step)
         .def("zero_grad", &Adam::ZeroGrad);
 
-    py::class_<AdamW>(m, "AdamW")
+    py::class_<AdamW, Optimizer>(m, "AdamW")
         .def(py::init<std::vector<Tensor*>, float, float, float, float, float>(), 
              py::arg("params"), py::arg("lr")=0.001, py::arg("beta1")=0.9, py::arg("beta2")=0.999, py::arg("epsilon")=1e-8, py::arg("weight_decay")=0.0)
         .def("step", &AdamW::Step)
         .def("zero_grad", &AdamW::ZeroGrad);
 
+    py::class_<LBFGS, Optimizer>(m, "LBFGS")
+        .def(py::init<std::vector<Tensor*>, float, int, int, float, float, int, bool>(),
+             py::arg("params"), py::arg("lr")=1.0f, py::arg("max_iter")=20, py::arg("max_eval")=-1,
+             py::arg("tolerance_grad")=1e-7f, py::arg("tolerance_change")=1e-9f, py::arg("history_size")=10,
+             py::arg("strong_wolfe")=true)
+        .def("step", (float (LBFGS::*)(const std::function<float()>&)) &LBFGS::Step, py::arg("closure"),
+             "closure() must rebuild the loss from the current params, call backward() and return the loss "
+             "as a float. Gradients are zeroed before each call. Returns the loss before the step.")
+        .def("num_evaluations", &LBFGS::NumEvaluations)
+        .def("reset_history", &LBFGS::ResetHistory);
+
+    // Learning-rate schedules; call step() once per optimizer step
+    py::class_<LRScheduler>(m, "LRScheduler")
+        .def("step", &LRScheduler::Step)
+        .def("get_step", &LRScheduler::GetStep)
+        .def("get_lr", &LRScheduler::GetLearningRate)
+        .def("lr_at", &LRScheduler::LearningRateAt, py::arg("step"));
+
+    py::class_<CosineAnnealingLR, LRScheduler>(m, "CosineAnnealingLR")
+        .def(py::init<Optimizer&, int, float>(), py::arg("optimizer"), py::arg("total_steps"), py::arg("min_lr")=0.0f,
+             py::keep_alive<1, 2>());
+
+    py::class_<LinearWarmupLR, LRScheduler>(m, "LinearWarmupLR")
+        .def(py::init<Optimizer&, int, float, LRScheduler*>(), py::arg("optimizer"), py::arg("warmup_steps"),
+             py::arg("start_factor")=0.0f, py::arg("after")=nullptr,
+             py::keep_alive<1, 2>(), py::keep_alive<1, 5>(),
+             "Linear warmup, then hand over to 'after' (create it first, and only step this scheduler).");
+
+    py::class_<StepLR, LRScheduler>(m, "StepLR")
+        .def(py::init<Optimizer&, int, float>(), py::arg("optimizer"), py::arg("step_size"), py::arg("gamma")=0.1f,
+             py::keep_alive<1, 2>());
+
+    // ---------------- Checkpoints ----------------
+    py::class_<CheckpointWriter>(m, "CheckpointWriter")
+        .def(py::init<>())
+        .def("add_array", &CheckpointWriter::AddMatrix, py::arg("name"), py::arg("data"))
+        .def("add_tensor", &CheckpointWriter::AddTensor, py::arg("name"), py::arg("tensor"))
+        .def("add_parameters", &CheckpointWriter::AddParameters, py::arg("prefix"), py::arg("params"),
+             "Stored as '<prefix>/0', '<prefix>/1', ...")
+        .def("add_int", &CheckpointWriter::AddInt, py::arg("name"), py::arg("value"))
+        .def("add_bytes", [](CheckpointWriter& w, const std::string& name, const py::bytes& data) {
+            w.AddBytes(name, std::string(data));
+        }, py::arg("name"), py::arg("data"))
+        .def("num_entries", &CheckpointWriter::NumEntries)
+        .def("save", &CheckpointWriter::Save, py::arg("path"), py::call_guard<py::gil_scoped_release>());
+
+    py::class_<Checkpoint>(m, "Checkpoint")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def_property_readonly("path", &Checkpoint::Path)
+        .def("names", &Checkpoint::Names)
+        .def("has", &Checkpoint::Has, py::arg("name"))
+        .def("__contains__", &Checkpoint::Has)
+        .def("array", [](py::object self, const std::string& name) {
+            const Checkpoint& c = self.cast<const Checkpoint&>();
+            Eigen::Map<const Eigen::MatrixXf> data = c.Matrix(name);
+            py::array view(py::dtype::of<float>(),
+                           {(py::ssize_t)data.rows(), (py::ssize_t)data.cols()},
+                           {(py::ssize_t)sizeof(float), (py::ssize_t)(sizeof(float) * data.rows())},
+                           data.data(), self);
+            view.attr("setflags")(py::arg("write") = false);
+            return view;
+        }, py::arg("name"), "Read-only numpy view into the mapped file (no copy); keeps the Checkpoint alive.")
+        .def("int", &Checkpoint::Int, py::arg("name"))
+        .def("bytes", [](const Checkpoint& c, const std::string& name) { return py::bytes(c.Bytes(name)); },
+             py::arg("name"))
+        .def("load_tensor", &Checkpoint::LoadTensor, py::arg("name"), py::arg("target"))
+        .def("load_parameters", &Checkpoint::LoadParameters, py::arg("prefix"), py::arg("params"));
+
     py::class_<Body>(m, "Body")
         .def(py::init<float, float, float, float, float>(), 
              py::arg("x"), py::arg("y"), py::arg("mass"), py::arg("width"), py::arg("height"))
@@ -134,9 +423,10 @@ PYBIND11_MODULE(rigidRL, m) {
         .def("get_x", &Body::GetX)
         .def("get_y", &Body::GetY)
         .def("get_rotation", &Body::GetRotation)
-        .def("set_rotation", [](Body& b, float angle) {
-            b.rotation = Tensor(std::vector<float>{angle}, true);
-        }, py::arg("angle"))
+        .def("set_rotation", &Body::SetRotation, py::arg("angle"))
+        .def("set_position", &Body::SetPosition, py::arg("x"), py::arg("y"))
+        .def("set_velocity", &Body::SetVelocity, py::arg("vx"), py::arg("vy"))
+        .def("set_angular_velocity", &Body::SetAngularVelocity, py::arg("omega"))
         .def_readwrite("is_static", &Body::is_static)
         .def_readwrite("friction", &Body::friction)
         .def_readwrite("restitution", &Body::restitution)
@@ -180,7 +470,10 @@ PYBIND11_MODULE(rigidRL, m) {
         .def_readwrite("thrust", &Motor::thrust)
         .def_readwrite("max_thrust", &Motor::max_thrust)
         .def_readwrite("angle", &Motor::angle)
-        .def("set_thrust", &Motor::SetThrust, py::arg("thrust"));
+        .def_readonly("command", &Motor::command, "Latest set_thrust() value (reaches thrust after the delay).")
+        .def("set_thrust", &Motor::SetThrust, py::arg("thrust"))
+        .def_property("delay", &Motor::GetDelay, &Motor::SetDelay, "Command latency in substeps.")
+        .def("reset_thrust", &Motor::ResetThrust, py::arg("thrust")=0.0f, "Drop commands in flight and hold thrust.");
 
     py::class_<Renderer>(m, "Renderer")
         .def("get_width", &Renderer::GetWidth, "Get the window width in pixels.")
@@ -217,12 +510,144 @@ PYBIND11_MODULE(rigidRL, m) {
              py::arg("r")=1.0f, py::arg("g")=1.0f, py::arg("b")=1.0f,
              "Draw text at screen coordinates (pixels from bottom-left).");
 
+    py::enum_<SensitivityParam>(m, "SensitivityParam")
+        .value("MASS", SensitivityParam::MASS)
+        .value("INERTIA", SensitivityParam::INERTIA)
+        .value("FRICTION", SensitivityParam::FRICTION)
+        .value("RESTITUTION", SensitivityParam::RESTITUTION)
+        .value("MOTOR_MAX_THRUST", SensitivityParam::MOTOR_MAX_THRUST)
+        .value("MOTOR_ANGLE", SensitivityParam::MOTOR_ANGLE);
+
+    py::enum_<SolverMode>(m, "SolverMode")
+        .value("IMPULSE", SolverMode::IMPULSE)
+        .value("XPBD", SolverMode::XPBD);
+
+    // ---------------- Joints ----------------
+    // Anchors in world coordinates at creation; a joint keeps its bodies alive
+
+    py::enum_<JointType>(m, "JointType")
+        .value("REVOLUTE", JointType::REVOLUTE)
+        .value("PRISMATIC", JointType::PRISMATIC)
+        .value("WELD", JointType::WELD)
+        .value("DISTANCE", JointType::DISTANCE);
+
+    py::class_<Joint>(m, "Joint")
+        .def_property_readonly("type", &Joint::GetType)
+        .def_property_readonly("body_a", &Joint::GetBodyA, py::return_value_policy::reference)
+        .def_property_readonly("body_b", &Joint::GetBodyB, py::return_value_policy::reference)
+        .def_readwrite("collide_connected", &Joint::collide_connected)
+        .def("reaction_force", [](const Joint& joint) {
+            return py::make_tuple(joint.GetReactionForceX(), joint.GetReactionForceY());
+        }, "Constraint force on body B during the last substep, (fx, fy).")
+        .def("reaction_torque", &Joint::GetReactionTorque);
+
+    py::class_<RevoluteJoint, Joint>(m, "RevoluteJoint")
+        .def(py::init<Body*, Body*, float, float>(),
+             py::arg("body_a"), py::arg("body_b"), py::arg("anchor_x"), py::arg("anchor_y"),
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>())
+        .def_property_readonly("angle", &RevoluteJoint::GetAngle)
+        .def_readwrite("enable_limit", &RevoluteJoint::enable_limit)
+        .def_readwrite("lower_angle", &RevoluteJoint::lower_angle)
+        .def_readwrite("upper_angle", &RevoluteJoint::upper_angle)
+        .def_readwrite("enable_motor", &RevoluteJoint::enable_motor)
+        .def_readwrite("motor_speed", &RevoluteJoint::motor_speed)
+        .def_readwrite("max_motor_torque", &RevoluteJoint::max_motor_torque);
+
+    py::class_<PrismaticJoint, Joint>(m, "PrismaticJoint")
+        .def(py::init<Body*, Body*, float, float, float, float>(),
+             py::arg("body_a"), py::arg("body_b"), py::arg("anchor_x"), py::arg("anchor_y"),
+             py::arg("axis_x"), py::arg("axis_y"),
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>())
+        .def_property_readonly("translation", &PrismaticJoint::GetTranslation)
+        .def_readwrite("enable_limit", &PrismaticJoint::enable_limit)
+        .def_readwrite("lower_translation", &PrismaticJoint::lower_translation)
+        .def_readwrite("upper_translation", &PrismaticJoint::upper_translation);
+
+    py::class_<WeldJoint, Joint>(m, "WeldJoint")
+        .def(py::init<Body*, Body*, float, float>(),
+             py::arg("body_a"), py::arg("body_b"), py::arg("anchor_x"), py::arg("anchor_y"),
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>());
+
+    py::class_<DistanceJoint, Joint>(m, "DistanceJoint")
+        .def(py::init<Body*, Body*, float, float, float, float, bool>(),
+             py::arg("body_a"), py::arg("body_b"), py::arg("anchor_a_x"), py::arg("anchor_a_y"),
+             py::arg("anchor_b_x"), py::arg("anchor_b_y"), py::arg("rope")=false,
+             py::keep_alive<1, 2>(), py::keep_alive<1, 3>(),
+             "rope=True only resists stretching (e.g. a slung load).")
+        .def_property_readonly("current_length", &DistanceJoint::GetCurrentLength)
+        .def_readwrite("length", &DistanceJoint::length)
+        .def_readwrite("rope", &DistanceJoint::rope);
+
+    // ---------------- Articulated chains ----------------
+    // Link 0 is the root; joint i (i >= 1) connects link i to its parent
+
+    py::class_<ArticulatedChain>(m, "ArticulatedChain")
+        .def(py::init<Body*, bool>(), py::arg("root"), py::arg("floating_base")=true, py::keep_alive<1, 2>(),
+             "Reduced-coordinate chain rooted at a body (fixed if static or floating_base=False).")
+        .def("add_link", &ArticulatedChain::AddLink,
+             py::arg("link"), py::arg("parent"), py::arg("anchor_x"), py::arg("anchor_y"), py::arg("damping")=0.0f,
+             py::keep_alive<1, 2>(), "Revolute joint at a world anchor; returns the link index.")
+        .def("num_links", &ArticulatedChain::NumLinks)
+        .def_property_readonly("links", &ArticulatedChain::Links, py::return_value_policy::reference)
+        .def("is_floating", &ArticulatedChain::IsFloating)
+        .def("set_joint_torque", &ArticulatedChain::SetJointTorque, py::arg("link"), py::arg("torque"))
+        .def("set_joint_torques", &ArticulatedChain::SetJointTorques, py::arg("torques"))
+        .def("joint_angle", &ArticulatedChain::GetJointAngle, py::arg("link"))
+        .def("joint_velocity", &ArticulatedChain::GetJointVelocity, py::arg("link"))
+        .def("joint_angles", &ArticulatedChain::GetJointAngles)
+        .def("joint_velocities", &ArticulatedChain::GetJointVelocities)
+        .def("set_joint_state", &ArticulatedChain::SetJointState, py::arg("link"), py::arg("angle"), py::arg("velocity")=0.0f)
+        .def("update_links", &ArticulatedChain::UpdateLinks, "Re-place every link from the root body and joint state.");
+
+    // ---------------- Sensors ----------------
+
+    py::class_<SensorConfig>(m, "SensorConfig")
+        .def(py::init<>())
+        .def_readwrite("accel_noise", &SensorConfig::accelNoise)
+        .def_readwrite("accel_bias", &SensorConfig::accelBias, "Std dev of the bias drawn on every reset.")
+        .def_readwrite("accel_bias_walk", &SensorConfig::accelBiasWalk)
+        .def_readwrite("accel_resolution", &SensorConfig::accelResolution)
+        .def_readwrite("gyro_noise", &SensorConfig::gyroNoise)
+        .def_readwrite("gyro_bias", &SensorConfig::gyroBias)
+        .def_readwrite("gyro_bias_walk", &SensorConfig::gyroBiasWalk)
+        .def_readwrite("gyro_resolution", &SensorConfig::gyroResolution)
+        .def_readwrite("position_noise", &SensorConfig::positionNoise)
+        .def_readwrite("position_rate", &SensorConfig::positionRate, "Fixes per second; 0 = one per step.")
+        .def_readwrite("position_delay", &SensorConfig::positionDelay);
+
+    py::class_<SensorSuite> sensorSuite(m, "SensorSuite");
+    py::enum_<SensorSuite::Row>(sensorSuite, "Row")
+        .value("ACCEL_X", SensorSuite::ACCEL_X)
+        .value("ACCEL_Y", SensorSuite::ACCEL_Y)
+        .value("GYRO", SensorSuite::GYRO)
+        .value("FIX_X", SensorSuite::FIX_X)
+        .value("FIX_Y", SensorSuite::FIX_Y)
+        .value("FIX_AGE", SensorSuite::FIX_AGE)
+        .export_values();
+    sensorSuite
+        .def("add", &SensorSuite::Add, py::arg("body"), py::arg("config")=SensorConfig(), py::keep_alive<1, 2>(),
+             "Attach an IMU + position fix sensor to a body; returns its column in readings().")
+        .def("clear", &SensorSuite::Clear)
+        .def("count", &SensorSuite::Count)
+        .def("reset", &SensorSuite::Reset, "Redraw biases and drop pending fixes (episode reset).")
+        .def("seed", &SensorSuite::Seed, py::arg("seed"))
+        .def("readings", [](SensorSuite& sensors) { return Eigen::MatrixXf(sensors.Readings()); },
+             "(6, N): accel x/y (body frame), gyro, fix x/y, fix age.");
+
     py::class_<Engine>(m, "Engine")
         .def(py::init<int, int, float, float, int, bool>(), 
              py::arg("width")=800, py::arg("height")=600, py::arg("scale")=50.0f, 
              py::arg("dt")=0.016f, py::arg("substeps")=10, py::arg("headless")=false)
         .def("add_body", &Engine::AddBody, py::keep_alive<1, 2>())
         .def("set_gravity", &Engine::SetGravity)
+        .def_property_readonly("sensors", &Engine::GetSensors, py::return_value_policy::reference_internal,
+                               "SensorSuite sampled on every update().")
+        .def_property("solver_mode", &Engine::GetSolverMode, &Engine::SetSolverMode,
+                      "IMPULSE (sequential impulses) or XPBD (one compliant position iteration per substep).")
+        .def_property("contact_compliance", &Engine::GetContactCompliance, &Engine::SetContactCompliance,
+                      "XPBD contact compliance (inverse stiffness, m/N); 0 = rigid.")
+        .def_property("joint_compliance", &Engine::GetJointCompliance, &Engine::SetJointCompliance,
+                      "XPBD joint compliance; 0 = rigid.")
         .def("step", &Engine::Step, "Run one simulation step. Returns False if Quit event received.")
         .def("update", &Engine::Update, "Run one physics step (forces, collision, integration).")
         .def("render_bodies", &Engine::RenderBodies, "Render all bodies + colliders.")
@@ -230,6 +655,340 @@ PYBIND11_MODULE(rigidRL, m) {
              py::return_value_policy::reference, "Add a static box collider with optional friction (0-1).")
         .def("clear_colliders", &Engine::ClearColliders, "Remove all static colliders.")
         .def("clear_bodies", &Engine::ClearBodies, "Remove all dynamic bodies (for episode reset).")
+        .def("add_joint", &Engine::AddJoint, py::arg("joint"), py::keep_alive<1, 2>())
+        .def("remove_joint", &Engine::RemoveJoint, py::arg("joint"))
+        .def("clear_joints", &Engine::ClearJoints)
+        .def_property_readonly("joints", &Engine::GetJoints, py::return_value_policy::reference_internal)
+        .def("add_articulation", &Engine::AddArticulation, py::arg("chain"), py::keep_alive<1, 2>())
+        .def("remove_articulation", &Engine::RemoveArticulation, py::arg("chain"))
+        .def("clear_articulations", &Engine::ClearArticulations)
         .def("get_renderer", &Engine::GetRenderer, py::return_value_policy::reference)
-        .def("is_headless", &Engine::IsHeadless, "Check if engine is running in headless mode.");
-}
\ No newline at end of file
+        .def("is_headless", &Engine::IsHeadless, "Check if engine is running in headless mode.")
+        .def("add_sensitivity_parameter", &Engine::AddSensitivityParameter,
+             py::arg("body"), py::arg("kind"), py::arg("motor_index")=-1,
+             "Track d(state)/d(param) with forward-mode AD. Returns the tangent column index.")
+        .def("get_sensitivity", &Engine::GetSensitivity, py::arg("body"),
+             "(6, P) sensitivities of [x, y, theta, vx, vy, omega] since the last reset.")
+        .def("reset_sensitivities", &Engine::ResetSensitivities, "Zero accumulated tangents (e.g. on episode reset).")
+        .def("clear_sensitivity_parameters", &Engine::ClearSensitivityParameters)
+        .def("num_sensitivity_parameters", &Engine::NumSensitivityParameters)
+        .def("enable_rewind", &Engine::EnableRewind, py::arg("steps"), py::arg("keyframe_interval")=16,
+             "Record the last `steps` states, keyframed every keyframe_interval and delta-encoded between.")
+        .def("disable_rewind", &Engine::DisableRewind)
+        .def("restart_rewind", &Engine::RestartRewind, "Drop the history (call after adding bodies or changing motor delays).")
+        .def("rewind", &Engine::Rewind, py::arg("steps"), "Restore the state `steps` updates back and drop the later ones.")
+        .def("rewind_available", &Engine::GetRewindAvailable)
+        .def("rewind_bytes", [](const Engine& engine) {
+            const RewindBuffer* pBuffer = engine.GetRewindBuffer();
+            return py::make_tuple(pBuffer ? pBuffer->Bytes() : 0, pBuffer ? pBuffer->MaxBytes() : 0,
+                                  pBuffer ? pBuffer->RawBytes() : 0);
+        }, "(allocated, bound, ring of steps + 1 full snapshots) in bytes.");
+
+    // ---------------- Trajectory optimization ----------------
+    // States are [x, y, theta, vx, vy, omega]; controls are motor thrusts, (num_motors, T)
+
+    py::class_<ILQRCost>(m, "ILQRCost")
+        .def(py::init<>())
+        .def_readwrite("state_target", &ILQRCost::stateTarget)
+        .def_readwrite("state_weights", &ILQRCost::stateWeights, "diag(Q) for the running cost.")
+        .def_readwrite("final_state_weights", &ILQRCost::finalStateWeights, "diag(Qf) for the final state.")
+        .def_readwrite("control_reference", &ILQRCost::controlReference, "Empty: zero thrust.")
+        .def_readwrite("control_weights", &ILQRCost::controlWeights, "diag(R); empty: 1e-3 per motor.");
+
+    py::class_<ILQRConfig>(m, "ILQRConfig")
+        .def(py::init<>())
+        .def_readwrite("max_iterations", &ILQRConfig::maxIterations)
+        .def_readwrite("tolerance", &ILQRConfig::tolerance)
+        .def_readwrite("max_line_search_steps", &ILQRConfig::maxLineSearchSteps)
+        .def_readwrite("regularization", &ILQRConfig::regularization)
+        .def_readwrite("max_regularization", &ILQRConfig::maxRegularization);
+
+    py::class_<ILQRResult>(m, "ILQRResult")
+        .def_readonly("states", &ILQRResult::states)
+        .def_readonly("controls", &ILQRResult::controls)
+        .def_readonly("feedback_gains", &ILQRResult::feedbackGains)
+        .def_readonly("cost_history", &ILQRResult::costHistory)
+        .def_readonly("cost", &ILQRResult::cost)
+        .def_readonly("iterations", &ILQRResult::iterations)
+        .def_readonly("converged", &ILQRResult::bConverged);
+
+    py::class_<ILQRSolver>(m, "ILQRSolver")
+        .def(py::init<const Engine&, const Body&, const ILQRConfig&>(),
+             py::arg("engine"), py::arg("body"), py::arg("config")=ILQRConfig(),
+             "Snapshot of the body's mass, inertia and motors and the engine's gravity, dt and substeps.")
+        .def("control_size", &ILQRSolver::ControlSize)
+        .def("control_limits", &ILQRSolver::ControlLimits, "Per-motor max_thrust (lower limit is 0).")
+        .def("dynamics", &ILQRSolver::Dynamics, py::arg("state"), py::arg("controls"))
+        .def("linearize", [](const ILQRSolver& solver, const Eigen::VectorXf& state, const Eigen::VectorXf& controls) {
+            Eigen::MatrixXf A, B;
+            solver.Linearize(state, controls, A, B);
+            return py::make_tuple(A, B);
+        }, py::arg("state"), py::arg("controls"), "Returns (A, B) = (df/dx, df/du).")
+        .def("solve", &ILQRSolver::Solve, py::arg("initial_state"), py::arg("initial_controls"), py::arg("cost"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Optimize (num_motors, T) thrusts from initial_state; returns ILQRResult.");
+
+    // ---------------- Batched differentiable dynamics ----------------
+    // Column-per-world: state (6, N), thrust (num_motors, N)
+
+    py::class_<BatchedBodyModel>(m, "BatchedBodyModel")
+        .def(py::init<>())
+        .def_static("from_body", &BatchedBodyModel::FromBody, py::arg("engine"), py::arg("body"))
+        .def_readwrite("motors", &BatchedBodyModel::motors, "Motor templates (local_x, local_y and angle are used).")
+        .def_readwrite("gravity_x", &BatchedBodyModel::gravityX)
+        .def_readwrite("gravity_y", &BatchedBodyModel::gravityY)
+        .def_readwrite("dt", &BatchedBodyModel::deltaTime)
+        .def_readwrite("substeps", &BatchedBodyModel::substeps);
+
+    m.def("batched_body_step", &BatchedBodyStep,
+          py::arg("state"), py::arg("thrust"), py::arg("mass"), py::arg("inertia"), py::arg("model"),
+          py::keep_alive<0, 1>(), py::keep_alive<0, 2>(), py::keep_alive<0, 3>(), py::keep_alive<0, 4>(),
+          "One Engine.update() of N bodies in free flight as a single differentiable op. "
+          "mass/inertia are (1, 1) shared (gradients reduced across worlds) or (1, N).");
+
+    // ---------------- Native PPO ----------------
+    // Batches are column-per-sample: observations (6, N), actions (num_motors, N)
+
+    py::enum_<CurriculumMode>(m, "CurriculumMode")
+        .value("UNIFORM", CurriculumMode::UNIFORM)
+        .value("LEARNING_PROGRESS", CurriculumMode::LEARNING_PROGRESS)
+        .value("DIFFICULTY", CurriculumMode::DIFFICULTY);
+
+    py::class_<CurriculumConfig>(m, "CurriculumConfig")
+        .def(py::init<>())
+        .def_readwrite("mode", &CurriculumConfig::mode)
+        .def_readwrite("fast_rate", &CurriculumConfig::fastRate)
+        .def_readwrite("slow_rate", &CurriculumConfig::slowRate)
+        .def_readwrite("uniform_mix", &CurriculumConfig::uniformMix)
+        .def_readwrite("min_episodes", &CurriculumConfig::minEpisodes)
+        .def_readwrite("success_radius", &CurriculumConfig::successRadius);
+
+    py::class_<CurriculumSampler::SpawnStats>(m, "SpawnStats")
+        .def_readonly("episodes", &CurriculumSampler::SpawnStats::episodes)
+        .def_readonly("success_rate", &CurriculumSampler::SpawnStats::successRate)
+        .def_readonly("fast_return", &CurriculumSampler::SpawnStats::fastReturn)
+        .def_readonly("slow_return", &CurriculumSampler::SpawnStats::slowReturn)
+        .def_readonly("fast_success", &CurriculumSampler::SpawnStats::fastSuccess)
+        .def_readonly("slow_success", &CurriculumSampler::SpawnStats::slowSuccess);
+
+    py::class_<CurriculumSampler>(m, "CurriculumSampler")
+        .def(py::init<int, const CurriculumConfig&>(), py::arg("num_spawns"), py::arg("config")=CurriculumConfig())
+        .def("num_spawns", &CurriculumSampler::NumSpawns)
+        .def("sample", py::overload_cast<float>(&CurriculumSampler::Sample, py::const_), py::arg("u"),
+             "Spawn index for a uniform draw u in [0, 1).")
+        .def("record", &CurriculumSampler::Record, py::arg("spawn"), py::arg("episode_return"), py::arg("success"))
+        .def("stats", &CurriculumSampler::Stats, py::arg("spawn"))
+        .def("probabilities", &CurriculumSampler::Probabilities)
+        .def("reset", &CurriculumSampler::Reset);
+
+    py::class_<DroneTaskConfig>(m, "DroneTaskConfig")
+        .def(py::init<>())
+        .def_readwrite("mass", &DroneTaskConfig::mass)
+        .def_readwrite("width", &DroneTaskConfig::width)
+        .def_readwrite("height", &DroneTaskConfig::height)
+        .def_readwrite("motors", &DroneTaskConfig::motors, "List of Motor templates; each world gets its own copies.")
+        .def_readwrite("target_x", &DroneTaskConfig::targetX)
+        .def_readwrite("target_y", &DroneTaskConfig::targetY)
+        .def_readwrite("spawn_points", &DroneTaskConfig::spawnPoints)
+        .def_readwrite("max_steps", &DroneTaskConfig::maxSteps)
+        .def_readwrite("dt", &DroneTaskConfig::deltaTime)
+        .def_readwrite("substeps", &DroneTaskConfig::substeps)
+        .def_readwrite("curriculum", &DroneTaskConfig::curriculum)
+        .def_readwrite("enable_sensors", &DroneTaskConfig::enableSensors)
+        .def_readwrite("sensors", &DroneTaskConfig::sensors)
+        .def_readwrite("history_length", &DroneTaskConfig::historyLength, "Frames per world in observation_history(); 0 = off.")
+        .def_readwrite("min_action_delay", &DroneTaskConfig::minActionDelay, "Actuator latency in substeps, drawn per reset.")
+        .def_readwrite("max_action_delay", &DroneTaskConfig::maxActionDelay)
+        .def_readwrite("rewind_steps", &DroneTaskConfig::rewindSteps, "Steps each world can rewind within its episode; 0 = off.")
+        .def_readwrite("rewind_keyframe_interval", &DroneTaskConfig::rewindKeyframeInterval);
+
+    py::class_<DroneVecEnv>(m, "DroneVecEnv")
+        .def(py::init<const DroneTaskConfig&, int, unsigned int>(),
+             py::arg("config"), py::arg("num_envs"), py::arg("seed")=0)
+        .def("num_envs", &DroneVecEnv::NumEnvs)
+        .def("observation_size", &DroneVecEnv::ObservationSize)
+        .def("action_size", &DroneVecEnv::ActionSize)
+        .def("reset", [](DroneVecEnv& env) { return Eigen::MatrixXf(env.Reset()); },
+             "Reset every world; returns (6, N) observations.")
+        .def("step", [](DroneVecEnv& env, const Eigen::MatrixXf& actions) {
+            {
+                py::gil_scoped_release release;
+                env.Step(actions);
+            }
+            return py::make_tuple(Eigen::MatrixXf(env.Observations()), Eigen::VectorXf(env.Rewards()),
+                                  env.Terminated(), env.Truncated());
+        }, py::arg("actions"),
+           "Step with (num_motors, N) actions in [-1, 1]. Returns (obs, rewards, terminated, truncated); "
+           "finished worlds are already reset.")
+        .def("terminal_observations", [](DroneVecEnv& env) { return Eigen::MatrixXf(env.TerminalObservations()); })
+        .def("sensor_readings", [](DroneVecEnv& env) { return Eigen::MatrixXf(env.SensorReadings()); },
+             "(6, N) IMU and position fix readings of the latest step (config.enable_sensors).")
+        .def("observation_history", [](py::object self) {
+            const ObservationHistory& history = self.cast<const DroneVecEnv&>().History();
+            py::array view(py::dtype::of<float>(),
+                           {(py::ssize_t)history.NumWorlds(), (py::ssize_t)history.Length(),
+                            (py::ssize_t)history.ObservationSize()},
+                           {(py::ssize_t)(sizeof(float) * history.WorldStride()),
+                            (py::ssize_t)(sizeof(float) * history.ObservationSize()), (py::ssize_t)sizeof(float)},
+                           history.Data(), self);
+            view.attr("setflags")(py::arg("write") = false);
+            return view;
+        }, "Read-only (N, k, 6) view of the last k observations, oldest first (no copy; "
+           "config.history_length = k). Take a new view after every step.")
+        .def("rewind_world", [](DroneVecEnv& env, int index, int steps) {
+            env.RewindWorld(index, steps);
+            return Eigen::MatrixXf(env.Observations());
+        }, py::arg("index"), py::arg("steps"),
+           "Move one world back `steps` steps within its episode (config.rewind_steps). Returns (6, N) observations.")
+        .def("rewind_available", &DroneVecEnv::RewindAvailable, py::arg("index"))
+        .def("curriculum", (CurriculumSampler& (DroneVecEnv::*)()) &DroneVecEnv::Curriculum,
+             py::return_value_policy::reference_internal);
+
+    py::class_<GaussianPolicy>(m, "GaussianPolicy")
+        .def(py::init<int, int, const std::vector<int>&, unsigned int, float>(),
+             py::arg("obs_size"), py::arg("action_size"), py::arg("hidden_sizes")=std::vector<int>{64, 64},
+             py::arg("seed")=0, py::arg("init_log_std")=0.0f)
+        .def("mean", &GaussianPolicy::Mean, py::arg("obs"), "Deterministic actions for (obs_size, B) observations.")
+        .def("value", &GaussianPolicy::Value, py::arg("obs"))
+        .def("parameters", &GaussianPolicy::Parameters, py::return_value_policy::reference_internal)
+        .def_property_readonly("log_std", [](GaussianPolicy& p) -> Tensor& { return p.LogStd(); },
+                               py::return_value_policy::reference_internal)
+        .def("save", &GaussianPolicy::Save, py::arg("path"))
+        .def_static("load", &GaussianPolicy::Load, py::arg("path"));
+
+    py::class_<PPOConfig>(m, "PPOConfig")
+        .def(py::init<>())
+        .def_readwrite("num_envs", &PPOConfig::numEnvs)
+        .def_readwrite("steps_per_env", &PPOConfig::stepsPerEnv)
+        .def_readwrite("epochs", &PPOConfig::epochs)
+        .def_readwrite("minibatch_size", &PPOConfig::minibatchSize)
+        .def_readwrite("learning_rate", &PPOConfig::learningRate)
+        .def_readwrite("gamma", &PPOConfig::gamma)
+        .def_readwrite("gae_lambda", &PPOConfig::gaeLambda)
+        .def_readwrite("max_grad_norm", &PPOConfig::maxGradNorm)
+        .def_readwrite("normalize_advantages", &PPOConfig::normalizeAdvantages)
+        .def_readwrite("loss", &PPOConfig::loss)
+        .def_readwrite("hidden_sizes", &PPOConfig::hiddenSizes)
+        .def_readwrite("init_log_std", &PPOConfig::initLogStd)
+        .def_readwrite("seed", &PPOConfig::seed);
+
+    py::class_<PPOIterationStats>(m, "PPOIterationStats")
+        .def_readonly("iteration", &PPOIterationStats::iteration)
+        .def_readonly("total_steps", &PPOIterationStats::totalSteps)
+        .def_readonly("episodes_finished", &PPOIterationStats::episodesFinished)
+        .def_readonly("mean_episode_return", &PPOIterationStats::meanEpisodeReturn)
+        .def_readonly("mean_episode_length", &PPOIterationStats::meanEpisodeLength)
+        .def_readonly("policy_loss", &PPOIterationStats::policyLoss)
+        .def_readonly("value_loss", &PPOIterationStats::valueLoss)
+        .def_readonly("entropy", &PPOIterationStats::entropy)
+        .def_readonly("approx_kl", &PPOIterationStats::approxKl)
+        .def_readonly("clip_fraction", &PPOIterationStats::clipFraction)
+        .def_readonly("rollout_ms", &PPOIterationStats::rolloutMs)
+        .def_readonly("update_ms", &PPOIterationStats::updateMs);
+
+    py::class_<PPOTrainer>(m, "PPOTrainer")
+        .def(py::init<const DroneTaskConfig&, const PPOConfig&>(), py::arg("task"), py::arg("config"))
+        .def("iterate", &PPOTrainer::Iterate, py::call_guard<py::gil_scoped_release>(),
+             "Collect one rollout and run the PPO update; returns PPOIterationStats.")
+        .def("train", &PPOTrainer::Train, py::arg("total_steps"), py::call_guard<py::gil_scoped_release>())
+        .def("policy", &PPOTrainer::Policy, py::return_value_policy::reference_internal)
+        .def("total_steps", &PPOTrainer::TotalSteps)
+        .def("save_checkpoint", &PPOTrainer::SaveCheckpoint, py::arg("path"),
+             "Policy weights, Adam moments, RNG and step counters.")
+        .def("load_checkpoint", &PPOTrainer::LoadCheckpoint, py::arg("path"),
+             "Restore a save_checkpoint() file; environments restart from fresh resets.");
+
+    // ---------------- Policy evaluation ----------------
+    py::class_<EvalCondition>(m, "EvalCondition")
+        .def(py::init<>())
+        .def(py::init([](float x, float y, unsigned int seed) { return EvalCondition{x, y, seed}; }),
+             py::arg("spawn_x"), py::arg("spawn_y"), py::arg("seed")=0)
+        .def_readwrite("spawn_x", &EvalCondition::spawnX)
+        .def_readwrite("spawn_y", &EvalCondition::spawnY)
+        .def_readwrite("seed", &EvalCondition::seed);
+
+    py::class_<EvalConfig>(m, "EvalConfig")
+        .def(py::init<>())
+        .def_readwrite("episodes_per_condition", &EvalConfig::episodesPerCondition)
+        .def_readwrite("num_worlds", &EvalConfig::numWorlds)
+        .def_readwrite("spawn_jitter", &EvalConfig::spawnJitter)
+        .def_readwrite("deterministic", &EvalConfig::deterministic)
+        .def_readwrite("success_radius", &EvalConfig::successRadius)
+        .def_readwrite("record_trajectories", &EvalConfig::recordTrajectories);
+
+    py::class_<EvalConditionResult>(m, "EvalConditionResult")
+        .def_readonly("condition", &EvalConditionResult::condition)
+        .def_readonly("returns", &EvalConditionResult::returns)
+        .def_readonly("lengths", &EvalConditionResult::lengths)
+        .def_readonly("successes", &EvalConditionResult::successes)
+        .def_readonly("mean_return", &EvalConditionResult::meanReturn)
+        .def_readonly("std_return", &EvalConditionResult::stdReturn)
+        .def_readonly("min_return", &EvalConditionResult::minReturn)
+        .def_readonly("max_return", &EvalConditionResult::maxReturn)
+        .def_readonly("mean_length", &EvalConditionResult::meanLength)
+        .def_readonly("success_rate", &EvalConditionResult::successRate)
+        .def_readonly("trajectories", &EvalConditionResult::trajectories,
+                      "Per episode (6, length + 1) states [x, y, theta, vx, vy, omega].");
+
+    py::class_<PolicyEvaluator>(m, "PolicyEvaluator")
+        .def(py::init<const DroneTaskConfig&, const EvalConfig&>(), py::arg("task"), py::arg("config")=EvalConfig())
+        .def("evaluate", py::overload_cast<const std::vector<EvalCondition>&, const GaussianPolicy&>(&PolicyEvaluator::Evaluate),
+             py::arg("conditions"), py::arg("policy"), py::call_guard<py::gil_scoped_release>())
+        .def("evaluate", py::overload_cast<const std::vector<EvalCondition>&, const EvalPolicyFn&>(&PolicyEvaluator::Evaluate),
+             py::arg("conditions"), py::arg("policy"), py::call_guard<py::gil_scoped_release>(),
+             "policy(obs) gets (6, B) observations of every running episode and returns (num_motors, B) actions.")
+        .def_property_readonly("config", &PolicyEvaluator::Config);
+
+    // ---------------- System identification ----------------
+
+    py::class_<SysIdParameter>(m, "SysIdParameter")
+        .def(py::init([](SensitivityParam kind, int motorIndex) { return SysIdParameter{kind, motorIndex}; }),
+             py::arg("kind"), py::arg("motor_index")=-1)
+        .def_readwrite("kind", &SysIdParameter::kind)
+        .def_readwrite("motor_index", &SysIdParameter::motorIndex);
+
+    py::enum_<RobustLoss>(m, "RobustLoss")
+        .value("SQUARED", RobustLoss::SQUARED)
+        .value("HUBER", RobustLoss::HUBER)
+        .value("CAUCHY", RobustLoss::CAUCHY);
+
+    py::class_<SysIdConfig>(m, "SysIdConfig")
+        .def(py::init<>())
+        .def_readwrite("max_iterations", &SysIdConfig::maxIterations)
+        .def_readwrite("tolerance", &SysIdConfig::tolerance)
+        .def_readwrite("initial_damping", &SysIdConfig::initialDamping)
+        .def_readwrite("loss", &SysIdConfig::loss)
+        .def_readwrite("loss_scale", &SysIdConfig::lossScale, "Huber/Cauchy threshold on weighted residuals.")
+        .def_readwrite("state_weights", &SysIdConfig::stateWeights, "Residual weight per state (6,).");
+
+    py::class_<SysIdSegment>(m, "SysIdSegment")
+        .def(py::init<>())
+        .def(py::init([](const Eigen::VectorXf& initialState, const Eigen::MatrixXf& commands, const Eigen::MatrixXf& states) {
+            return SysIdSegment{initialState, commands, states};
+        }), py::arg("initial_state"), py::arg("commands"), py::arg("states"))
+        .def_readwrite("initial_state", &SysIdSegment::initialState)
+        .def_readwrite("commands", &SysIdSegment::commands, "(num_motors, T) throttles in [0, 1].")
+        .def_readwrite("states", &SysIdSegment::states, "(6, T) logged state after each step.");
+
+    py::class_<SysIdResult>(m, "SysIdResult")
+        .def_readonly("parameters", &SysIdResult::parameters)
+        .def_readonly("cost_history", &SysIdResult::costHistory)
+        .def_readonly("cost", &SysIdResult::cost)
+        .def_readonly("iterations", &SysIdResult::iterations)
+        .def_readonly("converged", &SysIdResult::bConverged);
+
+    py::class_<SystemIdentifier>(m, "SystemIdentifier")
+        .def(py::init<const DroneTaskConfig&, const std::vector<SysIdParameter>&, const SysIdConfig&>(),
+             py::arg("model"), py::arg("parameters"), py::arg("config")=SysIdConfig())
+        .def("add_segment", &SystemIdentifier::AddSegment, py::arg("segment"))
+        .def("clear_segments", &SystemIdentifier::ClearSegments)
+        .def("num_segments", &SystemIdentifier::NumSegments)
+        .def("get_parameters", &SystemIdentifier::GetParameters)
+        .def("set_parameters", &SystemIdentifier::SetParameters, py::arg("values"))
+        .def("evaluate", &SystemIdentifier::Evaluate, py::call_guard<py::gil_scoped_release>(),
+             "Robust cost over every segment at the current parameters.")
+        .def("replay", &SystemIdentifier::Replay, py::arg("segment_index"),
+             "Simulated (6, T) states of one segment at the current parameters.")
+        .def("fit", &SystemIdentifier::Fit, py::call_guard<py::gil_scoped_release>(),
+             "Levenberg-Marquardt over all segments in parallel; the fitted values are kept.");
+}
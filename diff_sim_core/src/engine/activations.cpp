@@ -1,12 +1,18 @@
 #include "engine/activations.h"
+#include "engine/profiler.h"
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 Tensor relu(const Tensor& input) {
-    Tensor result(input.GetData().rows(), input.GetData().cols(), false);
-    result.SetData(input.GetData().cwiseMax(0.0f));
+    ProfileScope profile("ReLU");
+    Tensor result(input.Rows(), input.Cols(), false);
+    result.m_Data = input.m_Data.cwiseMax(0.0f);
 
     if (input.GetRequiresGrad()) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "ReLU";
+        result.SaveForBackward({&input});
         result.m_Grad.setZero();
         
         // We need to store 'input' to compute mask during backward. Be careful with const reference.
@@ -15,20 +21,28 @@ Tensor relu(const Tensor& input) {
 
         result.m_BackwardFn = [pInput](Tensor& self) {
             if (pInput->GetRequiresGrad()) {
-                Eigen::MatrixXf mask = (pInput->GetData().array() > 0.0f).cast<float>();
-                pInput->m_Grad.array() += mask.array() * self.m_Grad.array();
+                Tensor::GradAccumulator(pInput).array() +=
+                    (pInput->m_Data.array() > 0.0f).select(self.m_Grad.array(), 0.0f);
             }
         };
     }
+
+    if (input.m_Tangent.size() > 0) {
+        Eigen::Map<const Eigen::VectorXf> x(input.m_Data.data(), input.m_Data.size());
+        result.m_Tangent = ((x.array() > 0.0f).cast<float>().matrix()).asDiagonal() * input.m_Tangent;
+    }
     return result;
 }
 
 Tensor tanh(const Tensor& input) {
-    Tensor result(input.GetData().rows(), input.GetData().cols(), false);
-    result.SetData(input.GetData().array().tanh());
+    ProfileScope profile("Tanh");
+    Tensor result(input.Rows(), input.Cols(), false);
+    result.m_Data = input.m_Data.array().tanh();
 
     if (input.GetRequiresGrad()) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Tanh";
+        result.SaveForBackward({}, true);
         result.m_Grad.setZero();
         
         Tensor* pInput = (Tensor*)&input;
@@ -39,10 +53,395 @@ Tensor tanh(const Tensor& input) {
              if (pInput->GetRequiresGrad()) {
                  // dy/dx = 1 - y^2
                  // y is self.m_Data
-                 Eigen::MatrixXf deriv = 1.0f - self.GetData().array().square();
-                 pInput->m_Grad.array() += deriv.array() * self.m_Grad.array();
+                 Tensor::GradAccumulator(pInput).array() +=
+                     (1.0f - self.m_Data.array().square()) * self.m_Grad.array();
              }
         };
     }
+
+    if (input.m_Tangent.size() > 0) {
+        Eigen::Map<const Eigen::VectorXf> y(result.m_Data.data(), result.m_Data.size());
+        result.m_Tangent = (1.0f - y.array().square()).matrix().asDiagonal() * input.m_Tangent;
+    }
+    return result;
+}
+
+// ---------------- Elementwise ----------------
+// Each backward is one fused expression accumulated straight into the input
+// gradient, reading either the saved input or the output.
+
+Tensor sigmoid(const Tensor& input) {
+    ProfileScope profile("Sigmoid");
+    Tensor result(input.Rows(), input.Cols(), false);
+    result.m_Data = 1.0f / (1.0f + (-input.m_Data.array()).exp());
+
+    if (input.GetRequiresGrad()) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "Sigmoid";
+        result.SaveForBackward({}, true);
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        result.m_Children.push_back(pInput);
+
+        // dy/dx = y(1 - y)
+        result.m_BackwardFn = [pInput](Tensor& self) {
+            if (pInput->GetRequiresGrad()) {
+                Tensor::GradAccumulator(pInput).array() +=
+                    self.m_Data.array() * (1.0f - self.m_Data.array()) * self.m_Grad.array();
+            }
+        };
+    }
+
+    if (input.m_Tangent.size() > 0) {
+        Eigen::Map<const Eigen::ArrayXf> y(result.m_Data.data(), result.m_Data.size());
+        result.m_Tangent = input.m_Tangent;
+        result.m_Tangent.array().colwise() *= y * (1.0f - y);
+    }
+    return result;
+}
+
+Tensor softplus(const Tensor& input) {
+    ProfileScope profile("Softplus");
+    Tensor result(input.Rows(), input.Cols(), false);
+    // log(1 + e^x) = max(x, 0) + log(1 + e^-|x|), which never overflows
+    result.m_Data = input.m_Data.array().max(0.0f) + (-input.m_Data.array().abs()).exp().log1p();
+
+    if (input.GetRequiresGrad()) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "Softplus";
+        result.SaveForBackward({&input});
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        result.m_Children.push_back(pInput);
+
+        // dy/dx = sigmoid(x)
+        result.m_BackwardFn = [pInput](Tensor& self) {
+            if (pInput->GetRequiresGrad()) {
+                Tensor::GradAccumulator(pInput).array() +=
+                    self.m_Grad.array() / (1.0f + (-pInput->m_Data.array()).exp());
+            }
+        };
+    }
+
+    if (input.m_Tangent.size() > 0) {
+        Eigen::Map<const Eigen::ArrayXf> x(input.m_Data.data(), input.m_Data.size());
+        result.m_Tangent = input.m_Tangent;
+        result.m_Tangent.array().colwise() *= 1.0f / (1.0f + (-x).exp());
+    }
+    return result;
+}
+
+Tensor elu(const Tensor& input, float alpha) {
+    ProfileScope profile("ELU");
+    Tensor result(input.Rows(), input.Cols(), false);
+    result.m_Data = (input.m_Data.array() > 0.0f).select(
+        input.m_Data.array(), alpha * (input.m_Data.array().exp() - 1.0f));
+
+    if (input.GetRequiresGrad()) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "ELU";
+        result.SaveForBackward({}, true);
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        result.m_Children.push_back(pInput);
+
+        // dy/dx = 1 for x > 0, alpha * e^x = y + alpha otherwise (y > 0 iff x > 0)
+        result.m_BackwardFn = [pInput, alpha](Tensor& self) {
+            if (pInput->GetRequiresGrad()) {
+                Tensor::GradAccumulator(pInput).array() += (self.m_Data.array() > 0.0f).select(
+                    self.m_Grad.array(), (self.m_Data.array() + alpha) * self.m_Grad.array());
+            }
+        };
+    }
+
+    if (input.m_Tangent.size() > 0) {
+        Eigen::Map<const Eigen::ArrayXf> y(result.m_Data.data(), result.m_Data.size());
+        result.m_Tangent = input.m_Tangent;
+        result.m_Tangent.array().colwise() *= (y > 0.0f).select(Eigen::ArrayXf::Ones(y.size()), y + alpha);
+    }
+    return result;
+}
+
+// Exact GELU: x * Phi(x), Phi the standard normal CDF
+static inline float GeluForward(float x) {
+    return 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752f));
+}
+
+// d/dx [x * Phi(x)] = Phi(x) + x * phi(x)
+static inline float GeluDerivative(float x) {
+    const float INV_SQRT_2PI = 0.39894228040143268f;
+    float cdf = 0.5f * (1.0f + std::erf(x * 0.70710678118654752f));
+    return cdf + x * INV_SQRT_2PI * std::exp(-0.5f * x * x);
+}
+
+Tensor gelu(const Tensor& input) {
+    ProfileScope profile("GELU");
+    Tensor result(input.Rows(), input.Cols(), false);
+    result.m_Data = input.m_Data.unaryExpr(&GeluForward);
+
+    if (input.GetRequiresGrad()) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "GELU";
+        result.SaveForBackward({&input});
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        result.m_Children.push_back(pInput);
+
+        result.m_BackwardFn = [pInput](Tensor& self) {
+            if (pInput->GetRequiresGrad()) {
+                Tensor::GradAccumulator(pInput).array() +=
+                    pInput->m_Data.array().unaryExpr(&GeluDerivative) * self.m_Grad.array();
+            }
+        };
+    }
+
+    if (input.m_Tangent.size() > 0) {
+        Eigen::Map<const Eigen::ArrayXf> x(input.m_Data.data(), input.m_Data.size());
+        result.m_Tangent = input.m_Tangent;
+        result.m_Tangent.array().colwise() *= x.unaryExpr(&GeluDerivative);
+    }
+    return result;
+}
+
+// ---------------- Lane-wise (softmax, layer norm) ----------------
+// A lane is one column (axis 0) or one row (axis 1) of a column-major matrix.
+// Both are addressed as strided vector maps so every kernel has one code path.
+
+typedef Eigen::Map<Eigen::VectorXf, 0, Eigen::InnerStride<>> Lane;
+typedef Eigen::Map<const Eigen::VectorXf, 0, Eigen::InnerStride<>> ConstLane;
+
+struct LaneLayout {
+    int count;  // Number of lanes
+    int length; // Elements per lane
+    int step;   // Offset between the starts of consecutive lanes
+    int stride; // Offset between consecutive elements of a lane
+
+    LaneLayout(int rows, int cols, int axis) {
+        if (axis != 0 && axis != 1) throw std::runtime_error("Axis must be 0 or 1");
+        if (axis == 0) { count = cols; length = rows; step = rows; stride = 1; }
+        else           { count = rows; length = cols; step = 1; stride = rows; }
+    }
+
+    Lane Write(float* pData, int lane) const {
+        return Lane(pData + (size_t)lane * step, length, Eigen::InnerStride<>(stride));
+    }
+    ConstLane Read(const float* pData, int lane) const {
+        return ConstLane(pData + (size_t)lane * step, length, Eigen::InnerStride<>(stride));
+    }
+};
+
+// Flat column-major view of a matrix (gamma/beta are (n, 1) or (1, n))
+static Eigen::Map<const Eigen::ArrayXf> Flat(const Eigen::MatrixXf& m) {
+    return Eigen::Map<const Eigen::ArrayXf>(m.data(), m.size());
+}
+static Eigen::Map<Eigen::ArrayXf> Flat(Eigen::MatrixXf& m) {
+    return Eigen::Map<Eigen::ArrayXf>(m.data(), m.size());
+}
+
+Tensor softmax(const Tensor& input, int axis) {
+    ProfileScope profile("Softmax");
+    LaneLayout layout(input.Rows(), input.Cols(), axis);
+    Tensor result(input.Rows(), input.Cols(), false);
+    for (int l = 0; l < layout.count; ++l) {
+        ConstLane x = layout.Read(input.m_Data.data(), l);
+        Lane y = layout.Write(result.m_Data.data(), l);
+        y = (x.array() - x.maxCoeff()).exp();
+        y /= y.sum();
+    }
+
+    if (input.GetRequiresGrad()) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "Softmax";
+        result.SaveForBackward({}, true);
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        result.m_Children.push_back(pInput);
+
+        // dx = y * (g - <g, y>) per lane
+        result.m_BackwardFn = [pInput, layout](Tensor& self) {
+            if (pInput->GetRequiresGrad()) {
+                Eigen::MatrixXf& grad = Tensor::GradAccumulator(pInput);
+                for (int l = 0; l < layout.count; ++l) {
+                    ConstLane y = layout.Read(self.m_Data.data(), l);
+                    ConstLane g = layout.Read(self.m_Grad.data(), l);
+                    float dot = g.dot(y);
+                    layout.Write(grad.data(), l).array() += y.array() * (g.array() - dot);
+                }
+            }
+        };
+    }
+
+    if (input.m_Tangent.size() > 0) {
+        result.m_Tangent.resize(input.m_Tangent.rows(), input.m_Tangent.cols());
+        for (int p = 0; p < input.m_Tangent.cols(); ++p) {
+            for (int l = 0; l < layout.count; ++l) {
+                ConstLane y = layout.Read(result.m_Data.data(), l);
+                ConstLane dx = layout.Read(input.m_Tangent.col(p).data(), l);
+                float dot = dx.dot(y);
+                layout.Write(result.m_Tangent.col(p).data(), l) = y.array() * (dx.array() - dot);
+            }
+        }
+    }
+    return result;
+}
+
+Tensor log_softmax(const Tensor& input, int axis) {
+    ProfileScope profile("LogSoftmax");
+    LaneLayout layout(input.Rows(), input.Cols(), axis);
+    Tensor result(input.Rows(), input.Cols(), false);
+    for (int l = 0; l < layout.count; ++l) {
+        ConstLane x = layout.Read(input.m_Data.data(), l);
+        float maxVal = x.maxCoeff();
+        float logSum = maxVal + std::log((x.array() - maxVal).exp().sum());
+        layout.Write(result.m_Data.data(), l) = x.array() - logSum;
+    }
+
+    if (input.GetRequiresGrad()) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "LogSoftmax";
+        result.SaveForBackward({}, true);
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        result.m_Children.push_back(pInput);
+
+        // dx = g - softmax * sum(g), softmax = e^y
+        result.m_BackwardFn = [pInput, layout](Tensor& self) {
+            if (pInput->GetRequiresGrad()) {
+                Eigen::MatrixXf& grad = Tensor::GradAccumulator(pInput);
+                for (int l = 0; l < layout.count; ++l) {
+                    ConstLane y = layout.Read(self.m_Data.data(), l);
+                    ConstLane g = layout.Read(self.m_Grad.data(), l);
+                    float gSum = g.sum();
+                    layout.Write(grad.data(), l).array() += g.array() - y.array().exp() * gSum;
+                }
+            }
+        };
+    }
+
+    if (input.m_Tangent.size() > 0) {
+        result.m_Tangent.resize(input.m_Tangent.rows(), input.m_Tangent.cols());
+        for (int p = 0; p < input.m_Tangent.cols(); ++p) {
+            for (int l = 0; l < layout.count; ++l) {
+                ConstLane y = layout.Read(result.m_Data.data(), l);
+                ConstLane dx = layout.Read(input.m_Tangent.col(p).data(), l);
+                float dot = dx.dot(y.array().exp().matrix());
+                layout.Write(result.m_Tangent.col(p).data(), l) = dx.array() - dot;
+            }
+        }
+    }
+    return result;
+}
+
+Tensor layer_norm(const Tensor& input, int axis, float eps) {
+    return layer_norm(input, nullptr, nullptr, axis, eps);
+}
+
+Tensor layer_norm(const Tensor& input, const Tensor& gamma, const Tensor& beta, int axis, float eps) {
+    return layer_norm(input, &gamma, &beta, axis, eps);
+}
+
+// y = gamma * (x - mean) / sqrt(var + eps) + beta over each lane; gamma and
+// beta hold one value per lane element and are shared by all lanes
+Tensor layer_norm(const Tensor& input, const Tensor* pGamma, const Tensor* pBeta, int axis, float eps) {
+    ProfileScope profile("LayerNorm");
+    LaneLayout layout(input.Rows(), input.Cols(), axis);
+    if ((pGamma && pGamma->m_Data.size() != layout.length) ||
+        (pBeta && pBeta->m_Data.size() != layout.length)) {
+        throw std::runtime_error("LayerNorm: gamma/beta must have one element per normalized feature");
+    }
+
+    // Per-lane statistics, kept for backward so it never recomputes them
+    Eigen::VectorXf mean(layout.count);
+    Eigen::VectorXf rstd(layout.count);
+    Tensor result(input.Rows(), input.Cols(), false);
+    for (int l = 0; l < layout.count; ++l) {
+        ConstLane x = layout.Read(input.m_Data.data(), l);
+        Lane y = layout.Write(result.m_Data.data(), l);
+        mean(l) = x.mean();
+        rstd(l) = 1.0f / std::sqrt((x.array() - mean(l)).square().mean() + eps);
+        y = (x.array() - mean(l)) * rstd(l);
+        if (pGamma) y.array() *= Flat(pGamma->m_Data);
+        if (pBeta) y.array() += Flat(pBeta->m_Data);
+    }
+
+    bool bGammaGrad = pGamma && pGamma->GetRequiresGrad();
+    bool bBetaGrad = pBeta && pBeta->GetRequiresGrad();
+    if (input.GetRequiresGrad() || bGammaGrad || bBetaGrad) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "LayerNorm";
+        result.SaveForBackward({&input});
+        if (pGamma) result.SaveForBackward({pGamma});
+        result.m_Grad.setZero();
+
+        Tensor* pInput = (Tensor*)&input;
+        Tensor* pG = (Tensor*)pGamma;
+        Tensor* pB = (Tensor*)pBeta;
+        if (input.GetRequiresGrad()) result.m_Children.push_back(pInput);
+        if (bGammaGrad) result.m_Children.push_back(pG);
+        if (bBetaGrad) result.m_Children.push_back(pB);
+
+        // With xhat = (x - mean) * rstd and dxhat = g * gamma:
+        //   dx     = rstd * (dxhat - mean(dxhat) - xhat * mean(dxhat * xhat))
+        //   dgamma = sum over lanes of g * xhat,  dbeta = sum over lanes of g
+        result.m_BackwardFn = [pInput, pG, pB, layout, mean, rstd](Tensor& self) {
+            bool bInputGrad = pInput->GetRequiresGrad();
+            Eigen::MatrixXf* pGammaGrad = (pG && pG->GetRequiresGrad()) ? &Tensor::GradAccumulator(pG) : nullptr;
+            Eigen::MatrixXf* pBetaGrad = (pB && pB->GetRequiresGrad()) ? &Tensor::GradAccumulator(pB) : nullptr;
+            Eigen::MatrixXf* pInputGrad = bInputGrad ? &Tensor::GradAccumulator(pInput) : nullptr;
+
+            for (int l = 0; l < layout.count; ++l) {
+                ConstLane x = layout.Read(pInput->m_Data.data(), l);
+                ConstLane g = layout.Read(self.m_Grad.data(), l);
+                auto xhat = (x.array() - mean(l)) * rstd(l);
+
+                if (pGammaGrad) Flat(*pGammaGrad) += g.array() * xhat;
+                if (pBetaGrad) Flat(*pBetaGrad) += g.array();
+                if (!pInputGrad) continue;
+
+                float meanDx = 0.0f;
+                float meanDxXhat = 0.0f;
+                if (pG) {
+                    meanDx = (g.array() * Flat(pG->m_Data)).mean();
+                    meanDxXhat = (g.array() * Flat(pG->m_Data) * xhat).mean();
+                    layout.Write(pInputGrad->data(), l).array() +=
+                        rstd(l) * (g.array() * Flat(pG->m_Data) - meanDx - xhat * meanDxXhat);
+                } else {
+                    meanDx = g.mean();
+                    meanDxXhat = (g.array() * xhat).mean();
+                    layout.Write(pInputGrad->data(), l).array() +=
+                        rstd(l) * (g.array() - meanDx - xhat * meanDxXhat);
+                }
+            }
+        };
+    }
+
+    int numDirs = input.NumTangents();
+    if (pGamma) numDirs = std::max(numDirs, pGamma->NumTangents());
+    if (pBeta) numDirs = std::max(numDirs, pBeta->NumTangents());
+    if (numDirs > 0) {
+        // dy = gamma * rstd * (dx - mean(dx) - xhat * mean(xhat * dx)) + dgamma * xhat + dbeta
+        Eigen::MatrixXf tX = input.TangentOrZero(numDirs);
+        Eigen::MatrixXf tGamma = pGamma ? pGamma->TangentOrZero(numDirs) : Eigen::MatrixXf();
+        Eigen::MatrixXf tBeta = pBeta ? pBeta->TangentOrZero(numDirs) : Eigen::MatrixXf();
+        result.m_Tangent.resize(input.m_Data.size(), numDirs);
+        for (int p = 0; p < numDirs; ++p) {
+            for (int l = 0; l < layout.count; ++l) {
+                ConstLane x = layout.Read(input.m_Data.data(), l);
+                ConstLane dx = layout.Read(tX.col(p).data(), l);
+                Lane dy = layout.Write(result.m_Tangent.col(p).data(), l);
+                auto xhat = (x.array() - mean(l)) * rstd(l);
+                float meanXhatDx = (xhat * dx.array()).mean();
+                dy = rstd(l) * (dx.array() - dx.mean() - xhat * meanXhatDx);
+                if (pGamma) dy.array() = dy.array() * Flat(pGamma->m_Data) + tGamma.col(p).array() * xhat;
+                if (pBeta) dy += tBeta.col(p);
+            }
+        }
+    }
     return result;
 }
@@ -0,0 +1,400 @@
+#include "engine/articulated.h"
+#include "engine/engine.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// ---------------- Planar spatial helpers ----------------
+// Motion vectors (omega, vx, vy) referenced at a point; moving the reference
+// point by d gives v' = v + omega x d, force vectors transform with X^T.
+
+static Eigen::Matrix3f MotionTransform(const Eigen::Vector2f& d) {
+    Eigen::Matrix3f x = Eigen::Matrix3f::Identity();
+    x(1, 0) = -d.y();
+    x(2, 0) = d.x();
+    return x;
+}
+
+static Eigen::Vector2f Rotate(float angle, const float* pLocal) {
+    float c = std::cos(angle), s = std::sin(angle);
+    return Eigen::Vector2f(c * pLocal[0] - s * pLocal[1], s * pLocal[0] + c * pLocal[1]);
+}
+
+// omega x r
+static Eigen::Vector2f Perp(float omega, const Eigen::Vector2f& r) {
+    return Eigen::Vector2f(-omega * r.y(), omega * r.x());
+}
+
+static void ToLocal(const Body* pBody, float wx, float wy, float* pLocal) {
+    float dx = wx - pBody->GetX(), dy = wy - pBody->GetY();
+    float c = std::cos(pBody->GetRotation()), s = std::sin(pBody->GetRotation());
+    pLocal[0] = c * dx + s * dy;
+    pLocal[1] = -s * dx + c * dy;
+}
+
+// ---------------- Construction ----------------
+
+ArticulatedChain::ArticulatedChain(Body* pRoot, bool floatingBase) {
+    if (!pRoot) throw std::runtime_error("ArticulatedChain: root body is null");
+    m_bFloating = floatingBase && !pRoot->is_static;
+    Link root;
+    root.pBody = pRoot;
+    root.parent = -1;
+    root.parentAnchor[0] = root.parentAnchor[1] = 0.0f;
+    root.childAnchor[0] = root.childAnchor[1] = 0.0f;
+    root.referenceAngle = 0.0f;
+    m_Links.push_back(root);
+    m_LinkBodies.push_back(pRoot);
+    UpdateLinks();
+}
+
+int ArticulatedChain::AddLink(Body* pLink, int parent, float anchorX, float anchorY, float damping) {
+    if (!pLink) throw std::runtime_error("ArticulatedChain::AddLink: link body is null");
+    if (pLink->is_static) throw std::runtime_error("ArticulatedChain::AddLink: links must be dynamic");
+    if (parent < 0 || parent >= NumLinks()) throw std::runtime_error("ArticulatedChain::AddLink: parent out of range");
+    if (std::find(m_LinkBodies.begin(), m_LinkBodies.end(), pLink) != m_LinkBodies.end()) {
+        throw std::runtime_error("ArticulatedChain::AddLink: body is already in the chain");
+    }
+
+    Body* pParent = m_Links[parent].pBody;
+    Link link;
+    link.pBody = pLink;
+    link.parent = parent;
+    ToLocal(pParent, anchorX, anchorY, link.parentAnchor);
+    ToLocal(pLink, anchorX, anchorY, link.childAnchor);
+    link.referenceAngle = pLink->GetRotation() - pParent->GetRotation();
+    link.damping = damping;
+    link.qd = pLink->ang_vel.Get(0, 0) - (parent == 0 && !m_bFloating ? 0.0f : pParent->ang_vel.Get(0, 0));
+    m_Links.push_back(link);
+    m_LinkBodies.push_back(pLink);
+
+    UpdateLinks();
+    return NumLinks() - 1;
+}
+
+// ---------------- Joint state ----------------
+
+void ArticulatedChain::CheckJoint(int link, const char* pWhere) const {
+    if (link <= 0 || link >= NumLinks()) {
+        throw std::runtime_error(std::string("ArticulatedChain::") + pWhere + ": link " + std::to_string(link) +
+                                 " has no joint (valid: 1.." + std::to_string(NumLinks() - 1) + ")");
+    }
+}
+
+void ArticulatedChain::SetJointTorque(int link, float torque) {
+    CheckJoint(link, "SetJointTorque");
+    m_Links[link].torque = torque;
+}
+
+void ArticulatedChain::SetJointTorques(const Eigen::VectorXf& torques) {
+    if (torques.size() != NumLinks() - 1) {
+        throw std::runtime_error("ArticulatedChain::SetJointTorques: expected " + std::to_string(NumLinks() - 1) +
+                                 " torques, got " + std::to_string(torques.size()));
+    }
+    for (int i = 1; i < NumLinks(); ++i) m_Links[i].torque = torques(i - 1);
+}
+
+float ArticulatedChain::GetJointAngle(int link) const {
+    CheckJoint(link, "GetJointAngle");
+    return m_Links[link].q;
+}
+
+float ArticulatedChain::GetJointVelocity(int link) const {
+    CheckJoint(link, "GetJointVelocity");
+    return m_Links[link].qd;
+}
+
+Eigen::VectorXf ArticulatedChain::GetJointAngles() const {
+    Eigen::VectorXf q(std::max(NumLinks() - 1, 0));
+    for (int i = 1; i < NumLinks(); ++i) q(i - 1) = m_Links[i].q;
+    return q;
+}
+
+Eigen::VectorXf ArticulatedChain::GetJointVelocities() const {
+    Eigen::VectorXf qd(std::max(NumLinks() - 1, 0));
+    for (int i = 1; i < NumLinks(); ++i) qd(i - 1) = m_Links[i].qd;
+    return qd;
+}
+
+void ArticulatedChain::SetJointState(int link, float angle, float velocity) {
+    CheckJoint(link, "SetJointState");
+    m_Links[link].q = angle;
+    m_Links[link].qd = velocity;
+    UpdateLinks();
+}
+
+void ArticulatedChain::UpdateLinks() {
+    ReadRoot();
+    Kinematics(true);
+    WriteLinks();
+}
+
+// ---------------- Kinematics ----------------
+
+void ArticulatedChain::ReadRoot() {
+    Link& root = m_Links[0];
+    Body* pRoot = root.pBody;
+    root.theta = pRoot->GetRotation();
+    root.c = Eigen::Vector2f(pRoot->GetX(), pRoot->GetY());
+    if (m_bFloating) {
+        root.omega = pRoot->ang_vel.Get(0, 0);
+        root.v = Eigen::Vector2f(pRoot->vel.Get(0, 0), pRoot->vel.Get(1, 0));
+    } else {
+        root.omega = 0.0f;
+        root.v.setZero();
+    }
+    root.S.setZero();
+    root.kappa.setZero();
+}
+
+void ArticulatedChain::Kinematics(bool bVelocity) {
+    for (int i = 1; i < NumLinks(); ++i) {
+        Link& link = m_Links[i];
+        const Link& parent = m_Links[link.parent];
+        link.theta = parent.theta + link.q + link.referenceAngle;
+        Eigen::Vector2f fromParent = Rotate(parent.theta, link.parentAnchor);  // a_i - c_p
+        link.jointPoint = parent.c + fromParent;
+        Eigen::Vector2f r = -Rotate(link.theta, link.childAnchor);           // c_i - a_i
+        link.c = link.jointPoint + r;
+        link.S = Eigen::Vector3f(1.0f, -r.y(), r.x());
+        if (!bVelocity) continue;
+        link.omega = parent.omega + link.qd;
+        link.v = parent.v + Perp(parent.omega, fromParent) + Perp(link.omega, r);
+        Eigen::Vector2f centripetal = -parent.omega * parent.omega * fromParent - link.omega * link.omega * r;
+        link.kappa = Eigen::Vector3f(0.0f, centripetal.x(), centripetal.y());
+    }
+}
+
+void ArticulatedChain::WriteLinks() {
+    for (int i = 0; i < NumLinks(); ++i) {
+        const Link& link = m_Links[i];
+        Body* pBody = link.pBody;
+        if (pBody->is_static) continue;
+        if (i > 0 || m_bFloating) {
+            pBody->SetPosition(link.c.x(), link.c.y());
+            pBody->SetRotation(link.theta);
+        }
+        pBody->SetVelocity(link.v.x(), link.v.y());
+        pBody->SetAngularVelocity(link.omega);
+    }
+}
+
+// ---------------- Articulated-body algorithm ----------------
+
+void ArticulatedChain::Propagate(const std::vector<Eigen::Vector3f>& forces, bool bImpulse) {
+    int n = NumLinks();
+    for (int i = 0; i < n; ++i) {
+        Link& link = m_Links[i];
+        link.IA = Eigen::Vector3f(link.pBody->inertia.Get(0, 0), link.pBody->mass.Get(0, 0),
+                                  link.pBody->mass.Get(0, 0)).asDiagonal();
+        link.pA = -forces[i];
+    }
+
+    // Inward: articulated inertias and bias forces
+    for (int i = n - 1; i > 0; --i) {
+        Link& link = m_Links[i];
+        Link& parent = m_Links[link.parent];
+        link.U = link.IA * link.S;
+        link.D = link.S.dot(link.U);
+        float tau = bImpulse ? 0.0f : link.torque - link.damping * link.qd;
+        link.u = tau - link.S.dot(link.pA);
+        Eigen::Matrix3f Ia = link.IA - link.U * link.U.transpose() / link.D;
+        Eigen::Vector3f pa = link.pA + link.U * (link.u / link.D);
+        if (!bImpulse) pa += Ia * link.kappa;
+        Eigen::Matrix3f X = MotionTransform(link.c - parent.c);
+        parent.IA += X.transpose() * Ia * X;
+        parent.pA += X.transpose() * pa;
+    }
+
+    // Outward: accelerations
+    Link& root = m_Links[0];
+    root.A = m_bFloating ? Eigen::Vector3f(root.IA.ldlt().solve(-root.pA)) : Eigen::Vector3f::Zero();
+    for (int i = 1; i < n; ++i) {
+        Link& link = m_Links[i];
+        const Link& parent = m_Links[link.parent];
+        Eigen::Vector3f a = MotionTransform(link.c - parent.c) * parent.A;
+        if (!bImpulse) a += link.kappa;
+        link.qdd = (link.u - link.U.dot(a)) / link.D;
+        link.A = a + link.S * link.qdd;
+    }
+}
+
+// ---------------- State vector ----------------
+// [theta0, x0, y0, omega0, vx0, vy0, q_1..q_{n-1}, qd_1..qd_{n-1}]
+
+Eigen::VectorXf ArticulatedChain::GetState() const {
+    int joints = NumLinks() - 1;
+    Eigen::VectorXf x(6 + 2 * joints);
+    const Link& root = m_Links[0];
+    x.head<6>() << root.theta, root.c.x(), root.c.y(), root.omega, root.v.x(), root.v.y();
+    for (int i = 1; i <= joints; ++i) {
+        x(5 + i) = m_Links[i].q;
+        x(5 + joints + i) = m_Links[i].qd;
+    }
+    return x;
+}
+
+void ArticulatedChain::SetState(const Eigen::VectorXf& x) {
+    int joints = NumLinks() - 1;
+    Link& root = m_Links[0];
+    if (m_bFloating) {
+        root.theta = x(0);
+        root.c = Eigen::Vector2f(x(1), x(2));
+        root.omega = x(3);
+        root.v = Eigen::Vector2f(x(4), x(5));
+    }
+    for (int i = 1; i <= joints; ++i) {
+        m_Links[i].q = x(5 + i);
+        m_Links[i].qd = x(5 + joints + i);
+    }
+    Kinematics(true);
+}
+
+Eigen::VectorXf ArticulatedChain::Derivative(const Eigen::VectorXf& x) {
+    SetState(x);
+    Propagate(m_Forces, false);
+    int joints = NumLinks() - 1;
+    Eigen::VectorXf dx(x.size());
+    const Link& root = m_Links[0];
+    if (m_bFloating) {
+        dx.head<6>() << root.omega, root.v.x(), root.v.y(), root.A(0), root.A(1), root.A(2);
+    } else {
+        dx.head<6>().setZero();
+    }
+    for (int i = 1; i <= joints; ++i) {
+        dx(5 + i) = m_Links[i].qd;
+        dx(5 + joints + i) = m_Links[i].qdd;
+    }
+    return dx;
+}
+
+// ---------------- Stepping ----------------
+
+void ArticulatedChain::Step(float dt) {
+    ReadRoot();
+    Kinematics(true);
+
+    int n = NumLinks();
+    m_Forces.assign(n, Eigen::Vector3f::Zero());
+    for (int i = 0; i < n; ++i) {
+        Body* pBody = m_Links[i].pBody;
+        if (pBody->is_static) continue;
+        m_Forces[i] = Eigen::Vector3f(pBody->m_TorqueAccumulator.Get(0, 0), pBody->m_ForceAccumulator.Get(0, 0),
+                                      pBody->m_ForceAccumulator.Get(1, 0));
+        pBody->ResetForces();
+    }
+
+    // Classic RK4 over [root pose, root velocity, q, qd]; the external forces
+    // are held over the step. Four O(links) passes keep fast whips (light tether
+    // ends) stable where semi-implicit Euler gains energy.
+    Eigen::VectorXf x0 = GetState();
+    Eigen::VectorXf k1 = Derivative(x0);
+    Eigen::VectorXf k2 = Derivative(x0 + 0.5f * dt * k1);
+    Eigen::VectorXf k3 = Derivative(x0 + 0.5f * dt * k2);
+    Eigen::VectorXf k4 = Derivative(x0 + dt * k3);
+    SetState(x0 + dt / 6.0f * (k1 + 2.0f * k2 + 2.0f * k3 + k4));
+    WriteLinks();
+}
+
+// ---------------- Contact coupling ----------------
+
+void ArticulatedChain::CaptureLinkStates() {
+    for (Link& link : m_Links) {
+        Body* pBody = link.pBody;
+        link.capturedVel = Eigen::Vector3f(pBody->ang_vel.Get(0, 0), pBody->vel.Get(0, 0), pBody->vel.Get(1, 0));
+        link.capturedPos = Eigen::Vector3f(pBody->GetRotation(), pBody->GetX(), pBody->GetY());
+    }
+}
+
+void ArticulatedChain::ProjectLinkChanges() {
+    int n = NumLinks();
+    std::vector<Eigen::Vector3f> velImpulses(n, Eigen::Vector3f::Zero());
+    std::vector<Eigen::Vector3f> posImpulses(n, Eigen::Vector3f::Zero());
+    bool bChanged = false;
+    for (int i = 0; i < n; ++i) {
+        const Link& link = m_Links[i];
+        Body* pBody = link.pBody;
+        if (pBody->is_static || (i == 0 && !m_bFloating)) continue;
+        Eigen::Vector3f dv = Eigen::Vector3f(pBody->ang_vel.Get(0, 0), pBody->vel.Get(0, 0), pBody->vel.Get(1, 0)) -
+                             link.capturedVel;
+        Eigen::Vector3f dx = Eigen::Vector3f(pBody->GetRotation(), pBody->GetX(), pBody->GetY()) - link.capturedPos;
+        if (dv.isZero(0.0f) && dx.isZero(0.0f)) continue;
+        // What the change took on a free body, as a spatial impulse at the center
+        Eigen::Vector3f mass(pBody->inertia.Get(0, 0), pBody->mass.Get(0, 0), pBody->mass.Get(0, 0));
+        velImpulses[i] = mass.cwiseProduct(dv);
+        posImpulses[i] = mass.cwiseProduct(dx);
+        bChanged = true;
+    }
+    if (!bChanged) return;
+
+    // Velocities: delta qd = M^-1 J^T p
+    Link& root = m_Links[0];
+    Propagate(velImpulses, true);
+    if (m_bFloating) {
+        root.omega += root.A(0);
+        root.v += root.A.tail<2>();
+    }
+    for (int i = 1; i < n; ++i) m_Links[i].qd += m_Links[i].qdd;
+
+    // Positions: the same mass-weighted projection of the corrections
+    Propagate(posImpulses, true);
+    if (m_bFloating) {
+        root.theta += root.A(0);
+        root.c += root.A.tail<2>();
+    }
+    for (int i = 1; i < n; ++i) m_Links[i].q += m_Links[i].qdd;
+
+    Kinematics(true);
+    WriteLinks();
+}
+
+// ---------------- Engine integration ----------------
+
+void Engine::AddArticulation(ArticulatedChain* pChain) {
+    if (!pChain) throw std::runtime_error("Engine::AddArticulation: chain is null");
+    if (std::find(m_Articulations.begin(), m_Articulations.end(), pChain) != m_Articulations.end()) return;
+    for (Body* pLink : pChain->Links()) {
+        if (std::find(m_Bodies.begin(), m_Bodies.end(), pLink) != m_Bodies.end()) {
+            throw std::runtime_error("Engine::AddArticulation: a link is also added as a body");
+        }
+    }
+    m_Articulations.push_back(pChain);
+}
+
+void Engine::RemoveArticulation(ArticulatedChain* pChain) {
+    m_Articulations.erase(std::remove(m_Articulations.begin(), m_Articulations.end(), pChain), m_Articulations.end());
+}
+
+void Engine::ClearArticulations() {
+    m_Articulations.clear();
+}
+
+void Engine::ResolveArticulationContacts() {
+    // A link only sees its own mass, so one pass under-corrects a chain
+    // resting on something; repeat like the position iterations of a solver
+    for (int iteration = 0; iteration < m_PositionIterations; ++iteration) {
+        for (ArticulatedChain* pChain : m_Articulations) pChain->CaptureLinkStates();
+
+        for (size_t c = 0; c < m_Articulations.size(); ++c) {
+            const std::vector<Body*>& links = m_Articulations[c]->Links();
+            for (Body* pLink : links) {
+                if (pLink->is_static) continue;
+                for (Body* pBody : m_Bodies) {
+                    if (!m_Joints.empty() && JointPreventsCollision(pLink, pBody)) continue;
+                    ResolveCollision(pLink, pBody);
+                }
+                for (Body* pCollider : m_Colliders) {
+                    if (pCollider == links[0]) continue;  // A static root anchoring this chain
+                    ResolveCollision(pLink, pCollider);
+                }
+                // Other chains; links of the same chain never collide
+                for (size_t d = c + 1; d < m_Articulations.size(); ++d) {
+                    for (Body* pOther : m_Articulations[d]->Links()) ResolveCollision(pLink, pOther);
+                }
+            }
+        }
+
+        for (ArticulatedChain* pChain : m_Articulations) pChain->ProjectLinkChanges();
+    }
+}
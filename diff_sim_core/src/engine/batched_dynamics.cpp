@@ -0,0 +1,274 @@
+#include "engine/batched_dynamics.h"
+#include "engine/profiler.h"
+#include "engine/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+// Worlds below this many per thread aren't worth fanning out
+static const int MIN_WORLDS_PER_BLOCK = 64;
+
+BatchedBodyModel BatchedBodyModel::FromBody(const Engine& engine, const Body& body) {
+    BatchedBodyModel model;
+    for (const Motor* pMotor : body.motors) model.motors.push_back(*pMotor);
+    model.gravityX = engine.GetGravityX();
+    model.gravityY = engine.GetGravityY();
+    model.deltaTime = engine.GetDeltaTime();
+    model.substeps = engine.GetSubsteps();
+    return model;
+}
+
+// Per-motor body-frame force direction and torque arm, plus step constants
+struct StepConstants {
+    std::vector<float> dirX, dirY, arm;
+    float h;
+    float gravityX, gravityY;
+    int substeps;
+    int numMotors;
+
+    explicit StepConstants(const BatchedBodyModel& model) {
+        numMotors = (int)model.motors.size();
+        for (const Motor& motor : model.motors) {
+            float cx = std::cos(motor.angle), cy = std::sin(motor.angle);
+            dirX.push_back(cx);
+            dirY.push_back(cy);
+            // r x F in the body frame; the rotation cancels out of the 2D cross product
+            arm.push_back(motor.local_x * cy - motor.local_y * cx);
+        }
+        substeps = model.substeps;
+        h = model.deltaTime / (float)model.substeps;
+        gravityX = model.gravityX;
+        gravityY = model.gravityY;
+    }
+
+    // Body-frame force and torque of one world's thrusts (held over the control step)
+    void Wrench(const float* pThrust, float& localFx, float& localFy, float& torque) const {
+        localFx = localFy = torque = 0.0f;
+        for (int i = 0; i < numMotors; ++i) {
+            localFx += dirX[i] * pThrust[i];
+            localFy += dirY[i] * pThrust[i];
+            torque += arm[i] * pThrust[i];
+        }
+    }
+};
+
+// Same substep as Engine::Update() on a lone body: motor forces at the
+// current rotation, gravity, semi-implicit Euler. pThetas (optional) receives
+// the rotation at the start of every substep.
+static void StepWorld(const StepConstants& k, const float* pIn, const float* pThrust, float mass, float inertia,
+                      float* pOut, float* pThetas) {
+    float localFx, localFy, torque;
+    k.Wrench(pThrust, localFx, localFy, torque);
+    float invMass = 1.0f / mass;
+    float alpha = torque / inertia;
+
+    float x = pIn[0], y = pIn[1], theta = pIn[2], vx = pIn[3], vy = pIn[4], omega = pIn[5];
+    for (int step = 0; step < k.substeps; ++step) {
+        if (pThetas) pThetas[step] = theta;
+        float cosR = std::cos(theta), sinR = std::sin(theta);
+        vx += (k.gravityX + (cosR * localFx - sinR * localFy) * invMass) * k.h;
+        vy += (k.gravityY + (sinR * localFx + cosR * localFy) * invMass) * k.h;
+        x += vx * k.h;
+        y += vy * k.h;
+        omega += alpha * k.h;
+        theta += omega * k.h;
+    }
+    pOut[0] = x; pOut[1] = y; pOut[2] = theta; pOut[3] = vx; pOut[4] = vy; pOut[5] = omega;
+}
+
+// Run fn(block, begin, end) over contiguous blocks of worlds on the pool
+static void ForEachWorldBlock(int numWorlds, int numBlocks, const std::function<void(int, int, int)>& fn) {
+    GetGlobalThreadPool().ParallelFor(numBlocks, [&](int block) {
+        fn(block, block * numWorlds / numBlocks, (block + 1) * numWorlds / numBlocks);
+    });
+}
+
+static int NumWorldBlocks(int numWorlds) {
+    return std::max(1, std::min(GetNumThreads(), numWorlds / MIN_WORLDS_PER_BLOCK));
+}
+
+Tensor BatchedBodyStep(const Tensor& state, const Tensor& thrust, const Tensor& mass, const Tensor& inertia,
+                       const BatchedBodyModel& model) {
+    ProfileScope profile("BatchedBodyStep");
+    int numWorlds = state.Cols();
+    int numMotors = (int)model.motors.size();
+    if (state.Rows() != 6) {
+        throw std::runtime_error("BatchedBodyStep: state must be (6, N) [x, y, theta, vx, vy, omega]");
+    }
+    if (thrust.Rows() != numMotors || thrust.Cols() != numWorlds) {
+        throw std::runtime_error("BatchedBodyStep: thrust must be (num_motors, N)");
+    }
+    for (const Tensor* pParam : {&mass, &inertia}) {
+        if (pParam->Rows() != 1 || (pParam->Cols() != 1 && pParam->Cols() != numWorlds)) {
+            throw std::runtime_error("BatchedBodyStep: mass and inertia must be (1, 1) or (1, N)");
+        }
+    }
+    if (model.substeps <= 0) throw std::runtime_error("BatchedBodyStep: substeps must be positive");
+
+    StepConstants k(model);
+    bool bSharedMass = mass.Cols() == 1;
+    bool bSharedInertia = inertia.Cols() == 1;
+
+    Tensor result(6, numWorlds, false);
+    ForEachWorldBlock(numWorlds, NumWorldBlocks(numWorlds), [&](int, int begin, int end) {
+        for (int n = begin; n < end; ++n) {
+            StepWorld(k, state.m_Data.col(n).data(), thrust.m_Data.col(n).data(),
+                      mass.m_Data(0, bSharedMass ? 0 : n), inertia.m_Data(0, bSharedInertia ? 0 : n),
+                      result.m_Data.col(n).data(), nullptr);
+        }
+    });
+
+    if (state.m_bRequiresGrad || thrust.m_bRequiresGrad || mass.m_bRequiresGrad || inertia.m_bRequiresGrad) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "BatchedBodyStep";
+        result.SaveForBackward({&state, &thrust, &mass, &inertia});
+        result.m_Grad.setZero();
+
+        Tensor* pState = const_cast<Tensor*>(&state);
+        Tensor* pThrust = const_cast<Tensor*>(&thrust);
+        Tensor* pMass = const_cast<Tensor*>(&mass);
+        Tensor* pInertia = const_cast<Tensor*>(&inertia);
+        for (Tensor* pInput : {pState, pThrust, pMass, pInertia}) {
+            if (pInput->m_bRequiresGrad) result.m_Children.push_back(pInput);
+        }
+
+        result.m_BackwardFn = [pState, pThrust, pMass, pInertia, k, bSharedMass, bSharedInertia](Tensor& self) {
+            int numWorlds = self.m_Data.cols();
+            bool bMassGrad = pMass->m_bRequiresGrad, bInertiaGrad = pInertia->m_bRequiresGrad;
+
+            // Accumulators are fetched on this thread: each block writes its own
+            // columns, and shared-parameter gradients go through per-block sums
+            Eigen::MatrixXf* pStateGrad = pState->m_bRequiresGrad ? &Tensor::GradAccumulator(pState) : nullptr;
+            Eigen::MatrixXf* pThrustGrad = pThrust->m_bRequiresGrad ? &Tensor::GradAccumulator(pThrust) : nullptr;
+            Eigen::MatrixXf* pMassGrad = bMassGrad ? &Tensor::GradAccumulator(pMass) : nullptr;
+            Eigen::MatrixXf* pInertiaGrad = bInertiaGrad ? &Tensor::GradAccumulator(pInertia) : nullptr;
+
+            int numBlocks = NumWorldBlocks(numWorlds);
+            std::vector<float> massSums(numBlocks, 0.0f), inertiaSums(numBlocks, 0.0f);
+            ForEachWorldBlock(numWorlds, numBlocks, [&](int block, int begin, int end) {
+                std::vector<float> thetas(k.substeps);
+                float next[6];
+                for (int n = begin; n < end; ++n) {
+                    const float* pThrustCol = pThrust->m_Data.col(n).data();
+                    float m = pMass->m_Data(0, bSharedMass ? 0 : n);
+                    float I = pInertia->m_Data(0, bSharedInertia ? 0 : n);
+                    StepWorld(k, pState->m_Data.col(n).data(), pThrustCol, m, I, next, thetas.data());
+
+                    float localFx, localFy, torque;
+                    k.Wrench(pThrustCol, localFx, localFy, torque);
+
+                    // Adjoint of the substep loop, last substep first
+                    float a[6];
+                    for (int i = 0; i < 6; ++i) a[i] = self.m_Grad(i, n);
+                    float gLocalFx = 0.0f, gLocalFy = 0.0f, gTorque = 0.0f, gMass = 0.0f, gInertia = 0.0f;
+                    float hOverM = k.h / m;
+                    for (int step = k.substeps - 1; step >= 0; --step) {
+                        float cosR = std::cos(thetas[step]), sinR = std::sin(thetas[step]);
+                        float worldFx = cosR * localFx - sinR * localFy;
+                        float worldFy = sinR * localFx + cosR * localFy;
+
+                        // Positions and rotation read the updated velocities
+                        float gVx = a[3] + k.h * a[0];
+                        float gVy = a[4] + k.h * a[1];
+                        float gOmega = a[5] + k.h * a[2];
+
+                        a[2] += hOverM * (worldFx * gVy - worldFy * gVx);
+                        a[3] = gVx;
+                        a[4] = gVy;
+                        a[5] = gOmega;
+
+                        gLocalFx += hOverM * (cosR * gVx + sinR * gVy);
+                        gLocalFy += hOverM * (cosR * gVy - sinR * gVx);
+                        gTorque += k.h / I * gOmega;
+                        gMass -= hOverM / m * (worldFx * gVx + worldFy * gVy);
+                        gInertia -= k.h * torque / (I * I) * gOmega;
+                    }
+
+                    if (pStateGrad) {
+                        for (int i = 0; i < 6; ++i) (*pStateGrad)(i, n) += a[i];
+                    }
+                    if (pThrustGrad) {
+                        for (int i = 0; i < k.numMotors; ++i) {
+                            (*pThrustGrad)(i, n) += k.dirX[i] * gLocalFx + k.dirY[i] * gLocalFy + k.arm[i] * gTorque;
+                        }
+                    }
+                    if (bMassGrad) {
+                        if (bSharedMass) massSums[block] += gMass;
+                        else (*pMassGrad)(0, n) += gMass;
+                    }
+                    if (bInertiaGrad) {
+                        if (bSharedInertia) inertiaSums[block] += gInertia;
+                        else (*pInertiaGrad)(0, n) += gInertia;
+                    }
+                }
+            });
+
+            // Reduce shared parameters across worlds
+            for (int block = 0; block < numBlocks; ++block) {
+                if (bMassGrad && bSharedMass) (*pMassGrad)(0, 0) += massSums[block];
+                if (bInertiaGrad && bSharedInertia) (*pInertiaGrad)(0, 0) += inertiaSums[block];
+            }
+        };
+    }
+
+    int numDirs = std::max({state.NumTangents(), thrust.NumTangents(), mass.NumTangents(), inertia.NumTangents()});
+    if (numDirs > 0) {
+        Eigen::MatrixXf tState = state.TangentOrZero(numDirs);
+        Eigen::MatrixXf tThrust = thrust.TangentOrZero(numDirs);
+        Eigen::MatrixXf tMass = mass.TangentOrZero(numDirs);
+        Eigen::MatrixXf tInertia = inertia.TangentOrZero(numDirs);
+        result.m_Tangent.resize(6 * numWorlds, numDirs);
+
+        ForEachWorldBlock(numWorlds, NumWorldBlocks(numWorlds), [&](int, int begin, int end) {
+            for (int n = begin; n < end; ++n) {
+                const float* pThrustCol = thrust.m_Data.col(n).data();
+                int massIdx = bSharedMass ? 0 : n, inertiaIdx = bSharedInertia ? 0 : n;
+                float m = mass.m_Data(0, massIdx), I = inertia.m_Data(0, inertiaIdx);
+                float localFx, localFy, torque;
+                k.Wrench(pThrustCol, localFx, localFy, torque);
+
+                for (int d = 0; d < numDirs; ++d) {
+                    float dLocalFx = 0.0f, dLocalFy = 0.0f, dTorque = 0.0f;
+                    for (int i = 0; i < k.numMotors; ++i) {
+                        float du = tThrust(i + k.numMotors * n, d);
+                        dLocalFx += k.dirX[i] * du;
+                        dLocalFy += k.dirY[i] * du;
+                        dTorque += k.arm[i] * du;
+                    }
+                    float dm = tMass(massIdx, d), dI = tInertia(inertiaIdx, d);
+                    float dAlpha = dTorque / I - torque * dI / (I * I);
+
+                    float s[6], ds[6];
+                    for (int i = 0; i < 6; ++i) {
+                        s[i] = state.m_Data(i, n);
+                        ds[i] = tState(i + 6 * n, d);
+                    }
+                    for (int step = 0; step < k.substeps; ++step) {
+                        float cosR = std::cos(s[2]), sinR = std::sin(s[2]);
+                        float worldFx = cosR * localFx - sinR * localFy;
+                        float worldFy = sinR * localFx + cosR * localFy;
+                        float dWorldFx = -worldFy * ds[2] + cosR * dLocalFx - sinR * dLocalFy;
+                        float dWorldFy = worldFx * ds[2] + sinR * dLocalFx + cosR * dLocalFy;
+
+                        ds[3] += k.h * (dWorldFx - worldFx * dm / m) / m;
+                        ds[4] += k.h * (dWorldFy - worldFy * dm / m) / m;
+                        ds[0] += k.h * ds[3];
+                        ds[1] += k.h * ds[4];
+                        ds[5] += k.h * dAlpha;
+                        ds[2] += k.h * ds[5];
+
+                        s[3] += (k.gravityX + worldFx / m) * k.h;
+                        s[4] += (k.gravityY + worldFy / m) * k.h;
+                        s[0] += s[3] * k.h;
+                        s[1] += s[4] * k.h;
+                        s[5] += torque / I * k.h;
+                        s[2] += s[5] * k.h;
+                    }
+                    for (int i = 0; i < 6; ++i) result.m_Tangent(i + 6 * n, d) = ds[i];
+                }
+            }
+        });
+    }
+    return result;
+}
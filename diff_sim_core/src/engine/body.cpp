@@ -58,6 +58,19 @@ Body* Body::CreateStatic(float x, float y, float width, float height, float rota
 }
 
 void Body::Step(const Tensor& forces, const Tensor& torque, float dt) {
+    bool bAnyGrad = forces.GetRequiresGrad() || torque.GetRequiresGrad() ||
+                    mass.GetRequiresGrad() || inertia.GetRequiresGrad() ||
+                    pos.GetRequiresGrad() || vel.GetRequiresGrad() ||
+                    rotation.GetRequiresGrad() || ang_vel.GetRequiresGrad();
+    if (!bAnyGrad && pos.IsLeaf() && vel.IsLeaf() && rotation.IsLeaf() && ang_vel.IsLeaf()) {
+        // Nothing to differentiate: update the state buffers in place
+        vel.AddInPlace(forces, dt / mass.Get(0, 0));
+        pos.AddInPlace(vel, dt);
+        ang_vel.AddInPlace(torque, dt / inertia.Get(0, 0));
+        rotation.AddInPlace(ang_vel, dt);
+        return;
+    }
+
     // 1. Linear Acceleration: a = F / m
     std::vector<float> one = {1.0f};
     Tensor invMass = Tensor(one, false) / mass; 
@@ -90,6 +103,10 @@ void Body::Step(float dt) {
 }
 
 void Body::ApplyForce(const Tensor& f) {
+    if (m_ForceAccumulator.IsLeaf() && !m_ForceAccumulator.GetRequiresGrad() && !f.GetRequiresGrad()) {
+        m_ForceAccumulator.AddInPlace(f);
+        return;
+    }
     // If accumulator is zero (no grad), and f has grad, result has grad.
     m_ForceAccumulator = m_ForceAccumulator + f;
 }
@@ -98,55 +115,57 @@ void Body::ApplyForceAtPoint(const Tensor& force, const Tensor& point) {
     // 1. Apply Linear Force
     ApplyForce(force);
 
-    // 2. Calculate Torque = (point - pos) x force
-    // r = point - pos
+    // 2. Torque = r x F = rx * fy - ry * fx = r . (fy, -fx)
     // Note: 'point' should be world coordinates.
-
-    // Access components (select is now const-qualified)
-    Tensor px = pos.Select(0); 
-    Tensor py = pos.Select(1);
-    garbage_collector.push_back(px);
-    garbage_collector.push_back(py);
-
-    Tensor pointX = point.Select(0);
-    Tensor pointY = point.Select(1);
-    garbage_collector.push_back(pointX);
-    garbage_collector.push_back(pointY);
-
-    Tensor dx = pointX - px;
-    Tensor dy = pointY - py;
-    garbage_collector.push_back(dx);
-    garbage_collector.push_back(dy);
-
-    Tensor fx = force.Select(0);
-    Tensor fy = force.Select(1);
-    garbage_collector.push_back(fx);
-    garbage_collector.push_back(fy);
-
-    // Cross product 2D: rx * fy - ry * fx
-    Tensor t1 = dx * fy;
-    Tensor t2 = dy * fx;
-    garbage_collector.push_back(t1);
-    garbage_collector.push_back(t2);
-
-    Tensor torque = t1 - t2;
-    garbage_collector.push_back(torque);
-
-    ApplyTorque(torque);
+    Tensor& r = Keep(point - pos);
+    Tensor& fSwapped = Keep(force.Gather({1, 0}));
+    Tensor& sign = Keep(Tensor(std::vector<float>{1.0f, -1.0f}, false));
+    Tensor& fPerp = Keep(fSwapped * sign);
+    Tensor& moment = Keep(r * fPerp);
+    ApplyTorque(Keep(moment.Sum()));
 }
 
 void Body::ApplyTorque(const Tensor& t) {
+    if (m_TorqueAccumulator.IsLeaf() && !m_TorqueAccumulator.GetRequiresGrad() && !t.GetRequiresGrad()) {
+        m_TorqueAccumulator.AddInPlace(t);
+        return;
+    }
     m_TorqueAccumulator = m_TorqueAccumulator + t;
 }
 
 void Body::ResetForces() {
-    std::vector<float> zeroVec = {0.0f, 0.0f};
-    m_ForceAccumulator = Tensor(zeroVec, false);
-    
-    std::vector<float> zeroRot = {0.0f};
-    m_TorqueAccumulator = Tensor(zeroRot, false);
+    // Reuse the buffers unless a graph hangs off them
+    if (m_ForceAccumulator.IsLeaf() && !m_ForceAccumulator.GetRequiresGrad() && m_ForceAccumulator.Rows() == 2) {
+        m_ForceAccumulator.Set(0, 0, 0.0f);
+        m_ForceAccumulator.Set(1, 0, 0.0f);
+    } else {
+        std::vector<float> zeroVec = {0.0f, 0.0f};
+        m_ForceAccumulator = Tensor(zeroVec, false);
+    }
+
+    if (m_TorqueAccumulator.IsLeaf() && !m_TorqueAccumulator.GetRequiresGrad() && m_TorqueAccumulator.Rows() == 1) {
+        m_TorqueAccumulator.Set(0, 0, 0.0f);
+    } else {
+        std::vector<float> zeroRot = {0.0f};
+        m_TorqueAccumulator = Tensor(zeroRot, false);
+    }
 }
 
+// Write new values into a state Tensor, in place when nothing was built on it
+static void WriteState(Tensor& state, std::initializer_list<float> values) {
+    if (state.IsLeaf() && state.Rows() == (int)values.size() && state.Cols() == 1) {
+        int i = 0;
+        for (float v : values) state.Set(i++, 0, v);
+    } else {
+        state = Tensor(std::vector<float>(values), true);
+    }
+}
+
+void Body::SetPosition(float x, float y) { WriteState(pos, {x, y}); }
+void Body::SetVelocity(float vx, float vy) { WriteState(vel, {vx, vy}); }
+void Body::SetRotation(float theta) { WriteState(rotation, {theta}); }
+void Body::SetAngularVelocity(float omega) { WriteState(ang_vel, {omega}); }
+
 float Body::GetX() const {
     return const_cast<Tensor*>(&pos)->Get(0,0);
 }
@@ -159,53 +178,39 @@ float Body::GetRotation() const {
     return const_cast<Tensor*>(&rotation)->Get(0,0);
 }
 
-std::vector<Tensor> Body::GetCorners() {
-    std::vector<Tensor> corners;
+Tensor Body::GetCorners() {
     // Clear old graph nodes (assume single step usage)
     garbage_collector.clear();
 
-    float w = shapes[0].width;
-    float h = shapes[0].height;
-    float hw = w / 2.0f;
-    float hh = h / 2.0f;
-
-    struct Point { float x, y; };
-    // Corners: TR, TL, BL, BR
-    std::vector<Point> offsets = {
-        {hw, hh}, {-hw, hh}, {-hw, -hh}, {hw, -hh}
-    };
-
-    Tensor cosT = rotation.Cos();
-    Tensor sinT = rotation.Sin();
-    
-    // Save to GC to keep alive
-    garbage_collector.push_back(cosT);
-    garbage_collector.push_back(sinT);
-
-    Tensor px = pos.Select(0);
-    Tensor py = pos.Select(1);
-    garbage_collector.push_back(px);
-    garbage_collector.push_back(py);
-
-    for (const auto& off : offsets) {
-        // rotX = off.x * cos - off.y * sin
-        Tensor rotX = cosT * off.x - sinT * off.y;
-        garbage_collector.push_back(rotX);
-
-        // rotY = off.x * sin + off.y * cos
-        Tensor rotY = sinT * off.x + cosT * off.y;
-        garbage_collector.push_back(rotY);
-
-        Tensor finalX = px + rotX;
-        Tensor finalY = py + rotY;
-        
-        garbage_collector.push_back(finalX);
-        garbage_collector.push_back(finalY);
-
-        corners.push_back(finalX);
-        corners.push_back(finalY);
-    }
-    return corners;
+    float hw = shapes[0].width / 2.0f;
+    float hh = shapes[0].height / 2.0f;
+
+    // Local corners as columns: TR, TL, BL, BR; and the same rotated by +90 degrees
+    Eigen::MatrixXf offsets(2, 4);
+    offsets << hw, -hw, -hw, hw,
+               hh, hh, -hh, -hh;
+    Eigen::MatrixXf offsetsPerp(2, 4);
+    offsetsPerp.row(0) = -offsets.row(1);
+    offsetsPerp.row(1) = offsets.row(0);
+
+    Tensor& local = Keep(Tensor(2, 4, false));
+    local.SetData(offsets);
+    Tensor& localPerp = Keep(Tensor(2, 4, false));
+    localPerp.SetData(offsetsPerp);
+
+    // R(theta) * p = cos(theta) * p + sin(theta) * perp(p)
+    Tensor& cosT = Keep(rotation.Cos());
+    Tensor& sinT = Keep(rotation.Sin());
+    Tensor& rotA = Keep(local * cosT);
+    Tensor& rotB = Keep(localPerp * sinT);
+    Tensor& rotated = Keep(rotA + rotB);
+
+    // Broadcast the center across the four columns
+    Tensor& ones = Keep(Tensor(1, 4, false));
+    ones.SetData(Eigen::MatrixXf::Ones(1, 4));
+    Tensor& center = Keep(pos.Matmul(ones));
+
+    return rotated + center;
 }
 
 AABB Body::GetAABB() const {
@@ -236,6 +241,7 @@ void Body::ApplyMotorForces() {
     float sinR = std::sin(bodyRot);
     
     for (Motor* pMotor : motors) {
+        pMotor->AdvanceDelay();
         if (pMotor->thrust <= 0) continue;
         
         // Motor thrust direction in local space (default: up = +y)
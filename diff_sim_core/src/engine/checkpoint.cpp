@@ -0,0 +1,311 @@
+#include "engine/checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char CHECKPOINT_MAGIC[4] = {'R', 'L', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+static const uint64_t HEADER_SIZE = 32;
+static const uint64_t BLOCK_ALIGNMENT = 64;
+static const uint32_t MAX_NAME_LENGTH = 4096;
+
+static uint64_t AlignUp(uint64_t value) {
+    return (value + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+template <typename T>
+static void AppendPod(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// ---------------- CheckpointWriter ----------------
+
+void CheckpointWriter::Add(Record&& record) {
+    if (record.name.empty() || record.name.size() > MAX_NAME_LENGTH) {
+        throw std::runtime_error("CheckpointWriter: invalid entry name '" + record.name + "'");
+    }
+    for (const Record& existing : m_Records) {
+        if (existing.name == record.name) {
+            throw std::runtime_error("CheckpointWriter: duplicate entry '" + record.name + "'");
+        }
+    }
+    m_Records.push_back(std::move(record));
+}
+
+void CheckpointWriter::AddMatrix(const std::string& name, const Eigen::MatrixXf& data) {
+    Record record{name, CheckpointDType::FLOAT32, (int32_t)data.rows(), (int32_t)data.cols(), std::string()};
+    record.payload.assign(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    Add(std::move(record));
+}
+
+void CheckpointWriter::AddParameters(const std::string& prefix, const std::vector<Tensor*>& params) {
+    for (size_t i = 0; i < params.size(); ++i) {
+        AddTensor(prefix + "/" + std::to_string(i), *params[i]);
+    }
+}
+
+void CheckpointWriter::AddInt(const std::string& name, int64_t value) {
+    Record record{name, CheckpointDType::INT64, 1, 1, std::string()};
+    AppendPod(record.payload, value);
+    Add(std::move(record));
+}
+
+void CheckpointWriter::AddBytes(const std::string& name, const std::string& bytes) {
+    Add(Record{name, CheckpointDType::BYTES, 1, (int32_t)bytes.size(), bytes});
+}
+
+void CheckpointWriter::AddRng(const std::string& name, const std::mt19937& rng) {
+    std::ostringstream state;
+    state << rng;
+    AddBytes(name, state.str());
+}
+
+void CheckpointWriter::Save(const std::string& path) const {
+    // Lay the blocks out first so the table can carry final offsets
+    std::vector<uint64_t> offsets(m_Records.size());
+    uint64_t cursor = AlignUp(HEADER_SIZE);
+    for (size_t i = 0; i < m_Records.size(); ++i) {
+        offsets[i] = cursor;
+        cursor = AlignUp(cursor + m_Records[i].payload.size());
+    }
+    uint64_t tableOffset = cursor;
+
+    std::string table;
+    for (size_t i = 0; i < m_Records.size(); ++i) {
+        const Record& record = m_Records[i];
+        AppendPod(table, (uint32_t)record.name.size());
+        table += record.name;
+        AppendPod(table, (uint32_t)record.dtype);
+        AppendPod(table, record.rows);
+        AppendPod(table, record.cols);
+        AppendPod(table, offsets[i]);
+        AppendPod(table, (uint64_t)record.payload.size());
+    }
+
+    std::string header(CHECKPOINT_MAGIC, 4);
+    AppendPod(header, CHECKPOINT_VERSION);
+    AppendPod(header, BYTE_ORDER_MARK);
+    AppendPod(header, (uint32_t)m_Records.size());
+    AppendPod(header, tableOffset);
+    AppendPod(header, (uint64_t)table.size());
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("CheckpointWriter::Save: cannot open " + tmpPath);
+
+        static const char zeros[BLOCK_ALIGNMENT] = {0};
+        uint64_t written = 0;
+        auto pad = [&](uint64_t target) {
+            file.write(zeros, (std::streamsize)(target - written));
+            written = target;
+        };
+        file.write(header.data(), header.size());
+        written += header.size();
+        for (size_t i = 0; i < m_Records.size(); ++i) {
+            pad(offsets[i]);
+            file.write(m_Records[i].payload.data(), m_Records[i].payload.size());
+            written += m_Records[i].payload.size();
+        }
+        pad(tableOffset);
+        file.write(table.data(), table.size());
+        if (!file) throw std::runtime_error("CheckpointWriter::Save: write failed for " + tmpPath);
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        throw std::runtime_error("CheckpointWriter::Save: cannot replace " + path);
+    }
+#else
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("CheckpointWriter::Save: cannot replace " + path);
+    }
+#endif
+}
+
+// ---------------- Checkpoint ----------------
+
+Checkpoint::Checkpoint(const std::string& path) : m_Path(path) {
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) throw std::runtime_error("Checkpoint: cannot open " + path);
+    m_hFile = hFile;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize)) {
+        Unmap();
+        throw std::runtime_error("Checkpoint: cannot stat " + path);
+    }
+    m_Size = (size_t)fileSize.QuadPart;
+    if (m_Size > 0) {
+        m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_hMapping) m_pData = (const char*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_pData) {
+            Unmap();
+            throw std::runtime_error("Checkpoint: cannot map " + path);
+        }
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Checkpoint: cannot open " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Checkpoint: cannot stat " + path);
+    }
+    m_Size = (size_t)info.st_size;
+    if (m_Size > 0) {
+        void* pMapped = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Checkpoint: cannot map " + path);
+        }
+        m_pData = (const char*)pMapped;
+    }
+    close(fd);  // The mapping keeps the file alive
+#endif
+
+    // Header and table are validated up front; entries are trusted afterwards
+    auto fail = [&](const std::string& reason) {
+        Unmap();
+        throw std::runtime_error("Checkpoint: " + path + ": " + reason);
+    };
+    if (m_Size < HEADER_SIZE || std::memcmp(m_pData, CHECKPOINT_MAGIC, 4) != 0) fail("not a checkpoint file");
+
+    uint32_t version, byteOrder, numEntries;
+    uint64_t tableOffset, tableBytes;
+    std::memcpy(&version, m_pData + 4, 4);
+    std::memcpy(&byteOrder, m_pData + 8, 4);
+    std::memcpy(&numEntries, m_pData + 12, 4);
+    std::memcpy(&tableOffset, m_pData + 16, 8);
+    std::memcpy(&tableBytes, m_pData + 24, 8);
+    if (version != CHECKPOINT_VERSION) fail("unsupported version " + std::to_string(version));
+    if (byteOrder != BYTE_ORDER_MARK) fail("written on a machine with a different byte order");
+    if (tableOffset > m_Size || tableBytes > m_Size - tableOffset) fail("truncated entry table");
+
+    const char* pCursor = m_pData + tableOffset;
+    const char* pEnd = pCursor + tableBytes;
+    auto read = [&](void* pOut, size_t bytes) {
+        if ((size_t)(pEnd - pCursor) < bytes) fail("corrupt entry table");
+        std::memcpy(pOut, pCursor, bytes);
+        pCursor += bytes;
+    };
+    for (uint32_t i = 0; i < numEntries; ++i) {
+        uint32_t nameLength, dtype;
+        read(&nameLength, 4);
+        if (nameLength == 0 || nameLength > MAX_NAME_LENGTH) fail("corrupt entry table");
+        std::string name(nameLength, '\0');
+        read(&name[0], nameLength);
+
+        Entry entry;
+        read(&dtype, 4);
+        read(&entry.rows, 4);
+        read(&entry.cols, 4);
+        read(&entry.offset, 8);
+        read(&entry.size, 8);
+        entry.dtype = (CheckpointDType)dtype;
+
+        if (dtype > (uint32_t)CheckpointDType::BYTES || entry.rows < 0 || entry.cols < 0) fail("corrupt entry '" + name + "'");
+        if (entry.offset > m_Size || entry.size > m_Size - entry.offset) fail("entry '" + name + "' out of bounds");
+        uint64_t expected = entry.dtype == CheckpointDType::FLOAT32 ? (uint64_t)entry.rows * entry.cols * sizeof(float)
+                          : entry.dtype == CheckpointDType::INT64 ? sizeof(int64_t) : entry.size;
+        if (entry.size != expected) fail("entry '" + name + "' has the wrong size");
+        if (!m_Entries.emplace(name, entry).second) fail("duplicate entry '" + name + "'");
+        m_Names.push_back(name);
+    }
+}
+
+Checkpoint::~Checkpoint() {
+    Unmap();
+}
+
+void Checkpoint::Unmap() {
+#ifdef _WIN32
+    if (m_pData) UnmapViewOfFile(m_pData);
+    if (m_hMapping) CloseHandle((HANDLE)m_hMapping);
+    if (m_hFile) CloseHandle((HANDLE)m_hFile);
+    m_hMapping = nullptr;
+    m_hFile = nullptr;
+#else
+    if (m_pData) munmap(const_cast<char*>(m_pData), m_Size);
+#endif
+    m_pData = nullptr;
+}
+
+const Checkpoint::Entry& Checkpoint::Find(const std::string& name, CheckpointDType dtype) const {
+    auto it = m_Entries.find(name);
+    if (it == m_Entries.end()) {
+        throw std::runtime_error("Checkpoint: no entry '" + name + "' in " + m_Path);
+    }
+    if (it->second.dtype != dtype) {
+        throw std::runtime_error("Checkpoint: entry '" + name + "' has a different type");
+    }
+    return it->second;
+}
+
+int Checkpoint::Rows(const std::string& name) const {
+    auto it = m_Entries.find(name);
+    if (it == m_Entries.end()) throw std::runtime_error("Checkpoint: no entry '" + name + "' in " + m_Path);
+    return it->second.rows;
+}
+
+int Checkpoint::Cols(const std::string& name) const {
+    auto it = m_Entries.find(name);
+    if (it == m_Entries.end()) throw std::runtime_error("Checkpoint: no entry '" + name + "' in " + m_Path);
+    return it->second.cols;
+}
+
+Eigen::Map<const Eigen::MatrixXf> Checkpoint::Matrix(const std::string& name) const {
+    const Entry& entry = Find(name, CheckpointDType::FLOAT32);
+    return Eigen::Map<const Eigen::MatrixXf>(reinterpret_cast<const float*>(m_pData + entry.offset),
+                                             entry.rows, entry.cols);
+}
+
+int64_t Checkpoint::Int(const std::string& name) const {
+    const Entry& entry = Find(name, CheckpointDType::INT64);
+    int64_t value;
+    std::memcpy(&value, m_pData + entry.offset, sizeof(value));
+    return value;
+}
+
+std::string Checkpoint::Bytes(const std::string& name) const {
+    const Entry& entry = Find(name, CheckpointDType::BYTES);
+    return std::string(m_pData + entry.offset, (size_t)entry.size);
+}
+
+void Checkpoint::LoadTensor(const std::string& name, Tensor& target) const {
+    Eigen::Map<const Eigen::MatrixXf> data = Matrix(name);
+    if (data.rows() != target.Rows() || data.cols() != target.Cols()) {
+        throw std::runtime_error("Checkpoint: entry '" + name + "' is (" + std::to_string(data.rows()) + ", " +
+                                 std::to_string(data.cols()) + "), target Tensor is (" +
+                                 std::to_string(target.Rows()) + ", " + std::to_string(target.Cols()) + ")");
+    }
+    target.SetData(data);
+}
+
+void Checkpoint::LoadParameters(const std::string& prefix, const std::vector<Tensor*>& params) const {
+    for (size_t i = 0; i < params.size(); ++i) {
+        LoadTensor(prefix + "/" + std::to_string(i), *params[i]);
+    }
+}
+
+void Checkpoint::LoadRng(const std::string& name, std::mt19937& rng) const {
+    std::istringstream state(Bytes(name));
+    state >> rng;
+    if (!state) throw std::runtime_error("Checkpoint: entry '" + name + "' is not an RNG state");
+}
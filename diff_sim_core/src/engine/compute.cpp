@@ -0,0 +1,109 @@
+#include "engine/compute.h"
+#include "engine/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+static std::atomic<int> s_IntraOpThreads(0);
+static std::atomic<int64_t> s_GemmParallelThreshold(int64_t(1) << 20);
+
+// Smallest block worth handing to a thread (rows/cols of C, or reduction depth)
+static const int MIN_BLOCK = 32;
+
+void SetIntraOpThreads(int numThreads) {
+    s_IntraOpThreads.store(numThreads);
+}
+
+int GetIntraOpThreads() {
+    int poolThreads = GetNumThreads();
+    int requested = s_IntraOpThreads.load();
+    return requested <= 0 ? poolThreads : std::min(requested, poolThreads);
+}
+
+void SetGemmParallelThreshold(int64_t minMacs) {
+    s_GemmParallelThreshold.store(minMacs);
+}
+
+int64_t GetGemmParallelThreshold() {
+    return s_GemmParallelThreshold.load();
+}
+
+// Parallelism comes from our pool only; Eigen must not add its own on top
+static void DisableEigenThreading() {
+    static std::once_flag once;
+    std::call_once(once, []() { Eigen::setNbThreads(1); });
+}
+
+// Split [0, total) into 'parts' contiguous ranges
+static void SplitRange(int total, int parts, int part, int& begin, int& count) {
+    int base = total / parts;
+    int extra = total % parts;
+    begin = part * base + std::min(part, extra);
+    count = base + (part < extra ? 1 : 0);
+}
+
+template <typename Lhs, typename Rhs>
+static void GemmImpl(const Lhs& lhs, const Rhs& rhs, Eigen::MatrixXf& C, bool bAccumulate) {
+    int m = (int)lhs.rows();
+    int k = (int)lhs.cols();
+    int n = (int)rhs.cols();
+
+    if (!bAccumulate) {
+        C.resize(m, n);
+    }
+
+    int64_t macs = (int64_t)m * n * k;
+    int numThreads = GetIntraOpThreads();
+    if (numThreads <= 1 || macs < GetGemmParallelThreshold() || ThreadPool::InWorker()) {
+        if (bAccumulate) C.noalias() += lhs * rhs;
+        else C.noalias() = lhs * rhs;
+        return;
+    }
+    DisableEigenThreading();
+
+    ThreadPool& pool = GetGlobalThreadPool();
+
+    // Prefer splitting the output: blocks are disjoint, no reduction needed
+    if (n >= numThreads * MIN_BLOCK || (n >= m && n >= numThreads * 4)) {
+        int parts = std::min(numThreads, std::max(1, n / 4));
+        pool.ParallelFor(parts, [&](int part) {
+            int j0, cols;
+            SplitRange(n, parts, part, j0, cols);
+            if (bAccumulate) C.middleCols(j0, cols).noalias() += lhs * rhs.middleCols(j0, cols);
+            else C.middleCols(j0, cols).noalias() = lhs * rhs.middleCols(j0, cols);
+        });
+        return;
+    }
+    if (m >= numThreads * MIN_BLOCK || m >= numThreads * 4) {
+        int parts = std::min(numThreads, std::max(1, m / 4));
+        pool.ParallelFor(parts, [&](int part) {
+            int i0, rows;
+            SplitRange(m, parts, part, i0, rows);
+            if (bAccumulate) C.middleRows(i0, rows).noalias() += lhs.middleRows(i0, rows) * rhs;
+            else C.middleRows(i0, rows).noalias() = lhs.middleRows(i0, rows) * rhs;
+        });
+        return;
+    }
+
+    // Small output, long reduction (e.g. weight gradients over a large batch):
+    // split k and sum the partial products
+    int parts = std::min(numThreads, std::max(1, k / MIN_BLOCK));
+    std::vector<Eigen::MatrixXf> partials(parts);
+    pool.ParallelFor(parts, [&](int part) {
+        int k0, depth;
+        SplitRange(k, parts, part, k0, depth);
+        partials[part].noalias() = lhs.middleCols(k0, depth) * rhs.middleRows(k0, depth);
+    });
+    if (!bAccumulate) C.setZero();
+    for (const Eigen::MatrixXf& partial : partials) C += partial;
+}
+
+void Gemm(const Eigen::MatrixXf& A, bool bTransA,
+          const Eigen::MatrixXf& B, bool bTransB,
+          Eigen::MatrixXf& C, bool bAccumulate) {
+    if (bTransA && bTransB) GemmImpl(A.transpose(), B.transpose(), C, bAccumulate);
+    else if (bTransA) GemmImpl(A.transpose(), B, C, bAccumulate);
+    else if (bTransB) GemmImpl(A, B.transpose(), C, bAccumulate);
+    else GemmImpl(A, B, C, bAccumulate);
+}
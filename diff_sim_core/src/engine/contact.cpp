@@ -108,3 +108,11 @@ void ContactManager::Clear() {
     m_ManifoldCache.clear();
     m_ActiveManifolds.clear();
 }
+
+int64_t ContactManager::MemoryBytes() const {
+    // Hash nodes carry the key/value pair plus a next pointer and cached hash
+    int64_t nodeBytes = sizeof(ContactKey) + sizeof(ContactManifold) + 2 * sizeof(void*);
+    return (int64_t)m_ManifoldCache.size() * nodeBytes
+         + (int64_t)m_ManifoldCache.bucket_count() * sizeof(void*)
+         + (int64_t)m_ActiveManifolds.capacity() * sizeof(ContactManifold*);
+}
@@ -0,0 +1,124 @@
+#include "engine/curriculum.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+// x += rate * (value - x), retried until no other thread got in between
+static void UpdateEma(std::atomic<float>& ema, float rate, float value) {
+    float current = ema.load(std::memory_order_relaxed);
+    while (!ema.compare_exchange_weak(current, current + rate * (value - current), std::memory_order_relaxed)) {
+    }
+}
+
+// EMAs start at zero; divide out the missing weight of the first n updates
+static float BiasCorrected(float ema, float rate, int64_t n) {
+    if (n <= 0) return 0.0f;
+    float seen = 1.0f - std::pow(1.0f - rate, (float)n);
+    return seen > 0.0f ? ema / seen : ema;
+}
+
+CurriculumSampler::CurriculumSampler(int numSpawns, const CurriculumConfig& config)
+    : m_NumSpawns(numSpawns), m_Config(config), m_pSlots(new Slot[numSpawns > 0 ? numSpawns : 1])
+{
+    if (numSpawns <= 0) throw std::runtime_error("CurriculumSampler: numSpawns must be positive");
+    if (config.fastRate <= 0.0f || config.fastRate > 1.0f || config.slowRate <= 0.0f || config.slowRate > 1.0f) {
+        throw std::runtime_error("CurriculumSampler: EMA rates must be in (0, 1]");
+    }
+    if (config.uniformMix < 0.0f || config.uniformMix > 1.0f) {
+        throw std::runtime_error("CurriculumSampler: uniformMix must be in [0, 1]");
+    }
+}
+
+void CurriculumSampler::Record(int spawn, float episodeReturn, bool success) {
+    if (spawn < 0 || spawn >= m_NumSpawns) throw std::runtime_error("CurriculumSampler::Record: spawn out of range");
+    Slot& slot = m_pSlots[spawn];
+    float s = success ? 1.0f : 0.0f;
+    UpdateEma(slot.fastReturn, m_Config.fastRate, episodeReturn);
+    UpdateEma(slot.slowReturn, m_Config.slowRate, episodeReturn);
+    UpdateEma(slot.fastSuccess, m_Config.fastRate, s);
+    UpdateEma(slot.slowSuccess, m_Config.slowRate, s);
+    if (success) slot.successes.fetch_add(1, std::memory_order_relaxed);
+    // Counted last so readers never bias-correct an EMA that has not been updated yet
+    slot.episodes.fetch_add(1, std::memory_order_release);
+}
+
+CurriculumSampler::SpawnStats CurriculumSampler::Stats(int spawn) const {
+    if (spawn < 0 || spawn >= m_NumSpawns) throw std::runtime_error("CurriculumSampler::Stats: spawn out of range");
+    const Slot& slot = m_pSlots[spawn];
+    SpawnStats stats;
+    stats.episodes = slot.episodes.load(std::memory_order_acquire);
+    int64_t n = stats.episodes;
+    stats.successRate = n > 0 ? (float)slot.successes.load(std::memory_order_relaxed) / (float)n : 0.0f;
+    stats.fastReturn = BiasCorrected(slot.fastReturn.load(std::memory_order_relaxed), m_Config.fastRate, n);
+    stats.slowReturn = BiasCorrected(slot.slowReturn.load(std::memory_order_relaxed), m_Config.slowRate, n);
+    stats.fastSuccess = BiasCorrected(slot.fastSuccess.load(std::memory_order_relaxed), m_Config.fastRate, n);
+    stats.slowSuccess = BiasCorrected(slot.slowSuccess.load(std::memory_order_relaxed), m_Config.slowRate, n);
+    return stats;
+}
+
+float CurriculumSampler::Weight(const SpawnStats& stats) const {
+    switch (m_Config.mode) {
+        case CurriculumMode::LEARNING_PROGRESS:
+            return std::abs(stats.fastReturn - stats.slowReturn);
+        case CurriculumMode::DIFFICULTY:
+            return std::min(std::max(1.0f - stats.fastSuccess, 0.0f), 1.0f);
+        case CurriculumMode::UNIFORM:
+        default:
+            return 1.0f;
+    }
+}
+
+Eigen::VectorXf CurriculumSampler::Probabilities() const {
+    Eigen::VectorXf weights(m_NumSpawns);
+    std::vector<uint8_t> unexplored(m_NumSpawns, 0);
+    float maxWeight = 0.0f;
+    for (int i = 0; i < m_NumSpawns; ++i) {
+        SpawnStats stats = Stats(i);
+        if (m_Config.mode != CurriculumMode::UNIFORM && stats.episodes < m_Config.minEpisodes) {
+            unexplored[i] = 1;
+            weights(i) = 0.0f;
+            continue;
+        }
+        weights(i) = Weight(stats);
+        maxWeight = std::max(maxWeight, weights(i));
+    }
+    for (int i = 0; i < m_NumSpawns; ++i) {
+        if (unexplored[i]) weights(i) = maxWeight > 0.0f ? maxWeight : 1.0f;
+    }
+
+    float total = weights.sum();
+    float uniform = 1.0f / (float)m_NumSpawns;
+    if (!(total > 0.0f)) return Eigen::VectorXf::Constant(m_NumSpawns, uniform);
+    return (m_Config.uniformMix * uniform + (1.0f - m_Config.uniformMix) / total * weights.array()).matrix();
+}
+
+int CurriculumSampler::Sample(float u) const {
+    if (m_Config.mode == CurriculumMode::UNIFORM) {
+        return std::min((int)(u * (float)m_NumSpawns), m_NumSpawns - 1);
+    }
+    Eigen::VectorXf probabilities = Probabilities();
+    float cumulative = 0.0f;
+    for (int i = 0; i < m_NumSpawns - 1; ++i) {
+        cumulative += probabilities(i);
+        if (u < cumulative) return i;
+    }
+    return m_NumSpawns - 1;
+}
+
+int CurriculumSampler::Sample(std::mt19937& rng) const {
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    return Sample(dist(rng));
+}
+
+void CurriculumSampler::Reset() {
+    for (int i = 0; i < m_NumSpawns; ++i) {
+        Slot& slot = m_pSlots[i];
+        slot.episodes.store(0, std::memory_order_relaxed);
+        slot.successes.store(0, std::memory_order_relaxed);
+        slot.fastReturn.store(0.0f, std::memory_order_relaxed);
+        slot.slowReturn.store(0.0f, std::memory_order_relaxed);
+        slot.fastSuccess.store(0.0f, std::memory_order_relaxed);
+        slot.slowSuccess.store(0.0f, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,278 @@
+#include "engine/drone_task.h"
+#include "engine/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// One simulated drone. Declaration order matters: the engine only holds raw
+// pointers to the body, and the body to its motors, so they go first.
+struct DroneVecEnv::World {
+    std::vector<std::unique_ptr<Motor>> motors;
+    std::unique_ptr<Body> pDrone;
+    std::unique_ptr<Engine> pEngine;
+    std::mt19937 rng;
+    int spawnIndex = -1;  // Into config.spawnPoints; -1 after ResetWorldAt()
+    int stepCount = 0;
+    float episodeReturn = 0.0f;
+    std::vector<float> returns;  // Episode return after step t at t % (rewindSteps + 1)
+
+    // Totals of the episode that ended on the latest Step()
+    float lastReturn = 0.0f;
+    int lastLength = 0;
+};
+
+DroneVecEnv::DroneVecEnv(const DroneTaskConfig& config, int numEnvs, unsigned int seed)
+    : m_Config(config)
+{
+    if (numEnvs <= 0) throw std::runtime_error("DroneVecEnv: numEnvs must be positive");
+    if (config.motors.empty()) throw std::runtime_error("DroneVecEnv: the drone needs at least one motor");
+    if (config.spawnPoints.empty()) throw std::runtime_error("DroneVecEnv: no spawn points");
+    if (config.historyLength < 0) throw std::runtime_error("DroneVecEnv: historyLength must be non-negative");
+    if (config.minActionDelay < 0 || config.maxActionDelay < config.minActionDelay) {
+        throw std::runtime_error("DroneVecEnv: action delays must satisfy 0 <= minActionDelay <= maxActionDelay");
+    }
+    if (config.rewindSteps < 0) throw std::runtime_error("DroneVecEnv: rewindSteps must be non-negative");
+    m_pCurriculum.reset(new CurriculumSampler((int)config.spawnPoints.size(), config.curriculum));
+
+    for (int i = 0; i < numEnvs; ++i) {
+        std::unique_ptr<World> pWorld(new World());
+        pWorld->rng.seed(seed + 7919u * (unsigned int)i);
+
+        pWorld->pEngine.reset(new Engine(800, 600, 50.0f, config.deltaTime, config.substeps, true));
+        pWorld->pEngine->SetGravity(0.0f, -9.81f);
+        pWorld->pEngine->AddCollider(0.0f, -1.0f, 20.0f, 1.0f, 0.0f);
+
+        pWorld->pDrone.reset(new Body(0.0f, 0.0f, config.mass, config.width, config.height));
+        for (const Motor& motorConfig : config.motors) {
+            pWorld->motors.emplace_back(new Motor(motorConfig));
+            pWorld->pDrone->AddMotor(pWorld->motors.back().get());
+        }
+
+        // Rollouts never differentiate through the physics: keep every state
+        // a plain leaf so Body::Step takes its in-place path
+        Body& drone = *pWorld->pDrone;
+        drone.pos.SetRequiresGrad(false);
+        drone.vel.SetRequiresGrad(false);
+        drone.rotation.SetRequiresGrad(false);
+        drone.ang_vel.SetRequiresGrad(false);
+        drone.mass.SetRequiresGrad(false);
+        drone.inertia.SetRequiresGrad(false);
+
+        pWorld->pEngine->AddBody(pWorld->pDrone.get());
+        if (config.enableSensors) {
+            SensorSuite& sensors = pWorld->pEngine->GetSensors();
+            sensors.Seed(seed + 7919u * (unsigned int)i + 1u);
+            sensors.Add(pWorld->pDrone.get(), config.sensors);
+        }
+        if (config.rewindSteps > 0) {
+            pWorld->pEngine->EnableRewind(config.rewindSteps, config.rewindKeyframeInterval);
+            pWorld->returns.assign(config.rewindSteps + 1, 0.0f);
+        }
+        m_Worlds.push_back(std::move(pWorld));
+    }
+
+    m_Observations.resize(OBS_SIZE, numEnvs);
+    m_TerminalObservations.resize(OBS_SIZE, numEnvs);
+    m_Rewards = Eigen::VectorXf::Zero(numEnvs);
+    m_Terminated.assign(numEnvs, 0);
+    m_Truncated.assign(numEnvs, 0);
+    m_SensorReadings = Eigen::MatrixXf::Zero(SensorSuite::ROWS, config.enableSensors ? numEnvs : 0);
+    if (config.historyLength > 0) {
+        m_pHistory.reset(new ObservationHistory(numEnvs, config.historyLength, OBS_SIZE));
+    }
+}
+
+DroneVecEnv::~DroneVecEnv() = default;
+
+void DroneVecEnv::ResetWorld(int index) {
+    World& world = *m_Worlds[index];
+    if (m_Config.curriculum.mode == CurriculumMode::UNIFORM) {
+        std::uniform_int_distribution<int> pick(0, (int)m_Config.spawnPoints.size() - 1);
+        world.spawnIndex = pick(world.rng);
+    } else {
+        world.spawnIndex = m_pCurriculum->Sample(world.rng);
+    }
+    const std::pair<float, float>& spawn = m_Config.spawnPoints[world.spawnIndex];
+    PlaceWorld(index, spawn.first, spawn.second, world.rng);
+}
+
+void DroneVecEnv::PlaceWorld(int index, float x, float y, std::mt19937& rng) {
+    World& world = *m_Worlds[index];
+    Body& drone = *world.pDrone;
+    drone.SetPosition(x, y);
+    drone.SetVelocity(0.0f, 0.0f);
+    drone.SetRotation(0.0f);
+    drone.SetAngularVelocity(0.0f);
+    drone.ResetForces();
+    // Commands still in flight belong to the old episode
+    int delay = m_Config.minActionDelay;
+    if (m_Config.maxActionDelay > delay) {
+        std::uniform_int_distribution<int> pick(m_Config.minActionDelay, m_Config.maxActionDelay);
+        delay = pick(rng);
+    }
+    for (const std::unique_ptr<Motor>& pMotor : world.motors) {
+        pMotor->ResetThrust(0.0f);
+        if (pMotor->GetDelay() != delay) pMotor->SetDelay(delay);
+    }
+    world.pEngine->GetSensors().Reset();
+    world.stepCount = 0;
+    world.episodeReturn = 0.0f;
+    WriteSensors(index);
+    // The delay may have changed the state layout; history stays within the episode
+    if (m_Config.rewindSteps > 0) {
+        world.pEngine->RestartRewind();
+        world.returns[0] = 0.0f;
+    }
+}
+
+void DroneVecEnv::WriteSensors(int index) {
+    if (!m_Config.enableSensors) return;
+    m_SensorReadings.col(index) = m_Worlds[index]->pEngine->GetSensors().Readings().col(0);
+}
+
+void DroneVecEnv::ResetWorldAt(int index, float x, float y, std::mt19937& rng) {
+    if (index < 0 || index >= NumEnvs()) throw std::runtime_error("DroneVecEnv::ResetWorldAt: index out of range");
+    PlaceWorld(index, x, y, rng);
+    m_Worlds[index]->spawnIndex = -1;
+    WriteObservation(index, m_Observations);
+    WriteHistory(index, true);
+}
+
+const Eigen::MatrixXf& DroneVecEnv::Reset() {
+    for (int i = 0; i < NumEnvs(); ++i) {
+        ResetWorld(i);
+        WriteObservation(i, m_Observations);
+        WriteHistory(i, true);
+    }
+    return m_Observations;
+}
+
+const ObservationHistory& DroneVecEnv::History() const {
+    if (!m_pHistory) throw std::runtime_error("DroneVecEnv::History: historyLength is 0");
+    return *m_pHistory;
+}
+
+// The step's observation becomes the newest frame; a reset world starts from zeros
+void DroneVecEnv::WriteHistory(int index, bool bClear) {
+    if (!m_pHistory) return;
+    if (bClear) m_pHistory->Clear(index);
+    m_pHistory->Write(index, m_Observations.col(index).data());
+}
+
+void DroneVecEnv::WriteObservation(int index, Eigen::MatrixXf& target) const {
+    const Body& drone = *m_Worlds[index]->pDrone;
+    target(0, index) = m_Config.targetX - drone.GetX();
+    target(1, index) = m_Config.targetY - drone.GetY();
+    target(2, index) = drone.vel.Get(0, 0);
+    target(3, index) = drone.vel.Get(1, 0);
+    target(4, index) = drone.GetRotation();
+    target(5, index) = drone.ang_vel.Get(0, 0);
+}
+
+float DroneVecEnv::ComputeReward(int index) const {
+    const Body& drone = *m_Worlds[index]->pDrone;
+    float dx = m_Config.targetX - drone.GetX();
+    float dy = m_Config.targetY - drone.GetY();
+    float dist = std::sqrt(dx * dx + dy * dy);
+
+    // Exponential distance reward (stronger gradient as we get close)
+    float reward = std::exp(-dist);
+
+    // Bonus for being very close
+    if (dist < 0.5f) reward += 2.0f;
+    if (dist < 0.2f) reward += 5.0f;
+
+    // Crash penalty
+    if (drone.GetY() < 0.1f) reward -= 10.0f;
+
+    return reward;
+}
+
+bool DroneVecEnv::IsTerminated(int index) const {
+    const Body& drone = *m_Worlds[index]->pDrone;
+    // Crashed into ground, or flipped over
+    return drone.GetY() < 0.1f || std::abs(drone.GetRotation()) > (float)M_PI / 2.0f;
+}
+
+void DroneVecEnv::Step(const Eigen::MatrixXf& actions) {
+    int numEnvs = NumEnvs();
+    if (actions.rows() != ActionSize() || actions.cols() != numEnvs) {
+        throw std::runtime_error("DroneVecEnv::Step: actions must be (num_motors, num_envs)");
+    }
+
+    auto stepRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            World& world = *m_Worlds[i];
+            for (int m = 0; m < (int)world.motors.size(); ++m) {
+                Motor& motor = *world.motors[m];
+                float a = std::min(std::max(actions(m, i), -1.0f), 1.0f);
+                motor.SetThrust(0.5f * (a + 1.0f) * motor.max_thrust);
+            }
+            world.pEngine->Update();
+            world.stepCount++;
+            WriteSensors(i);
+
+            m_Rewards(i) = ComputeReward(i);
+            world.episodeReturn += m_Rewards(i);
+            if (!world.returns.empty()) world.returns[world.stepCount % world.returns.size()] = world.episodeReturn;
+            m_Terminated[i] = IsTerminated(i) ? 1 : 0;
+            m_Truncated[i] = (!m_Terminated[i] && world.stepCount >= m_Config.maxSteps) ? 1 : 0;
+
+            WriteObservation(i, m_TerminalObservations);
+            if (m_Terminated[i] || m_Truncated[i]) {
+                world.lastReturn = world.episodeReturn;
+                world.lastLength = world.stepCount;
+                if (world.spawnIndex >= 0) {
+                    float dx = m_TerminalObservations(0, i);
+                    float dy = m_TerminalObservations(1, i);
+                    bool success = !m_Terminated[i] &&
+                                   std::sqrt(dx * dx + dy * dy) < m_Config.curriculum.successRadius;
+                    m_pCurriculum->Record(world.spawnIndex, world.episodeReturn, success);
+                }
+                ResetWorld(i);
+                WriteObservation(i, m_Observations);
+                WriteHistory(i, true);
+            } else {
+                m_Observations.col(i) = m_TerminalObservations.col(i);
+                WriteHistory(i, false);
+            }
+        }
+    };
+
+    if (m_pHistory) m_pHistory->Advance();
+
+    // One contiguous block of worlds per thread
+    int numBlocks = std::min(numEnvs, GetNumThreads());
+    GetGlobalThreadPool().ParallelFor(numBlocks, [&](int block) {
+        stepRange(block * numEnvs / numBlocks, (block + 1) * numEnvs / numBlocks);
+    });
+
+    // Episode bookkeeping stays on the calling thread
+    for (int i = 0; i < numEnvs; ++i) {
+        if (!m_Terminated[i] && !m_Truncated[i]) continue;
+        m_FinishedReturns.push_back(m_Worlds[i]->lastReturn);
+        m_FinishedLengths.push_back(m_Worlds[i]->lastLength);
+    }
+}
+
+void DroneVecEnv::RewindWorld(int index, int steps) {
+    if (index < 0 || index >= NumEnvs()) throw std::runtime_error("DroneVecEnv::RewindWorld: index out of range");
+    if (m_Config.rewindSteps <= 0) throw std::runtime_error("DroneVecEnv::RewindWorld: rewindSteps is 0");
+    World& world = *m_Worlds[index];
+    world.pEngine->Rewind(steps);
+    world.stepCount -= steps;
+    world.episodeReturn = world.returns[world.stepCount % world.returns.size()];
+    WriteObservation(index, m_Observations);
+}
+
+int DroneVecEnv::RewindAvailable(int index) const {
+    if (index < 0 || index >= NumEnvs()) throw std::runtime_error("DroneVecEnv::RewindAvailable: index out of range");
+    return m_Worlds[index]->pEngine->GetRewindAvailable();
+}
+
+void DroneVecEnv::TakeFinishedEpisodes(std::vector<float>& returns, std::vector<int>& lengths) {
+    returns.swap(m_FinishedReturns);
+    lengths.swap(m_FinishedLengths);
+    m_FinishedReturns.clear();
+    m_FinishedLengths.clear();
+}
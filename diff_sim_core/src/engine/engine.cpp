@@ -19,9 +19,11 @@ Engine::Engine(int width, int height, float scale, float deltaTime, int substeps
     if (!m_bHeadless) {
         m_pRenderer = new SDLRenderer(width, height, scale);
     }
+    MemoryTracker::RegisterEngine(this);
 }
 
 Engine::~Engine() {
+    MemoryTracker::UnregisterEngine(this);
     if (m_pRenderer) {
         delete m_pRenderer;
     }
@@ -31,6 +33,36 @@ Engine::~Engine() {
     }
 }
 
+EngineMemoryStats Engine::GetMemoryStats() const {
+    EngineMemoryStats stats;
+    stats.bodies = (int)m_Bodies.size();
+    stats.colliders = (int)m_Colliders.size();
+    stats.joints = (int)m_Joints.size();
+    stats.manifolds = m_ContactManager.NumCached();
+    stats.activeManifolds = m_ContactManager.NumActive();
+
+    int64_t bytes = (int64_t)(m_Bodies.capacity() + m_Colliders.capacity()) * sizeof(Body*);
+    bytes += (int64_t)m_Joints.capacity() * sizeof(Joint*);
+    bytes += (int64_t)m_JointBodies.capacity() * sizeof(Body*) + (int64_t)m_JointVelocities.capacity() * sizeof(float);
+    auto countBody = [&](const Body* pBody, bool bOwned) {
+        stats.shapes += (int)pBody->shapes.size();
+        stats.garbageTensors += (int)pBody->garbage_collector.size();
+        for (const Tensor& t : pBody->garbage_collector) stats.garbageBytes += t.StorageBytes();
+        bytes += (int64_t)pBody->shapes.capacity() * sizeof(Shape) + (int64_t)pBody->motors.capacity() * sizeof(Motor*);
+        if (bOwned) bytes += sizeof(Body);
+    };
+    for (const Body* pBody : m_Bodies) countBody(pBody, false);
+    for (const Body* pCollider : m_Colliders) countBody(pCollider, true);
+
+    bytes += m_ContactManager.MemoryBytes();
+    bytes += (int64_t)m_SensitivityParams.capacity() * sizeof(SensitivityParamRef);
+    bytes += (int64_t)m_DualStates.size() * (sizeof(Body*) + sizeof(DualBodyState) + 2 * sizeof(void*));
+    stats.rewindBytes = m_pRewind ? m_pRewind->Bytes() : 0;
+    bytes += stats.rewindBytes + (int64_t)m_RewindState.capacity() * sizeof(float);
+    stats.bytes = bytes;
+    return stats;
+}
+
 // ============================================================================
 // Body and Collider Management
 // ============================================================================
@@ -56,6 +88,8 @@ void Engine::ClearColliders() {
 void Engine::ClearBodies() {
     // Clear contact manager first
     m_ContactManager.Clear();
+    m_DualStates.clear();
+    m_Sensors.Clear();
     
     // Just clear the vector - don't delete bodies
     // Python owns the Body objects and will garbage collect them
@@ -180,6 +214,15 @@ int Engine::DetectBoxBoxMulti(Body* pBodyA, const Shape& shapeA, Body* pBodyB, c
         }
     }
     
+    // Per-contact depth: distance a corner must travel along the normal to
+    // leave the other box (local point l, half extents hw/hh, local direction d)
+    auto exitDistance = [](float lx, float ly, float hw, float hh, float dx, float dy) {
+        float t = std::numeric_limits<float>::infinity();
+        if (std::abs(dx) > 1e-6f) t = std::min(t, (hw - (dx > 0 ? lx : -lx)) / std::abs(dx));
+        if (std::abs(dy) > 1e-6f) t = std::min(t, (hh - (dy > 0 ? ly : -ly)) / std::abs(dy));
+        return t;
+    };
+    
     // Find ALL penetrating corners (up to 4)
     int numContacts = 0;
     
@@ -198,7 +241,7 @@ int Engine::DetectBoxBoxMulti(Body* pBodyA, const Shape& shapeA, Body* pBodyB, c
         if (penX > 0 && penY > 0) {
             pContactsX[numContacts] = px;
             pContactsY[numContacts] = py;
-            pContactsPen[numContacts] = std::min(penX, penY);
+            pContactsPen[numContacts] = exitDistance(lx, ly, hwB, hhB, cosB * nx + sinB * ny, -sinB * nx + cosB * ny);
             numContacts++;
         }
     }
@@ -218,7 +261,7 @@ int Engine::DetectBoxBoxMulti(Body* pBodyA, const Shape& shapeA, Body* pBodyB, c
         if (penX > 0 && penY > 0) {
             pContactsX[numContacts] = px;
             pContactsY[numContacts] = py;
-            pContactsPen[numContacts] = std::min(penX, penY);
+            pContactsPen[numContacts] = exitDistance(lx, ly, hwA, hhA, -(cosA * nx + sinA * ny), sinA * nx - cosA * ny);
             numContacts++;
         }
     }
@@ -1169,10 +1212,8 @@ void Engine::ApplyImpulse(Body* pBodyA, Body* pBodyB, float nx, float ny, float
         if (newOmegaA > MAX_OMEGA) newOmegaA = MAX_OMEGA;
         if (newOmegaA < -MAX_OMEGA) newOmegaA = -MAX_OMEGA;
         
-        std::vector<float> newVelA = {newVaX, newVaY};
-        pBodyA->vel = Tensor(newVelA, true);
-        std::vector<float> newOmegaAVec = {newOmegaA};
-        pBodyA->ang_vel = Tensor(newOmegaAVec, true);
+        pBodyA->SetVelocity(newVaX, newVaY);
+        pBodyA->SetAngularVelocity(newOmegaA);
     }
     
     if (!pBodyB->is_static) {
@@ -1180,10 +1221,8 @@ void Engine::ApplyImpulse(Body* pBodyA, Body* pBodyB, float nx, float ny, float
         float newVbY = pBodyB->vel.Get(1, 0) - j * ny * invMassB;
         float newOmegaB = pBodyB->ang_vel.Get(0, 0) - rbCrossN * j * invInertiaB;
         
-        std::vector<float> newVelB = {newVbX, newVbY};
-        pBodyB->vel = Tensor(newVelB, true);
-        std::vector<float> newOmegaBVec = {newOmegaB};
-        pBodyB->ang_vel = Tensor(newOmegaBVec, true);
+        pBodyB->SetVelocity(newVbX, newVbY);
+        pBodyB->SetAngularVelocity(newOmegaB);
     }
     
     // --- FRICTION ---
@@ -1219,111 +1258,98 @@ void Engine::ApplyImpulse(Body* pBodyA, Body* pBodyB, float nx, float ny, float
         float newVaX = pBodyA->vel.Get(0, 0) + jt * tx * invMassA;
         float newVaY = pBodyA->vel.Get(1, 0) + jt * ty * invMassA;
         float newOmegaA = pBodyA->ang_vel.Get(0, 0) + raCrossT * jt * invInertiaA;
-        std::vector<float> newVelA = {newVaX, newVaY};
-        pBodyA->vel = Tensor(newVelA, true);
-        std::vector<float> newOmegaAVec = {newOmegaA};
-        pBodyA->ang_vel = Tensor(newOmegaAVec, true);
+        pBodyA->SetVelocity(newVaX, newVaY);
+        pBodyA->SetAngularVelocity(newOmegaA);
     }
     
     if (!pBodyB->is_static) {
         float newVbX = pBodyB->vel.Get(0, 0) - jt * tx * invMassB;
         float newVbY = pBodyB->vel.Get(1, 0) - jt * ty * invMassB;
         float newOmegaB = pBodyB->ang_vel.Get(0, 0) - rbCrossT * jt * invInertiaB;
-        std::vector<float> newVelB = {newVbX, newVbY};
-        pBodyB->vel = Tensor(newVelB, true);
-        std::vector<float> newOmegaBVec = {newOmegaB};
-        pBodyB->ang_vel = Tensor(newOmegaBVec, true);
+        pBodyB->SetVelocity(newVbX, newVbY);
+        pBodyB->SetAngularVelocity(newOmegaB);
     }
 }
 
+int Engine::CollideShapes(Body* pBodyA, const Shape& shapeA, Body* pBodyB, const Shape& shapeB,
+                          float& pen, float& nx, float& ny, float* pContactsX, float* pContactsY,
+                          float* pContactsPen) {
+    float cx = 0, cy = 0;
+    bool collision = false;
+    
+    // Dispatch based on shape types
+    if (shapeA.type == Shape::BOX && shapeB.type == Shape::BOX) {
+        float contactsPen[4];
+        return DetectBoxBoxMulti(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny,
+                                 pContactsX, pContactsY, pContactsPen ? pContactsPen : contactsPen);
+    }
+    else if (shapeA.type == Shape::CIRCLE && shapeB.type == Shape::CIRCLE) {
+        collision = DetectCircleCircle(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
+    }
+    else if (shapeA.type == Shape::CIRCLE && shapeB.type == Shape::BOX) {
+        collision = DetectCircleBox(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
+    }
+    else if (shapeA.type == Shape::BOX && shapeB.type == Shape::CIRCLE) {
+        // Swap order: DetectCircleBox expects circle first
+        collision = DetectCircleBox(pBodyB, shapeB, pBodyA, shapeA, pen, nx, ny, cx, cy);
+        if (collision) {
+            // Normal points from circle to box, flip for consistent impulse
+            nx = -nx;
+            ny = -ny;
+        }
+    }
+    // Triangle vs Circle
+    else if (shapeA.type == Shape::TRIANGLE && shapeB.type == Shape::CIRCLE) {
+        collision = DetectTriangleCircle(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
+        if (collision) {
+            // DetectTriangleCircle returns normal from triangle TO circle
+            // For ApplyImpulse, normal should point from B to A (circle to triangle)
+            // So flip it
+            nx = -nx;
+            ny = -ny;
+        }
+    }
+    else if (shapeA.type == Shape::CIRCLE && shapeB.type == Shape::TRIANGLE) {
+        // Normal is from triangle (B) to circle (A), which is what we need
+        collision = DetectTriangleCircle(pBodyB, shapeB, pBodyA, shapeA, pen, nx, ny, cx, cy);
+    }
+    // Triangle vs Box
+    else if (shapeA.type == Shape::TRIANGLE && shapeB.type == Shape::BOX) {
+        collision = DetectTriangleBox(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
+    }
+    else if (shapeA.type == Shape::BOX && shapeB.type == Shape::TRIANGLE) {
+        collision = DetectTriangleBox(pBodyB, shapeB, pBodyA, shapeA, pen, nx, ny, cx, cy);
+        if (collision) {
+            nx = -nx;
+            ny = -ny;
+        }
+    }
+    // Triangle vs Triangle
+    else if (shapeA.type == Shape::TRIANGLE && shapeB.type == Shape::TRIANGLE) {
+        collision = DetectTriangleTriangle(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
+    }
+    
+    if (!collision) return 0;
+    pContactsX[0] = cx;
+    pContactsY[0] = cy;
+    if (pContactsPen) pContactsPen[0] = pen;
+    return 1;
+}
+
 void Engine::ResolveCollision(Body* pBodyA, Body* pBodyB) {
     for (const Shape& shapeA : pBodyA->shapes) {
         for (const Shape& shapeB : pBodyB->shapes) {
-            float pen = 0, nx = 0, ny = 0, cx = 0, cy = 0;
-            bool collision = false;
+            float pen = 0, nx = 0, ny = 0;
+            float contactsX[4], contactsY[4];
+            int numContacts = CollideShapes(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, contactsX, contactsY);
             
-            // Dispatch based on shape types
-            if (shapeA.type == Shape::BOX && shapeB.type == Shape::BOX) {
-                float contactsX[4], contactsY[4], contactsPen[4];
-                int numContacts = DetectBoxBoxMulti(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny,
-                                                    contactsX, contactsY, contactsPen);
-                if (numContacts > 0) {
-                    collision = true;
-                    cx = contactsX[0];
-                    cy = contactsY[0];
-                    
-                    // Apply impulse at each contact point
-                    for (int i = 0; i < numContacts; ++i) {
-                        ApplyImpulse(pBodyA, pBodyB, nx, ny, contactsX[i], contactsY[i]);
-                    }
-                }
-            }
-            else if (shapeA.type == Shape::CIRCLE && shapeB.type == Shape::CIRCLE) {
-                collision = DetectCircleCircle(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
-                if (collision) {
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            else if (shapeA.type == Shape::CIRCLE && shapeB.type == Shape::BOX) {
-                collision = DetectCircleBox(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
-                if (collision) {
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            else if (shapeA.type == Shape::BOX && shapeB.type == Shape::CIRCLE) {
-                // Swap order: DetectCircleBox expects circle first
-                collision = DetectCircleBox(pBodyB, shapeB, pBodyA, shapeA, pen, nx, ny, cx, cy);
-                if (collision) {
-                    // Normal points from circle to box, flip for consistent impulse
-                    nx = -nx;
-                    ny = -ny;
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            // Triangle vs Circle
-            else if (shapeA.type == Shape::TRIANGLE && shapeB.type == Shape::CIRCLE) {
-                collision = DetectTriangleCircle(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
-                if (collision) {
-                    // DetectTriangleCircle returns normal from triangle TO circle
-                    // For ApplyImpulse, normal should point from B to A (circle to triangle)
-                    // So flip it
-                    nx = -nx;
-                    ny = -ny;
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            else if (shapeA.type == Shape::CIRCLE && shapeB.type == Shape::TRIANGLE) {
-                collision = DetectTriangleCircle(pBodyB, shapeB, pBodyA, shapeA, pen, nx, ny, cx, cy);
-                if (collision) {
-                    // Normal is from triangle (B) to circle (A), which is what we need
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            // Triangle vs Box
-            else if (shapeA.type == Shape::TRIANGLE && shapeB.type == Shape::BOX) {
-                collision = DetectTriangleBox(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
-                if (collision) {
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            else if (shapeA.type == Shape::BOX && shapeB.type == Shape::TRIANGLE) {
-                collision = DetectTriangleBox(pBodyB, shapeB, pBodyA, shapeA, pen, nx, ny, cx, cy);
-                if (collision) {
-                    nx = -nx;
-                    ny = -ny;
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
-            }
-            // Triangle vs Triangle
-            else if (shapeA.type == Shape::TRIANGLE && shapeB.type == Shape::TRIANGLE) {
-                collision = DetectTriangleTriangle(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny, cx, cy);
-                if (collision) {
-                    ApplyImpulse(pBodyA, pBodyB, nx, ny, cx, cy);
-                }
+            // Apply impulse at each contact point
+            for (int i = 0; i < numContacts; ++i) {
+                ApplyImpulse(pBodyA, pBodyB, nx, ny, contactsX[i], contactsY[i]);
             }
             
             // Position correction (Baumgarte stabilization)
-            if (collision && pen > 0.001f) {
+            if (numContacts > 0 && pen > 0.001f) {
                 float slop = 0.01f;
                 float baumgarte = 0.4f;
                 float correction = std::max(pen - slop, 0.0f) * baumgarte;
@@ -1335,19 +1361,19 @@ void Engine::ResolveCollision(Body* pBodyA, Body* pBodyB) {
                     
                     float newAx = pBodyA->pos.Get(0, 0) + nx * correction * ratioA;
                     float newAy = pBodyA->pos.Get(1, 0) + ny * correction * ratioA;
-                    pBodyA->pos = Tensor(std::vector<float>{newAx, newAy}, true);
+                    pBodyA->SetPosition(newAx, newAy);
                     
                     float newBx = pBodyB->pos.Get(0, 0) - nx * correction * ratioB;
                     float newBy = pBodyB->pos.Get(1, 0) - ny * correction * ratioB;
-                    pBodyB->pos = Tensor(std::vector<float>{newBx, newBy}, true);
+                    pBodyB->SetPosition(newBx, newBy);
                 } else if (!pBodyA->is_static) {
                     float newAx = pBodyA->pos.Get(0, 0) + nx * correction;
                     float newAy = pBodyA->pos.Get(1, 0) + ny * correction;
-                    pBodyA->pos = Tensor(std::vector<float>{newAx, newAy}, true);
+                    pBodyA->SetPosition(newAx, newAy);
                 } else if (!pBodyB->is_static) {
                     float newBx = pBodyB->pos.Get(0, 0) - nx * correction;
                     float newBy = pBodyB->pos.Get(1, 0) - ny * correction;
-                    pBodyB->pos = Tensor(std::vector<float>{newBx, newBy}, true);
+                    pBodyB->SetPosition(newBx, newBy);
                 }
             }
         }
@@ -1425,15 +1451,15 @@ void Engine::WarmStart() {
                 float vaX = pBodyA->vel.Get(0, 0) - px * invMassA;
                 float vaY = pBodyA->vel.Get(1, 0) - py * invMassA;
                 float omegaA = pBodyA->ang_vel.Get(0, 0) - (raX * py - raY * px) * invInertiaA;
-                pBodyA->vel = Tensor(std::vector<float>{vaX, vaY}, true);
-                pBodyA->ang_vel = Tensor(std::vector<float>{omegaA}, true);
+                pBodyA->SetVelocity(vaX, vaY);
+                pBodyA->SetAngularVelocity(omegaA);
             }
             if (!pBodyB->is_static) {
                 float vbX = pBodyB->vel.Get(0, 0) + px * invMassB;
                 float vbY = pBodyB->vel.Get(1, 0) + py * invMassB;
                 float omegaB = pBodyB->ang_vel.Get(0, 0) + (rbX * py - rbY * px) * invInertiaB;
-                pBodyB->vel = Tensor(std::vector<float>{vbX, vbY}, true);
-                pBodyB->ang_vel = Tensor(std::vector<float>{omegaB}, true);
+                pBodyB->SetVelocity(vbX, vbY);
+                pBodyB->SetAngularVelocity(omegaB);
             }
         }
     }
@@ -1479,15 +1505,15 @@ void Engine::ApplyContactImpulse(ContactManifold& manifold, int idx) {
         float newVaX = pBodyA->vel.Get(0, 0) + px * invMassA;
         float newVaY = pBodyA->vel.Get(1, 0) + py * invMassA;
         float newOmegaA = pBodyA->ang_vel.Get(0, 0) + (raX * py - raY * px) * invInertiaA;
-        pBodyA->vel = Tensor(std::vector<float>{newVaX, newVaY}, true);
-        pBodyA->ang_vel = Tensor(std::vector<float>{newOmegaA}, true);
+        pBodyA->SetVelocity(newVaX, newVaY);
+        pBodyA->SetAngularVelocity(newOmegaA);
     }
     if (!pBodyB->is_static) {
         float newVbX = pBodyB->vel.Get(0, 0) - px * invMassB;
         float newVbY = pBodyB->vel.Get(1, 0) - py * invMassB;
         float newOmegaB = pBodyB->ang_vel.Get(0, 0) - (rbX * py - rbY * px) * invInertiaB;
-        pBodyB->vel = Tensor(std::vector<float>{newVbX, newVbY}, true);
-        pBodyB->ang_vel = Tensor(std::vector<float>{newOmegaB}, true);
+        pBodyB->SetVelocity(newVbX, newVbY);
+        pBodyB->SetAngularVelocity(newOmegaB);
     }
     
     // Friction impulse
@@ -1507,15 +1533,15 @@ void Engine::ApplyContactImpulse(ContactManifold& manifold, int idx) {
         float newVaX = pBodyA->vel.Get(0, 0) + tx * invMassA;
         float newVaY = pBodyA->vel.Get(1, 0) + ty * invMassA;
         float newOmegaA = pBodyA->ang_vel.Get(0, 0) + (raX * ty - raY * tx) * invInertiaA;
-        pBodyA->vel = Tensor(std::vector<float>{newVaX, newVaY}, true);
-        pBodyA->ang_vel = Tensor(std::vector<float>{newOmegaA}, true);
+        pBodyA->SetVelocity(newVaX, newVaY);
+        pBodyA->SetAngularVelocity(newOmegaA);
     }
     if (!pBodyB->is_static) {
         float newVbX = pBodyB->vel.Get(0, 0) - tx * invMassB;
         float newVbY = pBodyB->vel.Get(1, 0) - ty * invMassB;
         float newOmegaB = pBodyB->ang_vel.Get(0, 0) - (rbX * ty - rbY * tx) * invInertiaB;
-        pBodyB->vel = Tensor(std::vector<float>{newVbX, newVbY}, true);
-        pBodyB->ang_vel = Tensor(std::vector<float>{newOmegaB}, true);
+        pBodyB->SetVelocity(newVbX, newVbY);
+        pBodyB->SetAngularVelocity(newOmegaB);
     }
 }
 
@@ -1542,18 +1568,18 @@ void Engine::SolvePositionConstraints() {
             if (!pBodyA->is_static && !pBodyB->is_static) {
                 float ax = pBodyA->pos.Get(0, 0) + pManifold->normal[0] * correction * 0.5f;
                 float ay = pBodyA->pos.Get(1, 0) + pManifold->normal[1] * correction * 0.5f;
-                pBodyA->pos = Tensor(std::vector<float>{ax, ay}, true);
+                pBodyA->SetPosition(ax, ay);
                 float bx = pBodyB->pos.Get(0, 0) - pManifold->normal[0] * correction * 0.5f;
                 float by = pBodyB->pos.Get(1, 0) - pManifold->normal[1] * correction * 0.5f;
-                pBodyB->pos = Tensor(std::vector<float>{bx, by}, true);
+                pBodyB->SetPosition(bx, by);
             } else if (!pBodyA->is_static) {
                 float ax = pBodyA->pos.Get(0, 0) + pManifold->normal[0] * correction;
                 float ay = pBodyA->pos.Get(1, 0) + pManifold->normal[1] * correction;
-                pBodyA->pos = Tensor(std::vector<float>{ax, ay}, true);
+                pBodyA->SetPosition(ax, ay);
             } else if (!pBodyB->is_static) {
                 float bx = pBodyB->pos.Get(0, 0) - pManifold->normal[0] * correction;
                 float by = pBodyB->pos.Get(1, 0) - pManifold->normal[1] * correction;
-                pBodyB->pos = Tensor(std::vector<float>{bx, by}, true);
+                pBodyB->SetPosition(bx, by);
             }
         }
     }
@@ -1564,6 +1590,38 @@ void Engine::SolvePositionConstraints() {
 // ============================================================================
 
 void Engine::Update() {
+    if (!m_SensitivityParams.empty()) {
+        if (!m_Joints.empty() || !m_Articulations.empty()) {
+            throw std::runtime_error("Engine: joints and articulated chains are not supported with sensitivity parameters");
+        }
+        if (m_SolverMode == SolverMode::XPBD) {
+            throw std::runtime_error("Engine: sensitivity parameters require the impulse solver");
+        }
+        for (Body* pBody : m_Bodies) {
+            for (Motor* pMotor : pBody->motors) {
+                if (pMotor->GetDelay() > 0) {
+                    throw std::runtime_error("Engine: delayed motors are not supported with sensitivity parameters");
+                }
+            }
+        }
+    }
+    
+    bool bSensors = m_Sensors.Count() > 0;
+    if (bSensors) m_Sensors.BeginStep();
+    
+    if (!m_SensitivityParams.empty()) {
+        UpdateWithSensitivities();
+    } else if (m_SolverMode == SolverMode::XPBD) {
+        UpdateXPBD();
+    } else {
+        UpdateImpulse();
+    }
+    
+    if (bSensors) m_Sensors.EndStep(m_DeltaTime, m_GravityX, m_GravityY);
+    if (m_pRewind) RecordRewindState();
+}
+
+void Engine::UpdateImpulse() {
     float subDt = m_DeltaTime / static_cast<float>(m_Substeps);
     
     for (int step = 0; step < m_Substeps; ++step) {
@@ -1571,21 +1629,36 @@ void Engine::Update() {
         for (Body* pBody : m_Bodies) {
             pBody->ApplyMotorForces();
         }
+        for (ArticulatedChain* pChain : m_Articulations) {
+            for (Body* pLink : pChain->Links()) pLink->ApplyMotorForces();
+        }
         
         // 1. Apply gravity
         for (Body* pBody : m_Bodies) {
             ApplyGravity(pBody, subDt);
         }
+        for (ArticulatedChain* pChain : m_Articulations) {
+            for (Body* pLink : pChain->Links()) ApplyGravity(pLink, subDt);
+        }
         
         // 2. Integrate positions and velocities
         for (Body* pBody : m_Bodies) {
             Integrate(pBody, subDt);
         }
+        for (ArticulatedChain* pChain : m_Articulations) {
+            pChain->Step(subDt);
+        }
         
-        // 3. Collision detection and response using OLD working system
+        // 3. Joints
+        if (!m_Joints.empty()) {
+            SolveJoints(subDt);
+        }
+        
+        // 4. Collision detection and response using OLD working system
         // Dynamic vs Dynamic
         for (size_t i = 0; i < m_Bodies.size(); ++i) {
             for (size_t j = i + 1; j < m_Bodies.size(); ++j) {
+                if (!m_Joints.empty() && JointPreventsCollision(m_Bodies[i], m_Bodies[j])) continue;
                 ResolveCollision(m_Bodies[i], m_Bodies[j]);
             }
         }
@@ -1593,15 +1666,24 @@ void Engine::Update() {
         // Dynamic vs Static (colliders)
         for (Body* pBody : m_Bodies) {
             for (Body* pCollider : m_Colliders) {
+                if (!m_Joints.empty() && JointPreventsCollision(pBody, pCollider)) continue;
                 ResolveCollision(pBody, pCollider);
             }
         }
+        
+        // Articulated links vs everything else
+        if (!m_Articulations.empty()) {
+            ResolveArticulationContacts();
+        }
     }
     
     // Clear garbage collectors
     for (Body* pBody : m_Bodies) {
         pBody->garbage_collector.clear();
     }
+    for (ArticulatedChain* pChain : m_Articulations) {
+        for (Body* pLink : pChain->Links()) pLink->garbage_collector.clear();
+    }
 }
 
 // ============================================================================
@@ -1645,8 +1727,14 @@ void Engine::RenderBodies() {
         }
     }
     
-    // Render dynamic bodies - filled with color
-    for (Body* pBody : m_Bodies) {
+    // Render dynamic bodies and articulated links - filled with color
+    std::vector<Body*> dynamicBodies = m_Bodies;
+    for (ArticulatedChain* pChain : m_Articulations) {
+        for (Body* pLink : pChain->Links()) {
+            if (!pLink->is_static) dynamicBodies.push_back(pLink);
+        }
+    }
+    for (Body* pBody : dynamicBodies) {
         float x = pBody->GetX();
         float y = pBody->GetY();
         float rot = pBody->GetRotation();
@@ -0,0 +1,185 @@
+#include "engine/evaluation.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+PolicyEvaluator::PolicyEvaluator(const DroneTaskConfig& task, const EvalConfig& config)
+    : m_Task(task), m_Config(config)
+{
+    if (config.episodesPerCondition <= 0 || config.numWorlds <= 0) {
+        throw std::runtime_error("PolicyEvaluator: episodesPerCondition and numWorlds must be positive");
+    }
+}
+
+std::vector<EvalConditionResult> PolicyEvaluator::Evaluate(const std::vector<EvalCondition>& conditions,
+                                                           const EvalPolicyFn& policy) {
+    return Run(conditions, policy, Eigen::VectorXf());
+}
+
+std::vector<EvalConditionResult> PolicyEvaluator::Evaluate(const std::vector<EvalCondition>& conditions,
+                                                           const GaussianPolicy& policy) {
+    if (policy.ObservationSize() != DroneVecEnv::OBS_SIZE || policy.ActionSize() != (int)m_Task.motors.size()) {
+        throw std::runtime_error("PolicyEvaluator: policy does not match the task's observation/action sizes");
+    }
+    EvalPolicyFn mean = [&policy](const Eigen::MatrixXf& obs) { return policy.Mean(obs); };
+    Eigen::VectorXf actionStd;
+    if (!m_Config.deterministic) {
+        actionStd = policy.LogStd().Data().col(0).array().exp();
+    }
+    return Run(conditions, mean, actionStd);
+}
+
+std::vector<EvalConditionResult> PolicyEvaluator::Run(const std::vector<EvalCondition>& conditions,
+                                                      const EvalPolicyFn& policy,
+                                                      const Eigen::VectorXf& actionStd) {
+    ProfileScope profile("PolicyEvaluator");
+    const int episodesPer = m_Config.episodesPerCondition;
+    const int totalEpisodes = (int)conditions.size() * episodesPer;
+    const int numMotors = (int)m_Task.motors.size();
+
+    std::vector<EvalConditionResult> results(conditions.size());
+    for (size_t c = 0; c < conditions.size(); ++c) {
+        EvalConditionResult& result = results[c];
+        result.condition = conditions[c];
+        result.returns.assign(episodesPer, 0.0f);
+        result.lengths.assign(episodesPer, 0);
+        result.successes.assign(episodesPer, 0);
+        if (m_Config.recordTrajectories) result.trajectories.resize(episodesPer);
+    }
+    if (totalEpisodes == 0) return results;
+
+    int numWorlds = std::min(m_Config.numWorlds, totalEpisodes);
+    if (!m_pEnv || m_pEnv->NumEnvs() != numWorlds) {
+        m_pEnv.reset(new DroneVecEnv(m_Task, numWorlds));
+    }
+    DroneVecEnv& env = *m_pEnv;
+    env.Reset();
+
+    // Episode in flight in each world (-1 once the world has run out of work)
+    struct Slot {
+        int episode = -1;
+        std::mt19937 rng;
+        float episodeReturn = 0.0f;
+        int length = 0;
+        std::vector<Eigen::Matrix<float, 6, 1>> states;
+    };
+    std::vector<Slot> slots(numWorlds);
+
+    auto stateFromObservation = [&](const Eigen::MatrixXf& obs, int col) {
+        Eigen::Matrix<float, 6, 1> state;
+        state << m_Task.targetX - obs(0, col), m_Task.targetY - obs(1, col), obs(4, col),
+                 obs(2, col), obs(3, col), obs(5, col);
+        return state;
+    };
+
+    int nextEpisode = 0;
+    auto startEpisode = [&](int world) {
+        Slot& slot = slots[world];
+        slot.episode = nextEpisode++;
+        const EvalCondition& condition = conditions[slot.episode / episodesPer];
+        std::seed_seq seq{condition.seed, (unsigned int)(slot.episode % episodesPer)};
+        slot.rng.seed(seq);
+        slot.episodeReturn = 0.0f;
+        slot.length = 0;
+
+        float x = condition.spawnX;
+        float y = condition.spawnY;
+        if (m_Config.spawnJitter > 0.0f) {
+            std::uniform_real_distribution<float> jitter(-m_Config.spawnJitter, m_Config.spawnJitter);
+            x += jitter(slot.rng);
+            y += jitter(slot.rng);
+        }
+        env.ResetWorldAt(world, x, y, slot.rng);
+        if (m_Config.recordTrajectories) {
+            slot.states.clear();
+            slot.states.push_back(stateFromObservation(env.Observations(), world));
+        }
+    };
+
+    for (int w = 0; w < numWorlds; ++w) startEpisode(w);
+
+    std::vector<int> running;
+    Eigen::MatrixXf obs;
+    Eigen::MatrixXf actions = Eigen::MatrixXf::Zero(numMotors, numWorlds);
+    std::vector<float> unusedReturns;
+    std::vector<int> unusedLengths;
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    while (true) {
+        running.clear();
+        for (int w = 0; w < numWorlds; ++w) {
+            if (slots[w].episode >= 0) running.push_back(w);
+        }
+        if (running.empty()) break;
+
+        // One policy call for every running episode
+        obs.resize(DroneVecEnv::OBS_SIZE, (int)running.size());
+        for (int j = 0; j < (int)running.size(); ++j) obs.col(j) = env.Observations().col(running[j]);
+        Eigen::MatrixXf batchActions = policy(obs);
+        if (batchActions.rows() != numMotors || batchActions.cols() != (int)running.size()) {
+            throw std::runtime_error("PolicyEvaluator: policy must return (num_motors, batch) actions");
+        }
+
+        // Idle worlds get zero throttle; their results are ignored
+        actions.setZero();
+        for (int j = 0; j < (int)running.size(); ++j) {
+            Slot& slot = slots[running[j]];
+            actions.col(running[j]) = batchActions.col(j);
+            if (actionStd.size() > 0) {
+                for (int m = 0; m < numMotors; ++m) actions(m, running[j]) += actionStd(m) * normal(slot.rng);
+            }
+        }
+
+        env.Step(actions);
+        env.TakeFinishedEpisodes(unusedReturns, unusedLengths);
+
+        const Eigen::MatrixXf& terminalObs = env.TerminalObservations();
+        for (int w : running) {
+            Slot& slot = slots[w];
+            slot.episodeReturn += env.Rewards()(w);
+            slot.length++;
+            if (m_Config.recordTrajectories) slot.states.push_back(stateFromObservation(terminalObs, w));
+            if (!env.Terminated()[w] && !env.Truncated()[w]) continue;
+
+            EvalConditionResult& result = results[slot.episode / episodesPer];
+            int k = slot.episode % episodesPer;
+            float dx = terminalObs(0, w);
+            float dy = terminalObs(1, w);
+            result.returns[k] = slot.episodeReturn;
+            result.lengths[k] = slot.length;
+            result.successes[k] = (!env.Terminated()[w] &&
+                                   std::sqrt(dx * dx + dy * dy) < m_Config.successRadius) ? 1 : 0;
+            if (m_Config.recordTrajectories) {
+                Eigen::MatrixXf& trajectory = result.trajectories[k];
+                trajectory.resize(6, (int)slot.states.size());
+                for (int t = 0; t < (int)slot.states.size(); ++t) trajectory.col(t) = slot.states[t];
+            }
+
+            if (nextEpisode < totalEpisodes) {
+                startEpisode(w);
+            } else {
+                slot.episode = -1;
+            }
+        }
+    }
+
+    for (EvalConditionResult& result : results) {
+        double sum = 0.0, sumSq = 0.0, length = 0.0, successes = 0.0;
+        for (int k = 0; k < episodesPer; ++k) {
+            sum += result.returns[k];
+            sumSq += (double)result.returns[k] * result.returns[k];
+            length += result.lengths[k];
+            successes += result.successes[k];
+        }
+        double mean = sum / episodesPer;
+        result.meanReturn = (float)mean;
+        result.stdReturn = (float)std::sqrt(std::max(0.0, sumSq / episodesPer - mean * mean));
+        result.minReturn = *std::min_element(result.returns.begin(), result.returns.end());
+        result.maxReturn = *std::max_element(result.returns.begin(), result.returns.end());
+        result.meanLength = (float)(length / episodesPer);
+        result.successRate = (float)(successes / episodesPer);
+    }
+    return results;
+}
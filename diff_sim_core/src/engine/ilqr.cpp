@@ -0,0 +1,386 @@
+#include "engine/ilqr.h"
+#include "engine/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Steps below this many per thread aren't worth fanning out
+static const int MIN_STEPS_PER_BLOCK = 32;
+
+// Accept a line-search step once it achieves this fraction of the predicted decrease
+static const double MIN_DECREASE_RATIO = 1e-4;
+
+struct ILQRSolver::Trajectory {
+    std::vector<StateVector> x;      // T + 1
+    std::vector<Eigen::VectorXd> u;  // T
+};
+
+struct ILQRSolver::CostTerms {
+    StateVector target;
+    StateVector q;
+    StateVector qf;
+    Eigen::VectorXd uRef;
+    Eigen::VectorXd r;
+
+    double Stage(const StateVector& x, const Eigen::VectorXd& u) const {
+        return (q.array() * (x - target).array().square()).sum() +
+               (r.array() * (u - uRef).array().square()).sum();
+    }
+    double Final(const StateVector& x) const {
+        return (qf.array() * (x - target).array().square()).sum();
+    }
+};
+
+ILQRSolver::ILQRSolver(const Engine& engine, const Body& body, const ILQRConfig& config)
+    : m_Config(config)
+{
+    if (body.is_static) {
+        throw std::runtime_error("ILQRSolver: body must be dynamic");
+    }
+    if (body.motors.empty()) {
+        throw std::runtime_error("ILQRSolver: body has no motors to control");
+    }
+    m_Mass = body.mass.Get(0, 0);
+    m_Inertia = body.inertia.Get(0, 0);
+    m_GravityX = engine.GetGravityX();
+    m_GravityY = engine.GetGravityY();
+    m_DeltaTime = engine.GetDeltaTime();
+    m_Substeps = std::max(1, engine.GetSubsteps());
+
+    int numMotors = (int)body.motors.size();
+    m_ForceX.resize(numMotors);
+    m_ForceY.resize(numMotors);
+    m_Torque.resize(numMotors);
+    m_MaxThrust.resize(numMotors);
+    for (int i = 0; i < numMotors; ++i) {
+        const Motor* pMotor = body.motors[i];
+        m_ForceX(i) = std::cos(pMotor->angle);
+        m_ForceY(i) = std::sin(pMotor->angle);
+        // r x F in the body frame; the rotation cancels out of the 2D cross product
+        m_Torque(i) = pMotor->local_x * m_ForceY(i) - pMotor->local_y * m_ForceX(i);
+        m_MaxThrust(i) = pMotor->max_thrust;
+    }
+}
+
+// ---------------- Dynamics ----------------
+
+// Mirrors Engine::Update() for a lone body: per substep, motor forces at the
+// current rotation, gravity, then semi-implicit Euler. The Jacobian w.r.t.
+// [x_0, u] (6 x (6 + M)) is carried along row by row in the same order.
+void ILQRSolver::Propagate(const StateVector& x, const Eigen::VectorXd& u, StateVector& xNext,
+                           Jacobian* pJacobian) const {
+    int numMotors = (int)u.size();
+    double h = m_DeltaTime / m_Substeps;
+
+    // Thrust is held over the control step, so body-frame force and torque are too
+    double localFx = m_ForceX.dot(u);
+    double localFy = m_ForceY.dot(u);
+    double alpha = m_Torque.dot(u) / m_Inertia;
+
+    if (pJacobian) {
+        pJacobian->setZero(6, 6 + numMotors);
+        pJacobian->leftCols<6>().setIdentity();
+    }
+
+    StateVector s = x;
+    for (int step = 0; step < m_Substeps; ++step) {
+        double cosR = std::cos(s(2));
+        double sinR = std::sin(s(2));
+        double worldFx = cosR * localFx - sinR * localFy;
+        double worldFy = sinR * localFx + cosR * localFy;
+
+        if (pJacobian) {
+            Jacobian& J = *pJacobian;
+            Eigen::RowVectorXd dTheta = J.row(2);
+
+            // dv += h * da, with a depending on theta and u
+            J.row(3) -= (h * worldFy / m_Mass) * dTheta;
+            J.row(4) += (h * worldFx / m_Mass) * dTheta;
+            for (int i = 0; i < numMotors; ++i) {
+                J(3, 6 + i) += h * (cosR * m_ForceX(i) - sinR * m_ForceY(i)) / m_Mass;
+                J(4, 6 + i) += h * (sinR * m_ForceX(i) + cosR * m_ForceY(i)) / m_Mass;
+                J(5, 6 + i) += h * m_Torque(i) / m_Inertia;
+            }
+            // Positions integrate the updated velocities
+            J.row(0) += h * J.row(3);
+            J.row(1) += h * J.row(4);
+            J.row(2) += h * J.row(5);
+        }
+
+        s(3) += (m_GravityX + worldFx / m_Mass) * h;
+        s(4) += (m_GravityY + worldFy / m_Mass) * h;
+        s(0) += s(3) * h;
+        s(1) += s(4) * h;
+        s(5) += alpha * h;
+        s(2) += s(5) * h;
+    }
+    xNext = s;
+}
+
+static void CheckSizes(const Eigen::VectorXf& state, const Eigen::VectorXf& controls, int numMotors) {
+    if (state.size() != 6) {
+        throw std::runtime_error("ILQRSolver: state must be [x, y, theta, vx, vy, omega]");
+    }
+    if (controls.size() != numMotors) {
+        throw std::runtime_error("ILQRSolver: expected one thrust per motor");
+    }
+}
+
+Eigen::VectorXf ILQRSolver::Dynamics(const Eigen::VectorXf& state, const Eigen::VectorXf& controls) const {
+    CheckSizes(state, controls, ControlSize());
+    StateVector xNext;
+    Propagate(state.cast<double>(), controls.cast<double>(), xNext, nullptr);
+    return xNext.cast<float>();
+}
+
+void ILQRSolver::Linearize(const Eigen::VectorXf& state, const Eigen::VectorXf& controls,
+                           Eigen::MatrixXf& A, Eigen::MatrixXf& B) const {
+    CheckSizes(state, controls, ControlSize());
+    StateVector xNext;
+    Jacobian J;
+    Propagate(state.cast<double>(), controls.cast<double>(), xNext, &J);
+    A = J.leftCols<6>().cast<float>();
+    B = J.rightCols(ControlSize()).cast<float>();
+}
+
+// ---------------- Passes ----------------
+
+double ILQRSolver::Rollout(const Trajectory& nominal, const std::vector<Eigen::VectorXd>& k,
+                           const std::vector<Eigen::MatrixXd>& K, double alpha, const CostTerms& cost,
+                           Trajectory& out) const {
+    int horizon = (int)nominal.u.size();
+    Eigen::VectorXd upper = m_MaxThrust.cast<double>();
+
+    out.x.resize(horizon + 1);
+    out.u.resize(horizon);
+    out.x[0] = nominal.x[0];
+
+    double total = 0.0;
+    for (int t = 0; t < horizon; ++t) {
+        Eigen::VectorXd u = nominal.u[t];
+        if (!k.empty()) {
+            u += alpha * k[t] + K[t] * (out.x[t] - nominal.x[t]);
+            u = u.cwiseMax(0.0).cwiseMin(upper);
+        }
+        out.u[t] = u;
+        total += cost.Stage(out.x[t], u);
+        Propagate(out.x[t], u, out.x[t + 1], nullptr);
+    }
+    return total + cost.Final(out.x[horizon]);
+}
+
+// Riccati recursion on the quadratized cost. Returns false if Q_uu (+ mu I)
+// is not positive definite somewhere, in which case the caller raises mu.
+bool ILQRSolver::BackwardPass(const Trajectory& nominal, const std::vector<Jacobian>& jacobians,
+                              const CostTerms& cost, double mu,
+                              std::vector<Eigen::VectorXd>& k, std::vector<Eigen::MatrixXd>& K,
+                              double& expectedLinear, double& expectedQuadratic) const {
+    int horizon = (int)nominal.u.size();
+    int numMotors = ControlSize();
+    Eigen::VectorXd upper = m_MaxThrust.cast<double>();
+
+    StateVector Vx = 2.0 * cost.qf.cwiseProduct(nominal.x[horizon] - cost.target);
+    StateMatrix Vxx = (2.0 * cost.qf).asDiagonal();
+    expectedLinear = 0.0;
+    expectedQuadratic = 0.0;
+
+    for (int t = horizon - 1; t >= 0; --t) {
+        const StateVector& x = nominal.x[t];
+        const Eigen::VectorXd& u = nominal.u[t];
+        StateMatrix A = jacobians[t].leftCols<6>();
+        Eigen::MatrixXd B = jacobians[t].rightCols(numMotors);
+
+        StateVector Qx = 2.0 * cost.q.cwiseProduct(x - cost.target) + A.transpose() * Vx;
+        Eigen::VectorXd Qu = 2.0 * cost.r.cwiseProduct(u - cost.uRef) + B.transpose() * Vx;
+        StateMatrix Qxx = StateMatrix((2.0 * cost.q).asDiagonal()) + A.transpose() * Vxx * A;
+        Eigen::MatrixXd Quu = Eigen::MatrixXd((2.0 * cost.r).asDiagonal()) + B.transpose() * Vxx * B;
+        Eigen::MatrixXd Qux = B.transpose() * Vxx * A;
+
+        Eigen::MatrixXd QuuReg = Quu + mu * Eigen::MatrixXd::Identity(numMotors, numMotors);
+        Eigen::LLT<Eigen::MatrixXd> llt(QuuReg);
+        if (llt.info() != Eigen::Success) return false;
+
+        // Feedforward step boxed to the motor limits: motors the Newton step
+        // pushes past a limit are pinned to it and the rest re-solved
+        // (projected Newton). Saturated motors get no feedback.
+        Eigen::VectorXd lower = -u;
+        Eigen::VectorXd room = upper - u;
+        Eigen::VectorXd kt = -llt.solve(Qu);
+        std::vector<bool> clamped(numMotors, false);
+        int numClamped = 0;
+        for (int pass = 0; pass <= numMotors; ++pass) {
+            bool bChanged = false;
+            for (int i = 0; i < numMotors; ++i) {
+                if (clamped[i]) continue;
+                if (kt(i) < lower(i) || kt(i) > room(i)) {
+                    clamped[i] = true;
+                    kt(i) = std::max(lower(i), std::min(kt(i), room(i)));
+                    numClamped++;
+                    bChanged = true;
+                }
+            }
+            if (!bChanged || numClamped == numMotors) break;
+
+            std::vector<int> freeIdx;
+            for (int i = 0; i < numMotors; ++i) if (!clamped[i]) freeIdx.push_back(i);
+            int numFree = (int)freeIdx.size();
+            Eigen::MatrixXd Qff(numFree, numFree);
+            Eigen::VectorXd rhs(numFree);
+            for (int a = 0; a < numFree; ++a) {
+                rhs(a) = -Qu(freeIdx[a]);
+                for (int i = 0; i < numMotors; ++i) {
+                    if (clamped[i]) rhs(a) -= QuuReg(freeIdx[a], i) * kt(i);
+                }
+                for (int b = 0; b < numFree; ++b) Qff(a, b) = QuuReg(freeIdx[a], freeIdx[b]);
+            }
+            Eigen::VectorXd kFree = Qff.llt().solve(rhs);
+            for (int a = 0; a < numFree; ++a) kt(freeIdx[a]) = kFree(a);
+        }
+
+        Eigen::MatrixXd Kt = Eigen::MatrixXd::Zero(numMotors, 6);
+        if (numClamped == 0) {
+            Kt = -llt.solve(Qux);
+        } else if (numClamped < numMotors) {
+            std::vector<int> freeIdx;
+            for (int i = 0; i < numMotors; ++i) if (!clamped[i]) freeIdx.push_back(i);
+            int numFree = (int)freeIdx.size();
+            Eigen::MatrixXd Qff(numFree, numFree);
+            Eigen::MatrixXd Qfx(numFree, 6);
+            for (int a = 0; a < numFree; ++a) {
+                Qfx.row(a) = Qux.row(freeIdx[a]);
+                for (int b = 0; b < numFree; ++b) Qff(a, b) = QuuReg(freeIdx[a], freeIdx[b]);
+            }
+            Eigen::MatrixXd KFree = -Qff.llt().solve(Qfx);
+            for (int a = 0; a < numFree; ++a) Kt.row(freeIdx[a]) = KFree.row(a);
+        }
+
+        expectedLinear += kt.dot(Qu);
+        expectedQuadratic += 0.5 * kt.dot(Quu * kt);
+
+        Vx = Qx + Kt.transpose() * (Quu * kt) + Kt.transpose() * Qu + Qux.transpose() * kt;
+        Vxx = Qxx + Kt.transpose() * Quu * Kt + Kt.transpose() * Qux + Qux.transpose() * Kt;
+        Vxx = 0.5 * (Vxx + Vxx.transpose()).eval();
+
+        k[t] = kt;
+        K[t] = Kt;
+    }
+    return true;
+}
+
+// ---------------- Solve ----------------
+
+ILQRResult ILQRSolver::Solve(const Eigen::VectorXf& initialState, const Eigen::MatrixXf& initialControls,
+                             const ILQRCost& cost) const {
+    int numMotors = ControlSize();
+    int horizon = (int)initialControls.cols();
+    if (initialState.size() != 6) {
+        throw std::runtime_error("ILQRSolver: state must be [x, y, theta, vx, vy, omega]");
+    }
+    if (initialControls.rows() != numMotors || horizon == 0) {
+        throw std::runtime_error("ILQRSolver: initial controls must be (num_motors, T) with T > 0");
+    }
+    if (cost.stateTarget.size() != 6 || cost.stateWeights.size() != 6 || cost.finalStateWeights.size() != 6) {
+        throw std::runtime_error("ILQRSolver: state target and weights must have 6 entries");
+    }
+    if ((cost.controlReference.size() != 0 && cost.controlReference.size() != numMotors) ||
+        (cost.controlWeights.size() != 0 && cost.controlWeights.size() != numMotors)) {
+        throw std::runtime_error("ILQRSolver: control reference and weights need one entry per motor");
+    }
+
+    CostTerms terms;
+    terms.target = cost.stateTarget.cast<double>();
+    terms.q = cost.stateWeights.cast<double>();
+    terms.qf = cost.finalStateWeights.cast<double>();
+    terms.uRef = Eigen::VectorXd::Zero(numMotors);
+    terms.r = Eigen::VectorXd::Constant(numMotors, 1e-3);
+    if (cost.controlReference.size()) terms.uRef = cost.controlReference.cast<double>();
+    if (cost.controlWeights.size()) terms.r = cost.controlWeights.cast<double>();
+
+    Trajectory nominal, candidate;
+    nominal.x.assign(1, initialState.cast<double>());
+    nominal.u.resize(horizon);
+    Eigen::VectorXd upper = m_MaxThrust.cast<double>();
+    for (int t = 0; t < horizon; ++t) {
+        nominal.u[t] = initialControls.col(t).cast<double>().cwiseMax(0.0).cwiseMin(upper);
+    }
+    double J = Rollout(nominal, {}, {}, 0.0, terms, candidate);
+    std::swap(nominal, candidate);
+
+    ILQRResult result;
+    result.costHistory.push_back((float)J);
+
+    std::vector<Jacobian> jacobians(horizon);
+    std::vector<Eigen::VectorXd> k(horizon);
+    std::vector<Eigen::MatrixXd> K(horizon);
+    double mu = m_Config.regularization;
+
+    int numBlocks = std::min(GetNumThreads(), std::max(1, horizon / MIN_STEPS_PER_BLOCK));
+    for (int iter = 0; iter < m_Config.maxIterations; ++iter) {
+        result.iterations = iter + 1;
+
+        // Linearize about the nominal trajectory; steps are independent
+        GetGlobalThreadPool().ParallelFor(numBlocks, [&](int block) {
+            int t1 = (block + 1) * horizon / numBlocks;
+            StateVector xNext;
+            for (int t = block * horizon / numBlocks; t < t1; ++t) {
+                Propagate(nominal.x[t], nominal.u[t], xNext, &jacobians[t]);
+            }
+        });
+
+        double dV1 = 0.0, dV2 = 0.0;
+        bool bAccepted = false;
+        while (!bAccepted) {
+            if (!BackwardPass(nominal, jacobians, terms, mu, k, K, dV1, dV2)) {
+                mu = std::max(mu * 10.0, 1e-6);
+                if (mu > m_Config.maxRegularization) break;
+                continue;
+            }
+
+            // Predicted decrease is -(alpha dV1 + alpha^2 dV2); tiny means we're at a minimum
+            if (-dV1 <= m_Config.tolerance * std::max(std::abs(J), 1e-12)) {
+                result.bConverged = true;
+                break;
+            }
+
+            double alpha = 1.0;
+            for (int ls = 0; ls < m_Config.maxLineSearchSteps; ++ls, alpha *= 0.5) {
+                double Jnew = Rollout(nominal, k, K, alpha, terms, candidate);
+                double expected = -(alpha * dV1 + alpha * alpha * dV2);
+                if (std::isfinite(Jnew) && Jnew < J && (J - Jnew) >= MIN_DECREASE_RATIO * expected) {
+                    double relative = (J - Jnew) / std::max(std::abs(J), 1e-12);
+                    std::swap(nominal, candidate);
+                    J = Jnew;
+                    result.costHistory.push_back((float)J);
+                    bAccepted = true;
+                    if (relative < m_Config.tolerance) result.bConverged = true;
+                    break;
+                }
+            }
+            if (bAccepted) {
+                mu = std::max(mu * 0.1, (double)m_Config.regularization);
+            } else {
+                mu = std::max(mu * 10.0, 1e-6);
+                if (mu > m_Config.maxRegularization) break;
+            }
+        }
+        if (!bAccepted || result.bConverged) break;
+    }
+
+    // Feedback gains about the returned trajectory (it may have moved since the last backward pass)
+    double dV1 = 0.0, dV2 = 0.0;
+    StateVector xNext;
+    for (int t = 0; t < horizon; ++t) Propagate(nominal.x[t], nominal.u[t], xNext, &jacobians[t]);
+    bool bHaveGains = BackwardPass(nominal, jacobians, terms, mu, k, K, dV1, dV2);
+
+    result.cost = (float)J;
+    result.states.resize(6, horizon + 1);
+    result.controls.resize(numMotors, horizon);
+    result.feedbackGains.resize(horizon);
+    for (int t = 0; t <= horizon; ++t) result.states.col(t) = nominal.x[t].cast<float>();
+    for (int t = 0; t < horizon; ++t) {
+        result.controls.col(t) = nominal.u[t].cast<float>();
+        result.feedbackGains[t] = bHaveGains ? Eigen::MatrixXf(K[t].cast<float>())
+                                             : Eigen::MatrixXf::Zero(numMotors, 6);
+    }
+    return result;
+}
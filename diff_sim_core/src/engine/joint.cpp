@@ -0,0 +1,729 @@
+#include "engine/joint.h"
+#include "engine/engine.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// ---------------- Solver helpers ----------------
+
+namespace {
+
+const float kLinearSlop = 0.005f;
+const float kAngularSlop = 2.0f / 180.0f * 3.14159265f;
+const float kMaxLinearCorrection = 0.2f;
+const float kMaxAngularCorrection = 8.0f / 180.0f * 3.14159265f;
+
+struct Velocity {
+    float vx, vy, w;
+};
+
+struct Placement {
+    float x, y, a;
+};
+
+float InvMass(const Body* pBody) { return pBody->is_static ? 0.0f : 1.0f / pBody->mass.Get(0, 0); }
+float InvInertia(const Body* pBody) { return pBody->is_static ? 0.0f : 1.0f / pBody->inertia.Get(0, 0); }
+
+Velocity LoadVelocity(const Body* pBody) {
+    return {pBody->vel.Get(0, 0), pBody->vel.Get(1, 0), pBody->ang_vel.Get(0, 0)};
+}
+
+void StoreVelocity(Body* pBody, const Velocity& v) {
+    if (pBody->is_static) return;
+    pBody->SetVelocity(v.vx, v.vy);
+    pBody->SetAngularVelocity(v.w);
+}
+
+Placement LoadPlacement(const Body* pBody) { return {pBody->GetX(), pBody->GetY(), pBody->GetRotation()}; }
+
+void StorePlacement(Body* pBody, const Placement& p) {
+    if (pBody->is_static) return;
+    pBody->SetPosition(p.x, p.y);
+    pBody->SetRotation(p.a);
+}
+
+void Rotate(float angle, const float* pLocal, float* pOut) {
+    float c = std::cos(angle), s = std::sin(angle);
+    pOut[0] = c * pLocal[0] - s * pLocal[1];
+    pOut[1] = s * pLocal[0] + c * pLocal[1];
+}
+
+float Cross(const float* a, const float* b) { return a[0] * b[1] - a[1] * b[0]; }
+
+// Velocity of the point at offset r: v + w x r
+void PointVelocity(const Velocity& v, const float* r, float* pOut) {
+    pOut[0] = v.vx - v.w * r[1];
+    pOut[1] = v.vy + v.w * r[0];
+}
+
+// Apply impulse P at offset r, plus an angular impulse L, with the given sign
+void ApplyImpulse(Velocity& v, float invMass, float invI, const float* r, float px, float py, float l, float sign) {
+    float p[2] = {px, py};
+    v.vx += sign * invMass * px;
+    v.vy += sign * invMass * py;
+    v.w += sign * invI * (Cross(r, p) + l);
+}
+
+void ApplyPositionImpulse(Placement& c, float invMass, float invI, const float* r, float px, float py, float l,
+                          float sign) {
+    float p[2] = {px, py};
+    c.x += sign * invMass * px;
+    c.y += sign * invMass * py;
+    c.a += sign * invI * (Cross(r, p) + l);
+}
+
+// Symmetric 2x2 and 3x3 solves by Cramer's rule; zero when singular
+void Solve22(float k11, float k12, float k22, float b1, float b2, float& x1, float& x2) {
+    float det = k11 * k22 - k12 * k12;
+    if (det != 0.0f) det = 1.0f / det;
+    x1 = det * (k22 * b1 - k12 * b2);
+    x2 = det * (k11 * b2 - k12 * b1);
+}
+
+void Solve33(const Eigen::Matrix3f& k, const Eigen::Vector3f& b, Eigen::Vector3f& x) {
+    float det = k.determinant();
+    x = det != 0.0f ? Eigen::Vector3f(k.inverse() * b) : Eigen::Vector3f::Zero();
+}
+
+// Effective mass of a point constraint at offsets rA, rB
+void PointMass(float mA, float iA, const float* rA, float mB, float iB, const float* rB, float& k11, float& k12,
+               float& k22) {
+    k11 = mA + mB + rA[1] * rA[1] * iA + rB[1] * rB[1] * iB;
+    k12 = -rA[1] * rA[0] * iA - rB[1] * rB[0] * iB;
+    k22 = mA + mB + rA[0] * rA[0] * iA + rB[0] * rB[0] * iB;
+}
+
+} // namespace
+
+// ---------------- Joint ----------------
+
+Joint::Joint(JointType type, Body* pBodyA, Body* pBodyB) : m_Type(type), m_pBodyA(pBodyA), m_pBodyB(pBodyB) {
+    if (!pBodyA || !pBodyB) throw std::runtime_error("Joint: both bodies are required");
+    if (pBodyA == pBodyB) throw std::runtime_error("Joint: cannot connect a body to itself");
+    if (pBodyA->is_static && pBodyB->is_static) throw std::runtime_error("Joint: at least one body must be dynamic");
+}
+
+void Joint::ToLocal(const Body* pBody, float wx, float wy, float& lx, float& ly) {
+    float dx = wx - pBody->GetX();
+    float dy = wy - pBody->GetY();
+    float c = std::cos(pBody->GetRotation()), s = std::sin(pBody->GetRotation());
+    lx = c * dx + s * dy;
+    ly = -s * dx + c * dy;
+}
+
+// ---------------- RevoluteJoint ----------------
+
+RevoluteJoint::RevoluteJoint(Body* pBodyA, Body* pBodyB, float anchorX, float anchorY)
+    : Joint(JointType::REVOLUTE, pBodyA, pBodyB)
+{
+    ToLocal(pBodyA, anchorX, anchorY, m_LocalA[0], m_LocalA[1]);
+    ToLocal(pBodyB, anchorX, anchorY, m_LocalB[0], m_LocalB[1]);
+    m_ReferenceAngle = pBodyB->GetRotation() - pBodyA->GetRotation();
+}
+
+float RevoluteJoint::GetAngle() const {
+    return m_pBodyB->GetRotation() - m_pBodyA->GetRotation() - m_ReferenceAngle;
+}
+
+void RevoluteJoint::Prepare(float /*dt*/) {
+    Rotate(m_pBodyA->GetRotation(), m_LocalA, m_Ra);
+    Rotate(m_pBodyB->GetRotation(), m_LocalB, m_Rb);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    m_AxialMass = iA + iB > 0.0f ? 1.0f / (iA + iB) : 0.0f;
+
+    if (!enable_motor) m_MotorImpulse = 0.0f;
+    if (!enable_limit) {
+        m_LowerImpulse = 0.0f;
+        m_UpperImpulse = 0.0f;
+    }
+
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float axial = m_MotorImpulse + m_LowerImpulse - m_UpperImpulse;
+    ApplyImpulse(vA, mA, iA, m_Ra, m_Impulse[0], m_Impulse[1], axial, -1.0f);
+    ApplyImpulse(vB, mB, iB, m_Rb, m_Impulse[0], m_Impulse[1], axial, 1.0f);
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+void RevoluteJoint::SolveVelocity(float dt) {
+    float invDt = 1.0f / dt;
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+
+    if (enable_motor) {
+        float impulse = -m_AxialMass * (vB.w - vA.w - motor_speed);
+        float oldImpulse = m_MotorImpulse;
+        float maxImpulse = max_motor_torque * dt;
+        m_MotorImpulse = std::min(std::max(oldImpulse + impulse, -maxImpulse), maxImpulse);
+        impulse = m_MotorImpulse - oldImpulse;
+        vA.w -= iA * impulse;
+        vB.w += iB * impulse;
+    }
+
+    if (enable_limit) {
+        float angle = GetAngle();
+        // Lower limit; a positive C is a gap the bodies may still close this substep (speculative)
+        {
+            float c = angle - lower_angle;
+            float bias = c > 0.0f ? c * invDt : 0.0f;
+            float impulse = -m_AxialMass * (vB.w - vA.w + bias);
+            float oldImpulse = m_LowerImpulse;
+            m_LowerImpulse = std::max(oldImpulse + impulse, 0.0f);
+            impulse = m_LowerImpulse - oldImpulse;
+            vA.w -= iA * impulse;
+            vB.w += iB * impulse;
+        }
+        {
+            float c = upper_angle - angle;
+            float bias = c > 0.0f ? c * invDt : 0.0f;
+            float impulse = -m_AxialMass * (vA.w - vB.w + bias);
+            float oldImpulse = m_UpperImpulse;
+            m_UpperImpulse = std::max(oldImpulse + impulse, 0.0f);
+            impulse = m_UpperImpulse - oldImpulse;
+            vA.w += iA * impulse;
+            vB.w -= iB * impulse;
+        }
+    }
+
+    float pa[2], pb[2];
+    PointVelocity(vA, m_Ra, pa);
+    PointVelocity(vB, m_Rb, pb);
+    float k11, k12, k22, px, py;
+    PointMass(mA, iA, m_Ra, mB, iB, m_Rb, k11, k12, k22);
+    Solve22(k11, k12, k22, -(pb[0] - pa[0]), -(pb[1] - pa[1]), px, py);
+    m_Impulse[0] += px;
+    m_Impulse[1] += py;
+    ApplyImpulse(vA, mA, iA, m_Ra, px, py, 0.0f, -1.0f);
+    ApplyImpulse(vB, mB, iB, m_Rb, px, py, 0.0f, 1.0f);
+
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+float RevoluteJoint::SolvePosition(float compliance) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Placement cA = LoadPlacement(m_pBodyA), cB = LoadPlacement(m_pBodyB);
+
+    float angularError = 0.0f;
+    if (enable_limit && iA + iB > 0.0f) {
+        float angle = cB.a - cA.a - m_ReferenceAngle;
+        float c = 0.0f;
+        if (std::abs(upper_angle - lower_angle) < 2.0f * kAngularSlop) {
+            c = std::min(std::max(angle - lower_angle, -kMaxAngularCorrection), kMaxAngularCorrection);
+        } else if (angle <= lower_angle) {
+            c = std::min(std::max(angle - lower_angle + kAngularSlop, -kMaxAngularCorrection), 0.0f);
+        } else if (angle >= upper_angle) {
+            c = std::min(std::max(angle - upper_angle - kAngularSlop, 0.0f), kMaxAngularCorrection);
+        }
+        float impulse = -c / (iA + iB + compliance);
+        cA.a -= iA * impulse;
+        cB.a += iB * impulse;
+        angularError = std::abs(c);
+    }
+
+    float rA[2], rB[2];
+    Rotate(cA.a, m_LocalA, rA);
+    Rotate(cB.a, m_LocalB, rB);
+    float cx = cB.x + rB[0] - cA.x - rA[0];
+    float cy = cB.y + rB[1] - cA.y - rA[1];
+    float k11, k12, k22, px, py;
+    PointMass(mA, iA, rA, mB, iB, rB, k11, k12, k22);
+    Solve22(k11 + compliance, k12, k22 + compliance, -cx, -cy, px, py);
+    ApplyPositionImpulse(cA, mA, iA, rA, px, py, 0.0f, -1.0f);
+    ApplyPositionImpulse(cB, mB, iB, rB, px, py, 0.0f, 1.0f);
+
+    StorePlacement(m_pBodyA, cA);
+    StorePlacement(m_pBodyB, cB);
+    return std::max(std::sqrt(cx * cx + cy * cy), angularError);
+}
+
+void RevoluteJoint::ApplyMotor(float dt) {
+    if (!enable_motor) return;
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    if (iA + iB <= 0.0f) return;
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+    float maxImpulse = max_motor_torque * dt;
+    float impulse = -(vB.w - vA.w - motor_speed) / (iA + iB);
+    impulse = std::min(std::max(impulse, -maxImpulse), maxImpulse);
+    vA.w -= iA * impulse;
+    vB.w += iB * impulse;
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+void RevoluteJoint::StoreReaction(float invDt) {
+    m_ReactionX = m_Impulse[0] * invDt;
+    m_ReactionY = m_Impulse[1] * invDt;
+    m_ReactionTorque = (m_MotorImpulse + m_LowerImpulse - m_UpperImpulse) * invDt;
+}
+
+void RevoluteJoint::ResetImpulses() {
+    m_Impulse[0] = m_Impulse[1] = 0.0f;
+    m_MotorImpulse = m_LowerImpulse = m_UpperImpulse = 0.0f;
+}
+
+// ---------------- PrismaticJoint ----------------
+
+PrismaticJoint::PrismaticJoint(Body* pBodyA, Body* pBodyB, float anchorX, float anchorY, float axisX, float axisY)
+    : Joint(JointType::PRISMATIC, pBodyA, pBodyB)
+{
+    float length = std::sqrt(axisX * axisX + axisY * axisY);
+    if (!(length > 0.0f)) throw std::runtime_error("PrismaticJoint: axis must be non-zero");
+    ToLocal(pBodyA, anchorX, anchorY, m_LocalA[0], m_LocalA[1]);
+    ToLocal(pBodyB, anchorX, anchorY, m_LocalB[0], m_LocalB[1]);
+    float world[2] = {axisX / length, axisY / length};
+    Rotate(-pBodyA->GetRotation(), world, m_LocalAxis);
+    m_ReferenceAngle = pBodyB->GetRotation() - pBodyA->GetRotation();
+}
+
+float PrismaticJoint::GetTranslation() const {
+    float rA[2], rB[2], axis[2];
+    Rotate(m_pBodyA->GetRotation(), m_LocalA, rA);
+    Rotate(m_pBodyB->GetRotation(), m_LocalB, rB);
+    Rotate(m_pBodyA->GetRotation(), m_LocalAxis, axis);
+    float dx = m_pBodyB->GetX() + rB[0] - m_pBodyA->GetX() - rA[0];
+    float dy = m_pBodyB->GetY() + rB[1] - m_pBodyA->GetY() - rA[1];
+    return axis[0] * dx + axis[1] * dy;
+}
+
+void PrismaticJoint::Prepare(float /*dt*/) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Rotate(m_pBodyA->GetRotation(), m_LocalA, m_Ra);
+    Rotate(m_pBodyB->GetRotation(), m_LocalB, m_Rb);
+    Rotate(m_pBodyA->GetRotation(), m_LocalAxis, m_Axis);
+    m_Perp[0] = -m_Axis[1];
+    m_Perp[1] = m_Axis[0];
+
+    // d + rA: from A's center to B's anchor
+    float d[2] = {m_pBodyB->GetX() + m_Rb[0] - m_pBodyA->GetX() - m_Ra[0],
+                  m_pBodyB->GetY() + m_Rb[1] - m_pBodyA->GetY() - m_Ra[1]};
+    float dRa[2] = {d[0] + m_Ra[0], d[1] + m_Ra[1]};
+    m_A1 = Cross(dRa, m_Axis);
+    m_A2 = Cross(m_Rb, m_Axis);
+    m_S1 = Cross(dRa, m_Perp);
+    m_S2 = Cross(m_Rb, m_Perp);
+    float axialMass = mA + mB + iA * m_A1 * m_A1 + iB * m_A2 * m_A2;
+    m_AxialMass = axialMass > 0.0f ? 1.0f / axialMass : 0.0f;
+    m_Translation = m_Axis[0] * d[0] + m_Axis[1] * d[1];
+
+    if (!enable_limit) {
+        m_LowerImpulse = 0.0f;
+        m_UpperImpulse = 0.0f;
+    }
+
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+    float axial = m_LowerImpulse - m_UpperImpulse;
+    float px = m_Impulse[0] * m_Perp[0] + axial * m_Axis[0];
+    float py = m_Impulse[0] * m_Perp[1] + axial * m_Axis[1];
+    float lA = m_Impulse[0] * m_S1 + m_Impulse[1] + axial * m_A1;
+    float lB = m_Impulse[0] * m_S2 + m_Impulse[1] + axial * m_A2;
+    vA.vx -= mA * px; vA.vy -= mA * py; vA.w -= iA * lA;
+    vB.vx += mB * px; vB.vy += mB * py; vB.w += iB * lB;
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+void PrismaticJoint::SolveVelocity(float dt) {
+    float invDt = 1.0f / dt;
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+
+    auto applyAxial = [&](float impulse) {
+        vA.vx -= mA * impulse * m_Axis[0]; vA.vy -= mA * impulse * m_Axis[1]; vA.w -= iA * impulse * m_A1;
+        vB.vx += mB * impulse * m_Axis[0]; vB.vy += mB * impulse * m_Axis[1]; vB.w += iB * impulse * m_A2;
+    };
+
+    if (enable_limit) {
+        {
+            float c = m_Translation - lower_translation;
+            float bias = c > 0.0f ? c * invDt : 0.0f;
+            float cdot = m_Axis[0] * (vB.vx - vA.vx) + m_Axis[1] * (vB.vy - vA.vy) + m_A2 * vB.w - m_A1 * vA.w;
+            float impulse = -m_AxialMass * (cdot + bias);
+            float oldImpulse = m_LowerImpulse;
+            m_LowerImpulse = std::max(oldImpulse + impulse, 0.0f);
+            applyAxial(m_LowerImpulse - oldImpulse);
+        }
+        {
+            float c = upper_translation - m_Translation;
+            float bias = c > 0.0f ? c * invDt : 0.0f;
+            float cdot = m_Axis[0] * (vA.vx - vB.vx) + m_Axis[1] * (vA.vy - vB.vy) + m_A1 * vA.w - m_A2 * vB.w;
+            float impulse = -m_AxialMass * (cdot + bias);
+            float oldImpulse = m_UpperImpulse;
+            m_UpperImpulse = std::max(oldImpulse + impulse, 0.0f);
+            applyAxial(-(m_UpperImpulse - oldImpulse));
+        }
+    }
+
+    // Perpendicular and angular rows together
+    float cdot1 = m_Perp[0] * (vB.vx - vA.vx) + m_Perp[1] * (vB.vy - vA.vy) + m_S2 * vB.w - m_S1 * vA.w;
+    float cdot2 = vB.w - vA.w;
+    float k11 = mA + mB + iA * m_S1 * m_S1 + iB * m_S2 * m_S2;
+    float k12 = iA * m_S1 + iB * m_S2;
+    float k22 = iA + iB;
+    if (k22 == 0.0f) k22 = 1.0f;  // Both rotations fixed
+    float df1, df2;
+    Solve22(k11, k12, k22, -cdot1, -cdot2, df1, df2);
+    m_Impulse[0] += df1;
+    m_Impulse[1] += df2;
+    float px = df1 * m_Perp[0], py = df1 * m_Perp[1];
+    float lA = df1 * m_S1 + df2;
+    float lB = df1 * m_S2 + df2;
+    vA.vx -= mA * px; vA.vy -= mA * py; vA.w -= iA * lA;
+    vB.vx += mB * px; vB.vy += mB * py; vB.w += iB * lB;
+
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+float PrismaticJoint::SolvePosition(float compliance) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Placement cA = LoadPlacement(m_pBodyA), cB = LoadPlacement(m_pBodyB);
+
+    float rA[2], rB[2], axis[2];
+    Rotate(cA.a, m_LocalA, rA);
+    Rotate(cB.a, m_LocalB, rB);
+    Rotate(cA.a, m_LocalAxis, axis);
+    float perp[2] = {-axis[1], axis[0]};
+    float d[2] = {cB.x + rB[0] - cA.x - rA[0], cB.y + rB[1] - cA.y - rA[1]};
+    float dRa[2] = {d[0] + rA[0], d[1] + rA[1]};
+    float a1 = Cross(dRa, axis), a2 = Cross(rB, axis);
+    float s1 = Cross(dRa, perp), s2 = Cross(rB, perp);
+
+    Eigen::Vector3f c(perp[0] * d[0] + perp[1] * d[1], cB.a - cA.a - m_ReferenceAngle, 0.0f);
+    float linearError = std::abs(c(0));
+    float angularError = std::abs(c(1));
+
+    bool bActive = false;
+    if (enable_limit) {
+        float translation = axis[0] * d[0] + axis[1] * d[1];
+        if (std::abs(upper_translation - lower_translation) < 2.0f * kLinearSlop) {
+            c(2) = translation - lower_translation;
+            linearError = std::max(linearError, std::abs(c(2)));
+            bActive = true;
+        } else if (translation <= lower_translation) {
+            c(2) = std::min(translation - lower_translation, 0.0f);
+            linearError = std::max(linearError, lower_translation - translation);
+            bActive = true;
+        } else if (translation >= upper_translation) {
+            c(2) = std::max(translation - upper_translation, 0.0f);
+            linearError = std::max(linearError, translation - upper_translation);
+            bActive = true;
+        }
+    }
+
+    float k11 = mA + mB + iA * s1 * s1 + iB * s2 * s2 + compliance;
+    float k12 = iA * s1 + iB * s2;
+    float k22 = iA + iB;
+    if (k22 == 0.0f) k22 = 1.0f;
+    k22 += compliance;
+    Eigen::Vector3f impulse;
+    if (bActive) {
+        float k13 = iA * s1 * a1 + iB * s2 * a2;
+        float k23 = iA * a1 + iB * a2;
+        float k33 = mA + mB + iA * a1 * a1 + iB * a2 * a2 + compliance;
+        Eigen::Matrix3f k;
+        k << k11, k12, k13,
+             k12, k22, k23,
+             k13, k23, k33;
+        Solve33(k, -c, impulse);
+    } else {
+        Solve22(k11, k12, k22, -c(0), -c(1), impulse(0), impulse(1));
+        impulse(2) = 0.0f;
+    }
+
+    float px = impulse(0) * perp[0] + impulse(2) * axis[0];
+    float py = impulse(0) * perp[1] + impulse(2) * axis[1];
+    float lA = impulse(0) * s1 + impulse(1) + impulse(2) * a1;
+    float lB = impulse(0) * s2 + impulse(1) + impulse(2) * a2;
+    cA.x -= mA * px; cA.y -= mA * py; cA.a -= iA * lA;
+    cB.x += mB * px; cB.y += mB * py; cB.a += iB * lB;
+
+    StorePlacement(m_pBodyA, cA);
+    StorePlacement(m_pBodyB, cB);
+    return std::max(linearError, angularError);
+}
+
+void PrismaticJoint::StoreReaction(float invDt) {
+    float axial = m_LowerImpulse - m_UpperImpulse;
+    m_ReactionX = (m_Impulse[0] * m_Perp[0] + axial * m_Axis[0]) * invDt;
+    m_ReactionY = (m_Impulse[0] * m_Perp[1] + axial * m_Axis[1]) * invDt;
+    m_ReactionTorque = m_Impulse[1] * invDt;
+}
+
+void PrismaticJoint::ResetImpulses() {
+    m_Impulse[0] = m_Impulse[1] = 0.0f;
+    m_LowerImpulse = m_UpperImpulse = 0.0f;
+}
+
+// ---------------- WeldJoint ----------------
+
+WeldJoint::WeldJoint(Body* pBodyA, Body* pBodyB, float anchorX, float anchorY)
+    : Joint(JointType::WELD, pBodyA, pBodyB)
+{
+    ToLocal(pBodyA, anchorX, anchorY, m_LocalA[0], m_LocalA[1]);
+    ToLocal(pBodyB, anchorX, anchorY, m_LocalB[0], m_LocalB[1]);
+    m_ReferenceAngle = pBodyB->GetRotation() - pBodyA->GetRotation();
+}
+
+// Effective mass of the point + angle rows
+static Eigen::Matrix3f WeldMass(float mA, float iA, const float* rA, float mB, float iB, const float* rB) {
+    float k11, k12, k22;
+    PointMass(mA, iA, rA, mB, iB, rB, k11, k12, k22);
+    float k13 = -rA[1] * iA - rB[1] * iB;
+    float k23 = rA[0] * iA + rB[0] * iB;
+    Eigen::Matrix3f k;
+    k << k11, k12, k13,
+         k12, k22, k23,
+         k13, k23, iA + iB;
+    return k;
+}
+
+void WeldJoint::Prepare(float /*dt*/) {
+    Rotate(m_pBodyA->GetRotation(), m_LocalA, m_Ra);
+    Rotate(m_pBodyB->GetRotation(), m_LocalB, m_Rb);
+
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+    ApplyImpulse(vA, mA, iA, m_Ra, m_Impulse[0], m_Impulse[1], m_Impulse[2], -1.0f);
+    ApplyImpulse(vB, mB, iB, m_Rb, m_Impulse[0], m_Impulse[1], m_Impulse[2], 1.0f);
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+void WeldJoint::SolveVelocity(float /*dt*/) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+
+    float pa[2], pb[2];
+    PointVelocity(vA, m_Ra, pa);
+    PointVelocity(vB, m_Rb, pb);
+    Eigen::Vector3f cdot(pb[0] - pa[0], pb[1] - pa[1], vB.w - vA.w);
+    Eigen::Vector3f impulse;
+    Solve33(WeldMass(mA, iA, m_Ra, mB, iB, m_Rb), -cdot, impulse);
+    m_Impulse[0] += impulse(0);
+    m_Impulse[1] += impulse(1);
+    m_Impulse[2] += impulse(2);
+    ApplyImpulse(vA, mA, iA, m_Ra, impulse(0), impulse(1), impulse(2), -1.0f);
+    ApplyImpulse(vB, mB, iB, m_Rb, impulse(0), impulse(1), impulse(2), 1.0f);
+
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+float WeldJoint::SolvePosition(float compliance) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Placement cA = LoadPlacement(m_pBodyA), cB = LoadPlacement(m_pBodyB);
+
+    float rA[2], rB[2];
+    Rotate(cA.a, m_LocalA, rA);
+    Rotate(cB.a, m_LocalB, rB);
+    Eigen::Vector3f c(cB.x + rB[0] - cA.x - rA[0], cB.y + rB[1] - cA.y - rA[1], cB.a - cA.a - m_ReferenceAngle);
+    Eigen::Vector3f impulse;
+    Solve33(WeldMass(mA, iA, rA, mB, iB, rB) + compliance * Eigen::Matrix3f::Identity(), -c, impulse);
+    ApplyPositionImpulse(cA, mA, iA, rA, impulse(0), impulse(1), impulse(2), -1.0f);
+    ApplyPositionImpulse(cB, mB, iB, rB, impulse(0), impulse(1), impulse(2), 1.0f);
+
+    StorePlacement(m_pBodyA, cA);
+    StorePlacement(m_pBodyB, cB);
+    return std::max(c.head<2>().norm(), std::abs(c(2)));
+}
+
+void WeldJoint::StoreReaction(float invDt) {
+    m_ReactionX = m_Impulse[0] * invDt;
+    m_ReactionY = m_Impulse[1] * invDt;
+    m_ReactionTorque = m_Impulse[2] * invDt;
+}
+
+void WeldJoint::ResetImpulses() {
+    m_Impulse[0] = m_Impulse[1] = m_Impulse[2] = 0.0f;
+}
+
+// ---------------- DistanceJoint ----------------
+
+DistanceJoint::DistanceJoint(Body* pBodyA, Body* pBodyB, float anchorAX, float anchorAY, float anchorBX,
+                             float anchorBY, bool rope)
+    : Joint(JointType::DISTANCE, pBodyA, pBodyB), rope(rope)
+{
+    ToLocal(pBodyA, anchorAX, anchorAY, m_LocalA[0], m_LocalA[1]);
+    ToLocal(pBodyB, anchorBX, anchorBY, m_LocalB[0], m_LocalB[1]);
+    float dx = anchorBX - anchorAX, dy = anchorBY - anchorAY;
+    length = std::sqrt(dx * dx + dy * dy);
+}
+
+float DistanceJoint::GetCurrentLength() const {
+    float rA[2], rB[2];
+    Rotate(m_pBodyA->GetRotation(), m_LocalA, rA);
+    Rotate(m_pBodyB->GetRotation(), m_LocalB, rB);
+    float dx = m_pBodyB->GetX() + rB[0] - m_pBodyA->GetX() - rA[0];
+    float dy = m_pBodyB->GetY() + rB[1] - m_pBodyA->GetY() - rA[1];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+void DistanceJoint::Prepare(float /*dt*/) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Rotate(m_pBodyA->GetRotation(), m_LocalA, m_Ra);
+    Rotate(m_pBodyB->GetRotation(), m_LocalB, m_Rb);
+    m_U[0] = m_pBodyB->GetX() + m_Rb[0] - m_pBodyA->GetX() - m_Ra[0];
+    m_U[1] = m_pBodyB->GetY() + m_Rb[1] - m_pBodyA->GetY() - m_Ra[1];
+    m_CurrentLength = std::sqrt(m_U[0] * m_U[0] + m_U[1] * m_U[1]);
+    if (m_CurrentLength > kLinearSlop) {
+        m_U[0] /= m_CurrentLength;
+        m_U[1] /= m_CurrentLength;
+    } else {
+        m_U[0] = m_U[1] = 0.0f;
+    }
+    float crA = Cross(m_Ra, m_U), crB = Cross(m_Rb, m_U);
+    float invMass = mA + iA * crA * crA + mB + iB * crB * crB;
+    m_Mass = invMass != 0.0f ? 1.0f / invMass : 0.0f;
+
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+    ApplyImpulse(vA, mA, iA, m_Ra, m_Impulse * m_U[0], m_Impulse * m_U[1], 0.0f, -1.0f);
+    ApplyImpulse(vB, mB, iB, m_Rb, m_Impulse * m_U[0], m_Impulse * m_U[1], 0.0f, 1.0f);
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+void DistanceJoint::SolveVelocity(float dt) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Velocity vA = LoadVelocity(m_pBodyA), vB = LoadVelocity(m_pBodyB);
+
+    float pa[2], pb[2];
+    PointVelocity(vA, m_Ra, pa);
+    PointVelocity(vB, m_Rb, pb);
+    float cdot = m_U[0] * (pb[0] - pa[0]) + m_U[1] * (pb[1] - pa[1]);
+
+    float impulse;
+    if (rope) {
+        // Pull only; slack may close within the substep but not overshoot
+        float c = length - m_CurrentLength;
+        impulse = -m_Mass * (cdot - std::max(c, 0.0f) / dt);
+        float oldImpulse = m_Impulse;
+        m_Impulse = std::min(oldImpulse + impulse, 0.0f);
+        impulse = m_Impulse - oldImpulse;
+    } else {
+        impulse = -m_Mass * cdot;
+        m_Impulse += impulse;
+    }
+    ApplyImpulse(vA, mA, iA, m_Ra, impulse * m_U[0], impulse * m_U[1], 0.0f, -1.0f);
+    ApplyImpulse(vB, mB, iB, m_Rb, impulse * m_U[0], impulse * m_U[1], 0.0f, 1.0f);
+
+    StoreVelocity(m_pBodyA, vA);
+    StoreVelocity(m_pBodyB, vB);
+}
+
+float DistanceJoint::SolvePosition(float compliance) {
+    float mA = InvMass(m_pBodyA), mB = InvMass(m_pBodyB);
+    float iA = InvInertia(m_pBodyA), iB = InvInertia(m_pBodyB);
+    Placement cA = LoadPlacement(m_pBodyA), cB = LoadPlacement(m_pBodyB);
+
+    float rA[2], rB[2];
+    Rotate(cA.a, m_LocalA, rA);
+    Rotate(cB.a, m_LocalB, rB);
+    float u[2] = {cB.x + rB[0] - cA.x - rA[0], cB.y + rB[1] - cA.y - rA[1]};
+    float current = std::sqrt(u[0] * u[0] + u[1] * u[1]);
+    if (current <= kLinearSlop) return 0.0f;
+    u[0] /= current;
+    u[1] /= current;
+
+    float c = current - length;
+    c = rope ? std::min(std::max(c, 0.0f), kMaxLinearCorrection)
+             : std::min(std::max(c, -kMaxLinearCorrection), kMaxLinearCorrection);
+    float crA = Cross(rA, u), crB = Cross(rB, u);
+    float invMass = mA + iA * crA * crA + mB + iB * crB * crB + compliance;
+    float impulse = invMass != 0.0f ? -c / invMass : 0.0f;
+    ApplyPositionImpulse(cA, mA, iA, rA, impulse * u[0], impulse * u[1], 0.0f, -1.0f);
+    ApplyPositionImpulse(cB, mB, iB, rB, impulse * u[0], impulse * u[1], 0.0f, 1.0f);
+
+    StorePlacement(m_pBodyA, cA);
+    StorePlacement(m_pBodyB, cB);
+    return std::abs(c);
+}
+
+void DistanceJoint::StoreReaction(float invDt) {
+    m_ReactionX = m_Impulse * m_U[0] * invDt;
+    m_ReactionY = m_Impulse * m_U[1] * invDt;
+    m_ReactionTorque = 0.0f;
+}
+
+void DistanceJoint::ResetImpulses() {
+    m_Impulse = 0.0f;
+}
+
+// ---------------- Engine integration ----------------
+
+void Engine::AddJoint(Joint* pJoint) {
+    if (!pJoint) throw std::runtime_error("Engine::AddJoint: joint is null");
+    if (std::find(m_Joints.begin(), m_Joints.end(), pJoint) != m_Joints.end()) return;
+    m_Joints.push_back(pJoint);
+}
+
+void Engine::RemoveJoint(Joint* pJoint) {
+    m_Joints.erase(std::remove(m_Joints.begin(), m_Joints.end(), pJoint), m_Joints.end());
+}
+
+void Engine::ClearJoints() {
+    m_Joints.clear();
+}
+
+bool Engine::JointPreventsCollision(Body* pBodyA, Body* pBodyB) const {
+    for (const Joint* pJoint : m_Joints) {
+        if (pJoint->collide_connected) continue;
+        if ((pJoint->m_pBodyA == pBodyA && pJoint->m_pBodyB == pBodyB) ||
+            (pJoint->m_pBodyA == pBodyB && pJoint->m_pBodyB == pBodyA)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Engine::SolveJoints(float subDt) {
+    // Velocities as integrated, to apply the position change the joint impulses imply.
+    // Member buffers, so the substep loop does not allocate once they have grown.
+    m_JointBodies.clear();
+    for (Joint* pJoint : m_Joints) {
+        if (!pJoint->m_pBodyA->is_static) m_JointBodies.push_back(pJoint->m_pBodyA);
+        if (!pJoint->m_pBodyB->is_static) m_JointBodies.push_back(pJoint->m_pBodyB);
+    }
+    std::sort(m_JointBodies.begin(), m_JointBodies.end());
+    m_JointBodies.erase(std::unique(m_JointBodies.begin(), m_JointBodies.end()), m_JointBodies.end());
+    m_JointVelocities.resize(3 * m_JointBodies.size());
+    for (size_t i = 0; i < m_JointBodies.size(); ++i) {
+        Velocity v = LoadVelocity(m_JointBodies[i]);
+        m_JointVelocities[3 * i] = v.vx;
+        m_JointVelocities[3 * i + 1] = v.vy;
+        m_JointVelocities[3 * i + 2] = v.w;
+    }
+
+    for (Joint* pJoint : m_Joints) pJoint->Prepare(subDt);
+    for (int i = 0; i < m_VelocityIterations; ++i) {
+        for (Joint* pJoint : m_Joints) pJoint->SolveVelocity(subDt);
+    }
+    float invDt = 1.0f / subDt;
+    for (Joint* pJoint : m_Joints) pJoint->StoreReaction(invDt);
+
+    for (size_t i = 0; i < m_JointBodies.size(); ++i) {
+        Body* pBody = m_JointBodies[i];
+        const float* pIntegrated = &m_JointVelocities[3 * i];
+        Velocity v = LoadVelocity(pBody);
+        pBody->SetPosition(pBody->GetX() + (v.vx - pIntegrated[0]) * subDt,
+                           pBody->GetY() + (v.vy - pIntegrated[1]) * subDt);
+        pBody->SetRotation(pBody->GetRotation() + (v.w - pIntegrated[2]) * subDt);
+    }
+
+    for (int i = 0; i < m_PositionIterations; ++i) {
+        float maxError = 0.0f;
+        for (Joint* pJoint : m_Joints) maxError = std::max(maxError, pJoint->SolvePosition(0.0f));
+        if (maxError < kLinearSlop) break;
+    }
+}
@@ -0,0 +1,387 @@
+#include "engine/lazy.h"
+#include "engine/profiler.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+// Elements processed per inner loop. Register tiles stay in L1.
+static constexpr int LAZY_TILE = 256;
+
+struct LazyNode {
+    LazyOp op = LazyOp::LEAF;
+    std::shared_ptr<LazyNode> pA;
+    std::shared_ptr<LazyNode> pB;
+    float s0 = 0.0f;
+    float s1 = 0.0f;
+    Tensor* pLeaf = nullptr;
+    int rows = 0;
+    int cols = 0;
+
+    // Compiled program, built on first Materialize() of this root
+    std::shared_ptr<LazyKernel> pKernel;
+};
+
+// One register-machine instruction: reg[out] = op(reg[a], reg[b])
+struct LazyInstr {
+    LazyOp op;
+    int a;
+    int b;
+    float s0;
+    float s1;
+};
+
+struct LazyKernel {
+    std::vector<Tensor*> leaves;      // Register i < leaves.size() holds leaf i
+    std::vector<LazyInstr> program;   // Register leaves.size() + k holds instruction k
+    int rows = 0;
+    int cols = 0;
+
+    int NumRegs() const { return (int)(leaves.size() + program.size()); }
+};
+
+// ---------------- Construction ----------------
+
+LazyExpr::LazyExpr(const Tensor& leaf) {
+    m_pNode = std::make_shared<LazyNode>();
+    m_pNode->op = LazyOp::LEAF;
+    m_pNode->pLeaf = const_cast<Tensor*>(&leaf);
+    m_pNode->rows = leaf.Rows();
+    m_pNode->cols = leaf.Cols();
+}
+
+LazyExpr::LazyExpr(std::shared_ptr<LazyNode> pNode) : m_pNode(std::move(pNode)) {}
+
+int LazyExpr::Rows() const { return m_pNode->rows; }
+int LazyExpr::Cols() const { return m_pNode->cols; }
+
+LazyExpr LazyExpr::Unary(const LazyExpr& a, LazyOp op, float s0, float s1) {
+    auto pNode = std::make_shared<LazyNode>();
+    pNode->op = op;
+    pNode->pA = a.m_pNode;
+    pNode->s0 = s0;
+    pNode->s1 = s1;
+    pNode->rows = a.Rows();
+    pNode->cols = a.Cols();
+    return LazyExpr(pNode);
+}
+
+LazyExpr LazyExpr::Binary(const LazyExpr& a, const LazyExpr& b, LazyOp op) {
+    bool bScalarA = (a.Rows() == 1 && a.Cols() == 1);
+    bool bScalarB = (b.Rows() == 1 && b.Cols() == 1);
+    if (!bScalarA && !bScalarB && (a.Rows() != b.Rows() || a.Cols() != b.Cols())) {
+        throw std::runtime_error("Dimension mismatch in LazyExpr " +
+            std::to_string(a.Rows()) + "x" + std::to_string(a.Cols()) + " vs " +
+            std::to_string(b.Rows()) + "x" + std::to_string(b.Cols()));
+    }
+    auto pNode = std::make_shared<LazyNode>();
+    pNode->op = op;
+    pNode->pA = a.m_pNode;
+    pNode->pB = b.m_pNode;
+    pNode->rows = bScalarA ? b.Rows() : a.Rows();
+    pNode->cols = bScalarA ? b.Cols() : a.Cols();
+    return LazyExpr(pNode);
+}
+
+LazyExpr LazyExpr::operator+(const LazyExpr& other) const { return Binary(*this, other, LazyOp::ADD); }
+LazyExpr LazyExpr::operator-(const LazyExpr& other) const { return Binary(*this, other, LazyOp::SUB); }
+LazyExpr LazyExpr::operator*(const LazyExpr& other) const { return Binary(*this, other, LazyOp::MUL); }
+LazyExpr LazyExpr::operator/(const LazyExpr& other) const { return Binary(*this, other, LazyOp::DIV); }
+
+LazyExpr LazyExpr::operator+(float scalar) const { return Unary(*this, LazyOp::ADD_SCALAR, scalar); }
+LazyExpr LazyExpr::operator-(float scalar) const { return Unary(*this, LazyOp::ADD_SCALAR, -scalar); }
+LazyExpr LazyExpr::operator*(float scalar) const { return Unary(*this, LazyOp::MUL_SCALAR, scalar); }
+LazyExpr LazyExpr::operator-() const { return Unary(*this, LazyOp::MUL_SCALAR, -1.0f); }
+
+LazyExpr LazyExpr::Pow(float exponent) const { return Unary(*this, LazyOp::POW, exponent); }
+LazyExpr LazyExpr::Exp() const { return Unary(*this, LazyOp::EXP); }
+LazyExpr LazyExpr::Log() const { return Unary(*this, LazyOp::LOG); }
+LazyExpr LazyExpr::Sqrt() const { return Unary(*this, LazyOp::SQRT); }
+LazyExpr LazyExpr::Abs() const { return Unary(*this, LazyOp::ABS); }
+LazyExpr LazyExpr::Sin() const { return Unary(*this, LazyOp::SIN); }
+LazyExpr LazyExpr::Cos() const { return Unary(*this, LazyOp::COS); }
+LazyExpr LazyExpr::Tanh() const { return Unary(*this, LazyOp::TANH); }
+LazyExpr LazyExpr::Clamp(float minVal, float maxVal) const { return Unary(*this, LazyOp::CLAMP, minVal, maxVal); }
+
+LazyExpr Tensor::Lazy() const { return LazyExpr(*this); }
+
+// ---------------- Compilation ----------------
+
+std::shared_ptr<LazyKernel> LazyExpr::Compile() const {
+    if (m_pNode->pKernel) return m_pNode->pKernel;
+
+    auto pKernel = std::make_shared<LazyKernel>();
+    pKernel->rows = m_pNode->rows;
+    pKernel->cols = m_pNode->cols;
+
+    // Pass 1: collect unique leaves and interior nodes in post-order.
+    // Iterative DFS (same pattern as Tensor::Backward) so deep chains can't overflow.
+    std::unordered_map<const LazyNode*, int> leafIndex;
+    std::unordered_map<const Tensor*, int> tensorIndex;
+    std::unordered_map<const LazyNode*, int> instrIndex;
+    std::vector<const LazyNode*> order;
+    std::vector<std::pair<const LazyNode*, bool>> stack;
+    stack.push_back({m_pNode.get(), false});
+
+    while (!stack.empty()) {
+        auto [pNode, bExpanded] = stack.back();
+        stack.pop_back();
+
+        if (pNode->op == LazyOp::LEAF) {
+            if (leafIndex.count(pNode)) continue;
+            auto it = tensorIndex.find(pNode->pLeaf);
+            if (it == tensorIndex.end()) {
+                int idx = (int)pKernel->leaves.size();
+                pKernel->leaves.push_back(pNode->pLeaf);
+                it = tensorIndex.insert({pNode->pLeaf, idx}).first;
+            }
+            leafIndex[pNode] = it->second;
+            continue;
+        }
+        if (instrIndex.count(pNode)) continue;
+
+        if (bExpanded) {
+            instrIndex[pNode] = (int)order.size();
+            order.push_back(pNode);
+        } else {
+            stack.push_back({pNode, true});
+            if (pNode->pB) stack.push_back({pNode->pB.get(), false});
+            stack.push_back({pNode->pA.get(), false});
+        }
+    }
+
+    // Pass 2: emit instructions now that the leaf register count is known
+    int numLeaves = (int)pKernel->leaves.size();
+    auto regOf = [&](const LazyNode* pNode) {
+        if (pNode->op == LazyOp::LEAF) return leafIndex.at(pNode);
+        return numLeaves + instrIndex.at(pNode);
+    };
+
+    for (const LazyNode* pNode : order) {
+        LazyInstr instr;
+        instr.op = pNode->op;
+        instr.a = regOf(pNode->pA.get());
+        instr.b = pNode->pB ? regOf(pNode->pB.get()) : -1;
+        instr.s0 = pNode->s0;
+        instr.s1 = pNode->s1;
+        pKernel->program.push_back(instr);
+    }
+
+    m_pNode->pKernel = pKernel;
+    return pKernel;
+}
+
+int LazyExpr::NumInstructions() const {
+    return (int)Compile()->program.size();
+}
+
+// ---------------- Evaluation ----------------
+
+using TileArray = Eigen::Map<Eigen::ArrayXf>;
+
+// Load leaf values for elements [start, start + n) into register tiles
+static void LoadLeaves(const LazyKernel& kernel, float* pRegs, int start, int n,
+                       const std::vector<const float*>& leafData, const std::vector<bool>& leafScalar) {
+    for (size_t l = 0; l < kernel.leaves.size(); ++l) {
+        TileArray r(pRegs + l * LAZY_TILE, n);
+        if (leafScalar[l]) {
+            r.setConstant(leafData[l][0]);
+        } else {
+            r = Eigen::Map<const Eigen::ArrayXf>(leafData[l] + start, n);
+        }
+    }
+}
+
+// Forward sweep over one tile
+static void RunForward(const LazyKernel& kernel, float* pRegs, int n) {
+    int numLeaves = (int)kernel.leaves.size();
+    for (size_t k = 0; k < kernel.program.size(); ++k) {
+        const LazyInstr& in = kernel.program[k];
+        TileArray out(pRegs + (numLeaves + k) * LAZY_TILE, n);
+        TileArray a(pRegs + in.a * LAZY_TILE, n);
+        switch (in.op) {
+            case LazyOp::ADD: out = a + TileArray(pRegs + in.b * LAZY_TILE, n); break;
+            case LazyOp::SUB: out = a - TileArray(pRegs + in.b * LAZY_TILE, n); break;
+            case LazyOp::MUL: out = a * TileArray(pRegs + in.b * LAZY_TILE, n); break;
+            case LazyOp::DIV: out = a / TileArray(pRegs + in.b * LAZY_TILE, n); break;
+            case LazyOp::ADD_SCALAR: out = a + in.s0; break;
+            case LazyOp::MUL_SCALAR: out = a * in.s0; break;
+            case LazyOp::POW: out = a.pow(in.s0); break;
+            case LazyOp::EXP: out = a.exp(); break;
+            case LazyOp::LOG: out = a.log(); break;
+            case LazyOp::SQRT: out = a.sqrt(); break;
+            case LazyOp::ABS: out = a.abs(); break;
+            case LazyOp::SIN: out = a.sin(); break;
+            case LazyOp::COS: out = a.cos(); break;
+            case LazyOp::TANH: out = a.tanh(); break;
+            case LazyOp::CLAMP: out = a.max(in.s0).min(in.s1); break;
+            case LazyOp::LEAF: break;
+        }
+    }
+}
+
+// Reverse sweep over one tile. pAdj holds the output adjoint in the last register.
+static void RunBackward(const LazyKernel& kernel, const float* pRegs, float* pAdj, int n) {
+    int numLeaves = (int)kernel.leaves.size();
+    for (int k = (int)kernel.program.size() - 1; k >= 0; --k) {
+        const LazyInstr& in = kernel.program[k];
+        int outReg = numLeaves + k;
+        Eigen::Map<const Eigen::ArrayXf> g(pAdj + outReg * LAZY_TILE, n);
+        Eigen::Map<const Eigen::ArrayXf> out(pRegs + outReg * LAZY_TILE, n);
+        Eigen::Map<const Eigen::ArrayXf> a(pRegs + in.a * LAZY_TILE, n);
+        TileArray ga(pAdj + in.a * LAZY_TILE, n);
+
+        switch (in.op) {
+            case LazyOp::ADD:
+                ga += g;
+                TileArray(pAdj + in.b * LAZY_TILE, n) += g;
+                break;
+            case LazyOp::SUB:
+                ga += g;
+                TileArray(pAdj + in.b * LAZY_TILE, n) -= g;
+                break;
+            case LazyOp::MUL: {
+                Eigen::Map<const Eigen::ArrayXf> b(pRegs + in.b * LAZY_TILE, n);
+                TileArray gb(pAdj + in.b * LAZY_TILE, n);
+                ga += g * b;
+                gb += g * a;
+                break;
+            }
+            case LazyOp::DIV: {
+                Eigen::Map<const Eigen::ArrayXf> b(pRegs + in.b * LAZY_TILE, n);
+                TileArray gb(pAdj + in.b * LAZY_TILE, n);
+                ga += g / b;
+                gb -= g * out / b;
+                break;
+            }
+            case LazyOp::ADD_SCALAR: ga += g; break;
+            case LazyOp::MUL_SCALAR: ga += g * in.s0; break;
+            case LazyOp::POW: ga += g * in.s0 * a.pow(in.s0 - 1.0f); break;
+            case LazyOp::EXP: ga += g * out; break;
+            case LazyOp::LOG: ga += g / a; break;
+            case LazyOp::SQRT: ga += 0.5f * g / out; break;
+            case LazyOp::ABS: ga += g * a.sign(); break;
+            case LazyOp::SIN: ga += g * a.cos(); break;
+            case LazyOp::COS: ga -= g * a.sin(); break;
+            case LazyOp::TANH: ga += g * (1.0f - out.square()); break;
+            case LazyOp::CLAMP: ga += (a >= in.s0 && a <= in.s1).select(g, 0.0f); break;
+            case LazyOp::LEAF: break;
+        }
+    }
+}
+
+Tensor LazyExpr::Materialize() const {
+    ProfileScope profile("LazyFused");
+    std::shared_ptr<LazyKernel> pKernel = Compile();
+    const LazyKernel& kernel = *pKernel;
+
+    Tensor result(kernel.rows, kernel.cols, false);
+
+    // A bare leaf has nothing to fuse
+    if (kernel.program.empty()) {
+        return kernel.leaves[0]->Reshape(kernel.rows, kernel.cols);
+    }
+
+    int numLeaves = (int)kernel.leaves.size();
+    std::vector<const float*> leafData(numLeaves);
+    std::vector<bool> leafScalar(numLeaves);
+    bool bAnyGrad = false;
+    for (int l = 0; l < numLeaves; ++l) {
+        leafData[l] = kernel.leaves[l]->m_Data.data();
+        leafScalar[l] = (kernel.leaves[l]->m_Data.size() == 1);
+        bAnyGrad = bAnyGrad || kernel.leaves[l]->m_bRequiresGrad;
+    }
+
+    int total = (int)result.m_Data.size();
+    int outReg = kernel.NumRegs() - 1;
+    std::vector<float> regs((size_t)kernel.NumRegs() * LAZY_TILE);
+
+    for (int start = 0; start < total; start += LAZY_TILE) {
+        int n = std::min(LAZY_TILE, total - start);
+        LoadLeaves(kernel, regs.data(), start, n, leafData, leafScalar);
+        RunForward(kernel, regs.data(), n);
+        Eigen::Map<Eigen::ArrayXf>(result.m_Data.data() + start, n) =
+            Eigen::Map<const Eigen::ArrayXf>(regs.data() + outReg * LAZY_TILE, n);
+    }
+
+    // Forward-mode: the program is elementwise, so a reverse sweep seeded with
+    // ones yields each element's partial w.r.t. the matching leaf element
+    int numDirs = 0;
+    for (Tensor* pLeaf : kernel.leaves) numDirs = std::max(numDirs, pLeaf->NumTangents());
+    if (numDirs > 0) {
+        std::vector<Eigen::MatrixXf> leafTangents;
+        for (Tensor* pLeaf : kernel.leaves) leafTangents.push_back(pLeaf->TangentOrZero(numDirs));
+        result.m_Tangent = Eigen::MatrixXf::Zero(total, numDirs);
+        std::vector<float> adj((size_t)kernel.NumRegs() * LAZY_TILE);
+
+        for (int start = 0; start < total; start += LAZY_TILE) {
+            int n = std::min(LAZY_TILE, total - start);
+            LoadLeaves(kernel, regs.data(), start, n, leafData, leafScalar);
+            RunForward(kernel, regs.data(), n);
+            std::fill(adj.begin(), adj.end(), 0.0f);
+            Eigen::Map<Eigen::ArrayXf>(adj.data() + outReg * LAZY_TILE, n).setOnes();
+            RunBackward(kernel, regs.data(), adj.data(), n);
+
+            for (int l = 0; l < numLeaves; ++l) {
+                Eigen::Map<const Eigen::VectorXf> partial(adj.data() + l * LAZY_TILE, n);
+                if (leafScalar[l]) {
+                    result.m_Tangent.middleRows(start, n) += partial * leafTangents[l].row(0);
+                } else {
+                    result.m_Tangent.middleRows(start, n) += partial.asDiagonal() * leafTangents[l].middleRows(start, n);
+                }
+            }
+        }
+    }
+
+    if (bAnyGrad) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "LazyFused";
+        result.m_Grad.setZero();
+        for (Tensor* pLeaf : kernel.leaves) {
+            result.SaveForBackward({pLeaf}); // Backward recomputes the forward from leaf data
+            if (pLeaf->m_bRequiresGrad) result.m_Children.push_back(pLeaf);
+        }
+
+        // Fused backward: recompute the tile forward, then sweep adjoints
+        // straight into the leaf gradients
+        result.m_BackwardFn = [pKernel](Tensor& self) {
+            const LazyKernel& k = *pKernel;
+            int nLeaves = (int)k.leaves.size();
+            int nTotal = (int)self.m_Grad.size();
+            int nOut = k.NumRegs() - 1;
+
+            std::vector<const float*> data(nLeaves);
+            std::vector<bool> scalar(nLeaves);
+            for (int l = 0; l < nLeaves; ++l) {
+                data[l] = k.leaves[l]->m_Data.data();
+                scalar[l] = (k.leaves[l]->m_Data.size() == 1);
+            }
+
+            std::vector<float> regs((size_t)k.NumRegs() * LAZY_TILE);
+            std::vector<float> adj((size_t)k.NumRegs() * LAZY_TILE);
+
+            for (int start = 0; start < nTotal; start += LAZY_TILE) {
+                int n = std::min(LAZY_TILE, nTotal - start);
+                LoadLeaves(k, regs.data(), start, n, data, scalar);
+                RunForward(k, regs.data(), n);
+
+                std::fill(adj.begin(), adj.end(), 0.0f);
+                Eigen::Map<Eigen::ArrayXf>(adj.data() + nOut * LAZY_TILE, n) =
+                    Eigen::Map<const Eigen::ArrayXf>(self.m_Grad.data() + start, n);
+                RunBackward(k, regs.data(), adj.data(), n);
+
+                for (int l = 0; l < nLeaves; ++l) {
+                    Tensor* pLeaf = k.leaves[l];
+                    if (!pLeaf->m_bRequiresGrad) continue;
+                    Eigen::Map<const Eigen::ArrayXf> gl(adj.data() + l * LAZY_TILE, n);
+                    if (scalar[l]) {
+                        Tensor::GradAccumulator(pLeaf)(0, 0) += gl.sum();
+                    } else {
+                        Eigen::Map<Eigen::ArrayXf>(Tensor::GradAccumulator(pLeaf).data() + start, n) += gl;
+                    }
+                }
+            }
+        };
+    }
+    return result;
+}
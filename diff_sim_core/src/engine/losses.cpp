@@ -0,0 +1,117 @@
+#include "engine/losses.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Tensor PPOLoss(const Tensor& logpNew, const Tensor& logpOld, const Tensor& advantages,
+               const Tensor& values, const Tensor& valuesOld, const Tensor& returns,
+               const Tensor& logStd, const PPOLossConfig& config, PPOLossStats* pStats) {
+    ProfileScope profile("PPOLoss");
+    const float LOG_2PI = 1.8378770664093453f;
+
+    int batch = (int)logpNew.m_Data.size();
+    if (batch == 0 || logpOld.m_Data.size() != batch || advantages.m_Data.size() != batch ||
+        values.m_Data.size() != batch || valuesOld.m_Data.size() != batch || returns.m_Data.size() != batch) {
+        throw std::runtime_error("PPOLoss: per-sample inputs must all hold the same (non-zero) number of elements");
+    }
+    if (logStd.Cols() != 1 && logStd.Cols() != batch) {
+        throw std::runtime_error("PPOLoss: logStd must be (D, 1) or (D, B)");
+    }
+
+    // Flat per-sample views (column-major storage, so any shape works)
+    Eigen::Map<const Eigen::ArrayXf> lpNew(logpNew.m_Data.data(), batch);
+    Eigen::Map<const Eigen::ArrayXf> lpOld(logpOld.m_Data.data(), batch);
+    Eigen::Map<const Eigen::ArrayXf> adv(advantages.m_Data.data(), batch);
+    Eigen::Map<const Eigen::ArrayXf> v(values.m_Data.data(), batch);
+    Eigen::Map<const Eigen::ArrayXf> vOld(valuesOld.m_Data.data(), batch);
+    Eigen::Map<const Eigen::ArrayXf> ret(returns.m_Data.data(), batch);
+
+    // Loss terms and their derivatives, in one pass over the batch
+    Eigen::MatrixXf dLogpNew(logpNew.Rows(), logpNew.Cols());
+    Eigen::MatrixXf dValues(values.Rows(), values.Cols());
+    float invBatch = 1.0f / batch;
+    double policySum = 0.0, valueSum = 0.0, klSum = 0.0;
+    int numClipped = 0;
+
+    for (int i = 0; i < batch; ++i) {
+        float logRatio = lpNew(i) - lpOld(i);
+        float ratio = std::exp(logRatio);
+        float clippedRatio = std::min(std::max(ratio, 1.0f - config.clipRatio), 1.0f + config.clipRatio);
+        float unclipped = ratio * adv(i);
+        float clipped = clippedRatio * adv(i);
+
+        // The clipped branch has zero slope, so only the unclipped one passes gradient
+        policySum += std::min(unclipped, clipped);
+        dLogpNew.data()[i] = unclipped <= clipped ? -invBatch * unclipped : 0.0f;
+        if (clippedRatio != ratio) ++numClipped;
+        klSum += (ratio - 1.0f) - logRatio;
+
+        float err = v(i) - ret(i);
+        float valueGrad = err;
+        float valueTerm = err * err;
+        if (config.valueClip > 0.0f) {
+            float delta = v(i) - vOld(i);
+            float clippedDelta = std::min(std::max(delta, -config.valueClip), config.valueClip);
+            float clippedErr = vOld(i) + clippedDelta - ret(i);
+            if (clippedErr * clippedErr > valueTerm) {
+                valueTerm = clippedErr * clippedErr;
+                valueGrad = clippedDelta == delta ? clippedErr : 0.0f;
+            }
+        }
+        valueSum += valueTerm;
+        dValues.data()[i] = config.valueCoef * invBatch * valueGrad;
+    }
+
+    // Diagonal Gaussian entropy: sum(logStd) + 0.5 D (1 + log 2pi), averaged over samples
+    int numDims = logStd.Rows();
+    float stdScale = 1.0f / logStd.Cols();
+    float entropy = logStd.m_Data.sum() * stdScale + 0.5f * numDims * (1.0f + LOG_2PI);
+
+    float policyLoss = (float)(-policySum * invBatch);
+    float valueLoss = (float)(0.5 * valueSum * invBatch);
+
+    Tensor result(1, 1, false);
+    result.m_Data(0, 0) = policyLoss + config.valueCoef * valueLoss - config.entropyCoef * entropy;
+
+    if (pStats) {
+        pStats->policyLoss = policyLoss;
+        pStats->valueLoss = valueLoss;
+        pStats->entropy = entropy;
+        pStats->approxKl = (float)(klSum * invBatch);
+        pStats->clipFraction = (float)numClipped * invBatch;
+    }
+
+    float dLogStd = -config.entropyCoef * stdScale;
+    if (logpNew.m_bRequiresGrad || values.m_bRequiresGrad || logStd.m_bRequiresGrad) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "PPOLoss";
+        result.m_Grad.setZero();
+
+        Tensor* pLogpNew = const_cast<Tensor*>(&logpNew);
+        Tensor* pValues = const_cast<Tensor*>(&values);
+        Tensor* pLogStd = const_cast<Tensor*>(&logStd);
+        if (logpNew.m_bRequiresGrad) result.m_Children.push_back(pLogpNew);
+        if (values.m_bRequiresGrad) result.m_Children.push_back(pValues);
+        if (logStd.m_bRequiresGrad) result.m_Children.push_back(pLogStd);
+
+        // No saved data is read here, so in-place edits of the inputs after
+        // the forward pass cannot corrupt the gradient
+        result.m_BackwardFn = [pLogpNew, pValues, pLogStd, dLogpNew, dValues, dLogStd](Tensor& self) {
+            float g = self.m_Grad(0, 0);
+            if (pLogpNew->m_bRequiresGrad) Tensor::GradAccumulator(pLogpNew) += g * dLogpNew;
+            if (pValues->m_bRequiresGrad) Tensor::GradAccumulator(pValues) += g * dValues;
+            if (pLogStd->m_bRequiresGrad) Tensor::GradAccumulator(pLogStd).array() += g * dLogStd;
+        };
+    }
+
+    int numDirs = std::max({logpNew.NumTangents(), values.NumTangents(), logStd.NumTangents()});
+    if (numDirs > 0) {
+        Eigen::Map<const Eigen::VectorXf> gLogp(dLogpNew.data(), batch);
+        Eigen::Map<const Eigen::VectorXf> gValues(dValues.data(), batch);
+        result.m_Tangent = gLogp.transpose() * logpNew.TangentOrZero(numDirs)
+                         + gValues.transpose() * values.TangentOrZero(numDirs)
+                         + dLogStd * logStd.TangentOrZero(numDirs).colwise().sum();
+    }
+    return result;
+}
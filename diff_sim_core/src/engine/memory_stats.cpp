@@ -0,0 +1,139 @@
+#include "engine/memory_stats.h"
+#include "engine/engine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define PSAPI_VERSION 2  // GetProcessMemoryInfo from kernel32, no psapi.lib needed
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+// ---------------- Counters ----------------
+
+namespace {
+
+struct Counter {
+    std::atomic<int64_t> value{0};
+    std::atomic<int64_t> peak{0};
+
+    void Add(int64_t delta) {
+        int64_t now = value.fetch_add(delta, std::memory_order_relaxed) + delta;
+        if (delta <= 0) return;
+        int64_t high = peak.load(std::memory_order_relaxed);
+        while (now > high && !peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) {
+        }
+    }
+    void ResetPeak() { peak.store(value.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+};
+
+// Separate cache lines: tensor counters are hit by every op on every thread
+struct alignas(64) PaddedCounter : Counter {};
+
+PaddedCounter s_Tensors;
+PaddedCounter s_DataBytes;
+PaddedCounter s_GradBytes;
+PaddedCounter s_TensorBytes;  // data + grad, for a combined high-water mark
+PaddedCounter s_GraphNodes;
+PaddedCounter s_ScratchBytes;
+
+std::mutex& EnginesMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<const Engine*>& Engines() {
+    static std::vector<const Engine*> engines;
+    return engines;
+}
+
+// Current and peak resident set size of this process
+void ReadResident(int64_t& current, int64_t& peak) {
+    current = 0;
+    peak = 0;
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        current = (int64_t)counters.WorkingSetSize;
+        peak = (int64_t)counters.PeakWorkingSetSize;
+    }
+#elif defined(__linux__)
+    FILE* pFile = std::fopen("/proc/self/status", "r");
+    if (!pFile) return;
+    char line[256];
+    while (std::fgets(line, sizeof(line), pFile)) {
+        long long kb = 0;
+        if (std::strncmp(line, "VmRSS:", 6) == 0 && std::sscanf(line + 6, "%lld", &kb) == 1) {
+            current = (int64_t)kb * 1024;
+        } else if (std::strncmp(line, "VmHWM:", 6) == 0 && std::sscanf(line + 6, "%lld", &kb) == 1) {
+            peak = (int64_t)kb * 1024;
+        }
+    }
+    std::fclose(pFile);
+#endif
+}
+
+} // namespace
+
+void MemoryTracker::AddTensors(int64_t count) { s_Tensors.Add(count); }
+
+void MemoryTracker::AddTensorBytes(int64_t dataBytes, int64_t gradBytes) {
+    if (dataBytes != 0) s_DataBytes.Add(dataBytes);
+    if (gradBytes != 0) s_GradBytes.Add(gradBytes);
+    s_TensorBytes.Add(dataBytes + gradBytes);
+}
+
+void MemoryTracker::AddGraphNodes(int64_t count) { s_GraphNodes.Add(count); }
+
+void MemoryTracker::AddBackwardScratchBytes(int64_t bytes) { s_ScratchBytes.Add(bytes); }
+
+// ---------------- Engines ----------------
+
+void MemoryTracker::RegisterEngine(const Engine* pEngine) {
+    std::lock_guard<std::mutex> lock(EnginesMutex());
+    Engines().push_back(pEngine);
+}
+
+void MemoryTracker::UnregisterEngine(const Engine* pEngine) {
+    std::lock_guard<std::mutex> lock(EnginesMutex());
+    std::vector<const Engine*>& engines = Engines();
+    engines.erase(std::remove(engines.begin(), engines.end(), pEngine), engines.end());
+}
+
+// ---------------- Snapshot ----------------
+
+MemoryStats MemoryTracker::Snapshot() {
+    MemoryStats stats;
+    stats.liveTensors = s_Tensors.value.load(std::memory_order_relaxed);
+    stats.peakTensors = s_Tensors.peak.load(std::memory_order_relaxed);
+    stats.tensorDataBytes = s_DataBytes.value.load(std::memory_order_relaxed);
+    stats.tensorGradBytes = s_GradBytes.value.load(std::memory_order_relaxed);
+    stats.peakTensorBytes = s_TensorBytes.peak.load(std::memory_order_relaxed);
+    stats.graphNodes = s_GraphNodes.value.load(std::memory_order_relaxed);
+    stats.peakGraphNodes = s_GraphNodes.peak.load(std::memory_order_relaxed);
+    stats.backwardScratchBytes = s_ScratchBytes.value.load(std::memory_order_relaxed);
+    stats.peakBackwardScratchBytes = s_ScratchBytes.peak.load(std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(EnginesMutex());
+        stats.engines.reserve(Engines().size());
+        for (const Engine* pEngine : Engines()) stats.engines.push_back(pEngine->GetMemoryStats());
+    }
+
+    ReadResident(stats.residentBytes, stats.peakResidentBytes);
+    return stats;
+}
+
+void MemoryTracker::ResetPeaks() {
+    s_Tensors.ResetPeak();
+    s_DataBytes.ResetPeak();
+    s_GradBytes.ResetPeak();
+    s_TensorBytes.ResetPeak();
+    s_GraphNodes.ResetPeak();
+    s_ScratchBytes.ResetPeak();
+}
@@ -0,0 +1,34 @@
+#include "engine/observation_history.h"
+#include <algorithm>
+#include <stdexcept>
+
+ObservationHistory::ObservationHistory(int numWorlds, int length, int obsSize)
+    : m_NumWorlds(numWorlds), m_Length(length), m_ObsSize(obsSize)
+{
+    if (numWorlds <= 0 || length <= 0 || obsSize <= 0) {
+        throw std::runtime_error("ObservationHistory: worlds, length and observation size must be positive");
+    }
+    m_Storage.assign((size_t)numWorlds * WorldStride(), 0.0f);
+}
+
+void ObservationHistory::Advance() {
+    m_Start = m_Start == m_Length ? 1 : m_Start + 1;
+}
+
+void ObservationHistory::Write(int world, const float* pObs) {
+    // The newest slot is always in the upper half; its twin is k slots below
+    int slot = m_Start + m_Length - 1;
+    int twin = slot - m_Length;
+    float* pWorld = m_Storage.data() + world * WorldStride();
+    std::copy(pObs, pObs + m_ObsSize, pWorld + (int64_t)slot * m_ObsSize);
+    std::copy(pObs, pObs + m_ObsSize, pWorld + (int64_t)twin * m_ObsSize);
+}
+
+void ObservationHistory::Clear(int world) {
+    float* pWorld = m_Storage.data() + world * WorldStride();
+    std::fill(pWorld, pWorld + WorldStride(), 0.0f);
+}
+
+void ObservationHistory::ClearAll() {
+    std::fill(m_Storage.begin(), m_Storage.end(), 0.0f);
+}
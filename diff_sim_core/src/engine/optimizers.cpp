@@ -1,5 +1,10 @@
 #include "engine/optimizers.h"
+#include "engine/checkpoint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 
 Optimizer::Optimizer(std::vector<Tensor*> params, float lr)
     : m_Parameters(params), m_LearningRate(lr) {}
@@ -12,6 +17,40 @@ void Optimizer::ZeroGrad() {
     }
 }
 
+void Optimizer::SaveState(CheckpointWriter& writer, const std::string& prefix) const {
+    writer.AddBytes(prefix + "/lr", std::string(reinterpret_cast<const char*>(&m_LearningRate), sizeof(float)));
+}
+
+void Optimizer::LoadState(const Checkpoint& checkpoint, const std::string& prefix) {
+    std::string lr = checkpoint.Bytes(prefix + "/lr");
+    if (lr.size() != sizeof(float)) throw std::runtime_error("Optimizer::LoadState: corrupt learning rate");
+    std::memcpy(&m_LearningRate, lr.data(), sizeof(float));
+}
+
+// Adam and AdamW share the moment layout: "<prefix>/t", "<prefix>/m/<i>", "<prefix>/v/<i>"
+static void SaveMoments(CheckpointWriter& writer, const std::string& prefix, int t,
+                        const std::vector<Eigen::MatrixXf>& m, const std::vector<Eigen::MatrixXf>& v) {
+    writer.AddInt(prefix + "/t", t);
+    for (size_t i = 0; i < m.size(); ++i) {
+        writer.AddMatrix(prefix + "/m/" + std::to_string(i), m[i]);
+        writer.AddMatrix(prefix + "/v/" + std::to_string(i), v[i]);
+    }
+}
+
+static void LoadMoments(const Checkpoint& checkpoint, const std::string& prefix, int& t,
+                        std::vector<Eigen::MatrixXf>& m, std::vector<Eigen::MatrixXf>& v) {
+    for (size_t i = 0; i < m.size(); ++i) {
+        std::string mName = prefix + "/m/" + std::to_string(i);
+        std::string vName = prefix + "/v/" + std::to_string(i);
+        if (checkpoint.Rows(mName) != m[i].rows() || checkpoint.Cols(mName) != m[i].cols()) {
+            throw std::runtime_error("Optimizer::LoadState: moment shape mismatch for parameter " + std::to_string(i));
+        }
+        m[i] = checkpoint.Matrix(mName);
+        v[i] = checkpoint.Matrix(vName);
+    }
+    t = (int)checkpoint.Int(prefix + "/t");
+}
+
 SGD::SGD(std::vector<Tensor*> params, float lr)
     : Optimizer(params, lr) {}
 
@@ -67,6 +106,17 @@ void Adam::Step() {
 }
 
 
+void Adam::SaveState(CheckpointWriter& writer, const std::string& prefix) const {
+    Optimizer::SaveState(writer, prefix);
+    SaveMoments(writer, prefix, m_T, m_M, m_V);
+}
+
+void Adam::LoadState(const Checkpoint& checkpoint, const std::string& prefix) {
+    Optimizer::LoadState(checkpoint, prefix);
+    LoadMoments(checkpoint, prefix, m_T, m_M, m_V);
+}
+
+
 // ---------------- AdamW ----------------
 
 
@@ -98,3 +148,326 @@ void AdamW::Step() {
         pParam->m_Data.array() -= m_LearningRate * mHat.array() / (vHat.array().sqrt() + m_Epsilon);
     }
 }
+
+
+void AdamW::SaveState(CheckpointWriter& writer, const std::string& prefix) const {
+    Optimizer::SaveState(writer, prefix);
+    SaveMoments(writer, prefix, m_T, m_M, m_V);
+}
+
+void AdamW::LoadState(const Checkpoint& checkpoint, const std::string& prefix) {
+    Optimizer::LoadState(checkpoint, prefix);
+    LoadMoments(checkpoint, prefix, m_T, m_M, m_V);
+}
+
+
+// ---------------- LBFGS ----------------
+
+LBFGS::LBFGS(std::vector<Tensor*> params, float lr, int maxIter, int maxEval,
+             float toleranceGrad, float toleranceChange, int historySize, bool bStrongWolfe)
+    : Optimizer(params, lr), m_MaxIter(maxIter),
+      m_MaxEval(maxEval > 0 ? maxEval : maxIter * 5 / 4),
+      m_ToleranceGrad(toleranceGrad), m_ToleranceChange(toleranceChange),
+      m_HistorySize(historySize), m_bStrongWolfe(bStrongWolfe) {}
+
+void LBFGS::Step() {
+    throw std::runtime_error("LBFGS::Step needs a closure that recomputes the loss");
+}
+
+void LBFGS::ResetHistory() {
+    m_S.clear();
+    m_Y.clear();
+    m_Rho.clear();
+    m_NumIters = 0;
+}
+
+int LBFGS::NumElements() const {
+    int n = 0;
+    for (Tensor* pParam : m_Parameters) {
+        if (pParam->GetRequiresGrad()) n += (int)pParam->m_Data.size();
+    }
+    return n;
+}
+
+Eigen::VectorXd LBFGS::GatherParams() const {
+    Eigen::VectorXd x(NumElements());
+    int offset = 0;
+    for (Tensor* pParam : m_Parameters) {
+        if (!pParam->GetRequiresGrad()) continue;
+        int size = (int)pParam->m_Data.size();
+        x.segment(offset, size) = Eigen::Map<const Eigen::VectorXf>(pParam->m_Data.data(), size).cast<double>();
+        offset += size;
+    }
+    return x;
+}
+
+Eigen::VectorXd LBFGS::GatherGrad() const {
+    Eigen::VectorXd g = Eigen::VectorXd::Zero(NumElements());
+    int offset = 0;
+    for (Tensor* pParam : m_Parameters) {
+        if (!pParam->GetRequiresGrad()) continue;
+        int size = (int)pParam->m_Data.size();
+        // Parameters the loss never touched keep an empty gradient: treat as zero
+        if (pParam->m_Grad.size() == size) {
+            g.segment(offset, size) = Eigen::Map<const Eigen::VectorXf>(pParam->m_Grad.data(), size).cast<double>();
+        }
+        offset += size;
+    }
+    return g;
+}
+
+void LBFGS::ScatterParams(const Eigen::VectorXd& x) {
+    int offset = 0;
+    for (Tensor* pParam : m_Parameters) {
+        if (!pParam->GetRequiresGrad()) continue;
+        int size = (int)pParam->m_Data.size();
+        Eigen::Map<Eigen::VectorXf>(pParam->m_Data.data(), size) = x.segment(offset, size).cast<float>();
+        ++pParam->m_Version;
+        offset += size;
+    }
+}
+
+double LBFGS::Evaluate(const std::function<float()>& closure, Eigen::VectorXd& grad) {
+    ZeroGrad();
+    double loss = closure();
+    ++m_NumEvals;
+    grad = GatherGrad();
+    return loss;
+}
+
+// Minimizer of the cubic through (x1, f1, g1) and (x2, f2, g2), clamped to [lo, hi]
+static double CubicInterpolate(double x1, double f1, double g1, double x2, double f2, double g2,
+                               double lo, double hi) {
+    double d1 = g1 + g2 - 3.0 * (f1 - f2) / (x1 - x2);
+    double d2Square = d1 * d1 - g1 * g2;
+    if (d2Square < 0.0) return 0.5 * (lo + hi);
+    double d2 = std::sqrt(d2Square);
+    double minPos = x1 <= x2 ? x2 - (x2 - x1) * ((g2 + d2 - d1) / (g2 - g1 + 2.0 * d2))
+                             : x1 - (x1 - x2) * ((g1 + d2 - d1) / (g1 - g2 + 2.0 * d2));
+    return std::min(std::max(minPos, lo), hi);
+}
+
+// Line search satisfying the strong Wolfe conditions (Nocedal & Wright,
+// Algorithms 3.5/3.6): bracket a step, then zoom with cubic interpolation.
+// On return the parameters are x + t * d and gNew is the gradient there.
+double LBFGS::StrongWolfe(const std::function<float()>& closure, const Eigen::VectorXd& x, double& t,
+                          const Eigen::VectorXd& d, double f, const Eigen::VectorXd& g, double gtd,
+                          Eigen::VectorXd& gNew) {
+    const double C1 = 1e-4;
+    const double C2 = 0.9;
+    const int MAX_LS = 25;
+    double dNorm = d.cwiseAbs().maxCoeff();
+
+    auto evaluateAt = [&](double step, Eigen::VectorXd& grad) {
+        ScatterParams(x + step * d);
+        return Evaluate(closure, grad);
+    };
+
+    double fNew = evaluateAt(t, gNew);
+    double gtdNew = gNew.dot(d);
+
+    double tPrev = 0.0, fPrev = f, gtdPrev = gtd;
+    Eigen::VectorXd gPrev = g;
+
+    // Bracket: two end points (or one when it already satisfies the conditions)
+    double bracketT[2], bracketF[2], bracketGtd[2];
+    Eigen::VectorXd bracketG[2];
+    int bracketSize = 0;
+    bool bDone = false;
+    int lsIter = 0;
+
+    while (lsIter < MAX_LS) {
+        if (fNew > f + C1 * t * gtd || (lsIter > 1 && fNew >= fPrev) || gtdNew >= 0.0) {
+            bracketT[0] = tPrev; bracketF[0] = fPrev; bracketG[0] = gPrev; bracketGtd[0] = gtdPrev;
+            bracketT[1] = t;     bracketF[1] = fNew;  bracketG[1] = gNew;  bracketGtd[1] = gtdNew;
+            bracketSize = 2;
+            break;
+        }
+        if (std::abs(gtdNew) <= -C2 * gtd) {
+            bracketT[0] = t; bracketF[0] = fNew; bracketG[0] = gNew;
+            bracketSize = 1;
+            bDone = true;
+            break;
+        }
+
+        // Extrapolate
+        double minStep = t + 0.01 * (t - tPrev);
+        double maxStep = t * 10.0;
+        double tNext = CubicInterpolate(tPrev, fPrev, gtdPrev, t, fNew, gtdNew, minStep, maxStep);
+        tPrev = t; fPrev = fNew; gPrev = gNew; gtdPrev = gtdNew;
+        t = tNext;
+        fNew = evaluateAt(t, gNew);
+        gtdNew = gNew.dot(d);
+        ++lsIter;
+    }
+    if (bracketSize == 0) {
+        bracketT[0] = 0.0; bracketF[0] = f;    bracketG[0] = g;    bracketGtd[0] = gtd;
+        bracketT[1] = t;   bracketF[1] = fNew; bracketG[1] = gNew; bracketGtd[1] = gtdNew;
+        bracketSize = 2;
+    }
+
+    // Zoom into the bracket
+    bool bInsufficientProgress = false;
+    int low = bracketF[0] <= bracketF[bracketSize - 1] ? 0 : 1;
+    int high = 1 - low;
+    while (!bDone && lsIter < MAX_LS) {
+        double bracketMin = std::min(bracketT[0], bracketT[1]);
+        double bracketMax = std::max(bracketT[0], bracketT[1]);
+        if ((bracketMax - bracketMin) * dNorm < m_ToleranceChange) break;
+
+        t = CubicInterpolate(bracketT[0], bracketF[0], bracketGtd[0], bracketT[1], bracketF[1], bracketGtd[1],
+                             bracketMin, bracketMax);
+
+        // Keep away from the bracket ends unless that has already stalled progress
+        double eps = 0.1 * (bracketMax - bracketMin);
+        if (std::min(bracketMax - t, t - bracketMin) < eps) {
+            if (bInsufficientProgress || t >= bracketMax || t <= bracketMin) {
+                t = std::abs(t - bracketMax) < std::abs(t - bracketMin) ? bracketMax - eps : bracketMin + eps;
+                bInsufficientProgress = false;
+            } else {
+                bInsufficientProgress = true;
+            }
+        } else {
+            bInsufficientProgress = false;
+        }
+
+        fNew = evaluateAt(t, gNew);
+        gtdNew = gNew.dot(d);
+        ++lsIter;
+
+        if (fNew > f + C1 * t * gtd || fNew >= bracketF[low]) {
+            bracketT[high] = t; bracketF[high] = fNew; bracketG[high] = gNew; bracketGtd[high] = gtdNew;
+            low = bracketF[0] <= bracketF[1] ? 0 : 1;
+            high = 1 - low;
+        } else {
+            if (std::abs(gtdNew) <= -C2 * gtd) {
+                bDone = true;
+            } else if (gtdNew * (bracketT[high] - bracketT[low]) >= 0.0) {
+                bracketT[high] = bracketT[low]; bracketF[high] = bracketF[low];
+                bracketG[high] = bracketG[low]; bracketGtd[high] = bracketGtd[low];
+            }
+            bracketT[low] = t; bracketF[low] = fNew; bracketG[low] = gNew; bracketGtd[low] = gtdNew;
+        }
+    }
+
+    int best = bracketSize == 1 ? 0 : low;
+    t = bracketT[best];
+    gNew = bracketG[best];
+    ScatterParams(x + t * d);
+    return bracketF[best];
+}
+
+float LBFGS::Step(const std::function<float()>& closure) {
+    int evalsAtStart = m_NumEvals;
+    Eigen::VectorXd g;
+    double f = Evaluate(closure, g);
+    float initialLoss = (float)f;
+    if (g.size() == 0 || g.cwiseAbs().maxCoeff() <= m_ToleranceGrad) return initialLoss;
+
+    Eigen::VectorXd x = GatherParams();
+    for (int iter = 0; iter < m_MaxIter; ++iter) {
+        // Two-loop recursion: d = -H g, with H0 = (s.y / y.y) I from the newest pair
+        Eigen::VectorXd d = -g;
+        int numPairs = (int)m_S.size();
+        std::vector<double> alpha(numPairs);
+        for (int i = numPairs - 1; i >= 0; --i) {
+            alpha[i] = m_Rho[i] * m_S[i].dot(d);
+            d -= alpha[i] * m_Y[i];
+        }
+        if (numPairs > 0) d *= m_S.back().dot(m_Y.back()) / m_Y.back().squaredNorm();
+        for (int i = 0; i < numPairs; ++i) {
+            double beta = m_Rho[i] * m_Y[i].dot(d);
+            d += (alpha[i] - beta) * m_S[i];
+        }
+
+        double gtd = g.dot(d);
+        if (gtd > -m_ToleranceChange) break; // Not a descent direction
+
+        // The first step ever has no curvature information: keep it small
+        double t = m_NumIters == 0 ? std::min(1.0, 1.0 / g.cwiseAbs().sum()) * m_LearningRate
+                                   : (double)m_LearningRate;
+        ++m_NumIters;
+
+        Eigen::VectorXd gNew;
+        double fNew;
+        if (m_bStrongWolfe) {
+            fNew = StrongWolfe(closure, x, t, d, f, g, gtd, gNew);
+        } else {
+            ScatterParams(x + t * d);
+            fNew = Evaluate(closure, gNew);
+        }
+
+        // Curvature pair; skipped when it would break positive definiteness
+        Eigen::VectorXd s = t * d;
+        Eigen::VectorXd y = gNew - g;
+        double ys = y.dot(s);
+        if (ys > 1e-10) {
+            if ((int)m_S.size() == m_HistorySize) {
+                m_S.erase(m_S.begin());
+                m_Y.erase(m_Y.begin());
+                m_Rho.erase(m_Rho.begin());
+            }
+            m_S.push_back(s);
+            m_Y.push_back(y);
+            m_Rho.push_back(1.0 / ys);
+        }
+
+        double fChange = std::abs(fNew - f);
+        x += s;
+        f = fNew;
+        g = gNew;
+
+        if (m_NumEvals - evalsAtStart >= m_MaxEval) break;
+        if (g.cwiseAbs().maxCoeff() <= m_ToleranceGrad) break;
+        if (s.cwiseAbs().maxCoeff() <= m_ToleranceChange) break;
+        if (fChange < m_ToleranceChange) break;
+    }
+    return initialLoss;
+}
+
+
+// ---------------- Learning-rate schedules ----------------
+
+LRScheduler::LRScheduler(Optimizer& optimizer)
+    : m_Optimizer(optimizer), m_BaseLearningRate(optimizer.GetLearningRate()) {}
+
+LRScheduler::~LRScheduler() {}
+
+void LRScheduler::Step() {
+    ++m_Step;
+    m_Optimizer.SetLearningRate(LearningRateAt(m_Step));
+}
+
+CosineAnnealingLR::CosineAnnealingLR(Optimizer& optimizer, int totalSteps, float minLr)
+    : LRScheduler(optimizer), m_TotalSteps(std::max(1, totalSteps)), m_MinLearningRate(minLr) {
+    m_Optimizer.SetLearningRate(LearningRateAt(0));
+}
+
+float CosineAnnealingLR::LearningRateAt(int step) const {
+    if (step >= m_TotalSteps) return m_MinLearningRate;
+    float progress = (float)step / (float)m_TotalSteps;
+    return m_MinLearningRate + 0.5f * (m_BaseLearningRate - m_MinLearningRate) *
+                               (1.0f + std::cos(3.14159265358979f * progress));
+}
+
+LinearWarmupLR::LinearWarmupLR(Optimizer& optimizer, int warmupSteps, float startFactor, LRScheduler* pAfter)
+    : LRScheduler(optimizer), m_WarmupSteps(std::max(0, warmupSteps)), m_StartFactor(startFactor), m_pAfter(pAfter) {
+    m_Optimizer.SetLearningRate(LearningRateAt(0));
+}
+
+float LinearWarmupLR::LearningRateAt(int step) const {
+    if (step < m_WarmupSteps) {
+        float factor = m_StartFactor + (1.0f - m_StartFactor) * (float)step / (float)m_WarmupSteps;
+        return m_BaseLearningRate * factor;
+    }
+    return m_pAfter ? m_pAfter->LearningRateAt(step - m_WarmupSteps) : m_BaseLearningRate;
+}
+
+StepLR::StepLR(Optimizer& optimizer, int stepSize, float gamma)
+    : LRScheduler(optimizer), m_StepSize(std::max(1, stepSize)), m_Gamma(gamma) {
+    m_Optimizer.SetLearningRate(LearningRateAt(0));
+}
+
+float StepLR::LearningRateAt(int step) const {
+    return m_BaseLearningRate * std::pow(m_Gamma, (float)(step / m_StepSize));
+}
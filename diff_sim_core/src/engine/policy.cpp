@@ -0,0 +1,228 @@
+#include "engine/policy.h"
+#include "engine/activations.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// ---------------- MLP ----------------
+
+MLP::MLP(const std::vector<int>& layerSizes, std::mt19937& rng, float outputScale)
+    : m_LayerSizes(layerSizes)
+{
+    if (layerSizes.size() < 2) throw std::runtime_error("MLP: need at least input and output sizes");
+
+    // Reserve up front: optimizers hold pointers into these vectors
+    int numLayers = (int)layerSizes.size() - 1;
+    m_Weights.reserve(numLayers);
+    m_Biases.reserve(numLayers);
+
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    for (int l = 0; l < numLayers; ++l) {
+        int fanIn = layerSizes[l];
+        int fanOut = layerSizes[l + 1];
+        float scale = 1.0f / std::sqrt((float)fanIn);
+        if (l == numLayers - 1) scale *= outputScale;
+
+        Eigen::MatrixXf w(fanOut, fanIn);
+        for (int k = 0; k < w.size(); ++k) w.data()[k] = scale * normal(rng);
+
+        m_Weights.emplace_back(fanOut, fanIn, true);
+        m_Weights.back().SetData(w);
+        m_Biases.emplace_back(fanOut, 1, true);
+    }
+}
+
+Tensor& MLP::Forward(const Tensor& input, std::list<Tensor>& tape) {
+    // Bias broadcast over the batch as b * ones(1, B): one rank-1 product
+    tape.emplace_back(1, input.Cols(), false);
+    Tensor& ones = tape.back();
+    ones.SetData(Eigen::MatrixXf::Ones(1, input.Cols()));
+
+    const Tensor* pActivation = &input;
+    for (int l = 0; l < NumLayers(); ++l) {
+        tape.push_back(m_Weights[l].Matmul(*pActivation));
+        Tensor& product = tape.back();
+        tape.push_back(m_Biases[l].Matmul(ones));
+        Tensor& bias = tape.back();
+        tape.push_back(product + bias);
+        if (l + 1 < NumLayers()) {
+            Tensor& preActivation = tape.back();
+            tape.push_back(tanh(preActivation));
+        }
+        pActivation = &tape.back();
+    }
+    return tape.back();
+}
+
+Eigen::MatrixXf MLP::Evaluate(const Eigen::MatrixXf& input) const {
+    Eigen::MatrixXf activation = input;
+    for (int l = 0; l < NumLayers(); ++l) {
+        Eigen::MatrixXf next = m_Weights[l].Data() * activation;
+        next.colwise() += m_Biases[l].Data().col(0);
+        if (l + 1 < NumLayers()) next = next.array().tanh();
+        activation.swap(next);
+    }
+    return activation;
+}
+
+std::vector<Tensor*> MLP::Parameters() {
+    std::vector<Tensor*> params;
+    for (int l = 0; l < NumLayers(); ++l) {
+        params.push_back(&m_Weights[l]);
+        params.push_back(&m_Biases[l]);
+    }
+    return params;
+}
+
+// ---------------- GaussianPolicy ----------------
+
+static std::vector<int> LayerSizes(int in, const std::vector<int>& hidden, int out) {
+    std::vector<int> sizes;
+    sizes.push_back(in);
+    sizes.insert(sizes.end(), hidden.begin(), hidden.end());
+    sizes.push_back(out);
+    return sizes;
+}
+
+GaussianPolicy::GaussianPolicy(int obsSize, int actionSize, const std::vector<int>& hiddenSizes,
+                               unsigned int seed, float initLogStd)
+    : m_ObsSize(obsSize), m_ActionSize(actionSize), m_HiddenSizes(hiddenSizes),
+      m_InitRng(seed),
+      // Small actor output so initial actions sit near the middle of the range
+      m_Actor(LayerSizes(obsSize, hiddenSizes, actionSize), m_InitRng, 0.01f),
+      m_Critic(LayerSizes(obsSize, hiddenSizes, 1), m_InitRng, 1.0f),
+      m_LogStd(actionSize, 1, true)
+{
+    m_LogStd.SetData(Eigen::MatrixXf::Constant(actionSize, 1, initLogStd));
+}
+
+std::vector<Tensor*> GaussianPolicy::Parameters() {
+    std::vector<Tensor*> params = m_Actor.Parameters();
+    std::vector<Tensor*> criticParams = m_Critic.Parameters();
+    params.insert(params.end(), criticParams.begin(), criticParams.end());
+    params.push_back(&m_LogStd);
+    return params;
+}
+
+Eigen::MatrixXf GaussianPolicy::Mean(const Eigen::MatrixXf& obs) const {
+    return m_Actor.Evaluate(obs);
+}
+
+Eigen::VectorXf GaussianPolicy::Value(const Eigen::MatrixXf& obs) const {
+    return m_Critic.Evaluate(obs).row(0).transpose();
+}
+
+void GaussianPolicy::Sample(const Eigen::MatrixXf& obs, std::mt19937& rng, Eigen::MatrixXf& actions,
+                            Eigen::VectorXf& logProbs, Eigen::VectorXf& values) const {
+    const float LOG_2PI = 1.8378770664093453f;
+    Eigen::MatrixXf mean = Mean(obs);
+    Eigen::VectorXf logStd = m_LogStd.Data().col(0);
+    Eigen::VectorXf stdDev = logStd.array().exp();
+    float logNormalizer = logStd.sum() + 0.5f * m_ActionSize * LOG_2PI;
+
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    int batch = (int)obs.cols();
+    actions.resize(m_ActionSize, batch);
+    logProbs.resize(batch);
+    for (int b = 0; b < batch; ++b) {
+        float sumSq = 0.0f;
+        for (int i = 0; i < m_ActionSize; ++i) {
+            float z = normal(rng);
+            actions(i, b) = mean(i, b) + stdDev(i) * z;
+            sumSq += z * z;
+        }
+        logProbs(b) = -0.5f * sumSq - logNormalizer;
+    }
+    values = Value(obs);
+}
+
+// ---------------- Serialization ----------------
+
+static const char POLICY_MAGIC[4] = {'R', 'L', 'P', 'L'};
+static const uint32_t POLICY_VERSION = 1;
+
+template <typename T>
+static void WritePod(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void ReadPod(std::ifstream& file, T& value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!file) throw std::runtime_error("GaussianPolicy::Load: unexpected end of file");
+}
+
+static void WriteMatrix(std::ofstream& file, const Eigen::MatrixXf& m) {
+    file.write(reinterpret_cast<const char*>(m.data()), m.size() * sizeof(float));
+}
+
+static void ReadMatrix(std::ifstream& file, Tensor& target) {
+    Eigen::MatrixXf m(target.Rows(), target.Cols());
+    file.read(reinterpret_cast<char*>(m.data()), m.size() * sizeof(float));
+    if (!file) throw std::runtime_error("GaussianPolicy::Load: unexpected end of file");
+    target.SetData(m);
+}
+
+void GaussianPolicy::Save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("GaussianPolicy::Save: cannot open " + path);
+
+    file.write(POLICY_MAGIC, 4);
+    WritePod(file, POLICY_VERSION);
+    WritePod(file, (int32_t)m_ObsSize);
+    WritePod(file, (int32_t)m_ActionSize);
+    WritePod(file, (int32_t)m_HiddenSizes.size());
+    for (int size : m_HiddenSizes) WritePod(file, (int32_t)size);
+
+    for (const MLP* pNet : {&m_Actor, &m_Critic}) {
+        for (int l = 0; l < pNet->NumLayers(); ++l) {
+            WriteMatrix(file, pNet->Weight(l).Data());
+            WriteMatrix(file, pNet->Bias(l).Data());
+        }
+    }
+    WriteMatrix(file, m_LogStd.Data());
+    if (!file) throw std::runtime_error("GaussianPolicy::Save: write failed for " + path);
+}
+
+GaussianPolicy GaussianPolicy::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("GaussianPolicy::Load: cannot open " + path);
+
+    char magic[4];
+    file.read(magic, 4);
+    if (!file || std::memcmp(magic, POLICY_MAGIC, 4) != 0) {
+        throw std::runtime_error("GaussianPolicy::Load: " + path + " is not a policy file");
+    }
+    uint32_t version;
+    ReadPod(file, version);
+    if (version != POLICY_VERSION) {
+        throw std::runtime_error("GaussianPolicy::Load: unsupported version " + std::to_string(version));
+    }
+
+    int32_t obsSize, actionSize, numHidden;
+    ReadPod(file, obsSize);
+    ReadPod(file, actionSize);
+    ReadPod(file, numHidden);
+    if (obsSize <= 0 || actionSize <= 0 || numHidden < 0 || numHidden > 64) {
+        throw std::runtime_error("GaussianPolicy::Load: corrupt header in " + path);
+    }
+    std::vector<int> hidden(numHidden);
+    for (int& size : hidden) {
+        int32_t value;
+        ReadPod(file, value);
+        if (value <= 0) throw std::runtime_error("GaussianPolicy::Load: corrupt header in " + path);
+        size = value;
+    }
+
+    GaussianPolicy policy(obsSize, actionSize, hidden);
+    for (MLP* pNet : {&policy.m_Actor, &policy.m_Critic}) {
+        for (int l = 0; l < pNet->NumLayers(); ++l) {
+            ReadMatrix(file, pNet->Weight(l));
+            ReadMatrix(file, pNet->Bias(l));
+        }
+    }
+    ReadMatrix(file, policy.m_LogStd);
+    return policy;
+}
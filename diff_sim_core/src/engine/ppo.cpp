@@ -0,0 +1,243 @@
+#include "engine/ppo.h"
+#include "engine/checkpoint.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+
+PPOTrainer::PPOTrainer(const DroneTaskConfig& task, const PPOConfig& config)
+    : m_Config(config),
+      m_Env(task, config.numEnvs, config.seed),
+      m_Policy(DroneVecEnv::OBS_SIZE, (int)task.motors.size(), config.hiddenSizes, config.seed, config.initLogStd),
+      m_Rng(config.seed + 1)
+{
+    if (config.stepsPerEnv <= 0 || config.epochs <= 0 || config.minibatchSize <= 0) {
+        throw std::runtime_error("PPOTrainer: stepsPerEnv, epochs and minibatchSize must be positive");
+    }
+    m_pOptimizer.reset(new Adam(m_Policy.Parameters(), config.learningRate));
+
+    int batch = config.numEnvs * config.stepsPerEnv;
+    m_Obs.resize(DroneVecEnv::OBS_SIZE, batch);
+    m_Actions.resize(m_Policy.ActionSize(), batch);
+    m_LogProbs.resize(batch);
+    m_Values.resize(batch);
+    m_Rewards.resize(batch);
+    m_Dones.resize(batch);
+    m_Advantages.resize(batch);
+    m_Returns.resize(batch);
+
+    m_Env.Reset();
+}
+
+void PPOTrainer::CollectRollout(PPOIterationStats& stats) {
+    int numEnvs = m_Env.NumEnvs();
+    Eigen::MatrixXf actions;
+    Eigen::VectorXf logProbs, values;
+
+    for (int t = 0; t < m_Config.stepsPerEnv; ++t) {
+        int k0 = t * numEnvs;
+        const Eigen::MatrixXf& obs = m_Env.Observations();
+        m_Policy.Sample(obs, m_Rng, actions, logProbs, values);
+
+        m_Obs.middleCols(k0, numEnvs) = obs;
+        m_Actions.middleCols(k0, numEnvs) = actions;
+        m_LogProbs.segment(k0, numEnvs) = logProbs;
+        m_Values.segment(k0, numEnvs) = values;
+
+        m_Env.Step(actions);
+
+        m_Rewards.segment(k0, numEnvs) = m_Env.Rewards();
+        bool bAnyTruncated = false;
+        for (int i = 0; i < numEnvs; ++i) {
+            m_Dones(k0 + i) = (m_Env.Terminated()[i] || m_Env.Truncated()[i]) ? 1.0f : 0.0f;
+            bAnyTruncated = bAnyTruncated || m_Env.Truncated()[i];
+        }
+
+        // A time limit is not a real terminal state: fold the value of the
+        // state we were cut off in into the reward
+        if (bAnyTruncated) {
+            Eigen::VectorXf terminalValues = m_Policy.Value(m_Env.TerminalObservations());
+            for (int i = 0; i < numEnvs; ++i) {
+                if (m_Env.Truncated()[i]) m_Rewards(k0 + i) += m_Config.gamma * terminalValues(i);
+            }
+        }
+    }
+    m_LastValues = m_Policy.Value(m_Env.Observations());
+
+    std::vector<float> returns;
+    std::vector<int> lengths;
+    m_Env.TakeFinishedEpisodes(returns, lengths);
+    stats.episodesFinished = (int)returns.size();
+    if (!returns.empty()) {
+        stats.meanEpisodeReturn = std::accumulate(returns.begin(), returns.end(), 0.0f) / returns.size();
+        stats.meanEpisodeLength = (float)std::accumulate(lengths.begin(), lengths.end(), 0) / lengths.size();
+    }
+}
+
+void PPOTrainer::ComputeAdvantages() {
+    int numEnvs = m_Env.NumEnvs();
+    float gamma = m_Config.gamma;
+    float lambda = m_Config.gaeLambda;
+
+    // GAE: A_t = delta_t + gamma * lambda * (1 - done_t) * A_{t+1}
+    Eigen::VectorXf nextAdvantage = Eigen::VectorXf::Zero(numEnvs);
+    Eigen::VectorXf nextValue = m_LastValues;
+    for (int t = m_Config.stepsPerEnv - 1; t >= 0; --t) {
+        for (int i = 0; i < numEnvs; ++i) {
+            int k = t * numEnvs + i;
+            float notDone = 1.0f - m_Dones(k);
+            float delta = m_Rewards(k) + gamma * nextValue(i) * notDone - m_Values(k);
+            nextAdvantage(i) = delta + gamma * lambda * notDone * nextAdvantage(i);
+            nextValue(i) = m_Values(k);
+            m_Advantages(k) = nextAdvantage(i);
+        }
+    }
+    m_Returns = m_Advantages + m_Values;
+}
+
+void PPOTrainer::ClipGradNorm() {
+    if (m_Config.maxGradNorm <= 0.0f) return;
+    std::vector<Tensor*> params = m_Policy.Parameters();
+    double sumSq = 0.0;
+    for (Tensor* pParam : params) {
+        Eigen::MatrixXf grad = pParam->GetGrad();
+        if (grad.size() > 0) sumSq += grad.squaredNorm();
+    }
+    float norm = (float)std::sqrt(sumSq);
+    if (norm <= m_Config.maxGradNorm) return;
+    float scale = m_Config.maxGradNorm / (norm + 1e-6f);
+    for (Tensor* pParam : params) {
+        Eigen::MatrixXf grad = pParam->GetGrad();
+        if (grad.size() > 0) pParam->SetGrad(grad * scale);
+    }
+}
+
+void PPOTrainer::Update(PPOIterationStats& stats) {
+    int batch = (int)m_Obs.cols();
+    int minibatchSize = std::min(m_Config.minibatchSize, batch);
+    int actionSize = m_Policy.ActionSize();
+
+    Eigen::VectorXf advantages = m_Advantages;
+    if (m_Config.normalizeAdvantages && batch > 1) {
+        float mean = advantages.mean();
+        float stdDev = std::sqrt((advantages.array() - mean).square().mean());
+        advantages = (advantages.array() - mean) / (stdDev + 1e-8f);
+    }
+
+    std::vector<int> order(batch);
+    std::iota(order.begin(), order.end(), 0);
+    double sums[5] = {0, 0, 0, 0, 0};
+    int numUpdates = 0;
+
+    for (int epoch = 0; epoch < m_Config.epochs; ++epoch) {
+        std::shuffle(order.begin(), order.end(), m_Rng);
+        for (int start = 0; start + minibatchSize <= batch; start += minibatchSize) {
+            // Gather the minibatch columns
+            Tensor obs(DroneVecEnv::OBS_SIZE, minibatchSize, false);
+            Tensor actions(actionSize, minibatchSize, false);
+            Tensor logpOld(1, minibatchSize, false);
+            Tensor adv(1, minibatchSize, false);
+            Tensor valuesOld(1, minibatchSize, false);
+            Tensor returns(1, minibatchSize, false);
+            {
+                Eigen::MatrixXf o(DroneVecEnv::OBS_SIZE, minibatchSize), a(actionSize, minibatchSize);
+                Eigen::MatrixXf lp(1, minibatchSize), ad(1, minibatchSize), v(1, minibatchSize), r(1, minibatchSize);
+                for (int j = 0; j < minibatchSize; ++j) {
+                    int k = order[start + j];
+                    o.col(j) = m_Obs.col(k);
+                    a.col(j) = m_Actions.col(k);
+                    lp(0, j) = m_LogProbs(k);
+                    ad(0, j) = advantages(k);
+                    v(0, j) = m_Values(k);
+                    r(0, j) = m_Returns(k);
+                }
+                obs.SetData(o);
+                actions.SetData(a);
+                logpOld.SetData(lp);
+                adv.SetData(ad);
+                valuesOld.SetData(v);
+                returns.SetData(r);
+            }
+
+            // Graph intermediates live here until Backward() is done
+            std::list<Tensor> tape;
+            Tensor& mean = m_Policy.Actor().Forward(obs, tape);
+            Tensor& values = m_Policy.Critic().Forward(obs, tape);
+            tape.push_back(Tensor::GaussianLogProb(actions, mean, m_Policy.LogStd()));
+            Tensor& logpNew = tape.back();
+
+            PPOLossStats lossStats;
+            Tensor loss = PPOLoss(logpNew, logpOld, adv, values, valuesOld, returns,
+                                  m_Policy.LogStd(), m_Config.loss, &lossStats);
+
+            m_pOptimizer->ZeroGrad();
+            loss.Backward();
+            ClipGradNorm();
+            m_pOptimizer->Step();
+
+            sums[0] += lossStats.policyLoss;
+            sums[1] += lossStats.valueLoss;
+            sums[2] += lossStats.entropy;
+            sums[3] += lossStats.approxKl;
+            sums[4] += lossStats.clipFraction;
+            ++numUpdates;
+        }
+    }
+
+    if (numUpdates > 0) {
+        stats.policyLoss = (float)(sums[0] / numUpdates);
+        stats.valueLoss = (float)(sums[1] / numUpdates);
+        stats.entropy = (float)(sums[2] / numUpdates);
+        stats.approxKl = (float)(sums[3] / numUpdates);
+        stats.clipFraction = (float)(sums[4] / numUpdates);
+    }
+}
+
+PPOIterationStats PPOTrainer::Iterate() {
+    PPOIterationStats stats;
+
+    int64_t t0 = Profiler::NowNs();
+    CollectRollout(stats);
+    int64_t t1 = Profiler::NowNs();
+    ComputeAdvantages();
+    Update(stats);
+    int64_t t2 = Profiler::NowNs();
+
+    m_TotalSteps += (int64_t)m_Config.stepsPerEnv * m_Env.NumEnvs();
+    stats.iteration = ++m_Iteration;
+    stats.totalSteps = m_TotalSteps;
+    stats.rolloutMs = (t1 - t0) * 1e-6;
+    stats.updateMs = (t2 - t1) * 1e-6;
+    return stats;
+}
+
+std::vector<PPOIterationStats> PPOTrainer::Train(int64_t totalSteps) {
+    std::vector<PPOIterationStats> history;
+    int64_t target = m_TotalSteps + totalSteps;
+    while (m_TotalSteps < target) {
+        history.push_back(Iterate());
+    }
+    return history;
+}
+
+void PPOTrainer::SaveCheckpoint(const std::string& path) {
+    CheckpointWriter writer;
+    writer.AddParameters("policy", m_Policy.Parameters());
+    m_pOptimizer->SaveState(writer, "optim");
+    writer.AddRng("rng", m_Rng);
+    writer.AddInt("iteration", m_Iteration);
+    writer.AddInt("total_steps", m_TotalSteps);
+    writer.Save(path);
+}
+
+void PPOTrainer::LoadCheckpoint(const std::string& path) {
+    Checkpoint checkpoint(path);
+    checkpoint.LoadParameters("policy", m_Policy.Parameters());
+    m_pOptimizer->LoadState(checkpoint, "optim");
+    checkpoint.LoadRng("rng", m_Rng);
+    m_Iteration = (int)checkpoint.Int("iteration");
+    m_TotalSteps = checkpoint.Int("total_steps");
+    m_Env.Reset();
+}
@@ -0,0 +1,195 @@
+#include "engine/profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+std::atomic<bool> Profiler::s_bEnabled(false);
+
+// Cap on stored trace events so a long session can't exhaust memory
+static const size_t MAX_TRACE_EVENTS = 2000000;
+
+struct TraceEvent {
+    const char* name;
+    bool bBackward;
+    int64_t startNs;
+    int64_t durationNs;
+    size_t threadId;
+};
+
+// All mutable profiler state; only touched while enabled
+struct ProfilerState {
+    std::mutex mutex;
+    std::unordered_map<std::string, OpStats> stats;
+    std::vector<TraceEvent> events;
+    bool bTrace = false;
+    int64_t originNs = 0;
+};
+
+static ProfilerState& State() {
+    static ProfilerState state;
+    return state;
+}
+
+static thread_local ProfileScope* t_pActiveScope = nullptr;
+
+static size_t ThreadId() {
+    return std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+void Profiler::Enable() {
+    ProfilerState& state = State();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.originNs == 0) state.originNs = NowNs();
+    }
+    s_bEnabled.store(true);
+}
+
+void Profiler::Disable() {
+    s_bEnabled.store(false);
+}
+
+void Profiler::Reset() {
+    ProfilerState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.stats.clear();
+    state.events.clear();
+    state.originNs = NowNs();
+}
+
+void Profiler::SetTraceEnabled(bool bEnabled) {
+    ProfilerState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.bTrace = bEnabled;
+}
+
+void Profiler::RecordForward(const char* opName, int64_t startNs, int64_t durationNs,
+                             int rows, int cols, int64_t bytes) {
+    ProfilerState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    OpStats& op = state.stats[opName];
+    if (op.name.empty()) op.name = opName;
+    op.forwardCount++;
+    op.forwardMs += durationNs * 1e-6;
+    op.bytesAllocated += bytes;
+    if (rows >= 0) op.shapes[{rows, cols}]++;
+    if (state.bTrace && state.events.size() < MAX_TRACE_EVENTS) {
+        state.events.push_back({opName, false, startNs, durationNs, ThreadId()});
+    }
+}
+
+void Profiler::RecordBackward(const char* opName, int64_t startNs, int64_t durationNs) {
+    ProfilerState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    OpStats& op = state.stats[opName];
+    if (op.name.empty()) op.name = opName;
+    op.backwardCount++;
+    op.backwardMs += durationNs * 1e-6;
+    if (state.bTrace && state.events.size() < MAX_TRACE_EVENTS) {
+        state.events.push_back({opName, true, startNs, durationNs, ThreadId()});
+    }
+}
+
+std::vector<OpStats> Profiler::GetStats() {
+    ProfilerState& state = State();
+    std::vector<OpStats> result;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (const auto& entry : state.stats) result.push_back(entry.second);
+    }
+    std::sort(result.begin(), result.end(), [](const OpStats& a, const OpStats& b) {
+        return a.TotalMs() > b.TotalMs();
+    });
+    return result;
+}
+
+std::string Profiler::Table(int maxRows) {
+    std::vector<OpStats> stats = GetStats();
+    double grandTotal = 0.0;
+    for (const OpStats& op : stats) grandTotal += op.TotalMs();
+
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-18s %9s %11s %9s %11s %11s %7s %10s  %s\n",
+                  "Op", "Calls", "Fwd (ms)", "Bwd calls", "Bwd (ms)", "Total (ms)", "%", "Alloc (MB)", "Top shape");
+    out += line;
+    out += std::string(110, '-') + "\n";
+
+    int numRows = 0;
+    for (const OpStats& op : stats) {
+        if (maxRows > 0 && numRows++ >= maxRows) break;
+
+        std::string topShape = "-";
+        int64_t topCount = 0;
+        for (const auto& shape : op.shapes) {
+            if (shape.second > topCount) {
+                topCount = shape.second;
+                topShape = std::to_string(shape.first.first) + "x" + std::to_string(shape.first.second);
+            }
+        }
+        if (op.shapes.size() > 1) topShape += " (+" + std::to_string(op.shapes.size() - 1) + ")";
+
+        double percent = grandTotal > 0.0 ? 100.0 * op.TotalMs() / grandTotal : 0.0;
+        std::snprintf(line, sizeof(line), "%-18s %9lld %11.3f %9lld %11.3f %11.3f %6.1f%% %10.3f  %s\n",
+                      op.name.c_str(), (long long)op.forwardCount, op.forwardMs,
+                      (long long)op.backwardCount, op.backwardMs, op.TotalMs(), percent,
+                      op.bytesAllocated / (1024.0 * 1024.0), topShape.c_str());
+        out += line;
+    }
+    return out;
+}
+
+void Profiler::DumpTrace(const std::string& path) {
+    ProfilerState& state = State();
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Profiler: cannot open trace file " + path);
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::unordered_map<size_t, int> threadIndex; // Small, stable tids for the viewer
+
+    file << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < state.events.size(); ++i) {
+        const TraceEvent& e = state.events[i];
+        auto it = threadIndex.find(e.threadId);
+        if (it == threadIndex.end()) it = threadIndex.emplace(e.threadId, (int)threadIndex.size()).first;
+
+        file << "{\"name\":\"" << e.name << "\",\"cat\":\"" << (e.bBackward ? "backward" : "forward")
+             << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << it->second
+             << ",\"ts\":" << (e.startNs - state.originNs) / 1000.0
+             << ",\"dur\":" << e.durationNs / 1000.0 << "}";
+        file << (i + 1 < state.events.size() ? ",\n" : "\n");
+    }
+    file << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+// ---------------- ProfileScope ----------------
+
+ProfileScope::ProfileScope(const char* opName) {
+    if (!Profiler::IsEnabled() || t_pActiveScope) return;
+    m_pOpName = opName;
+    m_StartNs = Profiler::NowNs();
+    t_pActiveScope = this;
+}
+
+ProfileScope::~ProfileScope() {
+    if (!m_pOpName) return;
+    t_pActiveScope = nullptr;
+    Profiler::RecordForward(m_pOpName, m_StartNs, Profiler::NowNs() - m_StartNs, m_Rows, m_Cols, m_Bytes);
+}
+
+void ProfileScope::CountAllocation(int rows, int cols, int64_t bytes) {
+    ProfileScope* pScope = t_pActiveScope;
+    if (!pScope) return;
+    if (pScope->m_Rows < 0) {
+        pScope->m_Rows = rows;
+        pScope->m_Cols = cols;
+    }
+    pScope->m_Bytes += bytes;
+}
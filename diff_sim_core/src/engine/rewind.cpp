@@ -0,0 +1,327 @@
+#include "engine/rewind.h"
+#include "engine/engine.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// ---------------- Encoding ----------------
+
+namespace {
+
+// Bytes kept of an XOR word per 2-bit code
+const int kCodeBytes[4] = {0, 2, 3, 4};
+
+// Frame headers of a delta slot
+const uint8_t kDeltaFrame = 0;
+const uint8_t kRawFrame = 1;
+
+int CodeOf(uint32_t x) {
+    if (x == 0) return 0;
+    if (x < (1u << 16)) return 1;
+    if (x < (1u << 24)) return 2;
+    return 3;
+}
+
+int64_t RawFrameBytes(int stateSize) { return (int64_t)stateSize * sizeof(uint32_t); }
+
+// A stored delta slot never exceeds the header plus a raw frame
+int64_t MaxSlotBytes(int stateSize) { return 1 + RawFrameBytes(stateSize); }
+
+const uint8_t* AsBytes(const void* p) { return static_cast<const uint8_t*>(p); }
+
+// Linear extrapolation on the bit patterns: exact for constant words and
+// close for floats that keep their sign and exponent. Integer arithmetic, so
+// encoder and decoder agree bit for bit whatever the float flags.
+uint32_t Extrapolate(uint32_t last, uint32_t before) { return 2u * last - before; }
+
+// Each word is XORed with whichever of its extrapolation and the previous
+// word of the same frame leaves fewer bytes; the latter catches runs, such
+// as the repeated commands of a motor delay line
+uint32_t Residual(uint32_t word, uint32_t last, uint32_t before, uint32_t left, bool& bLeft) {
+    uint32_t x = word ^ Extrapolate(last, before);
+    uint32_t y = word ^ left;
+    bLeft = CodeOf(y) < CodeOf(x);
+    return bLeft ? y : x;
+}
+
+uint32_t WordAt(const float* pState, int w) {
+    uint32_t word;
+    std::memcpy(&word, pState + w, sizeof(word));
+    return word;
+}
+
+// Size EncodeDelta() will append, so the segment can reserve exactly that:
+// per 8 words two bytes of 2-bit byte counts and one byte of predictor bits,
+// then each word's low bytes
+int64_t DeltaBytes(const float* pState, const uint32_t* pLast, const uint32_t* pBefore, int count) {
+    int64_t bytes = 3 * ((count + 7) / 8);
+    uint32_t left = 0;
+    bool bLeft;
+    for (int w = 0; w < count; ++w) {
+        uint32_t word = WordAt(pState, w);
+        bytes += kCodeBytes[CodeOf(Residual(word, pLast[w], pBefore[w], left, bLeft))];
+        left = word;
+    }
+    return bytes;
+}
+
+void EncodeDelta(const float* pState, const uint32_t* pLast, const uint32_t* pBefore, int count,
+                 std::vector<uint8_t>& out) {
+    uint32_t left = 0;
+    for (int i = 0; i < count; i += 8) {
+        size_t control = out.size();
+        out.insert(out.end(), 3, 0);
+        for (int j = 0; j < 8 && i + j < count; ++j) {
+            int w = i + j;
+            uint32_t word = WordAt(pState, w);
+            bool bLeft;
+            uint32_t x = Residual(word, pLast[w], pBefore[w], left, bLeft);
+            int code = CodeOf(x);
+            out[control + j / 4] |= (uint8_t)(code << (2 * (j % 4)));
+            if (bLeft) out[control + 2] |= (uint8_t)(1 << j);
+            for (int b = 0; b < kCodeBytes[code]; ++b) out.push_back((uint8_t)(x >> (8 * b)));
+            left = word;
+        }
+    }
+}
+
+// Decodes in place over pBefore: each word's prediction reads its slot
+// before overwriting it
+const uint8_t* DecodeDelta(const uint8_t* pIn, const uint32_t* pLast, uint32_t* pBefore, int count) {
+    for (int i = 0; i < count; i += 8) {
+        const uint8_t* pControl = pIn;
+        pIn += 3;
+        for (int j = 0; j < 8 && i + j < count; ++j) {
+            int w = i + j;
+            int code = (pControl[j / 4] >> (2 * (j % 4))) & 3;
+            uint32_t x = 0;
+            for (int b = 0; b < kCodeBytes[code]; ++b) x |= (uint32_t)(*pIn++) << (8 * b);
+            bool bLeft = (pControl[2] >> j) & 1;
+            pBefore[w] = x ^ (bLeft ? (w > 0 ? pBefore[w - 1] : 0u) : Extrapolate(pLast[w], pBefore[w]));
+        }
+    }
+    return pIn;
+}
+
+} // namespace
+
+// ---------------- RewindBuffer ----------------
+
+RewindBuffer::RewindBuffer(int steps, int keyframeInterval)
+    : m_Steps(steps), m_Interval(std::min(keyframeInterval, steps))
+{
+    if (steps <= 0 || keyframeInterval <= 0) {
+        throw std::runtime_error("RewindBuffer: steps and keyframe interval must be positive");
+    }
+    // Segments touched by T + 1 consecutive frames, so the one holding the
+    // oldest frame is never reused
+    m_Segments.resize((steps + m_Interval - 1) / m_Interval + 1);
+}
+
+void RewindBuffer::Clear() {
+    m_Newest = -1;
+    m_Oldest = 0;
+    for (Segment& segment : m_Segments) segment.data.clear();
+}
+
+int64_t RewindBuffer::SegmentBytes() const {
+    return RawFrameBytes(m_StateSize) + (m_Interval - 1) * MaxSlotBytes(m_StateSize);
+}
+
+void RewindBuffer::Record(const std::vector<float>& state) {
+    if ((int)state.size() != m_StateSize) {
+        Clear();
+        m_StateSize = (int)state.size();
+        // Buffers sized for the old layout would break the MaxBytes() bound
+        for (Segment& segment : m_Segments) std::vector<uint8_t>().swap(segment.data);
+        m_Last.assign(m_StateSize, 0u);
+        m_Before.assign(m_StateSize, 0u);
+    }
+
+    int64_t frame = m_Newest + 1;
+    int index = (int)(frame % m_Interval);
+    Segment& segment = m_Segments[(frame / m_Interval) % m_Segments.size()];
+    int64_t raw = RawFrameBytes(m_StateSize);
+    int64_t limit = SegmentBytes();
+    if (index == 0) {
+        // Start from what the previous segment encoded; capacity only grows,
+        // so once every buffer has been through a segment reallocation is rare
+        if (frame > 0) {
+            const Segment& previous = m_Segments[(frame / m_Interval - 1) % m_Segments.size()];
+            if (previous.data.size() > segment.data.capacity()) segment.data.reserve(previous.data.size());
+        }
+        segment.data.clear();
+        segment.data.insert(segment.data.end(), AsBytes(state.data()), AsBytes(state.data()) + raw);
+    } else {
+        // The first delta of a segment has no frame before its keyframe;
+        // a delta no smaller than the frame itself is stored raw
+        const std::vector<uint32_t>& before = index == 1 ? m_Last : m_Before;
+        int64_t delta = DeltaBytes(state.data(), m_Last.data(), before.data(), m_StateSize);
+        bool bRaw = delta >= raw;
+
+        // Grow by a sixteenth rather than doubling, and never past the worst case
+        size_t needed = segment.data.size() + 1 + (bRaw ? raw : delta);
+        if (needed > segment.data.capacity()) {
+            size_t grown = segment.data.capacity() + segment.data.capacity() / 16;
+            segment.data.reserve((size_t)std::min<int64_t>(std::max(needed, grown), limit));
+        }
+        segment.data.push_back(bRaw ? kRawFrame : kDeltaFrame);
+        if (bRaw) {
+            segment.data.insert(segment.data.end(), AsBytes(state.data()), AsBytes(state.data()) + raw);
+        } else {
+            EncodeDelta(state.data(), m_Last.data(), before.data(), m_StateSize, segment.data);
+        }
+    }
+
+    if (m_StateSize > 0) std::memcpy(m_Before.data(), state.data(), raw);
+    m_Last.swap(m_Before);
+    m_Newest = frame;
+    m_Oldest = std::max(m_Oldest, frame - m_Steps);
+}
+
+size_t RewindBuffer::Decode(int64_t frame) {
+    const Segment& segment = m_Segments[(frame / m_Interval) % m_Segments.size()];
+    int64_t raw = RawFrameBytes(m_StateSize);
+    const uint8_t* p = segment.data.data();
+    if (m_StateSize > 0) std::memcpy(m_Last.data(), p, raw);
+    p += raw;
+    int index = (int)(frame % m_Interval);
+    for (int i = 1; i <= index; ++i) {
+        // Before the first delta, m_Before stands in for the missing frame
+        if (i == 1) m_Before = m_Last;
+        if (*p++ == kRawFrame) {
+            if (m_StateSize > 0) std::memcpy(m_Before.data(), p, raw);
+            p += raw;
+        } else {
+            p = DecodeDelta(p, m_Last.data(), m_Before.data(), m_StateSize);
+        }
+        m_Last.swap(m_Before);
+    }
+    return (size_t)(p - segment.data.data());
+}
+
+void RewindBuffer::Rewind(int steps, std::vector<float>& state) {
+    if (steps < 0 || steps > Available()) {
+        throw std::runtime_error("RewindBuffer: can rewind between 0 and Available() steps");
+    }
+    int64_t frame = m_Newest - steps;
+    size_t end = Decode(frame);
+
+    // Drop the frames after the target in its segment; later segments are
+    // rewritten from their keyframe when recording reaches them
+    Segment& segment = m_Segments[(frame / m_Interval) % m_Segments.size()];
+    segment.data.resize(end);
+    m_Newest = frame;
+
+    state.resize(m_StateSize);
+    if (m_StateSize > 0) std::memcpy(state.data(), m_Last.data(), RawFrameBytes(m_StateSize));
+}
+
+int64_t RewindBuffer::Bytes() const {
+    int64_t bytes = (int64_t)m_Segments.capacity() * sizeof(Segment);
+    for (const Segment& segment : m_Segments) bytes += (int64_t)segment.data.capacity();
+    return bytes + (int64_t)(m_Last.capacity() + m_Before.capacity()) * sizeof(uint32_t);
+}
+
+int64_t RewindBuffer::MaxBytes() const {
+    return (int64_t)m_Segments.size() * (sizeof(Segment) + SegmentBytes()) + 2 * RawFrameBytes(m_StateSize);
+}
+
+int64_t RewindBuffer::RawBytes() const {
+    return (int64_t)(m_Steps + 1) * RawFrameBytes(m_StateSize);
+}
+
+// ---------------- Engine ----------------
+
+void Engine::EnableRewind(int steps, int keyframeInterval) {
+    m_pRewind.reset(new RewindBuffer(steps, keyframeInterval));
+    RecordRewindState();
+}
+
+void Engine::DisableRewind() {
+    m_pRewind.reset();
+    std::vector<float>().swap(m_RewindState);
+}
+
+void Engine::RestartRewind() {
+    if (!m_pRewind) throw std::runtime_error("Engine: rewind is not enabled");
+    m_pRewind->Clear();
+    RecordRewindState();
+}
+
+int Engine::GetRewindAvailable() const {
+    return m_pRewind ? m_pRewind->Available() : 0;
+}
+
+void Engine::Rewind(int steps) {
+    if (!m_pRewind) throw std::runtime_error("Engine: rewind is not enabled");
+    SaveRewindState(m_RewindState);
+    if ((int)m_RewindState.size() != m_pRewind->StateSize()) {
+        throw std::runtime_error("Engine: bodies or motor delays changed since the rewind history was recorded");
+    }
+    m_pRewind->Rewind(steps, m_RewindState);
+    LoadRewindState(m_RewindState);
+    // Cached impulses and tangents belong to the abandoned future
+    m_ContactManager.Clear();
+    for (Joint* pJoint : m_Joints) pJoint->ResetImpulses();
+    ResetSensitivities();
+}
+
+void Engine::RecordRewindState() {
+    SaveRewindState(m_RewindState);
+    m_pRewind->Record(m_RewindState);
+}
+
+// Layout: per body [x, y, theta, vx, vy, omega] and per motor [thrust, command,
+// commands in flight]; per articulation the root's 6 values and each joint's (q, qd)
+void Engine::SaveRewindState(std::vector<float>& state) const {
+    state.clear();
+    auto saveBody = [&state](const Body* pBody) {
+        state.insert(state.end(), {pBody->GetX(), pBody->GetY(), pBody->GetRotation(),
+                                   pBody->vel.Get(0, 0), pBody->vel.Get(1, 0), pBody->ang_vel.Get(0, 0)});
+    };
+    for (const Body* pBody : m_Bodies) {
+        saveBody(pBody);
+        for (const Motor* pMotor : pBody->motors) {
+            state.push_back(pMotor->thrust);
+            state.push_back(pMotor->command);
+            state.resize(state.size() + pMotor->GetDelay());
+            pMotor->SavePending(state.data() + state.size() - pMotor->GetDelay());
+        }
+    }
+    for (const ArticulatedChain* pChain : m_Articulations) {
+        saveBody(pChain->Links()[0]);
+        for (int link = 1; link < pChain->NumLinks(); ++link) {
+            state.push_back(pChain->GetJointAngle(link));
+            state.push_back(pChain->GetJointVelocity(link));
+        }
+    }
+}
+
+void Engine::LoadRewindState(const std::vector<float>& state) {
+    const float* p = state.data();
+    auto loadBody = [&p](Body* pBody) {
+        pBody->SetPosition(p[0], p[1]);
+        pBody->SetRotation(p[2]);
+        pBody->SetVelocity(p[3], p[4]);
+        pBody->SetAngularVelocity(p[5]);
+        p += 6;
+    };
+    for (Body* pBody : m_Bodies) {
+        loadBody(pBody);
+        for (Motor* pMotor : pBody->motors) {
+            pMotor->thrust = p[0];
+            pMotor->command = p[1];
+            pMotor->LoadPending(p + 2);
+            p += 2 + pMotor->GetDelay();
+        }
+    }
+    for (ArticulatedChain* pChain : m_Articulations) {
+        loadBody(pChain->Links()[0]);
+        for (int link = 1; link < pChain->NumLinks(); ++link) {
+            pChain->SetJointState(link, p[0], p[1]);
+            p += 2;
+        }
+        pChain->UpdateLinks();
+    }
+}
@@ -0,0 +1,326 @@
+#include "engine/engine.h"
+#include <cmath>
+#include <stdexcept>
+
+// ============================================================================
+// Forward-Mode Sensitivities
+//
+// Mirrors Engine::Update() (motors, gravity, semi-implicit Euler and the
+// legacy impulse response) on dual numbers. Contacts are detected on the
+// float state; normals are held constant while contact points and
+// penetration depth follow the bodies to first order.
+// ============================================================================
+
+// Per-update view of a body with its differentiable properties
+struct DualBody {
+    Body* pBody = nullptr;
+    bool bStatic = false;
+    DualBodyState s;
+    Dual mass;
+    Dual inertia;
+    Dual friction;
+    Dual restitution;
+    std::vector<Dual> thrust;
+    std::vector<Dual> angle;
+};
+
+static void LoadDualBody(DualBody& db, Body* pBody, const DualBodyState* pState) {
+    db.pBody = pBody;
+    db.bStatic = pBody->is_static;
+    if (pState) db.s = *pState;
+
+    // Values always come from the body (the user may have moved it); tangents persist
+    db.s.x.val = pBody->pos.Get(0, 0);
+    db.s.y.val = pBody->pos.Get(1, 0);
+    db.s.theta.val = pBody->rotation.Get(0, 0);
+    db.s.vx.val = pBody->vel.Get(0, 0);
+    db.s.vy.val = pBody->vel.Get(1, 0);
+    db.s.omega.val = pBody->ang_vel.Get(0, 0);
+
+    db.mass = Dual(pBody->mass.Get(0, 0));
+    db.inertia = Dual(pBody->inertia.Get(0, 0));
+    db.friction = Dual(pBody->friction);
+    db.restitution = Dual(pBody->restitution);
+
+    db.thrust.clear();
+    db.angle.clear();
+    for (Motor* pMotor : pBody->motors) {
+        db.thrust.push_back(Dual(pMotor->thrust));
+        db.angle.push_back(Dual(pMotor->angle));
+    }
+}
+
+// Write primal values back so float-based collision detection sees them
+static void SyncToBody(const DualBody& db) {
+    if (db.bStatic) return;
+    db.pBody->pos.Set(0, 0, db.s.x.val);
+    db.pBody->pos.Set(1, 0, db.s.y.val);
+    db.pBody->rotation.Set(0, 0, db.s.theta.val);
+    db.pBody->vel.Set(0, 0, db.s.vx.val);
+    db.pBody->vel.Set(1, 0, db.s.vy.val);
+    db.pBody->ang_vel.Set(0, 0, db.s.omega.val);
+}
+
+// Dual mirror of Engine::ApplyImpulse
+static void ApplyImpulseDual(DualBody& a, DualBody& b, float nx, float ny, const Dual& px, const Dual& py) {
+    Dual invMassA = a.bStatic ? Dual(0.0f) : 1.0f / a.mass;
+    Dual invMassB = b.bStatic ? Dual(0.0f) : 1.0f / b.mass;
+    Dual invInertiaA = a.bStatic ? Dual(0.0f) : 1.0f / a.inertia;
+    Dual invInertiaB = b.bStatic ? Dual(0.0f) : 1.0f / b.inertia;
+
+    Dual raX = px - a.s.x, raY = py - a.s.y;
+    Dual rbX = px - b.s.x, rbY = py - b.s.y;
+
+    Dual vRelX = (a.s.vx - a.s.omega * raY) - (b.s.vx - b.s.omega * rbY);
+    Dual vRelY = (a.s.vy + a.s.omega * raX) - (b.s.vy + b.s.omega * rbX);
+    Dual vRelN = vRelX * nx + vRelY * ny;
+
+    // Don't resolve if separating
+    if (vRelN.val > 0) return;
+
+    Dual e = (a.restitution + b.restitution) * 0.5f;
+
+    Dual raCrossN = raX * ny - raY * nx;
+    Dual rbCrossN = rbX * ny - rbY * nx;
+    Dual denom = invMassA + invMassB +
+                 raCrossN * raCrossN * invInertiaA +
+                 rbCrossN * rbCrossN * invInertiaB;
+    if (denom.val < 0.0001f) return;
+
+    Dual j = -(1.0f + e) * vRelN / denom;
+    if (std::isnan(j.val) || std::isinf(j.val)) return;
+
+    if (!a.bStatic) {
+        a.s.vx += j * nx * invMassA;
+        a.s.vy += j * ny * invMassA;
+        const float MAX_OMEGA = 3.0f;
+        a.s.omega = DualClamp(a.s.omega + raCrossN * j * invInertiaA, -MAX_OMEGA, MAX_OMEGA);
+    }
+    if (!b.bStatic) {
+        b.s.vx -= j * nx * invMassB;
+        b.s.vy -= j * ny * invMassB;
+        b.s.omega -= rbCrossN * j * invInertiaB;
+    }
+
+    // --- FRICTION ---
+    float tx = -ny, ty = nx;
+    Dual vRelT = ((a.s.vx - a.s.omega * raY) - (b.s.vx - b.s.omega * rbY)) * tx +
+                 ((a.s.vy + a.s.omega * raX) - (b.s.vy + b.s.omega * rbX)) * ty;
+
+    Dual raCrossT = raX * ty - raY * tx;
+    Dual rbCrossT = rbX * ty - rbY * tx;
+    Dual denomT = invMassA + invMassB +
+                  raCrossT * raCrossT * invInertiaA +
+                  rbCrossT * rbCrossT * invInertiaB;
+
+    Dual frictionCoef = (a.friction + b.friction) * 0.5f;
+    Dual bound = frictionCoef * abs(j);
+    Dual jt = DualMax(-bound, DualMin(bound, -vRelT / denomT));  // Clamp to Coulomb cone
+
+    if (!a.bStatic) {
+        a.s.vx += jt * tx * invMassA;
+        a.s.vy += jt * ty * invMassA;
+        a.s.omega += raCrossT * jt * invInertiaA;
+    }
+    if (!b.bStatic) {
+        b.s.vx -= jt * tx * invMassB;
+        b.s.vy -= jt * ty * invMassB;
+        b.s.omega -= rbCrossT * jt * invInertiaB;
+    }
+}
+
+void Engine::ResolveCollisionDual(DualBody& bodyA, DualBody& bodyB) {
+    for (const Shape& shapeA : bodyA.pBody->shapes) {
+        for (const Shape& shapeB : bodyB.pBody->shapes) {
+            float pen = 0, nx = 0, ny = 0;
+            float contactsX[4], contactsY[4];
+            int numContacts = CollideShapes(bodyA.pBody, shapeA, bodyB.pBody, shapeB, pen, nx, ny, contactsX, contactsY);
+            if (numContacts == 0) continue;
+
+            // Tangent-only displacement of each body since its float state was read
+            Dual dAx = bodyA.s.x - bodyA.s.x.val, dAy = bodyA.s.y - bodyA.s.y.val;
+            Dual dBx = bodyB.s.x - bodyB.s.x.val, dBy = bodyB.s.y - bodyB.s.y.val;
+            Dual dTheta = bodyA.s.theta - bodyA.s.theta.val;
+
+            for (int i = 0; i < numContacts; ++i) {
+                // Contact points ride on body A to first order
+                float raX = contactsX[i] - bodyA.s.x.val;
+                float raY = contactsY[i] - bodyA.s.y.val;
+                Dual px = contactsX[i] + dAx - raY * dTheta;
+                Dual py = contactsY[i] + dAy + raX * dTheta;
+                ApplyImpulseDual(bodyA, bodyB, nx, ny, px, py);
+            }
+
+            // Position correction (Baumgarte stabilization), as in ResolveCollision.
+            // Moving A along the normal (n points from B to A) reduces penetration.
+            if (pen > 0.001f) {
+                Dual penD = pen - ((dAx - dBx) * nx + (dAy - dBy) * ny);
+                Dual correction = DualMax(penD - 0.01f, Dual(0.0f)) * 0.4f;
+
+                if (!bodyA.bStatic && !bodyB.bStatic) {
+                    Dual totalMass = bodyA.mass + bodyB.mass;
+                    Dual ratioA = bodyB.mass / totalMass;
+                    Dual ratioB = bodyA.mass / totalMass;
+                    bodyA.s.x += ratioA * correction * nx;
+                    bodyA.s.y += ratioA * correction * ny;
+                    bodyB.s.x -= ratioB * correction * nx;
+                    bodyB.s.y -= ratioB * correction * ny;
+                } else if (!bodyA.bStatic) {
+                    bodyA.s.x += nx * correction;
+                    bodyA.s.y += ny * correction;
+                } else if (!bodyB.bStatic) {
+                    bodyB.s.x -= nx * correction;
+                    bodyB.s.y -= ny * correction;
+                }
+            }
+            SyncToBody(bodyA);
+            SyncToBody(bodyB);
+        }
+    }
+}
+
+void Engine::UpdateWithSensitivities() {
+    float subDt = m_DeltaTime / static_cast<float>(m_Substeps);
+
+    // Detach state from any autograd graph: the dual path owns it for this frame
+    for (Body* pBody : m_Bodies) {
+        pBody->SetPosition(pBody->GetX(), pBody->GetY());
+        pBody->SetRotation(pBody->GetRotation());
+        pBody->SetVelocity(pBody->vel.Get(0, 0), pBody->vel.Get(1, 0));
+        pBody->SetAngularVelocity(pBody->ang_vel.Get(0, 0));
+    }
+
+    std::vector<DualBody> dynamics(m_Bodies.size());
+    std::vector<DualBody> colliders(m_Colliders.size());
+    for (size_t i = 0; i < m_Bodies.size(); ++i) {
+        auto it = m_DualStates.find(m_Bodies[i]);
+        LoadDualBody(dynamics[i], m_Bodies[i], it != m_DualStates.end() ? &it->second : nullptr);
+    }
+    for (size_t i = 0; i < m_Colliders.size(); ++i) {
+        LoadDualBody(colliders[i], m_Colliders[i], nullptr);
+    }
+
+    // Seed one tangent direction per registered parameter
+    for (size_t p = 0; p < m_SensitivityParams.size(); ++p) {
+        const SensitivityParamRef& ref = m_SensitivityParams[p];
+        DualBody* pTarget = nullptr;
+        for (DualBody& db : dynamics) if (db.pBody == ref.pBody) pTarget = &db;
+        for (DualBody& db : colliders) if (db.pBody == ref.pBody) pTarget = &db;
+        if (!pTarget) continue;  // Body not in this engine (any more)
+
+        switch (ref.kind) {
+            case SensitivityParam::MASS: pTarget->mass.tan[p] = 1.0f; break;
+            case SensitivityParam::INERTIA: pTarget->inertia.tan[p] = 1.0f; break;
+            case SensitivityParam::FRICTION: pTarget->friction.tan[p] = 1.0f; break;
+            case SensitivityParam::RESTITUTION: pTarget->restitution.tan[p] = 1.0f; break;
+            case SensitivityParam::MOTOR_MAX_THRUST: {
+                Motor* pMotor = ref.pBody->motors[ref.motorIndex];
+                // thrust = throttle * max_thrust with throttle held fixed
+                if (pMotor->max_thrust > 0) {
+                    pTarget->thrust[ref.motorIndex].tan[p] = pMotor->thrust / pMotor->max_thrust;
+                }
+                break;
+            }
+            case SensitivityParam::MOTOR_ANGLE: pTarget->angle[ref.motorIndex].tan[p] = 1.0f; break;
+        }
+    }
+
+    for (int step = 0; step < m_Substeps; ++step) {
+        // Forces (motors + gravity) and semi-implicit Euler, as in Body::Step
+        for (DualBody& db : dynamics) {
+            if (db.bStatic) continue;
+            Body* pBody = db.pBody;
+
+            // External forces applied before Update() act on the first substep only,
+            // since Body::Step clears the accumulators
+            Dual fx = m_GravityX * db.mass + pBody->m_ForceAccumulator.Get(0, 0);
+            Dual fy = m_GravityY * db.mass + pBody->m_ForceAccumulator.Get(1, 0);
+            Dual torque(pBody->m_TorqueAccumulator.Get(0, 0));
+
+            Dual cosR = cos(db.s.theta);
+            Dual sinR = sin(db.s.theta);
+            for (size_t m = 0; m < pBody->motors.size(); ++m) {
+                if (db.thrust[m].val <= 0) continue;
+                Motor* pMotor = pBody->motors[m];
+
+                Dual localFx = cos(db.angle[m]) * db.thrust[m];
+                Dual localFy = sin(db.angle[m]) * db.thrust[m];
+                Dual worldFx = cosR * localFx - sinR * localFy;
+                Dual worldFy = sinR * localFx + cosR * localFy;
+                fx += worldFx;
+                fy += worldFy;
+
+                Dual rx = cosR * pMotor->local_x - sinR * pMotor->local_y;
+                Dual ry = sinR * pMotor->local_x + cosR * pMotor->local_y;
+                torque += rx * worldFy - ry * worldFx;
+            }
+
+            db.s.vx += fx / db.mass * subDt;
+            db.s.vy += fy / db.mass * subDt;
+            db.s.x += db.s.vx * subDt;
+            db.s.y += db.s.vy * subDt;
+            db.s.omega += torque / db.inertia * subDt;
+            db.s.theta += db.s.omega * subDt;
+            pBody->ResetForces();
+            SyncToBody(db);
+        }
+
+        // Collision response: Dynamic vs Dynamic, then Dynamic vs Static
+        for (size_t i = 0; i < dynamics.size(); ++i) {
+            for (size_t j = i + 1; j < dynamics.size(); ++j) {
+                ResolveCollisionDual(dynamics[i], dynamics[j]);
+            }
+        }
+        for (DualBody& db : dynamics) {
+            for (DualBody& collider : colliders) {
+                ResolveCollisionDual(db, collider);
+            }
+        }
+    }
+
+    for (DualBody& db : dynamics) {
+        m_DualStates[db.pBody] = db.s;
+        db.pBody->garbage_collector.clear();
+    }
+}
+
+// ============================================================================
+// Sensitivity Parameter Management
+// ============================================================================
+
+int Engine::AddSensitivityParameter(Body* pBody, SensitivityParam kind, int motorIndex) {
+    if ((int)m_SensitivityParams.size() >= DUAL_MAX_TANGENTS) {
+        throw std::runtime_error("Too many sensitivity parameters (max " + std::to_string(DUAL_MAX_TANGENTS) + ")");
+    }
+    bool bMotorParam = (kind == SensitivityParam::MOTOR_MAX_THRUST || kind == SensitivityParam::MOTOR_ANGLE);
+    if (bMotorParam && (motorIndex < 0 || motorIndex >= (int)pBody->motors.size())) {
+        throw std::runtime_error("Motor sensitivity parameter needs a valid motor_index");
+    }
+    m_SensitivityParams.push_back({pBody, kind, bMotorParam ? motorIndex : -1});
+    return (int)m_SensitivityParams.size() - 1;
+}
+
+void Engine::ClearSensitivityParameters() {
+    m_SensitivityParams.clear();
+    m_DualStates.clear();
+}
+
+void Engine::ResetSensitivities() {
+    m_DualStates.clear();
+}
+
+Eigen::MatrixXf Engine::GetSensitivity(Body* pBody) const {
+    int numParams = (int)m_SensitivityParams.size();
+    Eigen::MatrixXf result = Eigen::MatrixXf::Zero(6, numParams);
+    auto it = m_DualStates.find(pBody);
+    if (it == m_DualStates.end()) return result;
+
+    const DualBodyState& s = it->second;
+    const Dual* rows[6] = {&s.x, &s.y, &s.theta, &s.vx, &s.vy, &s.omega};
+    for (int r = 0; r < 6; ++r) {
+        for (int p = 0; p < numParams; ++p) {
+            result(r, p) = rows[r]->tan[p];
+        }
+    }
+    return result;
+}
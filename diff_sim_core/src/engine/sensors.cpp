@@ -0,0 +1,116 @@
+#include "engine/sensors.h"
+#include "engine/body.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+float Quantize(float value, float resolution) {
+    return resolution > 0.0f ? std::round(value / resolution) * resolution : value;
+}
+
+} // namespace
+
+SensorSuite::SensorSuite(unsigned int seed) : m_Rng(seed), m_Readings(ROWS, 0) {}
+
+float SensorSuite::Gaussian(float stdDev) {
+    return stdDev > 0.0f ? stdDev * m_Normal(m_Rng) : 0.0f;
+}
+
+int SensorSuite::Add(Body* pBody, const SensorConfig& config) {
+    if (!pBody) throw std::runtime_error("SensorSuite: body is required");
+    if (config.positionRate < 0.0f || config.positionDelay < 0.0f) {
+        throw std::runtime_error("SensorSuite: position rate and delay must be non-negative");
+    }
+    Sensor sensor;
+    sensor.pBody = pBody;
+    sensor.config = config;
+    m_Sensors.push_back(sensor);
+    m_Readings.conservativeResize(ROWS, (int)m_Sensors.size());
+    ResetSensor((int)m_Sensors.size() - 1);
+    return (int)m_Sensors.size() - 1;
+}
+
+void SensorSuite::Clear() {
+    m_Sensors.clear();
+    m_Readings.resize(ROWS, 0);
+}
+
+void SensorSuite::Seed(unsigned int seed) {
+    m_Rng.seed(seed);
+    m_Normal.reset();
+}
+
+void SensorSuite::Reset() {
+    m_Time = 0.0;
+    for (int i = 0; i < (int)m_Sensors.size(); ++i) ResetSensor(i);
+}
+
+void SensorSuite::ResetSensor(int index) {
+    Sensor& sensor = m_Sensors[index];
+    sensor.accelBias[0] = Gaussian(sensor.config.accelBias);
+    sensor.accelBias[1] = Gaussian(sensor.config.accelBias);
+    sensor.gyroBias = Gaussian(sensor.config.gyroBias);
+    sensor.nextFixTime = m_Time;
+    sensor.pending.clear();
+    sensor.bHasFix = false;
+
+    m_Readings.col(index).setZero();
+    m_Readings(FIX_AGE, index) = -1.0f;
+}
+
+void SensorSuite::BeginStep() {
+    for (Sensor& sensor : m_Sensors) {
+        sensor.startVel[0] = sensor.pBody->vel.Get(0, 0);
+        sensor.startVel[1] = sensor.pBody->vel.Get(1, 0);
+        sensor.startAngle = sensor.pBody->GetRotation();
+    }
+}
+
+void SensorSuite::EndStep(float dt, float gravityX, float gravityY) {
+    m_Time += dt;
+    float invDt = 1.0f / dt;
+    float sqrtDt = std::sqrt(dt);
+
+    for (int i = 0; i < (int)m_Sensors.size(); ++i) {
+        Sensor& sensor = m_Sensors[i];
+        const SensorConfig& config = sensor.config;
+        const Body& body = *sensor.pBody;
+
+        // Specific force in the world, then into the body frame
+        float fx = (body.vel.Get(0, 0) - sensor.startVel[0]) * invDt - gravityX;
+        float fy = (body.vel.Get(1, 0) - sensor.startVel[1]) * invDt - gravityY;
+        float angle = body.GetRotation();
+        float c = std::cos(angle), s = std::sin(angle);
+
+        sensor.accelBias[0] += Gaussian(config.accelBiasWalk * sqrtDt);
+        sensor.accelBias[1] += Gaussian(config.accelBiasWalk * sqrtDt);
+        sensor.gyroBias += Gaussian(config.gyroBiasWalk * sqrtDt);
+
+        float ax = c * fx + s * fy + sensor.accelBias[0] + Gaussian(config.accelNoise);
+        float ay = -s * fx + c * fy + sensor.accelBias[1] + Gaussian(config.accelNoise);
+        float rate = (angle - sensor.startAngle) * invDt + sensor.gyroBias + Gaussian(config.gyroNoise);
+        m_Readings(ACCEL_X, i) = Quantize(ax, config.accelResolution);
+        m_Readings(ACCEL_Y, i) = Quantize(ay, config.accelResolution);
+        m_Readings(GYRO, i) = Quantize(rate, config.gyroResolution);
+
+        // Measure a fix when one is due, report the newest one whose latency has passed
+        if (m_Time >= sensor.nextFixTime - 1e-6) {
+            sensor.pending.push_back({m_Time, body.GetX() + Gaussian(config.positionNoise),
+                                      body.GetY() + Gaussian(config.positionNoise)});
+            double period = config.positionRate > 0.0f ? 1.0 / config.positionRate : 0.0;
+            sensor.nextFixTime = std::max(sensor.nextFixTime + period, m_Time);
+        }
+        while (!sensor.pending.empty() && sensor.pending.front().time + config.positionDelay <= m_Time + 1e-6) {
+            sensor.reported = sensor.pending.front();
+            sensor.bHasFix = true;
+            sensor.pending.pop_front();
+        }
+        if (sensor.bHasFix) {
+            m_Readings(FIX_X, i) = sensor.reported.x;
+            m_Readings(FIX_Y, i) = sensor.reported.y;
+            m_Readings(FIX_AGE, i) = (float)(m_Time - sensor.reported.time);
+        }
+    }
+}
@@ -0,0 +1,316 @@
+#include "engine/system_id.h"
+#include "engine/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Same layout as DroneVecEnv::World: the engine and body hold raw pointers
+// to what is declared before them
+struct SystemIdentifier::World {
+    std::vector<std::unique_ptr<Motor>> motors;
+    std::unique_ptr<Body> pBody;
+    std::unique_ptr<Engine> pEngine;
+    bool bTracking = false;  // Sensitivity parameters registered on pEngine
+};
+
+// Per-thread partial sums of the (robust, IRLS-weighted) normal equations
+struct SystemIdentifier::Accumulator {
+    Eigen::MatrixXd hessian;  // J^T W J
+    Eigen::VectorXd gradient; // J^T W r
+    double cost = 0.0;
+};
+
+// Lower bounds that keep the model physical after a step
+static double ClampParameter(SensitivityParam kind, double value) {
+    switch (kind) {
+        case SensitivityParam::MASS:
+        case SensitivityParam::INERTIA:
+        case SensitivityParam::MOTOR_MAX_THRUST:
+            return std::max(value, 1e-4);
+        case SensitivityParam::FRICTION:
+            return std::max(value, 0.0);
+        case SensitivityParam::RESTITUTION:
+            return std::max(0.0, std::min(value, 1.0));
+        case SensitivityParam::MOTOR_ANGLE:
+            break;
+    }
+    return value;
+}
+
+SystemIdentifier::SystemIdentifier(const DroneTaskConfig& model, const std::vector<SysIdParameter>& parameters,
+                                   const SysIdConfig& config)
+    : m_Model(model), m_Parameters(parameters), m_Config(config)
+{
+    if (parameters.empty()) throw std::runtime_error("SystemIdentifier: no parameters to fit");
+    if ((int)parameters.size() > DUAL_MAX_TANGENTS) {
+        throw std::runtime_error("SystemIdentifier: at most " + std::to_string(DUAL_MAX_TANGENTS) + " parameters");
+    }
+    for (const SysIdParameter& param : parameters) {
+        bool bMotorParam = (param.kind == SensitivityParam::MOTOR_MAX_THRUST ||
+                            param.kind == SensitivityParam::MOTOR_ANGLE);
+        if (bMotorParam && (param.motorIndex < 0 || param.motorIndex >= (int)model.motors.size())) {
+            throw std::runtime_error("SystemIdentifier: motor parameter needs a valid motor index");
+        }
+    }
+    if (config.stateWeights.size() != 6) {
+        throw std::runtime_error("SystemIdentifier: stateWeights must have 6 entries");
+    }
+
+    int numWorlds = GetNumThreads();
+    for (int i = 0; i < numWorlds; ++i) {
+        std::unique_ptr<World> pWorld(new World());
+        pWorld->pEngine.reset(new Engine(800, 600, 50.0f, model.deltaTime, model.substeps, true));
+        pWorld->pEngine->SetGravity(0.0f, -9.81f);
+        pWorld->pEngine->AddCollider(0.0f, -1.0f, 20.0f, 1.0f, 0.0f);
+
+        pWorld->pBody.reset(new Body(0.0f, 0.0f, model.mass, model.width, model.height));
+        for (const Motor& motorConfig : model.motors) {
+            pWorld->motors.emplace_back(new Motor(motorConfig));
+            pWorld->pBody->AddMotor(pWorld->motors.back().get());
+        }
+        pWorld->pBody->mass.SetRequiresGrad(false);
+        pWorld->pBody->inertia.SetRequiresGrad(false);
+        pWorld->pEngine->AddBody(pWorld->pBody.get());
+        m_Worlds.push_back(std::move(pWorld));
+    }
+
+    // Starting point: the model as built (mass and inertia include the motors)
+    const World& world = *m_Worlds[0];
+    m_Values.resize(parameters.size());
+    for (size_t p = 0; p < parameters.size(); ++p) {
+        const SysIdParameter& param = parameters[p];
+        switch (param.kind) {
+            case SensitivityParam::MASS: m_Values(p) = world.pBody->mass.Get(0, 0); break;
+            case SensitivityParam::INERTIA: m_Values(p) = world.pBody->inertia.Get(0, 0); break;
+            case SensitivityParam::FRICTION: m_Values(p) = world.pBody->friction; break;
+            case SensitivityParam::RESTITUTION: m_Values(p) = world.pBody->restitution; break;
+            case SensitivityParam::MOTOR_MAX_THRUST: m_Values(p) = world.motors[param.motorIndex]->max_thrust; break;
+            case SensitivityParam::MOTOR_ANGLE: m_Values(p) = world.motors[param.motorIndex]->angle; break;
+        }
+    }
+}
+
+SystemIdentifier::~SystemIdentifier() = default;
+
+void SystemIdentifier::AddSegment(const SysIdSegment& segment) {
+    if (segment.initialState.size() != 6) {
+        throw std::runtime_error("SystemIdentifier: initial state must be [x, y, theta, vx, vy, omega]");
+    }
+    if (segment.commands.rows() != (int)m_Model.motors.size()) {
+        throw std::runtime_error("SystemIdentifier: commands must have one row per motor");
+    }
+    if (segment.states.rows() != 6 || segment.states.cols() != segment.commands.cols()) {
+        throw std::runtime_error("SystemIdentifier: states must be (6, T) with one column per command");
+    }
+    m_Segments.push_back(segment);
+}
+
+Eigen::VectorXf SystemIdentifier::GetParameters() const {
+    return m_Values.cast<float>();
+}
+
+void SystemIdentifier::SetParameters(const Eigen::VectorXf& values) {
+    if (values.size() != m_Values.size()) {
+        throw std::runtime_error("SystemIdentifier: expected one value per parameter");
+    }
+    for (int p = 0; p < (int)values.size(); ++p) {
+        m_Values(p) = ClampParameter(m_Parameters[p].kind, values(p));
+    }
+}
+
+void SystemIdentifier::ApplyParameters(World& world, const Eigen::VectorXd& values) const {
+    Body& body = *world.pBody;
+    for (size_t p = 0; p < m_Parameters.size(); ++p) {
+        float value = (float)values(p);
+        const SysIdParameter& param = m_Parameters[p];
+        switch (param.kind) {
+            case SensitivityParam::MASS: body.mass.Set(0, 0, value); break;
+            case SensitivityParam::INERTIA: body.inertia.Set(0, 0, value); break;
+            case SensitivityParam::FRICTION: body.friction = value; break;
+            case SensitivityParam::RESTITUTION: body.restitution = value; break;
+            case SensitivityParam::MOTOR_MAX_THRUST: world.motors[param.motorIndex]->max_thrust = value; break;
+            case SensitivityParam::MOTOR_ANGLE: world.motors[param.motorIndex]->angle = value; break;
+        }
+    }
+}
+
+// ---------------- Replay ----------------
+
+void SystemIdentifier::ReplaySegment(World& world, const SysIdSegment& segment, bool bJacobian,
+                                     Accumulator& acc, Eigen::MatrixXf* pStates) const {
+    Engine& engine = *world.pEngine;
+    Body& body = *world.pBody;
+
+    // Tangents cost 16 lanes per value: only carry them when the Jacobian is wanted
+    if (bJacobian != world.bTracking) {
+        engine.ClearSensitivityParameters();
+        if (bJacobian) {
+            for (const SysIdParameter& param : m_Parameters) {
+                engine.AddSensitivityParameter(&body, param.kind, param.motorIndex);
+            }
+        }
+        world.bTracking = bJacobian;
+    }
+
+    const Eigen::VectorXf& x0 = segment.initialState;
+    body.SetPosition(x0(0), x0(1));
+    body.SetRotation(x0(2));
+    body.SetVelocity(x0(3), x0(4));
+    body.SetAngularVelocity(x0(5));
+    body.ResetForces();
+    engine.ResetSensitivities();
+
+    const Eigen::VectorXf& weights = m_Config.stateWeights;
+    double c = m_Config.lossScale;
+    int numSteps = (int)segment.commands.cols();
+    if (pStates) pStates->resize(6, numSteps);
+
+    Eigen::MatrixXd Jw;
+    for (int t = 0; t < numSteps; ++t) {
+        for (size_t m = 0; m < world.motors.size(); ++m) {
+            Motor& motor = *world.motors[m];
+            motor.SetThrust(segment.commands(m, t) * motor.max_thrust);
+        }
+        engine.Update();
+
+        float state[6] = {body.GetX(), body.GetY(), body.GetRotation(),
+                          body.vel.Get(0, 0), body.vel.Get(1, 0), body.ang_vel.Get(0, 0)};
+        if (pStates) {
+            for (int i = 0; i < 6; ++i) (*pStates)(i, t) = state[i];
+        }
+        if (bJacobian) {
+            Jw = weights.cast<double>().asDiagonal() * engine.GetSensitivity(&body).cast<double>();
+        }
+
+        for (int i = 0; i < 6; ++i) {
+            double r = weights(i) * (double)(state[i] - segment.states(i, t));
+            double rSq = r * r;
+            double rho = rSq;
+            double w = 1.0;
+            switch (m_Config.loss) {
+                case RobustLoss::SQUARED:
+                    break;
+                case RobustLoss::HUBER:
+                    if (std::abs(r) > c) {
+                        rho = 2.0 * c * std::abs(r) - c * c;
+                        w = c / std::abs(r);
+                    }
+                    break;
+                case RobustLoss::CAUCHY:
+                    rho = c * c * std::log1p(rSq / (c * c));
+                    w = 1.0 / (1.0 + rSq / (c * c));
+                    break;
+            }
+            acc.cost += 0.5 * rho;
+            if (bJacobian) {
+                acc.gradient.noalias() += (w * r) * Jw.row(i).transpose();
+                acc.hessian.noalias() += w * Jw.row(i).transpose() * Jw.row(i);
+            }
+        }
+    }
+}
+
+double SystemIdentifier::Accumulate(const Eigen::VectorXd& values, bool bJacobian,
+                                    Eigen::MatrixXd* pHessian, Eigen::VectorXd* pGradient) {
+    int numParams = NumParameters();
+    int numSegments = NumSegments();
+    int numBlocks = std::max(1, std::min(numSegments, (int)m_Worlds.size()));
+
+    std::vector<Accumulator> partials(numBlocks);
+    GetGlobalThreadPool().ParallelFor(numBlocks, [&](int block) {
+        World& world = *m_Worlds[block];
+        Accumulator& acc = partials[block];
+        acc.hessian = Eigen::MatrixXd::Zero(numParams, numParams);
+        acc.gradient = Eigen::VectorXd::Zero(numParams);
+        ApplyParameters(world, values);
+
+        int end = (block + 1) * numSegments / numBlocks;
+        for (int s = block * numSegments / numBlocks; s < end; ++s) {
+            ReplaySegment(world, m_Segments[s], bJacobian, acc, nullptr);
+        }
+    });
+
+    double cost = 0.0;
+    if (pHessian) pHessian->setZero(numParams, numParams);
+    if (pGradient) pGradient->setZero(numParams);
+    for (const Accumulator& acc : partials) {
+        cost += acc.cost;
+        if (pHessian) *pHessian += acc.hessian;
+        if (pGradient) *pGradient += acc.gradient;
+    }
+    return cost;
+}
+
+float SystemIdentifier::Evaluate() {
+    return (float)Accumulate(m_Values, false, nullptr, nullptr);
+}
+
+Eigen::MatrixXf SystemIdentifier::Replay(int segmentIndex) {
+    if (segmentIndex < 0 || segmentIndex >= NumSegments()) {
+        throw std::runtime_error("SystemIdentifier: segment index out of range");
+    }
+    World& world = *m_Worlds[0];
+    ApplyParameters(world, m_Values);
+    Accumulator acc;
+    Eigen::MatrixXf states;
+    ReplaySegment(world, m_Segments[segmentIndex], false, acc, &states);
+    return states;
+}
+
+// ---------------- Fit ----------------
+
+SysIdResult SystemIdentifier::Fit() {
+    if (m_Segments.empty()) throw std::runtime_error("SystemIdentifier: no segments to fit");
+
+    int numParams = NumParameters();
+    Eigen::MatrixXd H;
+    Eigen::VectorXd g;
+    Eigen::VectorXd values = m_Values;
+    double cost = Accumulate(values, true, &H, &g);
+    double lambda = m_Config.initialDamping;
+
+    SysIdResult result;
+    result.costHistory.push_back((float)cost);
+
+    for (int iter = 0; iter < m_Config.maxIterations; ++iter) {
+        result.iterations = iter + 1;
+
+        bool bAccepted = false;
+        double relative = 0.0;
+        while (!bAccepted && lambda < 1e10) {
+            // Marquardt scaling: damping proportional to each parameter's curvature
+            Eigen::MatrixXd A = H;
+            A.diagonal() += lambda * H.diagonal().cwiseMax(1e-12);
+            Eigen::VectorXd delta = A.ldlt().solve(-g);
+
+            Eigen::VectorXd trial = values + delta;
+            for (int p = 0; p < numParams; ++p) trial(p) = ClampParameter(m_Parameters[p].kind, trial(p));
+
+            double trialCost = Accumulate(trial, false, nullptr, nullptr);
+            if (std::isfinite(trialCost) && trialCost < cost) {
+                relative = (cost - trialCost) / std::max(cost, 1e-30);
+                values = trial;
+                cost = trialCost;
+                lambda = std::max(lambda * 0.1, 1e-9);
+                bAccepted = true;
+            } else {
+                lambda *= 10.0;
+            }
+        }
+        if (!bAccepted) {
+            result.bConverged = true;  // No descent direction left at any damping
+            break;
+        }
+        result.costHistory.push_back((float)cost);
+        if (relative < m_Config.tolerance) {
+            result.bConverged = true;
+            break;
+        }
+        Accumulate(values, true, &H, &g);
+    }
+
+    m_Values = values;
+    result.parameters = values.cast<float>();
+    result.cost = (float)cost;
+    return result;
+}
@@ -1,6 +1,43 @@
 #include "engine/tensor.h"
+#include "engine/thread_pool.h"
+#include "engine/compute.h"
+#include "engine/profiler.h"
 #include <iostream>
 #include <unordered_set>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+// ---------------- Forward-mode helpers ----------------
+
+using ConstMatMap = Eigen::Map<const Eigen::MatrixXf>;
+
+// Tangent of an elementwise f(x): scale each tangent row by f'(x)
+static Eigen::MatrixXf ScaleTangent(const Eigen::MatrixXf& tangent, const Eigen::MatrixXf& deriv) {
+    Eigen::Map<const Eigen::VectorXf> d(deriv.data(), deriv.size());
+    return (tangent.array().colwise() * d.array()).matrix();
+}
+
+// Apply a shape-aware linear map to every tangent direction.
+// Each column of 'tangent' is viewed as a (rows x cols) matrix.
+template <typename F>
+static Eigen::MatrixXf MapTangent(const Eigen::MatrixXf& tangent, int rows, int cols, int outSize, F f) {
+    Eigen::MatrixXf out(outSize, tangent.cols());
+    for (int p = 0; p < tangent.cols(); ++p) {
+        Eigen::MatrixXf r = f(ConstMatMap(tangent.col(p).data(), rows, cols));
+        out.col(p) = Eigen::Map<const Eigen::VectorXf>(r.data(), r.size());
+    }
+    return out;
+}
+
+// Graphs smaller than this run backward serially (scheduling overhead dominates)
+static int s_ParallelBackwardThreshold = 2048;
 
 Tensor::Tensor() {
     m_Data.resize(0, 0);
@@ -10,26 +47,33 @@ Tensor::Tensor() {
 Tensor::Tensor(int rows, int cols, bool requiresGrad) {
     m_Data.resize(rows, cols);
     m_Data.setZero();
+    ProfileScope::CountAllocation(rows, cols, (int64_t)m_Data.size() * sizeof(float));
     SetRequiresGrad(requiresGrad);
+    TrackMemory();
 }
 
 Tensor::Tensor(int size, bool requiresGrad) {
     m_Data.resize(size, 1);
     m_Data.setZero();
+    ProfileScope::CountAllocation(size, 1, (int64_t)m_Data.size() * sizeof(float));
     SetRequiresGrad(requiresGrad);
+    TrackMemory();
 }
 
 Tensor::Tensor(std::vector<float> dataList, bool requiresGrad) {
     m_Data.resize(dataList.size(), 1);
+    ProfileScope::CountAllocation((int)dataList.size(), 1, (int64_t)m_Data.size() * sizeof(float));
     for (size_t i = 0; i < dataList.size(); ++i) {
         m_Data(i, 0) = dataList[i];
     }
     SetRequiresGrad(requiresGrad);
+    TrackMemory();
 }
 
 void Tensor::Set(int r, int c, float value) {
     if (r >= 0 && r < m_Data.rows() && c >= 0 && c < m_Data.cols()) {
         m_Data(r, c) = value;
+        ++m_Version;
     }
 }
 
@@ -45,6 +89,8 @@ void Tensor::SetRequiresGrad(bool requiresGrad) {
     if (requiresGrad && m_Grad.size() == 0) {
         m_Grad.resizeLike(m_Data);
         m_Grad.setZero();
+        ProfileScope::CountAllocation(m_Data.rows(), m_Data.cols(), (int64_t)m_Grad.size() * sizeof(float));
+        TrackMemory();
     }
 }
 
@@ -62,6 +108,7 @@ void Tensor::Backward() {
 
     if (m_Grad.size() == 0) {
         m_Grad.resizeLike(m_Data);
+        TrackMemory();
     }
     m_Grad.setOnes();
 
@@ -97,27 +144,296 @@ void Tensor::Backward() {
     
 
     // Backward Pass
-    int count = 0;
+    if ((int)topo.size() >= s_ParallelBackwardThreshold && GetNumThreads() > 1 && !ThreadPool::InWorker()) {
+        BackwardParallel(topo);
+        return;
+    }
     for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
         Tensor* pNode = *it;
         if (pNode->m_BackwardFn) {
-            pNode->m_BackwardFn(*pNode);
+            RunBackwardFn(pNode);
+        }
+    }
+}
+
+void Tensor::RunBackwardFn(Tensor* pNode) {
+    pNode->CheckSavedVersions();
+    if (!Profiler::IsEnabled()) {
+        pNode->m_BackwardFn(*pNode);
+        return;
+    }
+    int64_t startNs = Profiler::NowNs();
+    pNode->m_BackwardFn(*pNode);
+    Profiler::RecordBackward(pNode->m_OpName ? pNode->m_OpName : "Unknown", startNs, Profiler::NowNs() - startNs);
+}
+
+// ---------------- Parallel backward ----------------
+
+struct BackwardContext {
+    std::unordered_map<const Tensor*, int> sharedIndex; // Nodes with more than one incoming gradient edge
+    std::vector<std::vector<Eigen::MatrixXf>> buffers;  // [worker slot][shared index]
+
+    // Buffers still held here were never reduced (the backward threw)
+    ~BackwardContext() {
+        int64_t bytes = 0;
+        for (const std::vector<Eigen::MatrixXf>& slot : buffers) {
+            for (const Eigen::MatrixXf& buffer : slot) bytes += (int64_t)buffer.size() * sizeof(float);
+        }
+        if (bytes > 0) MemoryTracker::AddBackwardScratchBytes(-bytes);
+    }
+};
+
+static thread_local BackwardContext* t_pBackwardCtx = nullptr;
+static thread_local int t_BackwardSlot = 0;
+
+Eigen::MatrixXf& Tensor::GradAccumulator(const Tensor* pTarget) {
+    Tensor* pNode = const_cast<Tensor*>(pTarget);
+    if (!t_pBackwardCtx) return pNode->m_Grad;
+
+    auto it = t_pBackwardCtx->sharedIndex.find(pTarget);
+    if (it == t_pBackwardCtx->sharedIndex.end()) return pNode->m_Grad; // Single writer
+
+    Eigen::MatrixXf& buffer = t_pBackwardCtx->buffers[t_BackwardSlot][it->second];
+    if (buffer.size() == 0) {
+        buffer.setZero(pNode->m_Data.rows(), pNode->m_Data.cols());
+        MemoryTracker::AddBackwardScratchBytes((int64_t)buffer.size() * sizeof(float));
+    }
+    return buffer;
+}
+
+void Tensor::BackwardParallel(const std::vector<Tensor*>& topo) {
+    int numNodes = (int)topo.size();
+    int numSlots = GetNumThreads();
+
+    std::unordered_map<const Tensor*, int> nodeIndex;
+    nodeIndex.reserve(numNodes);
+    for (int i = 0; i < numNodes; ++i) nodeIndex[topo[i]] = i;
+
+    // Dependency counts: a node is ready once every parent has pushed its gradient
+    std::unique_ptr<std::atomic<int>[]> pending(new std::atomic<int>[numNodes]);
+    std::vector<int> incoming(numNodes, 0);
+    for (Tensor* pNode : topo) {
+        for (Tensor* pChild : pNode->m_Children) incoming[nodeIndex[pChild]]++;
+    }
+
+    BackwardContext ctx;
+    for (int i = 0; i < numNodes; ++i) {
+        pending[i].store(incoming[i], std::memory_order_relaxed);
+        if (incoming[i] > 1) {
+            int k = (int)ctx.sharedIndex.size();
+            ctx.sharedIndex[topo[i]] = k;
         }
     }
+    ctx.buffers.assign(numSlots, std::vector<Eigen::MatrixXf>(ctx.sharedIndex.size()));
+
+    std::deque<int> ready;
+    std::mutex readyMutex;
+    std::condition_variable readyCv;
+    std::atomic<int> numDone(0);
+    std::atomic<bool> bAbort(false);
+    ready.push_back(numNodes - 1); // Root is last in topological order
+
+    auto reduceShared = [&](int nodeId) {
+        auto it = ctx.sharedIndex.find(topo[nodeId]);
+        if (it == ctx.sharedIndex.end()) return;
+        Tensor* pNode = topo[nodeId];
+        for (int s = 0; s < numSlots; ++s) {
+            Eigen::MatrixXf& buffer = ctx.buffers[s][it->second];
+            if (buffer.size() == 0) continue;
+            pNode->m_Grad += buffer;
+            MemoryTracker::AddBackwardScratchBytes(-(int64_t)buffer.size() * (int64_t)sizeof(float));
+            buffer.resize(0, 0);
+        }
+    };
+
+    GetGlobalThreadPool().ParallelFor(numSlots, [&](int slot) {
+        t_pBackwardCtx = &ctx;
+        t_BackwardSlot = slot;
+        try {
+            while (true) {
+                int nodeId;
+                {
+                    std::unique_lock<std::mutex> lock(readyMutex);
+                    readyCv.wait(lock, [&]() {
+                        return !ready.empty() || bAbort.load() || numDone.load() == numNodes;
+                    });
+                    if (ready.empty() || bAbort.load()) break;
+                    nodeId = ready.front();
+                    ready.pop_front();
+                }
+
+                // Follow one newly-ready child inline, queue the rest
+                while (nodeId >= 0 && !bAbort.load(std::memory_order_relaxed)) {
+                    Tensor* pNode = topo[nodeId];
+                    if (pNode->m_BackwardFn) {
+                        RunBackwardFn(pNode);
+                    }
+
+                    int next = -1;
+                    for (Tensor* pChild : pNode->m_Children) {
+                        int childId = nodeIndex.at(pChild);
+                        if (pending[childId].fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+                        reduceShared(childId);
+                        if (next < 0) {
+                            next = childId;
+                        } else {
+                            std::lock_guard<std::mutex> lock(readyMutex);
+                            ready.push_back(childId);
+                            readyCv.notify_one();
+                        }
+                    }
+
+                    if (numDone.fetch_add(1) + 1 == numNodes) {
+                        std::lock_guard<std::mutex> lock(readyMutex);
+                        readyCv.notify_all();
+                    }
+                    nodeId = next;
+                }
+            }
+        } catch (...) {
+            t_pBackwardCtx = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(readyMutex);
+                bAbort = true;
+            }
+            readyCv.notify_all();
+            throw;
+        }
+        t_pBackwardCtx = nullptr;
+    });
+}
+
+void Tensor::SetParallelBackwardThreshold(int minNodes) {
+    s_ParallelBackwardThreshold = minNodes;
+}
+
+int Tensor::GetParallelBackwardThreshold() {
+    return s_ParallelBackwardThreshold;
 }
 
 int Tensor::Rows() const { return m_Data.rows(); }
 int Tensor::Cols() const { return m_Data.cols(); }
 float* Tensor::DataPtr() { return m_Data.data(); }
 
+// ---------------- Version tracking ----------------
+
+void Tensor::SaveForBackward(std::initializer_list<const Tensor*> inputs, bool bOutput) {
+    for (const Tensor* pInput : inputs) {
+        m_SavedVersions.emplace_back(pInput, pInput->m_Version);
+    }
+    if (bOutput) {
+        m_SavedVersions.emplace_back(nullptr, m_Version);
+    }
+}
+
+void Tensor::CheckSavedVersions() const {
+    for (const auto& saved : m_SavedVersions) {
+        const Tensor* pSaved = saved.first ? saved.first : this;
+        if (pSaved->m_Version != saved.second) {
+            throw std::runtime_error(
+                std::string("Backward of ") + (m_OpName ? m_OpName : "op") +
+                ": a Tensor needed for gradient computation was modified in place (version " +
+                std::to_string(pSaved->m_Version) + ", expected " + std::to_string(saved.second) +
+                "). Use the out-of-place op, or rebuild the graph after the update.");
+        }
+    }
+}
+
+void Tensor::CheckInPlace(const Tensor* pOther, const char* opName) const {
+    if (!IsLeaf()) {
+        throw std::runtime_error(std::string(opName) + ": in-place op on a non-leaf Tensor (it is part of a graph)");
+    }
+    if (pOther && pOther->m_bRequiresGrad && pOther != this) {
+        throw std::runtime_error(std::string(opName) + ": operand requires grad; use the out-of-place op");
+    }
+}
+
+// ---------------- In-place ops ----------------
+
+Tensor& Tensor::AddInPlace(const Tensor& other, float alpha) {
+    CheckInPlace(&other, "AddInPlace");
+    if (other.m_Data.size() == 1) {
+        m_Data.array() += alpha * other.m_Data(0, 0);
+    } else {
+        m_Data += alpha * other.m_Data;
+    }
+    if (other.m_Tangent.size() > 0 || m_Tangent.size() > 0) {
+        int numDirs = std::max(NumTangents(), other.NumTangents());
+        Eigen::MatrixXf tOther = other.TangentOrZero(numDirs);
+        m_Tangent = TangentOrZero(numDirs);
+        if (other.m_Data.size() == 1) {
+            m_Tangent.rowwise() += alpha * tOther.row(0);
+        } else {
+            m_Tangent += alpha * tOther;
+        }
+    }
+    ++m_Version;
+    return *this;
+}
+
+Tensor& Tensor::MulInPlace(const Tensor& other) {
+    CheckInPlace(&other, "MulInPlace");
+    if (other.m_Tangent.size() > 0 || m_Tangent.size() > 0) {
+        // d(xy) = y dx + x dy, using values from before the write
+        int numDirs = std::max(NumTangents(), other.NumTangents());
+        Eigen::MatrixXf tOther = other.TangentOrZero(numDirs);
+        Eigen::MatrixXf tSelf = TangentOrZero(numDirs);
+        if (other.m_Data.size() == 1) {
+            Eigen::Map<const Eigen::VectorXf> x(m_Data.data(), m_Data.size());
+            m_Tangent = tSelf * other.m_Data(0, 0) + x * tOther.row(0);
+        } else {
+            m_Tangent = ScaleTangent(tSelf, other.m_Data) + ScaleTangent(tOther, m_Data);
+        }
+    }
+    if (other.m_Data.size() == 1) {
+        m_Data *= other.m_Data(0, 0);
+    } else {
+        m_Data.array() *= other.m_Data.array();
+    }
+    ++m_Version;
+    return *this;
+}
+
+Tensor& Tensor::MulInPlace(float scalar) {
+    CheckInPlace(nullptr, "MulInPlace");
+    m_Data *= scalar;
+    if (m_Tangent.size() > 0) m_Tangent *= scalar;
+    ++m_Version;
+    return *this;
+}
+
+Tensor& Tensor::CopyFrom(const Tensor& other) {
+    CheckInPlace(&other, "CopyFrom");
+    if (other.m_Data.rows() != m_Data.rows() || other.m_Data.cols() != m_Data.cols()) {
+        throw std::runtime_error("CopyFrom: shape mismatch");
+    }
+    m_Data = other.m_Data; // Same shape: Eigen reuses the buffer
+    m_Tangent = other.m_Tangent;
+    ++m_Version;
+    return *this;
+}
+
+Tensor& Tensor::ClampInPlace(float minVal, float maxVal) {
+    CheckInPlace(nullptr, "ClampInPlace");
+    if (m_Tangent.size() > 0) {
+        Eigen::MatrixXf inside = (m_Data.array() >= minVal && m_Data.array() <= maxVal).cast<float>();
+        m_Tangent = ScaleTangent(m_Tangent, inside);
+    }
+    m_Data = m_Data.cwiseMax(minVal).cwiseMin(maxVal);
+    ++m_Version;
+    return *this;
+}
+
 // Reductions
 
 // Sum (Scalar)
 Tensor Tensor::Sum() {
+    ProfileScope profile("Sum");
     Tensor result(1, 1, false);
     result.m_Data(0, 0) = this->m_Data.sum();
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Sum";
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -126,15 +442,19 @@ Tensor Tensor::Sum() {
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
                 float gradVal = self.m_Grad(0, 0); 
-                this->m_Grad.array() += gradVal;
+                GradAccumulator(this).array() += gradVal;
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = m_Tangent.colwise().sum();
+    }
     return result;
 }
 
 // Min (Scalar)
 Tensor Tensor::Min() {
+    ProfileScope profile("Min");
     Tensor result(1, 1, false);
     Eigen::Index r, c;
     float val = this->m_Data.minCoeff(&r, &c);
@@ -142,19 +462,24 @@ Tensor Tensor::Min() {
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Min";
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this, r, c](Tensor& self) {
              if (this->m_bRequiresGrad) {
-                 this->m_Grad(r, c) += self.m_Grad(0,0);
+                 GradAccumulator(this)(r, c) += self.m_Grad(0,0);
              }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = m_Tangent.row(r + c * m_Data.rows());
+    }
     return result;
 }
 
 // Max (Scalar)
 Tensor Tensor::Max() {
+    ProfileScope profile("Max");
     Tensor result(1, 1, false);
     Eigen::Index r, c;
     float val = this->m_Data.maxCoeff(&r, &c);
@@ -162,19 +487,24 @@ Tensor Tensor::Max() {
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Max";
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this, r, c](Tensor& self) {
              if (this->m_bRequiresGrad) {
-                 this->m_Grad(r, c) += self.m_Grad(0,0);
+                 GradAccumulator(this)(r, c) += self.m_Grad(0,0);
              }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = m_Tangent.row(r + c * m_Data.rows());
+    }
     return result;
 }
 
 // Sum (Axis)
 Tensor Tensor::Sum(int axis) {
+    ProfileScope profile("SumAxis");
     if (axis != 0 && axis != 1) throw std::runtime_error("Axis must be 0 or 1");
 
     Tensor result(0,0);
@@ -188,23 +518,30 @@ Tensor Tensor::Sum(int axis) {
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "SumAxis";
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this, axis](Tensor& self) {
             if (this->m_bRequiresGrad) {
                 if (axis == 0) {
-                    this->m_Grad.array() += self.m_Grad.array().row(0).replicate(this->Rows(), 1);
+                    GradAccumulator(this).array() += self.m_Grad.array().row(0).replicate(this->Rows(), 1);
                 } else {
-                    this->m_Grad.array() += self.m_Grad.array().col(0).replicate(1, this->Cols());
+                    GradAccumulator(this).array() += self.m_Grad.array().col(0).replicate(1, this->Cols());
                 }
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = MapTangent(m_Tangent, Rows(), Cols(), result.m_Data.size(), [axis](const ConstMatMap& t) {
+            return axis == 0 ? Eigen::MatrixXf(t.colwise().sum()) : Eigen::MatrixXf(t.rowwise().sum());
+        });
+    }
     return result;
 }
 
 // Mean (Axis)
 Tensor Tensor::Mean(int axis) {
+    ProfileScope profile("MeanAxis");
     if (axis != 0 && axis != 1) throw std::runtime_error("Axis must be 0 or 1");
     Tensor result(0,0);
     if (axis == 0) {
@@ -217,28 +554,37 @@ Tensor Tensor::Mean(int axis) {
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "MeanAxis";
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this, axis](Tensor& self) {
             if (this->m_bRequiresGrad) {
                 float n = (axis == 0) ? (float)this->Rows() : (float)this->Cols();
                 if (axis == 0) {
-                     this->m_Grad.array() += (self.m_Grad.array().row(0) / n).replicate(this->Rows(), 1);
+                     GradAccumulator(this).array() += (self.m_Grad.array().row(0) / n).replicate(this->Rows(), 1);
                 } else {
-                     this->m_Grad.array() += (self.m_Grad.array().col(0) / n).replicate(1, this->Cols());
+                     GradAccumulator(this).array() += (self.m_Grad.array().col(0) / n).replicate(1, this->Cols());
                 }
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = MapTangent(m_Tangent, Rows(), Cols(), result.m_Data.size(), [axis](const ConstMatMap& t) {
+            return axis == 0 ? Eigen::MatrixXf(t.colwise().mean()) : Eigen::MatrixXf(t.rowwise().mean());
+        });
+    }
     return result;
 }
 
 Tensor Tensor::Sin() {
+    ProfileScope profile("Sin");
     Tensor result(m_Data.rows(), m_Data.cols(), false);
     result.m_Data = m_Data.array().sin().matrix();
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Sin";
+        result.SaveForBackward({this});
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -246,19 +592,25 @@ Tensor Tensor::Sin() {
 
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += self.m_Grad.array() * this->m_Data.array().cos();
+                GradAccumulator(this).array() += self.m_Grad.array() * this->m_Data.array().cos();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, m_Data.array().cos().matrix());
+    }
     return result;
 }
 
 Tensor Tensor::Cos() {
+    ProfileScope profile("Cos");
     Tensor result(m_Data.rows(), m_Data.cols(), false);
     result.m_Data = m_Data.array().cos().matrix();
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Cos";
+        result.SaveForBackward({this});
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -266,18 +618,23 @@ Tensor Tensor::Cos() {
 
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() -= self.m_Grad.array() * this->m_Data.array().sin();
+                GradAccumulator(this).array() -= self.m_Grad.array() * this->m_Data.array().sin();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, -m_Data.array().sin().matrix());
+    }
     return result;
 }
 
 Tensor Tensor::Mean() {
+    ProfileScope profile("Mean");
     Tensor result(1, 1, false);
     result.m_Data(0, 0) = this->m_Data.mean();
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Mean";
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -285,70 +642,223 @@ Tensor Tensor::Mean() {
         
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += self.m_Grad.array() / this->m_Data.rows();
+                GradAccumulator(this).array() += self.m_Grad.array() / this->m_Data.rows();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = m_Tangent.colwise().sum() / (float)m_Data.size();
+    }
     return result;
 }
 
 Tensor Tensor::Select(int idx) const {
-    Tensor result(1, 1, false);
+    ProfileScope profile("Select");
     if (idx < 0 || idx >= m_Data.size()) {
         std::cerr << "Error: Index " << idx << " out of bounds for Tensor size " << m_Data.size() << std::endl;
-        return result; 
+        return Tensor(1, 1, false);
     }
-    result.m_Data(0,0) = this->m_Data(idx);
-    
+    Tensor result = View(idx, 1, 1, 1, 1);
+    result.m_OpName = "Select";
+    return result;
+}
+
+// ---------------- Strided copies ----------------
+
+using StridedMap = Eigen::Map<Eigen::MatrixXf, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+using ConstStridedMap = Eigen::Map<const Eigen::MatrixXf, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+Tensor Tensor::View(int offset, int rows, int cols, int rowStride, int colStride) const {
+    ProfileScope profile("View");
+    int last = offset + (rows - 1) * rowStride + (cols - 1) * colStride;
+    if (rows <= 0 || cols <= 0 || offset < 0 || rowStride < 0 || colStride < 0 || last >= m_Data.size()) {
+        std::cerr << "Error: View (offset " << offset << ", " << rows << "x" << cols << ", strides " << rowStride
+                  << "/" << colStride << ") out of bounds for Tensor size " << m_Data.size() << std::endl;
+        return Tensor(1, 1, false);
+    }
+
+    // Eigen strides: outer = step between columns, inner = step between rows
+    Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> stride(colStride, rowStride);
+
+    Tensor result(rows, cols, false);
+    result.m_Data = ConstStridedMap(m_Data.data() + offset, rows, cols, stride);
+
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "View";
         result.m_Grad.setZero();
         result.m_Children.push_back(const_cast<Tensor*>(this));
-        
-        Tensor* pSelf = const_cast<Tensor*>(this);
-        result.m_BackwardFn = [pSelf, idx](Tensor& self) {
-            if (pSelf->m_bRequiresGrad) {
-                pSelf->m_Grad(idx) += self.m_Grad(0,0);
+
+        Tensor* pBase = const_cast<Tensor*>(this);
+        result.m_BackwardFn = [pBase, offset, rows, cols, stride](Tensor& self) {
+            if (pBase->m_bRequiresGrad) {
+                Eigen::MatrixXf& grad = GradAccumulator(pBase);
+                StridedMap(grad.data() + offset, rows, cols, stride) += self.m_Grad;
+            }
+        };
+    }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent.resize(rows * cols, m_Tangent.cols());
+        for (int j = 0; j < cols; ++j) {
+            for (int i = 0; i < rows; ++i) {
+                result.m_Tangent.row(i + j * rows) = m_Tangent.row(offset + i * rowStride + j * colStride);
+            }
+        }
+    }
+    return result;
+}
+
+Tensor Tensor::Slice(int rowStart, int numRows, int colStart, int numCols) const {
+    ProfileScope profile("Slice");
+    if (numCols < 0) numCols = Cols() - colStart;
+    if (rowStart < 0 || colStart < 0 || rowStart + numRows > Rows() || colStart + numCols > Cols()) {
+        std::cerr << "Error: Slice [" << rowStart << ":+" << numRows << ", " << colStart << ":+" << numCols
+                  << "] out of bounds for " << Rows() << "x" << Cols() << " Tensor" << std::endl;
+        return Tensor(1, 1, false);
+    }
+    Tensor result = View(rowStart + colStart * Rows(), numRows, numCols, 1, Rows());
+    result.m_OpName = "Slice";
+    return result;
+}
+
+Tensor Tensor::Gather(const std::vector<int>& indices) const {
+    ProfileScope profile("Gather");
+    int n = indices.size();
+    for (int idx : indices) {
+        if (idx < 0 || idx >= m_Data.size()) {
+            std::cerr << "Error: Gather index " << idx << " out of bounds for Tensor size " << m_Data.size() << std::endl;
+            return Tensor(n, 1, false);
+        }
+    }
+
+    Tensor result(n, 1, false);
+    for (int k = 0; k < n; ++k) {
+        result.m_Data(k, 0) = m_Data(indices[k]);
+    }
+
+    if (this->m_bRequiresGrad) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "Gather";
+        result.m_Grad.setZero();
+        result.m_Children.push_back(const_cast<Tensor*>(this));
+
+        Tensor* pBase = const_cast<Tensor*>(this);
+        result.m_BackwardFn = [pBase, indices](Tensor& self) {
+            if (pBase->m_bRequiresGrad) {
+                Eigen::MatrixXf& grad = GradAccumulator(pBase);
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    grad(indices[k]) += self.m_Grad(k, 0);
+                }
+            }
+        };
+    }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent.resize(n, m_Tangent.cols());
+        for (int k = 0; k < n; ++k) {
+            result.m_Tangent.row(k) = m_Tangent.row(indices[k]);
+        }
+    }
+    return result;
+}
+
+Tensor Tensor::ScatterAdd(const std::vector<int>& indices, int rows, int cols) const {
+    ProfileScope profile("ScatterAdd");
+    int n = indices.size();
+    if (n != m_Data.size()) {
+        std::cerr << "Error: ScatterAdd needs one index per element (" << m_Data.size() << "), got " << n << std::endl;
+        return Tensor(rows, cols, false);
+    }
+    for (int idx : indices) {
+        if (idx < 0 || idx >= rows * cols) {
+            std::cerr << "Error: ScatterAdd index " << idx << " out of bounds for " << rows << "x" << cols << std::endl;
+            return Tensor(rows, cols, false);
+        }
+    }
+
+    Tensor result(rows, cols, false);
+    result.m_Data.setZero();
+    for (int k = 0; k < n; ++k) {
+        result.m_Data(indices[k]) += m_Data(k);
+    }
+
+    if (this->m_bRequiresGrad) {
+        result.SetRequiresGrad(true);
+        result.m_OpName = "ScatterAdd";
+        result.m_Grad.setZero();
+        result.m_Children.push_back(const_cast<Tensor*>(this));
+
+        Tensor* pSource = const_cast<Tensor*>(this);
+        result.m_BackwardFn = [pSource, indices](Tensor& self) {
+            if (pSource->m_bRequiresGrad) {
+                Eigen::MatrixXf& grad = GradAccumulator(pSource);
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    grad(k) += self.m_Grad(indices[k]);
+                }
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent.setZero(rows * cols, m_Tangent.cols());
+        for (int k = 0; k < n; ++k) {
+            result.m_Tangent.row(indices[k]) += m_Tangent.row(k);
+        }
+    }
     return result;
 }
 
 Tensor Tensor::Stack(const std::vector<Tensor*>& tensors) {
+    ProfileScope profile("Stack");
     int n = tensors.size();
     if (n == 0) return Tensor(0, 1);
-    
-    Tensor result(n, 1, false); 
+
+    // Scalars stack into a column (n, 1); (r, 1) vectors stack as columns (r, n).
+    // Both layouts place input i at flat elements [i * r, (i + 1) * r).
+    int r = tensors[0]->Rows();
+    for (auto* pTensor : tensors) {
+        if (pTensor->Cols() != 1 || pTensor->Rows() != r) {
+            std::cerr << "Error: Stack expects inputs of one shape (r, 1)." << std::endl;
+            return Tensor(0, 1);
+        }
+    }
+
+    Tensor result(r == 1 ? n : r, r == 1 ? 1 : n, false);
+    for (int i = 0; i < n; ++i) {
+        Eigen::Map<Eigen::VectorXf>(result.m_Data.data() + i * r, r) = tensors[i]->m_Data.col(0);
+    }
+
     bool bAnyGrad = false;
-    for(auto* pTensor : tensors) {
-        if(pTensor->GetRequiresGrad()) bAnyGrad = true;
+    for (auto* pTensor : tensors) {
+        if (pTensor->GetRequiresGrad()) bAnyGrad = true;
     }
-    
+
     if (bAnyGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Stack";
         result.m_Grad.setZero();
-        
-        for(int i=0; i<n; ++i) {
-            result.m_Data(i, 0) = tensors[i]->m_Data(0,0);
-            if(tensors[i]->GetRequiresGrad()) {
+
+        for (int i = 0; i < n; ++i) {
+            if (tensors[i]->GetRequiresGrad()) {
                 result.m_Children.push_back(tensors[i]);
             }
         }
-        
+
         std::vector<Tensor*> inputs = tensors;
-        
-        result.m_BackwardFn = [inputs](Tensor& self) {
-            for(size_t i=0; i<inputs.size(); ++i) {
+
+        result.m_BackwardFn = [inputs, r](Tensor& self) {
+            for (size_t i = 0; i < inputs.size(); ++i) {
                 Tensor* pInput = inputs[i];
-                if(pInput->GetRequiresGrad()) {
-                    pInput->m_Grad(0,0) += self.m_Grad(i,0);
+                if (pInput->GetRequiresGrad()) {
+                    GradAccumulator(pInput).col(0) += Eigen::Map<const Eigen::VectorXf>(self.m_Grad.data() + i * r, r);
                 }
             }
         };
-    } else {
-         for(int i=0; i<n; ++i) {
-            result.m_Data(i, 0) = tensors[i]->m_Data(0,0);
+    }
+    int numDirs = 0;
+    for (auto* pTensor : tensors) numDirs = std::max(numDirs, pTensor->NumTangents());
+    if (numDirs > 0) {
+        result.m_Tangent.resize(n * r, numDirs);
+        for (int i = 0; i < n; ++i) {
+            result.m_Tangent.middleRows(i * r, r) = tensors[i]->TangentOrZero(numDirs);
         }
     }
     return result;
@@ -358,11 +868,13 @@ Tensor Tensor::Stack(const std::vector<Tensor*>& tensors) {
 // ---------------- Operators ----------------
 
 Tensor Tensor::operator+(const Tensor& other) const {
+    ProfileScope profile("Add");
     Tensor result(m_Data.rows(), m_Data.cols(), false);
     result.m_Data = this->m_Data + other.m_Data;
 
     if (this->m_bRequiresGrad || other.m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Add";
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -371,22 +883,28 @@ Tensor Tensor::operator+(const Tensor& other) const {
 
         result.m_BackwardFn = [this, &other](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                const_cast<Tensor*>(this)->m_Grad += self.m_Grad;
+                GradAccumulator(this) += self.m_Grad;
             }
             if (other.m_bRequiresGrad) {
-                const_cast<Tensor*>(&other)->m_Grad += self.m_Grad;
+                GradAccumulator(&other) += self.m_Grad;
             }
         };
     }
+    int numDirs = std::max(NumTangents(), other.NumTangents());
+    if (numDirs > 0) {
+        result.m_Tangent = TangentOrZero(numDirs) + other.TangentOrZero(numDirs);
+    }
     return result;
 }
 
 Tensor Tensor::operator-(const Tensor& other) const {
+    ProfileScope profile("Sub");
     Tensor result(m_Data.rows(), m_Data.cols(), false);
     result.m_Data = this->m_Data - other.m_Data;
 
     if (this->m_bRequiresGrad || other.m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Sub";
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -395,17 +913,22 @@ Tensor Tensor::operator-(const Tensor& other) const {
 
         result.m_BackwardFn = [this, &other](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                const_cast<Tensor*>(this)->m_Grad += self.m_Grad;
+                GradAccumulator(this) += self.m_Grad;
             }
             if (other.m_bRequiresGrad) {
-                const_cast<Tensor*>(&other)->m_Grad -= self.m_Grad;
+                GradAccumulator(&other) -= self.m_Grad;
             }
         };
     }
+    int numDirs = std::max(NumTangents(), other.NumTangents());
+    if (numDirs > 0) {
+        result.m_Tangent = TangentOrZero(numDirs) - other.TangentOrZero(numDirs);
+    }
     return result;
 }
 
 Tensor Tensor::operator*(const Tensor& other) const {
+    ProfileScope profile("Mul");
     bool bScalarBroadcast = (other.Rows() == 1 && other.Cols() == 1);
     
     Tensor result(m_Data.rows(), m_Data.cols(), false);
@@ -423,6 +946,8 @@ Tensor Tensor::operator*(const Tensor& other) const {
 
     if (this->m_bRequiresGrad || other.m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Mul";
+        result.SaveForBackward({this, &other});
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
 
@@ -432,25 +957,37 @@ Tensor Tensor::operator*(const Tensor& other) const {
         result.m_BackwardFn = [this, &other, bScalarBroadcast](Tensor& self) {
             if (this->m_bRequiresGrad) {
                 if (bScalarBroadcast) {
-                     const_cast<Tensor*>(this)->m_Grad.array() += self.m_Grad.array() * other.m_Data(0,0);
+                     GradAccumulator(this).array() += self.m_Grad.array() * other.m_Data(0,0);
                 } else {
-                     const_cast<Tensor*>(this)->m_Grad.array() += self.m_Grad.array() * other.m_Data.array();
+                     GradAccumulator(this).array() += self.m_Grad.array() * other.m_Data.array();
                 }
             }
             if (other.m_bRequiresGrad) {
                 if (bScalarBroadcast) {
                     float gradScalar = (self.m_Grad.array() * this->m_Data.array()).sum();
-                    const_cast<Tensor*>(&other)->m_Grad(0,0) += gradScalar;
+                    GradAccumulator(&other)(0,0) += gradScalar;
                 } else {
-                     const_cast<Tensor*>(&other)->m_Grad.array() += self.m_Grad.array() * this->m_Data.array();
+                     GradAccumulator(&other).array() += self.m_Grad.array() * this->m_Data.array();
                 }
             }
         };
     }
+    int numDirs = std::max(NumTangents(), other.NumTangents());
+    if (numDirs > 0) {
+        Eigen::MatrixXf tA = TangentOrZero(numDirs);
+        Eigen::MatrixXf tB = other.TangentOrZero(numDirs);
+        if (bScalarBroadcast) {
+            Eigen::Map<const Eigen::VectorXf> a(m_Data.data(), m_Data.size());
+            result.m_Tangent = tA * other.m_Data(0, 0) + a * tB.row(0);
+        } else {
+            result.m_Tangent = ScaleTangent(tA, other.m_Data) + ScaleTangent(tB, m_Data);
+        }
+    }
     return result;
 }
 
 Tensor Tensor::operator/(const Tensor& other) const {
+    ProfileScope profile("Div");
     bool bScalarBroadcast = (other.Rows() == 1 && other.Cols() == 1);
 
     Tensor result(m_Data.rows(), m_Data.cols(), false);
@@ -468,6 +1005,8 @@ Tensor Tensor::operator/(const Tensor& other) const {
 
     if (this->m_bRequiresGrad || other.m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Div";
+        result.SaveForBackward({this, &other});
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
 
@@ -477,31 +1016,46 @@ Tensor Tensor::operator/(const Tensor& other) const {
         result.m_BackwardFn = [this, &other, bScalarBroadcast](Tensor& self) {
             if (this->m_bRequiresGrad) {
                 if (bScalarBroadcast) {
-                    const_cast<Tensor*>(this)->m_Grad.array() += self.m_Grad.array() / other.m_Data(0,0);
+                    GradAccumulator(this).array() += self.m_Grad.array() / other.m_Data(0,0);
                 } else {
-                    const_cast<Tensor*>(this)->m_Grad.array() += self.m_Grad.array() / other.m_Data.array();
+                    GradAccumulator(this).array() += self.m_Grad.array() / other.m_Data.array();
                 }
             }
             if (other.m_bRequiresGrad) {
                 if (bScalarBroadcast) {
                      float s = other.m_Data(0,0);
                      float gradScalar = (self.m_Grad.array() * this->m_Data.array() * (-1.0f / (s*s))).sum();
-                     const_cast<Tensor*>(&other)->m_Grad(0,0) += gradScalar;
+                     GradAccumulator(&other)(0,0) += gradScalar;
                 } else {
-                    const_cast<Tensor*>(&other)->m_Grad.array() -= self.m_Grad.array() * this->m_Data.array() / (other.m_Data.array().square());
+                    GradAccumulator(&other).array() -= self.m_Grad.array() * this->m_Data.array() / (other.m_Data.array().square());
                 }
             }
         };
     }
+    int numDirs = std::max(NumTangents(), other.NumTangents());
+    if (numDirs > 0) {
+        Eigen::MatrixXf tA = TangentOrZero(numDirs);
+        Eigen::MatrixXf tB = other.TangentOrZero(numDirs);
+        if (bScalarBroadcast) {
+            float s = other.m_Data(0, 0);
+            Eigen::Map<const Eigen::VectorXf> a(m_Data.data(), m_Data.size());
+            result.m_Tangent = tA / s - (a / (s * s)) * tB.row(0);
+        } else {
+            result.m_Tangent = ScaleTangent(tA, other.m_Data.cwiseInverse())
+                             - ScaleTangent(tB, (m_Data.array() / other.m_Data.array().square()).matrix());
+        }
+    }
     return result;
 }
 
 Tensor Tensor::operator*(float scalar) const {
+    ProfileScope profile("MulScalar");
     Tensor result(m_Data.rows(), m_Data.cols(), false);
     result.m_Data = this->m_Data * scalar;
 
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "MulScalar";
         result.m_Grad.resizeLike(result.m_Data);
         result.m_Grad.setZero();
         
@@ -509,10 +1063,13 @@ Tensor Tensor::operator*(float scalar) const {
 
         result.m_BackwardFn = [this, scalar](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                const_cast<Tensor*>(this)->m_Grad.array() += self.m_Grad.array() * scalar;
+                GradAccumulator(this).array() += self.m_Grad.array() * scalar;
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = m_Tangent * scalar;
+    }
     return result;
 }
 
@@ -520,155 +1077,171 @@ Tensor Tensor::operator*(float scalar) const {
 
 // Transpose
 Tensor Tensor::Transpose() {
-    Tensor result(this->m_Data.cols(), this->m_Data.rows(), false);
-    result.m_Data = this->m_Data.transpose();
-    if (this->m_bRequiresGrad) {
-        result.SetRequiresGrad(true);
-        result.m_Grad.setZero();
-        result.m_Children.push_back(this);
-        result.m_BackwardFn = [this](Tensor& self) {
-            if (this->m_bRequiresGrad) {
-                this->m_Grad += self.m_Grad.transpose();
-            }
-        };
-    }
+    ProfileScope profile("Transpose");
+    // result(i, j) = base(j, i) = base[j + i * rows]
+    Tensor result = View(0, Cols(), Rows(), Rows(), 1);
+    result.m_OpName = "Transpose";
     return result;
 }
 
 // Power
 Tensor Tensor::Pow(float exponent) {
+    ProfileScope profile("Pow");
     Tensor result(this->m_Data.rows(), this->m_Data.cols(), false);
     result.m_Data = this->m_Data.array().pow(exponent);
     
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Pow";
+        result.SaveForBackward({this});
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         
         result.m_BackwardFn = [this, exponent](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += exponent * this->m_Data.array().pow(exponent - 1.0f) * self.m_Grad.array();
+                GradAccumulator(this).array() += exponent * this->m_Data.array().pow(exponent - 1.0f) * self.m_Grad.array();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, (exponent * m_Data.array().pow(exponent - 1.0f)).matrix());
+    }
     return result;
 }
 
 // Exp
 Tensor Tensor::Exp() {
+    ProfileScope profile("Exp");
     Tensor result(this->m_Data.rows(), this->m_Data.cols(), false);
     result.m_Data = this->m_Data.array().exp();
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Exp";
+        result.SaveForBackward({}, true);
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += self.m_Data.array() * self.m_Grad.array(); 
+                GradAccumulator(this).array() += self.m_Data.array() * self.m_Grad.array(); 
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, result.m_Data);
+    }
     return result;
 }
 
 // Log
 Tensor Tensor::Log() {
+    ProfileScope profile("Log");
     Tensor result(this->m_Data.rows(), this->m_Data.cols(), false);
     result.m_Data = this->m_Data.array().log();
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Log";
+        result.SaveForBackward({this});
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += self.m_Grad.array() / this->m_Data.array();
+                GradAccumulator(this).array() += self.m_Grad.array() / this->m_Data.array();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, m_Data.cwiseInverse());
+    }
     return result;
 }
 
 // Sqrt
 Tensor Tensor::Sqrt() {
+    ProfileScope profile("Sqrt");
     Tensor result(this->m_Data.rows(), this->m_Data.cols(), false);
     result.m_Data = this->m_Data.array().sqrt();
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Sqrt";
+        result.SaveForBackward({}, true);
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += 0.5f * self.m_Grad.array() / self.m_Data.array();
+                GradAccumulator(this).array() += 0.5f * self.m_Grad.array() / self.m_Data.array();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, (0.5f / result.m_Data.array()).matrix());
+    }
     return result;
 }
 
 // Abs
 Tensor Tensor::Abs() {
+    ProfileScope profile("Abs");
     Tensor result(this->m_Data.rows(), this->m_Data.cols(), false);
     result.m_Data = this->m_Data.array().abs();
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Abs";
+        result.SaveForBackward({this});
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this](Tensor& self) {
             if (this->m_bRequiresGrad) {
-                this->m_Grad.array() += self.m_Grad.array() * this->m_Data.array().sign();
+                GradAccumulator(this).array() += self.m_Grad.array() * this->m_Data.array().sign();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, m_Data.array().sign().matrix());
+    }
     return result;
 }
 
 // Clamp
 Tensor Tensor::Clamp(float minVal, float maxVal) {
+    ProfileScope profile("Clamp");
     Tensor result(this->m_Data.rows(), this->m_Data.cols(), false);
     result.m_Data = this->m_Data.cwiseMax(minVal).cwiseMin(maxVal);
     if (this->m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Clamp";
+        result.SaveForBackward({this});
         result.m_Grad.setZero();
         result.m_Children.push_back(this);
         result.m_BackwardFn = [this, minVal, maxVal](Tensor& self) {
             if (this->m_bRequiresGrad) {
                 Eigen::ArrayXXf x = this->m_Data.array();
-                this->m_Grad.array() += self.m_Grad.array() * (x >= minVal && x <= maxVal).cast<float>();
+                GradAccumulator(this).array() += self.m_Grad.array() * (x >= minVal && x <= maxVal).cast<float>();
             }
         };
     }
+    if (m_Tangent.size() > 0) {
+        result.m_Tangent = ScaleTangent(m_Tangent, (m_Data.array() >= minVal && m_Data.array() <= maxVal).cast<float>().matrix());
+    }
     return result;
 }
 
 
 // Reshape
 Tensor Tensor::Reshape(int r, int c) {
+    ProfileScope profile("Reshape");
     if (r * c != this->m_Data.size()) {
          std::cerr << "Error: Reshape size mismatch. Total " << this->m_Data.size() << " requested " << r << "x" << c << std::endl;
          return Tensor(1,1);
     }
-    
-    Tensor result(r, c, false);
-    result.m_Data = Eigen::Map<Eigen::MatrixXf>(this->m_Data.data(), r, c);
-    
-    if (this->m_bRequiresGrad) {
-        result.SetRequiresGrad(true);
-        result.m_Grad.setZero();
-        result.m_Children.push_back(this);
-        
-        result.m_BackwardFn = [this](Tensor& self) {
-            if (this->m_bRequiresGrad) {
-                Eigen::Map<Eigen::VectorXf> flatGrad(this->m_Grad.data(), this->m_Grad.size());
-                Eigen::Map<Eigen::VectorXf> flatSelf(self.m_Grad.data(), self.m_Grad.size());
-                flatGrad += flatSelf;
-            }
-        };
-    }
+    // Column-major storage: a reshape is a contiguous strided copy
+    Tensor result = View(0, r, c, 1, r);
+    result.m_OpName = "Reshape";
     return result;
 }
 
 // Concatenate
 Tensor Tensor::Cat(const std::vector<Tensor*>& tensors, int dim) {
+    ProfileScope profile("Cat");
     if (tensors.empty()) return Tensor(0, 0);
 
     int rows = tensors[0]->m_Data.rows();
@@ -707,6 +1280,7 @@ Tensor Tensor::Cat(const std::vector<Tensor*>& tensors, int dim) {
         
         if (pTensor->GetRequiresGrad()) {
             result.SetRequiresGrad(true);
+            result.m_OpName = "Cat";
             result.m_Children.push_back(const_cast<Tensor*>(pTensor));
         }
     }
@@ -724,9 +1298,9 @@ Tensor Tensor::Cat(const std::vector<Tensor*>& tensors, int dim) {
                 
                 if (pTensor->GetRequiresGrad()) {
                     if (dim == 0) {
-                        pTensor->m_Grad += self.m_Grad.block(offset, 0, r, c);
+                        GradAccumulator(pTensor) += self.m_Grad.block(offset, 0, r, c);
                     } else {
-                        pTensor->m_Grad += self.m_Grad.block(0, offset, r, c);
+                        GradAccumulator(pTensor) += self.m_Grad.block(0, offset, r, c);
                     }
                 }
                 
@@ -736,19 +1310,46 @@ Tensor Tensor::Cat(const std::vector<Tensor*>& tensors, int dim) {
         };
     }
     
+    int numDirs = 0;
+    for (const auto* pTensor : tensors) numDirs = std::max(numDirs, pTensor->NumTangents());
+    if (numDirs > 0) {
+        std::vector<Eigen::MatrixXf> inputTangents;
+        for (const auto* pTensor : tensors) inputTangents.push_back(pTensor->TangentOrZero(numDirs));
+
+        result.m_Tangent.resize(result.m_Data.size(), numDirs);
+        for (int p = 0; p < numDirs; ++p) {
+            Eigen::Map<Eigen::MatrixXf> out(result.m_Tangent.col(p).data(), totalRows, totalCols);
+            int offset = 0;
+            for (size_t i = 0; i < tensors.size(); ++i) {
+                int r = tensors[i]->m_Data.rows();
+                int c = tensors[i]->m_Data.cols();
+                ConstMatMap t(inputTangents[i].col(p).data(), r, c);
+                if (dim == 0) {
+                    out.block(offset, 0, r, c) = t;
+                    offset += r;
+                } else {
+                    out.block(0, offset, r, c) = t;
+                    offset += c;
+                }
+            }
+        }
+    }
     return result;
 }
 
 
 // Matrix Multiplication
 Tensor Tensor::Matmul(const Tensor& other) {
+    ProfileScope profile("Matmul");
     if (this->m_Data.cols() != other.m_Data.rows()) {
         throw std::runtime_error("Shape mismatch for Matmul");
     }
     Tensor result(this->m_Data.rows(), other.m_Data.cols(), false);
-    result.m_Data = this->m_Data * other.m_Data;
+    Gemm(this->m_Data, false, other.m_Data, false, result.m_Data, false);
     if (this->m_bRequiresGrad || other.m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "Matmul";
+        result.SaveForBackward({this, &other});
         result.m_Grad.setZero();
         if (this->m_bRequiresGrad) result.m_Children.push_back((Tensor*)this);
         if (other.m_bRequiresGrad) result.m_Children.push_back((Tensor*)&other);
@@ -756,73 +1357,145 @@ Tensor Tensor::Matmul(const Tensor& other) {
         Tensor* pB = (Tensor*)&other;
         result.m_BackwardFn = [pA, pB](Tensor& self) {
             if (pA->GetRequiresGrad()) {
-                pA->m_Grad += self.m_Grad * pB->m_Data.transpose();
+                Gemm(self.m_Grad, false, pB->m_Data, true, GradAccumulator(pA), true);
             }
             if (pB->GetRequiresGrad()) {
-                pB->m_Grad += pA->m_Data.transpose() * self.m_Grad;
+                Gemm(pA->m_Data, true, self.m_Grad, false, GradAccumulator(pB), true);
             }
         };
     }
+    int numDirs = std::max(NumTangents(), other.NumTangents());
+    if (numDirs > 0) {
+        Eigen::MatrixXf tA = TangentOrZero(numDirs);
+        Eigen::MatrixXf tB = other.TangentOrZero(numDirs);
+        result.m_Tangent.resize(result.m_Data.size(), numDirs);
+        for (int p = 0; p < numDirs; ++p) {
+            Eigen::Map<const Eigen::MatrixXf> dA(tA.col(p).data(), Rows(), Cols());
+            Eigen::Map<const Eigen::MatrixXf> dB(tB.col(p).data(), other.Rows(), other.Cols());
+            Eigen::Map<Eigen::MatrixXf> out(result.m_Tangent.col(p).data(), result.Rows(), result.Cols());
+            out.noalias() = dA * other.m_Data + m_Data * dB;
+        }
+    }
     return result;
 }
 
 
 // Gaussian log probability for policy gradients
-// log π(a|μ,σ) = -0.5 × ((a - μ)/σ)² - log(σ) - 0.5×log(2π)
+// log π(a|μ,σ) = Σ_i [-0.5 × ((a_i - μ_i)/σ_i)² - log(σ_i) - 0.5×log(2π)]
+// action and mean are (D, B), one sample per column; logStd is (D, B) or a
+// shared (D, 1). Returns (1, B).
 Tensor Tensor::GaussianLogProb(const Tensor& action, const Tensor& mean, const Tensor& logStd) {
+    ProfileScope profile("GaussianLogProb");
     const float LOG_2PI = 1.8378770664093453f;
-    
-    Tensor result(1, 1, false);
-    float total = 0.0f;
+
     int n = action.Rows();
-    
-    for (int i = 0; i < n; i++) {
-        float a = action.m_Data(i, 0);
-        float mu = mean.m_Data(i, 0);
-        float logS = logStd.m_Data(i, 0);
-        float s = std::exp(logS);
-        float diff = (a - mu) / s;
-        total += -0.5f * diff * diff - logS - 0.5f * LOG_2PI;
-    }
-    result.m_Data(0, 0) = total;
-    
+    int batch = action.Cols();
+    if (mean.Rows() != n || mean.Cols() != batch || logStd.Rows() != n ||
+        (logStd.Cols() != batch && logStd.Cols() != 1)) {
+        throw std::runtime_error("Shape mismatch for GaussianLogProb");
+    }
+    bool bSharedStd = logStd.Cols() != batch;
+
+    Tensor result(1, batch, false);
+    for (int b = 0; b < batch; b++) {
+        int sb = bSharedStd ? 0 : b;
+        float total = 0.0f;
+        for (int i = 0; i < n; i++) {
+            float a = action.m_Data(i, b);
+            float mu = mean.m_Data(i, b);
+            float logS = logStd.m_Data(i, sb);
+            float s = std::exp(logS);
+            float diff = (a - mu) / s;
+            total += -0.5f * diff * diff - logS - 0.5f * LOG_2PI;
+        }
+        result.m_Data(0, b) = total;
+    }
+
     if (mean.m_bRequiresGrad || logStd.m_bRequiresGrad) {
         result.SetRequiresGrad(true);
+        result.m_OpName = "GaussianLogProb";
+        result.SaveForBackward({&action, &mean, &logStd});
         result.m_Grad.setZero();
-        result.m_Children.push_back(const_cast<Tensor*>(&mean));
-        result.m_Children.push_back(const_cast<Tensor*>(&logStd));
-        
+        if (mean.m_bRequiresGrad) result.m_Children.push_back(const_cast<Tensor*>(&mean));
+        if (logStd.m_bRequiresGrad) result.m_Children.push_back(const_cast<Tensor*>(&logStd));
+
         Tensor* pAction = const_cast<Tensor*>(&action);
         Tensor* pMean = const_cast<Tensor*>(&mean);
         Tensor* pLogStd = const_cast<Tensor*>(&logStd);
-        int numDims = n;
-        
-        result.m_BackwardFn = [pAction, pMean, pLogStd, numDims](Tensor& self) {
-            for (int i = 0; i < numDims; i++) {
-                float a = pAction->m_Data(i, 0);
-                float mu = pMean->m_Data(i, 0);
-                float logS = pLogStd->m_Data(i, 0);
-                float s = std::exp(logS);
-                float diff = a - mu;
-                
-                if (pMean->m_bRequiresGrad) {
-                    pMean->m_Grad(i, 0) += self.m_Grad(0, 0) * diff / (s * s);
-                }
-                if (pLogStd->m_bRequiresGrad) {
-                    float normalizedDiff = diff / s;
-                    pLogStd->m_Grad(i, 0) += self.m_Grad(0, 0) * (normalizedDiff * normalizedDiff - 1.0f);
+
+        result.m_BackwardFn = [pAction, pMean, pLogStd, bSharedStd](Tensor& self) {
+            int numDims = pAction->Rows();
+            for (int b = 0; b < pAction->Cols(); b++) {
+                int sb = bSharedStd ? 0 : b;
+                float g = self.m_Grad(0, b);
+                for (int i = 0; i < numDims; i++) {
+                    float a = pAction->m_Data(i, b);
+                    float mu = pMean->m_Data(i, b);
+                    float logS = pLogStd->m_Data(i, sb);
+                    float s = std::exp(logS);
+                    float diff = a - mu;
+
+                    if (pMean->m_bRequiresGrad) {
+                        GradAccumulator(pMean)(i, b) += g * diff / (s * s);
+                    }
+                    if (pLogStd->m_bRequiresGrad) {
+                        float normalizedDiff = diff / s;
+                        GradAccumulator(pLogStd)(i, sb) += g * (normalizedDiff * normalizedDiff - 1.0f);
+                    }
                 }
             }
         };
     }
+    int numDirs = std::max({action.NumTangents(), mean.NumTangents(), logStd.NumTangents()});
+    if (numDirs > 0) {
+        Eigen::MatrixXf tAction = action.TangentOrZero(numDirs);
+        Eigen::MatrixXf tMean = mean.TangentOrZero(numDirs);
+        Eigen::MatrixXf tLogStd = logStd.TangentOrZero(numDirs);
+        result.m_Tangent = Eigen::MatrixXf::Zero(batch, numDirs);
+        for (int b = 0; b < batch; b++) {
+            int sb = bSharedStd ? 0 : b;
+            for (int i = 0; i < n; i++) {
+                int k = b * n + i;      // Flat index into action/mean
+                int ks = sb * n + i;    // Flat index into logStd
+                float s = std::exp(logStd.m_Data(i, sb));
+                float diff = (action.m_Data(i, b) - mean.m_Data(i, b)) / s;
+                // d/da = -diff/s, d/dmu = diff/s, d/dlogS = diff^2 - 1
+                result.m_Tangent.row(b) += (tMean.row(k) - tAction.row(k)) * (diff / s) + tLogStd.row(ks) * (diff * diff - 1.0f);
+            }
+        }
+    }
     return result;
 }
 
 // Accessors
 Eigen::MatrixXf Tensor::GetData() const { return m_Data; }
-void Tensor::SetData(const Eigen::MatrixXf& d) { m_Data = d; }
+void Tensor::SetData(const Eigen::MatrixXf& d) { m_Data = d; ++m_Version; TrackMemory(); }
 
 Eigen::MatrixXf Tensor::GetGrad() const { return m_Grad; }
-void Tensor::SetGrad(const Eigen::MatrixXf& g) { m_Grad = g; }
+void Tensor::SetGrad(const Eigen::MatrixXf& g) { m_Grad = g; TrackMemory(); }
 
 bool Tensor::GetRequiresGrad() const { return m_bRequiresGrad; }
+
+// Forward-mode tangents
+void Tensor::SetTangent(const Eigen::MatrixXf& t) {
+    if (t.rows() != m_Data.size()) {
+        throw std::runtime_error("Tangent must have one row per element: expected " +
+            std::to_string(m_Data.size()) + " rows, got " + std::to_string(t.rows()));
+    }
+    m_Tangent = t;
+}
+
+Eigen::MatrixXf Tensor::GetTangent() const { return m_Tangent; }
+int Tensor::NumTangents() const { return m_Tangent.cols(); }
+void Tensor::ClearTangent() { m_Tangent.resize(0, 0); }
+
+Eigen::MatrixXf Tensor::TangentOrZero(int numDirs) const {
+    if (m_Tangent.size() > 0) {
+        if (m_Tangent.cols() != numDirs) {
+            throw std::runtime_error("Tangent direction mismatch: expected " + std::to_string(numDirs) +
+                " columns, got " + std::to_string(m_Tangent.cols()));
+        }
+        return m_Tangent;
+    }
+    return Eigen::MatrixXf::Zero(m_Data.size(), numDirs);
+}
@@ -0,0 +1,123 @@
+#include "engine/thread_pool.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+
+static thread_local bool t_bInWorker = false;
+
+ThreadPool::ThreadPool(int numThreads) {
+    for (int i = 0; i < numThreads; ++i) {
+        m_Workers.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStop = true;
+    }
+    m_TaskCv.notify_all();
+    for (std::thread& worker : m_Workers) {
+        worker.join();
+    }
+}
+
+bool ThreadPool::InWorker() {
+    return t_bInWorker;
+}
+
+void ThreadPool::WorkerLoop() {
+    t_bInWorker = true;
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_TaskCv.wait(lock, [this]() { return m_bStop || !m_Tasks.empty(); });
+            if (m_bStop && m_Tasks.empty()) return;
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) return;
+    if (count == 1 || m_Workers.empty() || InWorker()) {
+        for (int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    // Completion latch shared with the queued tasks
+    struct Latch {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int remaining;
+        std::exception_ptr pError;
+    };
+    auto pLatch = std::make_shared<Latch>();
+    pLatch->remaining = count - 1;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (int i = 1; i < count; ++i) {
+            m_Tasks.push_back([pLatch, &fn, i]() {
+                std::exception_ptr pError;
+                try {
+                    fn(i);
+                } catch (...) {
+                    pError = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(pLatch->mutex);
+                if (pError && !pLatch->pError) pLatch->pError = pError;
+                if (--pLatch->remaining == 0) pLatch->cv.notify_one();
+            });
+        }
+    }
+    m_TaskCv.notify_all();
+
+    // The caller counts as a worker while it runs its share, so nested
+    // parallel regions inside fn(0) run serially like on the other workers
+    std::exception_ptr pError;
+    bool bWasInWorker = t_bInWorker;
+    t_bInWorker = true;
+    try {
+        fn(0);
+    } catch (...) {
+        pError = std::current_exception();
+    }
+    t_bInWorker = bWasInWorker;
+
+    std::unique_lock<std::mutex> lock(pLatch->mutex);
+    pLatch->cv.wait(lock, [&]() { return pLatch->remaining == 0; });
+    if (!pError) pError = pLatch->pError;
+    if (pError) std::rethrow_exception(pError);
+}
+
+// ---------------- Global pool ----------------
+
+static std::unique_ptr<ThreadPool> s_pGlobalPool;
+static std::mutex s_GlobalPoolMutex;
+
+static int DefaultThreadCount() {
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+ThreadPool& GetGlobalThreadPool() {
+    std::lock_guard<std::mutex> lock(s_GlobalPoolMutex);
+    if (!s_pGlobalPool) {
+        s_pGlobalPool.reset(new ThreadPool(DefaultThreadCount() - 1));
+    }
+    return *s_pGlobalPool;
+}
+
+void SetNumThreads(int numThreads) {
+    if (numThreads <= 0) numThreads = DefaultThreadCount();
+    std::lock_guard<std::mutex> lock(s_GlobalPoolMutex);
+    s_pGlobalPool.reset(new ThreadPool(numThreads - 1));
+}
+
+int GetNumThreads() {
+    return GetGlobalThreadPool().NumThreads() + 1;
+}
@@ -0,0 +1,272 @@
+#include "engine/engine.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Contact point found after a substep's prediction, solved once at the position level
+struct XPBDContact {
+    Body* pBodyA;
+    Body* pBodyB;
+    float nx, ny;                // From B to A
+    float pen;                   // Depth when detected
+    float localA[2], localB[2];  // Contact point in each body's frame
+    float friction;
+    float restitution;
+    float normalVelocity;        // Before the solve, for restitution
+    float lambda = 0.0f;         // Normal position impulse of this substep
+};
+
+// ---------------- Helpers ----------------
+
+namespace {
+
+float InvMass(const Body* pBody) { return pBody->is_static ? 0.0f : 1.0f / pBody->mass.Get(0, 0); }
+float InvInertia(const Body* pBody) { return pBody->is_static ? 0.0f : 1.0f / pBody->inertia.Get(0, 0); }
+
+void Rotate(float angle, const float* pLocal, float* pOut) {
+    float c = std::cos(angle), s = std::sin(angle);
+    pOut[0] = c * pLocal[0] - s * pLocal[1];
+    pOut[1] = s * pLocal[0] + c * pLocal[1];
+}
+
+void ToLocal(const Body* pBody, float wx, float wy, float* pOut) {
+    float c = std::cos(pBody->GetRotation()), s = std::sin(pBody->GetRotation());
+    float dx = wx - pBody->GetX(), dy = wy - pBody->GetY();
+    pOut[0] = c * dx + s * dy;
+    pOut[1] = -s * dx + c * dy;
+}
+
+void LoadPose(const Body* pBody, float* pOut) {
+    pOut[0] = pBody->GetX();
+    pOut[1] = pBody->GetY();
+    pOut[2] = pBody->GetRotation();
+}
+
+// Generalized inverse mass for a correction along (nx, ny) at offset r
+float GeneralizedInvMass(const Body* pBody, const float* r, float nx, float ny) {
+    if (pBody->is_static) return 0.0f;
+    float rn = r[0] * ny - r[1] * nx;
+    return InvMass(pBody) + InvInertia(pBody) * rn * rn;
+}
+
+// Shift the body by the position impulse (px, py) at offset r
+void ApplyPositionImpulse(Body* pBody, const float* r, float px, float py) {
+    if (pBody->is_static) return;
+    float invMass = InvMass(pBody);
+    pBody->SetPosition(pBody->GetX() + invMass * px, pBody->GetY() + invMass * py);
+    pBody->SetRotation(pBody->GetRotation() + InvInertia(pBody) * (r[0] * py - r[1] * px));
+}
+
+void ApplyVelocityImpulse(Body* pBody, const float* r, float px, float py) {
+    if (pBody->is_static) return;
+    float invMass = InvMass(pBody);
+    pBody->SetVelocity(pBody->vel.Get(0, 0) + invMass * px, pBody->vel.Get(1, 0) + invMass * py);
+    pBody->SetAngularVelocity(pBody->ang_vel.Get(0, 0) + InvInertia(pBody) * (r[0] * py - r[1] * px));
+}
+
+// Velocity of the body's material point at offset r
+void PointVelocity(const Body* pBody, const float* r, float* pOut) {
+    float w = pBody->ang_vel.Get(0, 0);
+    pOut[0] = pBody->vel.Get(0, 0) - w * r[1];
+    pOut[1] = pBody->vel.Get(1, 0) + w * r[0];
+}
+
+// Current offsets of the contact point on both bodies
+void ContactOffsets(const XPBDContact& c, float* rA, float* rB) {
+    Rotate(c.pBodyA->GetRotation(), c.localA, rA);
+    Rotate(c.pBodyB->GetRotation(), c.localB, rB);
+}
+
+// Non-penetration along the normal. Friction is left to the velocity pass,
+// whose Coulomb-clamped impulse can stop the slip completely and so also
+// holds resting contacts; a positional static-friction step on top of it
+// made tall stacks rock with a single iteration.
+void SolveContactPosition(XPBDContact& c, float compliance) {
+    float rA[2], rB[2];
+    ContactOffsets(c, rA, rB);
+    // Both anchors started at the detected point, so their relative motion
+    // along the normal is how much of the depth has been resolved
+    float dx = (c.pBodyA->GetX() + rA[0]) - (c.pBodyB->GetX() + rB[0]);
+    float dy = (c.pBodyA->GetY() + rA[1]) - (c.pBodyB->GetY() + rB[1]);
+    float pen = c.pen - (dx * c.nx + dy * c.ny);
+    if (pen <= 0.0f) return;
+
+    float w = GeneralizedInvMass(c.pBodyA, rA, c.nx, c.ny) + GeneralizedInvMass(c.pBodyB, rB, c.nx, c.ny);
+    if (w <= 0.0f) return;
+    float lambda = pen / (w + compliance);
+    c.lambda += lambda;
+    ApplyPositionImpulse(c.pBodyA, rA, lambda * c.nx, lambda * c.ny);
+    ApplyPositionImpulse(c.pBodyB, rB, -lambda * c.nx, -lambda * c.ny);
+}
+
+// Dynamic friction and restitution on the velocities derived from the positions
+void SolveContactVelocity(XPBDContact& c, float h, float gravity) {
+    if (c.lambda <= 0.0f) return;
+    float rA[2], rB[2], vA[2], vB[2];
+    ContactOffsets(c, rA, rB);
+    PointVelocity(c.pBodyA, rA, vA);
+    PointVelocity(c.pBodyB, rB, vB);
+    float vx = vA[0] - vB[0], vy = vA[1] - vB[1];
+    float vn = vx * c.nx + vy * c.ny;
+    float vtx = vx - vn * c.nx, vty = vy - vn * c.ny;
+    float vt = std::sqrt(vtx * vtx + vty * vty);
+
+    float px = 0.0f, py = 0.0f;
+    if (vt > 1e-9f) {
+        // Normal force is lambda / h^2, so the friction impulse is at most mu * lambda / h
+        float tx = vtx / vt, ty = vty / vt;
+        float wt = GeneralizedInvMass(c.pBodyA, rA, tx, ty) + GeneralizedInvMass(c.pBodyB, rB, tx, ty);
+        if (wt > 0.0f) {
+            float pt = std::min(c.friction * c.lambda / h, vt / wt);
+            px -= pt * tx;
+            py -= pt * ty;
+        }
+    }
+    // No bounce below the speed gravity adds in two substeps (resting contacts)
+    float e = std::abs(c.normalVelocity) <= 2.0f * gravity * h ? 0.0f : c.restitution;
+    float wn = GeneralizedInvMass(c.pBodyA, rA, c.nx, c.ny) + GeneralizedInvMass(c.pBodyB, rB, c.nx, c.ny);
+    if (wn > 0.0f) {
+        float pn = (-vn + std::max(-e * c.normalVelocity, 0.0f)) / wn;
+        px += pn * c.nx;
+        py += pn * c.ny;
+    }
+    ApplyVelocityImpulse(c.pBodyA, rA, px, py);
+    ApplyVelocityImpulse(c.pBodyB, rB, -px, -py);
+}
+
+} // namespace
+
+// ---------------- Solver mode ----------------
+
+void Engine::SetSolverMode(SolverMode mode) { m_SolverMode = mode; }
+
+void Engine::SetContactCompliance(float compliance) {
+    if (compliance < 0.0f) throw std::runtime_error("Engine: contact compliance must be non-negative");
+    m_ContactCompliance = compliance;
+}
+
+void Engine::SetJointCompliance(float compliance) {
+    if (compliance < 0.0f) throw std::runtime_error("Engine: joint compliance must be non-negative");
+    m_JointCompliance = compliance;
+}
+
+// ---------------- Contacts ----------------
+
+void Engine::DetectXPBDContacts(Body* pBodyA, Body* pBodyB, std::vector<XPBDContact>& contacts) {
+    for (const Shape& shapeA : pBodyA->shapes) {
+        for (const Shape& shapeB : pBodyB->shapes) {
+            float pen = 0, nx = 0, ny = 0;
+            float contactsX[4], contactsY[4], contactsPen[4];
+            int numContacts = CollideShapes(pBodyA, shapeA, pBodyB, shapeB, pen, nx, ny,
+                                            contactsX, contactsY, contactsPen);
+            for (int i = 0; i < numContacts; ++i) {
+                XPBDContact contact;
+                contact.pBodyA = pBodyA;
+                contact.pBodyB = pBodyB;
+                contact.nx = nx;
+                contact.ny = ny;
+                contact.pen = contactsPen[i];
+                ToLocal(pBodyA, contactsX[i], contactsY[i], contact.localA);
+                ToLocal(pBodyB, contactsX[i], contactsY[i], contact.localB);
+                contact.friction = (pBodyA->friction + pBodyB->friction) / 2.0f;
+                contact.restitution = (pBodyA->restitution + pBodyB->restitution) / 2.0f;
+
+                float rA[2], rB[2], vA[2], vB[2];
+                ContactOffsets(contact, rA, rB);
+                PointVelocity(pBodyA, rA, vA);
+                PointVelocity(pBodyB, rB, vB);
+                contact.normalVelocity = (vA[0] - vB[0]) * nx + (vA[1] - vB[1]) * ny;
+                contacts.push_back(contact);
+            }
+        }
+    }
+}
+
+// ---------------- Update ----------------
+
+void Engine::UpdateXPBD() {
+    float h = m_DeltaTime / static_cast<float>(m_Substeps);
+    float invH = 1.0f / h;
+    float contactCompliance = m_ContactCompliance * invH * invH;
+    float jointCompliance = m_JointCompliance * invH * invH;
+    float gravity = std::sqrt(m_GravityX * m_GravityX + m_GravityY * m_GravityY);
+
+    std::vector<float> prev(m_Bodies.size() * 3);
+    std::vector<XPBDContact> contacts;
+
+    for (int step = 0; step < m_Substeps; ++step) {
+        // 0-1. Motor forces and gravity, as in the impulse solver
+        for (Body* pBody : m_Bodies) {
+            pBody->ApplyMotorForces();
+            ApplyGravity(pBody, h);
+        }
+        for (ArticulatedChain* pChain : m_Articulations) {
+            for (Body* pLink : pChain->Links()) {
+                pLink->ApplyMotorForces();
+                ApplyGravity(pLink, h);
+            }
+        }
+
+        // 2. Predict: unconstrained integration from the saved poses
+        for (size_t i = 0; i < m_Bodies.size(); ++i) {
+            LoadPose(m_Bodies[i], &prev[i * 3]);
+            Integrate(m_Bodies[i], h);
+        }
+        for (ArticulatedChain* pChain : m_Articulations) {
+            pChain->Step(h);
+        }
+
+        // 3. Contacts at the predicted poses
+        contacts.clear();
+        for (size_t i = 0; i < m_Bodies.size(); ++i) {
+            for (size_t j = i + 1; j < m_Bodies.size(); ++j) {
+                if (!m_Joints.empty() && JointPreventsCollision(m_Bodies[i], m_Bodies[j])) continue;
+                DetectXPBDContacts(m_Bodies[i], m_Bodies[j], contacts);
+            }
+        }
+        for (Body* pBody : m_Bodies) {
+            for (Body* pCollider : m_Colliders) {
+                if (!m_Joints.empty() && JointPreventsCollision(pBody, pCollider)) continue;
+                DetectXPBDContacts(pBody, pCollider, contacts);
+            }
+        }
+
+        // 4. One position iteration over contacts and joints
+        for (XPBDContact& contact : contacts) {
+            SolveContactPosition(contact, contactCompliance);
+        }
+        for (Joint* pJoint : m_Joints) {
+            pJoint->SolvePosition(jointCompliance);
+        }
+
+        // 5. Velocities from the position change
+        for (size_t i = 0; i < m_Bodies.size(); ++i) {
+            Body* pBody = m_Bodies[i];
+            if (pBody->is_static) continue;
+            const float* pPrev = &prev[i * 3];
+            pBody->SetVelocity((pBody->GetX() - pPrev[0]) * invH, (pBody->GetY() - pPrev[1]) * invH);
+            pBody->SetAngularVelocity((pBody->GetRotation() - pPrev[2]) * invH);
+        }
+
+        // 6. Velocity pass: friction, restitution, joint motors
+        for (XPBDContact& contact : contacts) {
+            SolveContactVelocity(contact, h, gravity);
+        }
+        for (Joint* pJoint : m_Joints) {
+            pJoint->ApplyMotor(h);
+        }
+
+        // Articulated links vs everything else
+        if (!m_Articulations.empty()) {
+            ResolveArticulationContacts();
+        }
+    }
+
+    // Clear garbage collectors
+    for (Body* pBody : m_Bodies) {
+        pBody->garbage_collector.clear();
+    }
+    for (ArticulatedChain* pChain : m_Articulations) {
+        for (Body* pLink : pChain->Links()) pLink->garbage_collector.clear();
+    }
+}
@@ -0,0 +1,145 @@
+"""
+DroneEnv Native PPO Demo - Train with the built-in C++ PPO trainer
+
+This example demonstrates:
+1. Training entirely in C++ (rollouts, GAE, minibatch updates, Adam)
+2. Saving the policy to a small binary file
+3. Loading it back and flying the Python DroneEnv with it
+
+No PyTorch or Stable-Baselines3 needed; Python only runs once per iteration
+to print progress.
+
+Usage:
+    python examples/demo_native_ppo.py [--steps 1000000] [--out drone_policy.bin] [--no-render]
+"""
+
+import sys
+import os
+import argparse
+
+# Add project to path
+script_dir = os.path.dirname(os.path.abspath(__file__))
+project_dir = os.path.dirname(script_dir)
+sys.path.insert(0, project_dir)
+
+import numpy as np
+from rigidrl_py.envs import DroneEnv
+from rigidrl_py.envs.drone_env import rigid
+from rigidrl_py.configs import EnvConfig, DroneConfig, MotorConfig
+
+if rigid is None:
+    print("ERROR: rigidRL module not found. Run compile.bat / compile.sh first.")
+    exit(1)
+
+
+# === Configuration ===
+DRONE = DroneConfig(
+    mass=1.0,
+    width=1.0,
+    height=0.2,
+    motors=[
+        MotorConfig(x=-0.4, max_thrust=10.0),
+        MotorConfig(x=0.4, max_thrust=10.0)
+    ]
+)
+
+TRAIN_CONFIG = EnvConfig(
+    drone=DRONE,
+    target=(0.0, 4.0),
+    spawn_points=[(0.0, 1.5), (-2.0, 1.5), (2.0, 1.5), (0.0, 2.5), (1.0, 1.0)],
+    max_steps=500
+)
+
+TEST_CONFIG = EnvConfig(
+    drone=DRONE,
+    target=(0.0, 4.0),
+    spawn_points=[(-3.0, 2.0)],
+    max_steps=500,
+    window_width=1000,
+    window_height=800,
+    scale=80.0
+)
+
+
+def to_task_config(config: EnvConfig, dt: float = 0.016, substeps: int = 20) -> "rigid.DroneTaskConfig":
+    """Convert a Python EnvConfig into the C++ task description."""
+    task = rigid.DroneTaskConfig()
+    task.mass = config.drone.mass
+    task.width = config.drone.width
+    task.height = config.drone.height
+    task.motors = [
+        rigid.Motor(m.x, m.y, m.width, m.height, m.mass, m.max_thrust)
+        for m in config.drone.motors
+    ]
+    task.target_x, task.target_y = config.target
+    task.spawn_points = [tuple(p) for p in config.spawn_points]
+    task.max_steps = config.max_steps
+    task.dt = dt
+    task.substeps = substeps
+    return task
+
+
+def train(total_steps: int, out_path: str):
+    ppo = rigid.PPOConfig()
+    ppo.num_envs = 16
+    ppo.steps_per_env = 256
+    ppo.epochs = 10
+    ppo.minibatch_size = 512
+    ppo.learning_rate = 3e-4
+    ppo.loss.entropy_coef = 0.0
+
+    trainer = rigid.PPOTrainer(to_task_config(TRAIN_CONFIG), ppo)
+    print(f"Training for {total_steps:,} steps with {ppo.num_envs} worlds "
+          f"({rigid.get_num_threads()} threads)")
+
+    while trainer.total_steps() < total_steps:
+        s = trainer.iterate()
+        if s.iteration % 5 == 0:
+            print(f"iter {s.iteration:4d} | steps {s.total_steps:9,d} | "
+                  f"return {s.mean_episode_return:8.1f} | len {s.mean_episode_length:5.0f} | "
+                  f"kl {s.approx_kl:.4f} | clip {s.clip_fraction:.2f} | "
+                  f"{s.rollout_ms:.0f} + {s.update_ms:.0f} ms")
+
+    trainer.policy().save(out_path)
+    print(f"Saved policy to {out_path}")
+
+
+def visualize(policy_path: str, episodes: int = 3):
+    """Fly the Python DroneEnv on an unseen spawn point with the saved policy."""
+    policy = rigid.GaussianPolicy.load(policy_path)
+    env = DroneEnv(config=TEST_CONFIG, render_mode="human")
+    max_thrust = np.array([m.max_thrust for m in TEST_CONFIG.drone.motors], dtype=np.float32)
+
+    for episode in range(episodes):
+        obs, _ = env.reset()
+        total_reward = 0.0
+        while True:
+            # Policy acts in [-1, 1]; DroneEnv expects thrust in [0, max_thrust]
+            action = np.asarray(policy.mean(obs.reshape(-1, 1)))[:, 0]
+            thrust = 0.5 * (np.clip(action, -1.0, 1.0) + 1.0) * max_thrust
+            obs, reward, terminated, truncated, info = env.step(thrust)
+            total_reward += reward
+            if info.get("window_closed"):
+                env.close()
+                return
+            if terminated or truncated:
+                print(f"Episode {episode + 1}: {'Crashed' if terminated else 'Timeout'}, "
+                      f"reward {total_reward:.1f}")
+                break
+    env.close()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--steps", type=int, default=1_000_000)
+    parser.add_argument("--out", default="drone_policy.bin")
+    parser.add_argument("--no-render", action="store_true")
+    args = parser.parse_args()
+
+    train(args.steps, args.out)
+    if not args.no_render:
+        visualize(args.out)
+
+
+if __name__ == "__main__":
+    main()
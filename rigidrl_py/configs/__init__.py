@@ -39,6 +39,21 @@ class DroneConfig:
         )
 
 
+@dataclass
+class CurriculumConfig:
+    """Spawn-point curriculum (see rigidRL.CurriculumSampler)"""
+    mode: str = "uniform"       # "uniform", "learning_progress" or "difficulty"
+    fast_rate: float = 0.1
+    slow_rate: float = 0.01
+    uniform_mix: float = 0.1
+    min_episodes: int = 3
+    success_radius: float = 0.5
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "CurriculumConfig":
+        return cls(**data)
+
+
 @dataclass
 class EnvConfig:
     """Environment configuration"""
@@ -49,6 +64,7 @@ class EnvConfig:
     window_width: int = 800
     window_height: int = 600
     scale: float = 50.0
+    curriculum: CurriculumConfig = field(default_factory=CurriculumConfig)
     
     @classmethod
     def from_dict(cls, data: dict) -> "EnvConfig":
@@ -65,7 +81,8 @@ class EnvConfig:
             max_steps=data.get("max_steps", 500),
             window_width=data.get("window_width", 800),
             window_height=data.get("window_height", 600),
-            scale=data.get("scale", 50.0)
+            scale=data.get("scale", 50.0),
+            curriculum=CurriculumConfig.from_dict(data.get("curriculum", {}))
         )
     
     @classmethod
@@ -76,4 +93,4 @@ class EnvConfig:
 
 
 # Convenience exports
-__all__ = ["MotorConfig", "DroneConfig", "EnvConfig"]
+__all__ = ["MotorConfig", "DroneConfig", "CurriculumConfig", "EnvConfig"]
@@ -85,6 +85,11 @@ class DroneEnv(RigidEnv):
         self.drone = None
         self.motors = []
         
+        # Spawn curriculum; episodes report back to it when they end
+        self.curriculum = self._create_curriculum(config.curriculum, len(self.spawn_points))
+        self._spawn_idx = 0
+        self._episode_return = 0.0
+        
     @classmethod
     def from_yaml(cls, path: str, render_mode=None) -> "DroneEnv":
         """Create environment from YAML config file."""
@@ -100,6 +105,23 @@ class DroneEnv(RigidEnv):
         )
         return cls.from_yaml(default_path, render_mode=render_mode)
         
+    @staticmethod
+    def _create_curriculum(cfg, num_spawns):
+        """Native sampler for non-uniform curricula, None for uniform sampling."""
+        if cfg.mode == "uniform" or rigid is None:
+            return None
+        sampler_cfg = rigid.CurriculumConfig()
+        sampler_cfg.mode = {
+            "learning_progress": rigid.CurriculumMode.LEARNING_PROGRESS,
+            "difficulty": rigid.CurriculumMode.DIFFICULTY,
+        }[cfg.mode]
+        sampler_cfg.fast_rate = cfg.fast_rate
+        sampler_cfg.slow_rate = cfg.slow_rate
+        sampler_cfg.uniform_mix = cfg.uniform_mix
+        sampler_cfg.min_episodes = cfg.min_episodes
+        sampler_cfg.success_radius = cfg.success_radius
+        return rigid.CurriculumSampler(num_spawns, sampler_cfg)
+        
     def _setup_scene(self):
         """Create the drone simulation scene."""
         self.engine.set_gravity(0, -9.81)
@@ -107,9 +129,14 @@ class DroneEnv(RigidEnv):
         # Ground plane
         self.engine.Collider(0, -1, 20, 1, 0)
         
-        # Randomly select spawn point
-        spawn_idx = np.random.randint(0, len(self.spawn_points))
+        # Select spawn point (uniformly, or from the curriculum)
+        if self.curriculum is None:
+            spawn_idx = np.random.randint(0, len(self.spawn_points))
+        else:
+            spawn_idx = self.curriculum.sample(np.random.random())
         spawn_x, spawn_y = self.spawn_points[spawn_idx]
+        self._spawn_idx = spawn_idx
+        self._episode_return = 0.0
         
         # Create drone body from config
         drone_cfg = self.config.drone
@@ -179,3 +206,13 @@ class DroneEnv(RigidEnv):
             return True
         return False
 
+    
+    def step(self, action: np.ndarray):
+        """Step, and report finished episodes to the spawn curriculum."""
+        obs, reward, terminated, truncated, info = super().step(action)
+        self._episode_return += reward
+        if self.curriculum is not None and (terminated or truncated):
+            dist = float(np.hypot(obs[0], obs[1]))
+            success = not terminated and dist < self.config.curriculum.success_radius
+            self.curriculum.record(self._spawn_idx, self._episode_return, success)
+        return obs, reward, terminated, truncated, info